@@ -6,6 +6,10 @@ namespace BSDS500 {
 
     void kOfN (int k, int n, int* values);
 
+    // Reseed the calling thread's generator, so that a sequence of kOfN
+    // calls can be reproduced regardless of the thread it runs on.
+    void seedKOfN (unsigned int seed);
+
 } // namespace BSDS500
 
 #endif // __kofn_hh__
@@ -4,12 +4,13 @@
 #include <chrono>
 #include <cassert>
 #include <functional>
+#include <thread>
 
 using namespace BSDS500;
 
-static std::mt19937 s_oMT(std::chrono::system_clock::now().time_since_epoch().count());
-static std::uniform_real_distribution<double> s_oURDistrib_0_1(0,std::nextafter(1,std::numeric_limits<double>::max()));
-static auto s_oRand_0_1_Funct = std::bind(s_oURDistrib_0_1,s_oMT);
+// generators are per-thread, as matching jobs may run concurrently
+static thread_local std::mt19937 s_oMT(std::chrono::system_clock::now().time_since_epoch().count()^std::hash<std::thread::id>()(std::this_thread::get_id()));
+static thread_local std::uniform_real_distribution<double> s_oURDistrib_0_1(0,std::nextafter(1,std::numeric_limits<double>::max()));
 
 // O(n) implementation.
 static void
@@ -21,7 +22,7 @@ _kOfN_largeK (int k, int n, int* values)
     for (int i = 0; i < n; i++) {
         double prob = (double) (k - j) / (n - i);
         assert (prob <= 1);
-        double x = s_oRand_0_1_Funct();
+        double x = s_oURDistrib_0_1(s_oMT);
         if (x < prob) {
             values[j++] = i;
         }
@@ -77,3 +78,10 @@ BSDS500::kOfN (int k, int n, int* values)
         _kOfN_largeK (k, n, values);
     }
 }
+
+void
+BSDS500::seedKOfN (unsigned int seed)
+{
+    s_oMT.seed(seed);
+    s_oURDistrib_0_1.reset();
+}
@@ -34,10 +34,13 @@
 #define USE_GLSL_IMPL           0
 #define USE_CUDA_IMPL           0
 #define USE_OPENCL_IMPL         0
+#define USE_GLSL_CPU_EVAL       0 // counts GLSL outputs on a cpu worker thread instead of a compute shader (only used if evaluating)
 ////////////////////////////////
 #define DATASET_ID              Dataset_CDnet // comment this line to fall back to custom dataset definition
 #define DATASET_OUTPUT_PATH     "results_test" // will be created in the app's working directory if using a custom dataset
 #define DATASET_PRECACHING      1
+#define DATASET_LIVE_REPORTING  0 // writes per-batch packet counts, throughput, latency percentiles and metrics to 'live_report.json' in the output directory while processing
+#define DATASET_PACKED_CACHE    0 // packs decoded packets in a single file per batch on first run, then memory-maps it on later runs
 #define DATASET_SCALE_FACTOR    1.0
 #define DATASET_WORKTHREADS     1
 ////////////////////////////////
@@ -89,7 +92,7 @@ using BackgroundSubtractorType = BackgroundSubtractorPAWCS_<eImplTypeEnum>;
 int main(int, char**) {
     try {
         DatasetType::Ptr pDataset = DatasetType::create(DATASET_PARAMS);
-        lv::IDataHandlerPtrQueue vpBatches = pDataset->getSortedBatches(false);
+        const lv::IDataHandlerPtrArray vpBatches = pDataset->getBatches(false);
         const size_t nTotPackets = pDataset->getInputCount();
         const size_t nTotBatches = vpBatches.size();
         if(nTotBatches==0 || nTotPackets==0)
@@ -97,17 +100,15 @@ int main(int, char**) {
         std::cout << "Parsing complete. [" << nTotBatches << " batch(es)]" << std::endl;
         std::cout << "\n[" << lv::getTimeStamp() << "]\n" << std::endl;
         std::cout << "Executing algorithm with " << (USE_GPU_IMPL?1:DATASET_WORKTHREADS) << " thread(s)..." << std::endl;
-        lv::WorkerPool<(USE_GPU_IMPL?1:DATASET_WORKTHREADS)> oPool;
-        std::queue<std::future<void>> vTaskResults;
-        while(!vpBatches.empty()) {
-            lv::IDataHandlerPtr pBatch = vpBatches.top();
-            vTaskResults.push(oPool.queueTask(Analyze,std::to_string(nTotBatches-vpBatches.size()+1)+"/"+std::to_string(nTotBatches),pBatch));
-            vpBatches.pop();
-        }
-        while(!vTaskResults.empty()) {
-            vTaskResults.front().get();
-            vTaskResults.pop();
-        }
+        std::unique_ptr<lv::DataLiveReporter> pLiveReporter;
+        if(DATASET_LIVE_REPORTING)
+            pLiveReporter = std::make_unique<lv::DataLiveReporter>(pDataset,pDataset->getOutputPath()+"live_report.json");
+        // batches are dispatched longest-first, with expected durations refined from the throughput of finished batches
+        lv::BatchScheduler oScheduler((USE_GPU_IMPL?1:DATASET_WORKTHREADS));
+        oScheduler.run(vpBatches,[](const lv::IDataHandlerPtr& pBatch, size_t /*nThreadBudget*/, const std::string& sWorkerName) {
+            Analyze(sWorkerName,pBatch); // the budget is applied by the scheduler to nested parallel loops (e.g. evaluation), so tail batches still use idle workers
+        });
+        pLiveReporter = nullptr; // writes the final records of all batches
         pDataset->writeEvalReport();
     }
     catch(const cv::Exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught cv::Exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return -1;}
@@ -125,6 +126,13 @@ void Analyze(std::string sWorkerName, lv::IDataHandlerPtr pBatch) {
         DatasetType::WorkBatch& oBatch = dynamic_cast<DatasetType::WorkBatch&>(*pBatch);
         lvAssert(oBatch.getInputPacketType()==lv::ImagePacket && oBatch.getOutputPacketType()==lv::ImagePacket);
         lvAssert(oBatch.getFrameCount()>1);
+        if(DATASET_PACKED_CACHE) {
+            const std::string sPackedCachePath = oBatch.getOutputPath()+"packed_cache.bin";
+            if(!oBatch.openPackedCache(sPackedCachePath)) {
+                oBatch.writePackedCache(sPackedCachePath,EVALUATE_OUTPUT);
+                lvAssert(oBatch.openPackedCache(sPackedCachePath));
+            }
+        }
         if(DATASET_PRECACHING)
             oBatch.startPrecaching(EVALUATE_OUTPUT);
         const std::string sCurrBatchName = lv::clampString(oBatch.getName(),12);
@@ -137,6 +145,7 @@ void Analyze(std::string sWorkerName, lv::IDataHandlerPtr pBatch) {
         pAlgo->m_pDisplayHelper = pDisplayHelper;
 #endif //DISPLAY_OUTPUT>1
         const double dDefaultLearningRate = pAlgo->getDefaultLearningRate();
+        oBatch.setCPUEvaluation(bool(USE_GLSL_CPU_EVAL));
         oBatch.initialize_gl(pAlgo);
         oContext.setWindowSize(oBatch.getIdealGLWindowSize());
         oBatch.startProcessing();
@@ -196,6 +205,13 @@ void Analyze(std::string sWorkerName, lv::IDataHandlerPtr pBatch) {
         DatasetType::WorkBatch& oBatch = dynamic_cast<DatasetType::WorkBatch&>(*pBatch);
         lvAssert(oBatch.getInputPacketType()==lv::ImagePacket && oBatch.getOutputPacketType()==lv::ImagePacket);
         lvAssert(oBatch.getFrameCount()>1);
+        if(DATASET_PACKED_CACHE) {
+            const std::string sPackedCachePath = oBatch.getOutputPath()+"packed_cache.bin";
+            if(!oBatch.openPackedCache(sPackedCachePath)) {
+                oBatch.writePackedCache(sPackedCachePath,EVALUATE_OUTPUT);
+                lvAssert(oBatch.openPackedCache(sPackedCachePath));
+            }
+        }
         if(DATASET_PRECACHING)
             oBatch.startPrecaching(EVALUATE_OUTPUT);
         const std::string sCurrBatchName = lv::clampString(oBatch.getName(),12);
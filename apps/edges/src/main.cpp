@@ -31,6 +31,7 @@
 #define DATASET_ID              Dataset_BSDS500 // comment this line to fall back to custom dataset definition
 #define DATASET_OUTPUT_PATH     "results_test" // will be created in the app's working directory if using a custom dataset
 #define DATASET_PRECACHING      1
+#define DATASET_LIVE_REPORTING  0 // writes per-batch packet counts, throughput, latency percentiles and metrics to 'live_report.json' in the output directory while processing
 #define DATASET_SCALE_FACTOR    1.0
 #define DATASET_WORKTHREADS     1
 ////////////////////////////////
@@ -72,7 +73,7 @@ using EdgeDetectorType = EdgeDetectorLBSP;
 int main(int, char**) {
     try {
         DatasetType::Ptr pDataset = DatasetType::create(DATASET_PARAMS);
-        lv::IDataHandlerPtrQueue vpBatches = pDataset->getSortedBatches(false);
+        const lv::IDataHandlerPtrArray vpBatches = pDataset->getBatches(false);
         const size_t nTotPackets = pDataset->getInputCount();
         const size_t nTotBatches = vpBatches.size();
         if(nTotBatches==0 || nTotPackets==0)
@@ -80,17 +81,15 @@ int main(int, char**) {
         std::cout << "Parsing complete. [" << nTotBatches << " batch(es)]" << std::endl;
         std::cout << "\n[" << lv::getTimeStamp() << "]\n" << std::endl;
         std::cout << "Executing algorithm with " << DATASET_WORKTHREADS << " thread(s)..." << std::endl;
-        lv::WorkerPool<DATASET_WORKTHREADS> oPool;
-        std::queue<std::future<void>> vTaskResults;
-        while(!vpBatches.empty()) {
-            lv::IDataHandlerPtr pBatch = vpBatches.top();
-            vTaskResults.push(oPool.queueTask(Analyze,std::to_string(nTotBatches-vpBatches.size()+1)+"/"+std::to_string(nTotBatches),pBatch));
-            vpBatches.pop();
-        }
-        while(!vTaskResults.empty()) {
-            vTaskResults.front().get();
-            vTaskResults.pop();
-        }
+        std::unique_ptr<lv::DataLiveReporter> pLiveReporter;
+        if(DATASET_LIVE_REPORTING)
+            pLiveReporter = std::make_unique<lv::DataLiveReporter>(pDataset,pDataset->getOutputPath()+"live_report.json");
+        // batches are dispatched longest-first, with expected durations refined from the throughput of finished batches
+        lv::BatchScheduler oScheduler(DATASET_WORKTHREADS);
+        oScheduler.run(vpBatches,[](const lv::IDataHandlerPtr& pBatch, size_t /*nThreadBudget*/, const std::string& sWorkerName) {
+            Analyze(sWorkerName,pBatch); // the budget is applied by the scheduler to nested parallel loops (e.g. evaluation), so tail batches still use idle workers
+        });
+        pLiveReporter = nullptr; // writes the final records of all batches
         pDataset->writeEvalReport();
     }
     catch(const cv::Exception& e) {std::cout << "\n!!!!!!!!!!!!!!\nTop level caught cv::Exception:\n" << e.what() << "\n!!!!!!!!!!!!!!\n" << std::endl; return -1;}
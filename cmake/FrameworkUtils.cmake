@@ -44,6 +44,19 @@ macro(litiv_module name)
     set(LITIV_CURRENT_PROJECT_NAME litiv_${name})
 endmacro(litiv_module)
 
+macro(litiv_test name)
+    set(LITIV_CURRENT_TEST_NAME litiv_test_${LITIV_CURRENT_MODULE_NAME}_${name})
+    add_executable(${LITIV_CURRENT_TEST_NAME} "test/${name}.cpp")
+    target_link_libraries(${LITIV_CURRENT_TEST_NAME} ${LITIV_CURRENT_PROJECT_NAME})
+    # tests may also check internal kernels via the module's private headers
+    target_include_directories(${LITIV_CURRENT_TEST_NAME}
+        PRIVATE "${CMAKE_SOURCE_DIR}/modules/utils/test/"
+        PRIVATE "${CMAKE_CURRENT_SOURCE_DIR}/src/"
+    )
+    set_target_properties(${LITIV_CURRENT_TEST_NAME} PROPERTIES FOLDER "tests")
+    add_test(NAME ${LITIV_CURRENT_TEST_NAME} COMMAND ${LITIV_CURRENT_TEST_NAME})
+endmacro(litiv_test)
+
 macro(set_eval name)
     if(${ARGN})
         set(${name} 1)
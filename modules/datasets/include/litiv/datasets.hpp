@@ -74,8 +74,10 @@ namespace lv {
                 public DataProducer_<eDatasetTask,eDatasetSource,eDataset>,
                 public DataTemplSpec_<eDatasetTask,eDatasetSource,eDataset,eDatasetEval>,
                 public DataEvaluator_<eDatasetEval,eDataset,eEvalImpl> {
-            /// default destructor, should stay public so smart pointers can access it
-            virtual ~WorkBatch() = default;
+            /// default destructor, should stay public so smart pointers can access it (joins the async evaluation worker while virtual calls are still safe)
+            virtual ~WorkBatch() {
+                this->stopAsyncEvaluation();
+            }
             /// returns the time taken so far to process the work batch data (i.e. between start/stopProcessing calls)
             virtual double getCurrentProcessTime() const override final {return this->m_bIsProcessing?this->m_oStopWatch.elapsed():this->m_dFinalElapsedTime;}
             /// returns the final time taken to process the work batch data (i.e. between start/stopProcessing calls)
@@ -171,8 +173,11 @@ namespace lv {
             this->m_bIsBare = false; // always false by default for top level
             if(!this->getOutputPath().empty())
                 lv::CreateDirIfNotExist(this->getOutputPath());
+            std::vector<std::pair<std::string,std::string>> vsBatchNamesAndPaths;
             for(const auto& sPathIter : this->getWorkBatchDirs())
-                this->m_vpBatches.push_back(createWorkBatch(sPathIter,lv::AddDirSlashIfMissing(sPathIter)));
+                vsBatchNamesAndPaths.emplace_back(sPathIter,lv::AddDirSlashIfMissing(sPathIter));
+            this->m_vpBatches = this->createWorkBatches(vsBatchNamesAndPaths);
+            this->getIndexCache().save(); // makes the next parsing of this dataset (near) instantaneous
         }
     protected:
         /// full dataset constructor (copied from DatasetHandler to avoid msvc2015 bug); parameters are passed through lv::datasets::create<...>(...), and may be caught/simplified by a specialization
@@ -18,6 +18,7 @@
 #pragma once
 
 #define DATASETUTILS_VALIDATE_ASYNC_EVALUATORS 0
+#define DATASETUTILS_CPU_ASYNC_EVAL_MAX_QUEUED 4 // packets waiting to be counted by the cpu async evaluator before the processing thread blocks
 
 #include "litiv/datasets/metrics.hpp"
 
@@ -33,8 +34,10 @@ namespace lv {
         /// writes an evaluation report listing packet counts, seconds elapsed and algo speed for current batch(es)
         virtual void writeEvalReport() const override;
     protected:
-        /// returns a one-line string listing packet counts, seconds elapsed and algo speed for current batch(es)
+        /// returns a one-line string listing packet counts, seconds elapsed, algo speed and per-packet latency percentiles for current batch(es)
         std::string writeInlineBasicReport(size_t nIndentSize) const;
+        /// returns a one-line string listing per-packet latency percentiles for current batch(es)
+        std::string writeInlineLatencyReport() const;
     };
 
     /// data reporter specialization for binary classification work batch report writing
@@ -91,6 +94,12 @@ namespace lv {
             lvAssert_(pLoader->getOutputPacketType()==ImagePacket && pLoader->getGTPacketType()==ImagePacket && pLoader->getGTMappingType()==PixelMapping,"default impl cannot display mask without 1:1 image pixel mapping");
             return BinClassif::getColoredMask(oClassif,pLoader->getGT(nIdx),pLoader->getGTROI(nIdx));
         }
+        /// evaluates several candidate outputs for the same packet (e.g. from a parameter sweep) in a single pass over its gt/ROI, with one counters object per candidate (resized if empty); the batch's own metrics are untouched
+        virtual void evaluateCandidates(const std::vector<cv::Mat>& vClassifs, size_t nIdx, std::vector<BinClassif>& vCounters) {
+            auto pLoader = shared_from_this_cast<IIDataLoader>(true);
+            lvAssert_(pLoader->getOutputPacketType()==ImagePacket && pLoader->getGTPacketType()==ImagePacket && pLoader->getGTMappingType()==PixelMapping,"default impl cannot evaluate without 1:1 image pixel mapping");
+            BinClassif::accumulate(vClassifs,pLoader->getGT(nIdx),pLoader->getGTROI(nIdx),vCounters);
+        }
         /// resets internal packet count + classification metrics
         virtual void resetMetrics() override {
             IDataConsumer_<DatasetEval_BinaryClassifier>::resetMetrics();
@@ -101,13 +110,17 @@ namespace lv {
         virtual IIMetricsAccumulatorConstPtr getMetricsBase() const override final {
             return m_pMetricsBase;
         }
+        /// overrides 'getLiveMetrics' from IDataCounter to attach classification metrics to live snapshots
+        virtual IIMetricsCalculatorConstPtr getLiveMetrics() const override {
+            return this->getMetrics(false);
+        }
         /// overrides 'processOutput' from IDataConsumer_ to evaluate the provided output packet
         virtual void processOutput(const cv::Mat& oClassif, size_t nIdx) override {
             if(isEvaluating()) {
                 lvAssert_(!oClassif.empty(),"output must be non-empty for evaluation");
                 auto pLoader = shared_from_this_cast<IIDataLoader>(true);
                 lvAssert_(pLoader->getOutputPacketType()==ImagePacket && pLoader->getGTPacketType()==ImagePacket && pLoader->getGTMappingType()==PixelMapping,"default impl cannot evaluate without 1:1 image pixel mapping");
-                m_pMetricsBase->m_oCounters.accumulate(oClassif,pLoader->getGT(nIdx),pLoader->getGTROI(nIdx));
+                m_pMetricsBase->m_oCounters.accumulate(oClassif,pLoader->getGT(nIdx,getGTReaderIdx()),pLoader->getGTROI(nIdx));
             }
         }
         /// default constructor; automatically creates an instance of the base metrics accumulator object
@@ -144,6 +157,10 @@ namespace lv {
         virtual IIMetricsAccumulatorConstPtr getMetricsBase() const override final {
             return m_pMetricsBase;
         }
+        /// overrides 'getLiveMetrics' from IDataCounter to attach classification metrics to live snapshots
+        virtual IIMetricsCalculatorConstPtr getLiveMetrics() const override {
+            return this->getMetrics(false);
+        }
         /// overrides 'processOutput' from IDataConsumer_ to evaluate the provided output packet
         virtual void processOutput(const std::vector<cv::Mat>& vClassif, size_t nIdx) override {
             if(isEvaluating()) {
@@ -151,7 +168,7 @@ namespace lv {
                 auto pLoader = shared_from_this_cast<IDataLoader_<Array>>(true);
                 lvAssert_(pLoader->getOutputPacketType()==ImageArrayPacket && pLoader->getGTPacketType()==ImageArrayPacket && pLoader->getGTMappingType()==PixelMapping,"default impl cannot evaluate without 1:1 image pixel mapping");
                 lvAssert_(pLoader->getGTStreamCount()==getOutputStreamCount() && vClassif.size()==getOutputStreamCount(),"gt/output array size mismatch");
-                const std::vector<cv::Mat>& vGTArray = pLoader->getGTArray(nIdx);
+                const std::vector<cv::Mat>& vGTArray = pLoader->getGTArray(nIdx,getGTReaderIdx());
                 const std::vector<cv::Mat>& vGTROIArray = pLoader->getGTROIArray(nIdx);
                 lvAssert_(vClassif.size()==vGTArray.size() && (vGTROIArray.empty() || vClassif.size()==vGTROIArray.size()),"gt/output array size mistmatch");
                 for(size_t s=0; s<vClassif.size(); ++s)
@@ -164,6 +181,21 @@ namespace lv {
         BinClassifMetricsArrayAccumulatorPtr m_pMetricsBase;
     };
 
+    /// basic 2D binary classifier evaluator with the same overlapped behavior as the GLSL one, but counting (via SIMD kernels) on a cpu worker thread
+    struct CPUBinaryClassifierEvaluator {
+        /// starts the counting worker thread, which may lag behind by up to 'nMaxQueuedPackets' packets
+        CPUBinaryClassifierEvaluator(size_t nMaxQueuedPackets=DATASETUTILS_CPU_ASYNC_EVAL_MAX_QUEUED);
+        /// queues an output/gt/roi triplet for counting and returns immediately, unless the queue is full (the output is copied, but the gt and roi are shared, and must not be modified afterwards)
+        void apply(const cv::Mat& oOutput, const cv::Mat& oGT, const cv::Mat& oROI=cv::Mat());
+        /// waits for all queued packets to be counted, and returns a copy of the accumulated counters
+        BinClassifMetricsAccumulatorPtr getMetricsBase();
+        /// waits for all queued packets to be counted, and resets the accumulated counters
+        void resetMetrics();
+    private:
+        BinClassifMetricsAccumulatorPtr m_pMetricsBase;
+        DataConsumerQueue m_oCountingQueue;
+    };
+
 #if HAVE_GLSL
 
     /// basic 2D binary classifier evaluator algo interface
@@ -182,8 +214,15 @@ namespace lv {
         virtual void resetMetrics() override {
             IAsyncDataConsumer_<DatasetEval_BinaryClassifier,lv::GLSL>::resetMetrics();
             // ... @@@@ reset glsl eval? need a 'setEvaluationAtomicCounterBuffer' function
+            if(m_pCPUEvalAlgo)
+                m_pCPUEvalAlgo->resetMetrics();
             m_pMetricsBase = IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifier,eDataset>>();
         }
+        /// toggles whether outputs should be evaluated by a cpu worker thread instead of a compute shader (for GPU-less evaluation nodes; must be set before 'initialize_gl')
+        void setCPUEvaluation(bool bEnabled) {
+            lvAssert_(!m_pEvalAlgo && !m_pCPUEvalAlgo,"evaluation algo type must be selected before initialization");
+            m_bUsingCPUEvaluation = bEnabled;
+        }
     protected:
         /// overrides 'getMetricsBase' from IIMetricRetriever for non-group-impl (as always required)
         virtual IIMetricsAccumulatorConstPtr getMetricsBase() const override final {
@@ -193,18 +232,34 @@ namespace lv {
         }
         /// overrides '_stopProcessing' from IDataHandler to make sure accumulated metrics are fetched from gpu once processing is done
         virtual void stopProcessing_impl() override {
-            if(m_pEvalAlgo && m_pEvalAlgo->getIsGLInitialized()) {
+            if(m_pCPUEvalAlgo) {
+                m_pMetricsBase = m_pCPUEvalAlgo->getMetricsBase();
+                invalidateMetrics();
+            }
+            else if(m_pEvalAlgo && m_pEvalAlgo->getIsGLInitialized()) {
                 auto pEvalAlgo = std::dynamic_pointer_cast<GLBinaryClassifierEvaluator>(m_pEvalAlgo);
                 lvAssert_(pEvalAlgo,"evaluation algo did not have a GLBinaryClassifierEvaluator interface");
                 BinClassifMetricsAccumulatorPtr pMetricsBase = pEvalAlgo->getMetricsBase();
                 lvAssert_(!DATASETUTILS_VALIDATE_ASYNC_EVALUATORS || !m_pMetricsBase || m_pMetricsBase->isEqual(pMetricsBase),"gpu evaluation algo did not return same results as cpu evaluation");
                 m_pMetricsBase = pMetricsBase;
+                invalidateMetrics();
             }
+            updateLiveSnapshot(true);
         }
         /// overrides 'post_initialize_gl' from IAsyncDataConsumer_ to initialize an evaluation algo interface
         virtual void post_initialize_gl() override {
             IAsyncDataConsumer_<DatasetEval_BinaryClassifier,lv::GLSL>::post_initialize_gl();
-            if(isEvaluating()) {
+            if(isEvaluating() && m_bUsingCPUEvaluation) {
+                // outputs are fetched after each 'apply_gl' call, and counted on the worker thread while the next packet is processed
+                m_pCPUEvalAlgo = std::make_unique<CPUBinaryClassifierEvaluator>();
+                m_pMetricsBase = IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifier,eDataset>>();
+                m_lDataCallback = [this](const cv::Mat&, const cv::Mat&, const cv::Mat& oOutput, const cv::Mat& oGT, const cv::Mat& oGTROI, size_t) {
+                    lvAssert_(!oOutput.empty() && !oGT.empty(),"provided output and gt mats need to be non-empty");
+                    m_pCPUEvalAlgo->apply(oOutput,oGT,oGTROI);
+                };
+                m_pAlgo->setOutputFetching(true);
+            }
+            else if(isEvaluating()) {
                 lvAssert_(m_pLoader->getExpectedOutputCount()>0,"need predetermined limit on eval count");
                 m_pEvalAlgo = std::make_shared<GLBinaryClassifierEvaluator>(m_pAlgo,m_pLoader->getExpectedOutputCount());
                 m_pEvalAlgo->initialize_gl(m_oCurrGT,m_pLoader->getGTROI(m_nCurrIdx));
@@ -227,8 +282,10 @@ namespace lv {
             m_pMetricsBase->m_oCounters.accumulate(oOutput,oGT,oGTROI);
         }
         /// default constructor; automatically creates an instance of the base metrics accumulator object
-        inline DataEvaluatorWrapper_() : m_pMetricsBase(IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifier,eDataset>>()) {}
+        inline DataEvaluatorWrapper_() : m_pMetricsBase(IIMetricsAccumulator::create<MetricsAccumulator_<DatasetEval_BinaryClassifier,eDataset>>()),m_bUsingCPUEvaluation(false) {}
         BinClassifMetricsAccumulatorPtr m_pMetricsBase;
+        std::unique_ptr<CPUBinaryClassifierEvaluator> m_pCPUEvalAlgo;
+        bool m_bUsingCPUEvaluation;
     };
 
 #endif //HAVE_GLSL
@@ -247,4 +304,33 @@ namespace lv {
     template<DatasetEvalList eDatasetEval, DatasetList eDataset>
     struct DatasetReporter_ : public DatasetReporterWrapper_<eDatasetEval,eDataset> {};
 
+    /// background reporter writing machine-readable live metrics (packet counts, fps, latency percentiles, Rcl/Prc/FM) for all work batches of a dataset while they are processed
+    struct DataLiveReporter {
+        /// attaches to the work batches of 'pDataset' and starts reporting every 'nPeriodMS' milliseconds; records are written as csv rows if the file extension is '.csv', and as json lines otherwise
+        DataLiveReporter(const IDataHandlerPtr& pDataset, const std::string& sOutputFilePath, size_t nPeriodMS=1000);
+        /// writes the last pending records, detaches from the work batches, and joins the reporting thread
+        ~DataLiveReporter();
+    private:
+        /// per-batch reporting state (keeps the previous snapshot and latency histogram to compute windowed throughput and percentiles)
+        struct BatchState {
+            IDataHandlerPtr pBatch;
+            IDataCounter* pCounter;
+            std::string sName;
+            size_t nLastOutputCount;
+            double dLastProcessTime;
+            LatencyHistogram oLastLatencies;
+        };
+        void entry();
+        void writeRecords();
+        const bool m_bUseCSV;
+        const size_t m_nPeriodMS;
+        std::vector<BatchState> m_vBatchStates;
+        std::ofstream m_oOutput;
+        lv::StopWatch m_oStopWatch;
+        std::mutex m_oSyncMutex;
+        std::condition_variable m_oStopCondVar;
+        bool m_bIsActive;
+        std::thread m_hWorker;
+    };
+
 } // namespace lv
@@ -86,11 +86,11 @@ namespace lv {
         virtual void parseData() override final {
             lvDbgExceptionWatch;
             // 'this' is required below since name lookup is done during instantiation because of not-fully-specialized class template
-            lv::GetFilesFromDir(this->getDataPath(),this->m_vsInputPaths);
+            this->getIndexCache().getFilesFromDir(this->getDataPath(),this->m_vsInputPaths);
             lv::FilterFilePaths(this->m_vsInputPaths,{},{".jpg",".png",".bmp"});
             if(this->m_vsInputPaths.empty())
                 lvError_("BSDS500 set '%s' did not possess any jpg/png/bmp image file",this->getName().c_str());
-            lv::GetSubDirsFromDir(this->getRoot()->getDataPath()+"../groundTruth_bdry_images/"+this->getRelativePath(),this->m_vsGTPaths);
+            this->getIndexCache().getSubDirsFromDir(this->getRoot()->getDataPath()+"../groundTruth_bdry_images/"+this->getRelativePath(),this->m_vsGTPaths);
             if(this->m_vsGTPaths.empty())
                 lvError_("BSDS500 set '%s' did not possess any groundtruth image folders",this->getName().c_str());
             else if(this->m_vsGTPaths.size()!=this->m_vsInputPaths.size())
@@ -100,9 +100,11 @@ namespace lv {
                 this->m_mGTIndexLUT[n] = n;
             // make sure folders are non-empty, and folders & images are similarliy ordered
             std::vector<std::string> vsTempPaths;
+            std::vector<size_t> vnGTCounts(this->m_vsGTPaths.size());
             for(size_t nImageIdx=0; nImageIdx<this->m_vsGTPaths.size(); ++nImageIdx) {
-                lv::GetFilesFromDir(this->m_vsGTPaths[nImageIdx],vsTempPaths);
+                this->getIndexCache().getFilesFromDir(this->m_vsGTPaths[nImageIdx],vsTempPaths);
                 lvAssert(!vsTempPaths.empty());
+                vnGTCounts[nImageIdx] = vsTempPaths.size();
                 const size_t nLastInputSlashPos = this->m_vsInputPaths[nImageIdx].find_last_of("/\\");
                 const std::string sInputFullName = nLastInputSlashPos==std::string::npos?this->m_vsInputPaths[nImageIdx]:this->m_vsInputPaths[nImageIdx].substr(nLastInputSlashPos+1);
                 const size_t nLastGTSlashPos = this->m_vsGTPaths[nImageIdx].find_last_of("/\\");
@@ -115,13 +117,13 @@ namespace lv {
             this->m_vGTSizes.clear();
             this->m_vGTSizes.reserve(this->m_vsGTPaths.size());
             const double dScale = this->getScaleFactor();
+            // input sizes come from the dataset index when valid; otherwise, all images are read in parallel
+            const std::vector<cv::Size> voInputSizes = this->getIndexCache().getImageSizes(this->m_vsInputPaths,this->isGrayscale()?cv::IMREAD_GRAYSCALE:cv::IMREAD_COLOR);
             for(size_t nImageIdx=0; nImageIdx<this->m_vsInputPaths.size(); ++nImageIdx) {
-                const cv::Mat oCurrInput = cv::imread(this->m_vsInputPaths[nImageIdx],this->isGrayscale()?cv::IMREAD_GRAYSCALE:cv::IMREAD_COLOR);
-                lvAssert(!oCurrInput.empty() && (oCurrInput.size()==cv::Size(321,481) || oCurrInput.size()==cv::Size(481,321)));
-                lv::GetFilesFromDir(this->m_vsGTPaths[nImageIdx],vsTempPaths);
-                lvAssert(!vsTempPaths.empty());
-                this->m_vInputSizes.push_back(cv::Size(int(oCurrInput.cols*dScale),int(oCurrInput.rows*dScale)));
-                this->m_vGTSizes.push_back(cv::Size(int(oCurrInput.cols*dScale),int(oCurrInput.rows*vsTempPaths.size()*dScale)));
+                const cv::Size& oCurrInputSize = voInputSizes[nImageIdx];
+                lvAssert(oCurrInputSize==cv::Size(321,481) || oCurrInputSize==cv::Size(481,321));
+                this->m_vInputSizes.push_back(cv::Size(int(oCurrInputSize.width*dScale),int(oCurrInputSize.height*dScale)));
+                this->m_vGTSizes.push_back(cv::Size(int(oCurrInputSize.width*dScale),int(oCurrInputSize.height*vnGTCounts[nImageIdx]*dScale)));
                 this->m_oInputMaxSize.width = std::max(this->m_oInputMaxSize.width,this->m_vInputSizes[nImageIdx].width);
                 this->m_oInputMaxSize.height = std::max(this->m_oInputMaxSize.height,this->m_vInputSizes[nImageIdx].height);
                 this->m_oGTMaxSize.width = std::max(this->m_oGTMaxSize.width,this->m_vGTSizes[nImageIdx].width);
@@ -134,10 +136,10 @@ namespace lv {
             lvDbgExceptionWatch;
             // 'this' is always required here since function name lookup is done during instantiation because of not-fully-specialized class template
             if(this->m_mGTIndexLUT.count(nIdx)) {
-                const size_t nGTIdx = this->m_mGTIndexLUT[nIdx];
+                const size_t nGTIdx = this->m_mGTIndexLUT.at(nIdx);
                 if(nGTIdx<this->m_vsGTPaths.size()) {
                     std::vector<std::string> vsTempPaths;
-                    lv::GetFilesFromDir(this->m_vsGTPaths[nIdx],vsTempPaths);
+                    this->getIndexCache().getFilesFromDir(this->m_vsGTPaths[nIdx],vsTempPaths);
                     lvAssert(!vsTempPaths.empty());
                     cv::Mat oTempRefGTImage = cv::imread(vsTempPaths[0],cv::IMREAD_GRAYSCALE);
                     lvAssert(!oTempRefGTImage.empty() && (oTempRefGTImage.size()==cv::Size(481,321) || oTempRefGTImage.size()==cv::Size(321,481)));
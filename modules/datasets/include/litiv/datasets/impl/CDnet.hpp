@@ -77,24 +77,24 @@ namespace lv {
             lvDbgExceptionWatch;
             // 'this' is required below since name lookup is done during instantiation because of not-fully-specialized class template
             std::vector<std::string> vsSubDirs;
-            lv::GetSubDirsFromDir(this->getDataPath(),vsSubDirs);
+            this->getIndexCache().getSubDirsFromDir(this->getDataPath(),vsSubDirs);
             auto gtDir = std::find(vsSubDirs.begin(),vsSubDirs.end(),this->getDataPath()+"groundtruth");
             auto inputDir = std::find(vsSubDirs.begin(),vsSubDirs.end(),this->getDataPath()+"input");
             if(gtDir==vsSubDirs.end() || inputDir==vsSubDirs.end())
                 lvError_("CDnet sequence '%s' did not possess the required groundtruth and input directories",this->getName().c_str());
-            lv::GetFilesFromDir(*inputDir,this->m_vsInputPaths);
-            lv::GetFilesFromDir(*gtDir,this->m_vsGTPaths);
+            this->getIndexCache().getFilesFromDir(*inputDir,this->m_vsInputPaths);
+            this->getIndexCache().getFilesFromDir(*gtDir,this->m_vsGTPaths);
             this->m_nFrameCount = this->m_vsInputPaths.size();
             lvAssert_(this->m_nFrameCount>0,"could not find any input frames");
             if(this->m_vsGTPaths.size()!=this->m_vsInputPaths.size())
                 lvError_("CDnet sequence '%s' did not possess same amount of GT & input frames",this->getName().c_str());
-            cv::Mat oROI = cv::imread(this->getDataPath()+"ROI.bmp",cv::IMREAD_GRAYSCALE);
-            cv::Mat oTempROI = cv::imread(this->getDataPath()+"ROI.jpg");
-            if(oROI.empty() || oTempROI.empty())
+            cv::Mat oROI = this->getIndexCache().readMask(this->getDataPath()+"ROI.bmp");
+            const cv::Size oTempROISize = this->getIndexCache().getImageSize(this->getDataPath()+"ROI.jpg");
+            if(oROI.empty() || oTempROISize.area()==0)
                 lvError_("CDnet sequence '%s' did not possess ROI.bmp/ROI.jpg files",this->getName().c_str());
-            if(oROI.size()!=oTempROI.size()) {
+            if(oROI.size()!=oTempROISize) {
                 std::cerr << "CDnet sequence '" << this->getName().c_str() << "' ROI images size mismatch; will keep smallest overlap." << std::endl;
-                oROI = oROI(cv::Rect(0,0,std::min(oROI.cols,oTempROI.cols),std::min(oROI.rows,oTempROI.rows))).clone();
+                oROI = oROI(cv::Rect(0,0,std::min(oROI.cols,oTempROISize.width),std::min(oROI.rows,oTempROISize.height))).clone();
             }
             this->m_oInputROI = oROI>0;
             const double dScale = this->getScaleFactor();
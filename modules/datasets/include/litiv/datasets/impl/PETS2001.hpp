@@ -66,17 +66,17 @@ namespace lv {
             // 'this' is required below since name lookup is done during instantiation because of not-fully-specialized class template
             // @@@@ untested since 2016/01 refactoring
             std::vector<std::string> vsVideoSeqPaths;
-            lv::GetFilesFromDir(this->getDataPath(),vsVideoSeqPaths);
+            this->getIndexCache().getFilesFromDir(this->getDataPath(),vsVideoSeqPaths);
             if(vsVideoSeqPaths.size()!=1)
                 lvError_("PETS2006D3TC1 sequence '%s': bad subdirectory for parsing (should contain only one video sequence file)",this->getName().c_str());
             std::vector<std::string> vsGTSubdirPaths;
-            lv::GetSubDirsFromDir(this->getDataPath(),vsGTSubdirPaths);
+            this->getIndexCache().getSubDirsFromDir(this->getDataPath(),vsGTSubdirPaths);
             if(vsGTSubdirPaths.size()!=1)
                 lvError_("PETS2006D3TC1 sequence '%s': bad subdirectory for parsing (should contain only one GT subdir)",this->getName().c_str());
             this->m_voVideoReader.open(vsVideoSeqPaths[0]);
             if(!this->m_voVideoReader.isOpened())
                 lvError_("PETS2006D3TC1 sequence '%s': video file could not be opened",this->getName().c_str());
-            lv::GetFilesFromDir(vsGTSubdirPaths[0],this->m_vsGTPaths);
+            this->getIndexCache().getFilesFromDir(vsGTSubdirPaths[0],this->m_vsGTPaths);
             if(this->m_vsGTPaths.empty())
                 lvError_("PETS2006D3TC1 sequence '%s': did not possess any valid GT frames",this->getName().c_str());
             const std::string sGTFilePrefix("image_");
@@ -84,10 +84,10 @@ namespace lv {
             this->m_mGTIndexLUT.clear();
             for(auto iter=this->m_vsGTPaths.begin(); iter!=this->m_vsGTPaths.end(); ++iter)
                 this->m_mGTIndexLUT[(size_t)atoi(iter->substr(iter->find(sGTFilePrefix)+sGTFilePrefix.size(),nInputFileNbDecimals).c_str())] = iter-this->m_vsGTPaths.begin();
-            cv::Mat oTempImg = cv::imread(this->m_vsGTPaths[0]);
-            if(oTempImg.empty())
+            const cv::Size oGTSize = this->getIndexCache().getImageSize(this->m_vsGTPaths[0]);
+            if(oGTSize.area()==0)
                 lvError_("PETS2006D3TC1 sequence '%s': did not possess valid GT file(s)",this->getName().c_str());
-            this->m_oInputROI = cv::Mat(oTempImg.size(),CV_8UC1,cv::Scalar_<uchar>(255));
+            this->m_oInputROI = cv::Mat(oGTSize,CV_8UC1,cv::Scalar_<uchar>(255));
             const double dScale = this->getScaleFactor();
             if(dScale!=1.0)
                 cv::resize(this->m_oInputROI,this->m_oInputROI,cv::Size(),dScale,dScale,cv::INTER_NEAREST);
@@ -66,7 +66,7 @@ namespace lv {
             // 'this' is required below since name lookup is done during instantiation because of not-fully-specialized class template
             // @@@@ untested since 2016/01 refactoring
             std::vector<std::string> vsImgPaths;
-            lv::GetFilesFromDir(this->getDataPath(),vsImgPaths);
+            this->getIndexCache().getFilesFromDir(this->getDataPath(),vsImgPaths);
             bool bFoundScript=false, bFoundGTFile=false;
             const std::string sGTFilePrefix("hand_segmented_");
             const size_t nInputFileNbDecimals = 5;
@@ -88,10 +88,10 @@ namespace lv {
             }
             if(!bFoundGTFile || !bFoundScript || this->m_vsInputPaths.empty() || this->m_vsGTPaths.size()!=1)
                 lvError_("Wallflower sequence '%s' did not possess the required groundtruth and input files",this->getName().c_str());
-            cv::Mat oTempImg = cv::imread(this->m_vsGTPaths[0]);
-            if(oTempImg.empty())
+            const cv::Size oGTSize = this->getIndexCache().getImageSize(this->m_vsGTPaths[0]);
+            if(oGTSize.area()==0)
                 lvError_("Wallflower sequence '%s' did not possess a valid GT file",this->getName().c_str());
-            this->m_oInputROI = cv::Mat(oTempImg.size(),CV_8UC1,cv::Scalar_<uchar>(255));
+            this->m_oInputROI = cv::Mat(oGTSize,CV_8UC1,cv::Scalar_<uchar>(255));
             const double dScale = this->getScaleFactor();
             if(dScale!=1.0)
                 cv::resize(this->m_oInputROI,this->m_oInputROI,cv::Size(),dScale,dScale,cv::INTER_NEAREST);
@@ -119,7 +119,7 @@ namespace lv {
             lvDbgExceptionWatch;
             // 'this' is required below since name lookup is done during instantiation because of not-fully-specialized class template
             std::vector<std::string> vsSubDirs;
-            lv::GetSubDirsFromDir(this->getDataPath(),vsSubDirs);
+            this->getIndexCache().getSubDirsFromDir(this->getDataPath(),vsSubDirs);
             auto psDepthGTDir = std::find(vsSubDirs.begin(),vsSubDirs.end(),this->getDataPath()+"depthMasks");
             auto psDepthDir = std::find(vsSubDirs.begin(),vsSubDirs.end(),this->getDataPath()+"SyncD");
             auto psRGBGTDir = std::find(vsSubDirs.begin(),vsSubDirs.end(),this->getDataPath()+"rgbMasks");
@@ -168,8 +168,8 @@ namespace lv {
             //    stream[2] = depth   (default:?) --- if enabled only
             //
             std::vector<std::string> vsRGBPaths;
-            lv::GetFilesFromDir(*psRGBDir,vsRGBPaths);
-            if(vsRGBPaths.empty() || cv::imread(vsRGBPaths[0]).size()!=oImageSize)
+            this->getIndexCache().getFilesFromDir(*psRGBDir,vsRGBPaths);
+            if(vsRGBPaths.empty() || this->getIndexCache().getImageSize(vsRGBPaths[0])!=oImageSize)
                 lvError_("VAPtrimod2016 sequence '%s' did not possess expected RGB data",this->getName().c_str());
             this->m_vvsInputPaths.resize(vsRGBPaths.size());
             std::vector<std::string> vsTempInputFileNames(vsRGBPaths.size());
@@ -181,7 +181,7 @@ namespace lv {
                 const size_t nLastInputDotPos = sInputFileNameExt.find_last_of('.');
                 vsTempInputFileNames[nInputPacketIdx] = nLastInputDotPos==std::string::npos?sInputFileNameExt:sInputFileNameExt.substr(0,nLastInputDotPos);
             }
-            cv::Mat oRGBROI = cv::imread(this->getDataPath()+"rgb_roi.png",cv::IMREAD_GRAYSCALE);
+            cv::Mat oRGBROI = this->getIndexCache().readMask(this->getDataPath()+"rgb_roi.png");
             if(!oRGBROI.empty()) {
                 lvAssert(oRGBROI.type()==CV_8UC1 && oRGBROI.size()==oImageSize);
                 oRGBROI = oRGBROI>0;
@@ -195,8 +195,8 @@ namespace lv {
             this->m_vInputROIs[0] = oRGBROI.clone();
             this->m_vGTROIs[0] = oRGBROI.clone();
             std::vector<std::string> vsRGBGTPaths;
-            lv::GetFilesFromDir(*psRGBGTDir,vsRGBGTPaths);
-            if(vsRGBGTPaths.empty() || cv::imread(vsRGBGTPaths[0]).size()!=oImageSize)
+            this->getIndexCache().getFilesFromDir(*psRGBGTDir,vsRGBGTPaths);
+            if(vsRGBGTPaths.empty() || this->getIndexCache().getImageSize(vsRGBGTPaths[0])!=oImageSize)
                 lvError_("VAPtrimod2016 sequence '%s' did not possess expected RGB gt data",this->getName().c_str());
             this->m_vvsGTPaths.resize(vsRGBGTPaths.size());
             this->m_mGTIndexLUT.clear();
@@ -216,14 +216,14 @@ namespace lv {
                 this->m_mGTIndexLUT[nInputPacketIdx] = nGTPacketIdx; // direct gt path index to frame index mapping
             }
             std::vector<std::string> vsThermalPaths;
-            lv::GetFilesFromDir(*psThermalDir,vsThermalPaths);
-            if(vsThermalPaths.empty() || cv::imread(vsThermalPaths[0]).size()!=oImageSize)
+            this->getIndexCache().getFilesFromDir(*psThermalDir,vsThermalPaths);
+            if(vsThermalPaths.empty() || this->getIndexCache().getImageSize(vsThermalPaths[0])!=oImageSize)
                 lvError_("VAPtrimod2016 sequence '%s' did not possess expected thermal data",this->getName().c_str());
             if(vsThermalPaths.size()!=vsRGBPaths.size())
                 lvError_("VAPtrimod2016 sequence '%s' did not possess same amount of RGB/thermal frames",this->getName().c_str());
             for(size_t nInputPacketIdx=0; nInputPacketIdx<vsThermalPaths.size(); ++nInputPacketIdx)
                 this->m_vvsInputPaths[nInputPacketIdx][1] = vsThermalPaths[nInputPacketIdx];
-            cv::Mat oThermalROI = cv::imread(this->getDataPath()+"thermal_roi.png",cv::IMREAD_GRAYSCALE);
+            cv::Mat oThermalROI = this->getIndexCache().readMask(this->getDataPath()+"thermal_roi.png");
             if(!oThermalROI.empty()) {
                 lvAssert(oThermalROI.type()==CV_8UC1 && oThermalROI.size()==oImageSize);
                 oThermalROI = oThermalROI>0;
@@ -237,8 +237,8 @@ namespace lv {
             this->m_vInputROIs[1] = oThermalROI.clone();
             this->m_vGTROIs[1] = oThermalROI.clone();
             std::vector<std::string> vsThermalGTPaths;
-            lv::GetFilesFromDir(*psThermalGTDir,vsThermalGTPaths);
-            if(vsThermalGTPaths.empty() || cv::imread(vsThermalGTPaths[0]).size()!=oImageSize)
+            this->getIndexCache().getFilesFromDir(*psThermalGTDir,vsThermalGTPaths);
+            if(vsThermalGTPaths.empty() || this->getIndexCache().getImageSize(vsThermalGTPaths[0])!=oImageSize)
                 lvError_("VAPtrimod2016 sequence '%s' did not possess expected thermal gt data",this->getName().c_str());
             if(vsThermalGTPaths.size()!=vsRGBGTPaths.size())
                 lvError_("VAPtrimod2016 sequence '%s' did not possess same amount of RGB/thermal gt frames",this->getName().c_str());
@@ -246,14 +246,14 @@ namespace lv {
                 this->m_vvsGTPaths[nGTPacketIdx][1] = vsThermalGTPaths[nGTPacketIdx];
             if(this->m_bLoadDepth) {
                 std::vector<std::string> vsDepthPaths;
-                lv::GetFilesFromDir(*psDepthDir,vsDepthPaths);
-                if(vsDepthPaths.empty() || cv::imread(vsDepthPaths[0]).size()!=oImageSize)
+                this->getIndexCache().getFilesFromDir(*psDepthDir,vsDepthPaths);
+                if(vsDepthPaths.empty() || this->getIndexCache().getImageSize(vsDepthPaths[0])!=oImageSize)
                     lvError_("VAPtrimod2016 sequence '%s' did not possess expected depth data",this->getName().c_str());
                 if(vsDepthPaths.size()!=vsRGBPaths.size())
                     lvError_("VAPtrimod2016 sequence '%s' did not possess same amount of RGB/depth frames",this->getName().c_str());
                 for(size_t nInputPacketIdx=0; nInputPacketIdx<vsDepthPaths.size(); ++nInputPacketIdx)
                     this->m_vvsInputPaths[nInputPacketIdx][2] = vsDepthPaths[nInputPacketIdx];
-                cv::Mat oDepthROI = cv::imread(this->getDataPath()+"depth_roi.png",cv::IMREAD_GRAYSCALE);
+                cv::Mat oDepthROI = this->getIndexCache().readMask(this->getDataPath()+"depth_roi.png");
                 if(!oDepthROI.empty()) {
                     lvAssert(oDepthROI.type()==CV_8UC1 && oDepthROI.size()==oImageSize);
                     oDepthROI = oDepthROI>0;
@@ -265,8 +265,8 @@ namespace lv {
                 this->m_vInputROIs[2] = oDepthROI.clone();
                 this->m_vGTROIs[2] = oDepthROI.clone();
                 std::vector<std::string> vsDepthGTPaths;
-                lv::GetFilesFromDir(*psDepthGTDir,vsDepthGTPaths);
-                if(vsDepthGTPaths.empty() || cv::imread(vsDepthGTPaths[0]).size()!=oImageSize)
+                this->getIndexCache().getFilesFromDir(*psDepthGTDir,vsDepthGTPaths);
+                if(vsDepthGTPaths.empty() || this->getIndexCache().getImageSize(vsDepthGTPaths[0])!=oImageSize)
                     lvError_("VAPtrimod2016 sequence '%s' did not possess expected depth gt data",this->getName().c_str());
                 if(vsDepthGTPaths.size()!=vsRGBGTPaths.size())
                     lvError_("VAPtrimod2016 sequence '%s' did not possess same amount of RGB/depth gt frames",this->getName().c_str());
@@ -339,7 +339,7 @@ namespace lv {
         }
         virtual cv::Mat getRawGT(size_t nPacketIdx) override final {
             if(this->m_mGTIndexLUT.count(nPacketIdx)) {
-                const size_t nGTIdx = this->m_mGTIndexLUT[nPacketIdx];
+                const size_t nGTIdx = this->m_mGTIndexLUT.at(nPacketIdx);
                 lvDbgAssert(nGTIdx<this->m_vvsGTPaths.size());
                 const std::vector<std::string>& vsGTPaths = this->m_vvsGTPaths[nGTIdx];
                 lvDbgAssert(!vsGTPaths.empty() && vsGTPaths.size()==getGTStreamCount() && vsGTPaths.size()==(this->m_bLoadDepth?3:2));
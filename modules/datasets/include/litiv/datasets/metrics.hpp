@@ -60,6 +60,10 @@ namespace lv {
         }
         /// accumulates the pixel-level classification counts of 'oClassif' vs 'oGT' into the internal counts
         void accumulate(const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI=cv::Mat());
+        /// accumulates the pixel-level classification counts of several outputs (e.g. from a parameter sweep) vs a shared 'oGT' in a single pass, with one counters object per output (resized if empty); batches expose it through 'evaluateCandidates'
+        static void accumulate(const std::vector<cv::Mat>& vClassifs, const cv::Mat& oGT, const cv::Mat& oROI, std::vector<BinClassif>& vCounters);
+        /// accumulates the pixel-level classification counts of an array of outputs vs a shared 'oGT' in a single pass, with one counters object per output
+        static void accumulate(const cv::Mat* aClassifs, size_t nClassifs, const cv::Mat& oGT, const cv::Mat& oROI, BinClassif* aCounters);
         /// returns a colored classification mask for visualization based on good/bad classifcations of 'oClassif' vs 'oGT'
         static cv::Mat getColoredMask(const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI=cv::Mat());
         /// default constructor; sets all counters to zero
@@ -300,34 +304,78 @@ namespace lv {
         virtual IIMetricsAccumulatorConstPtr getMetricsBase() const = 0;
         /// accumulates and returns high-level evaluation metrics, e.g. computes F-Measure from classification counters
         virtual IIMetricsCalculatorPtr getMetrics(bool bAverage) const = 0;
+    protected:
+        /// calls 'lFunc' for all children batch indices, in parallel for the outermost call only (nested calls from the workers run serially)
+        static void parallelForBatches(size_t nBatches, const std::function<void(size_t)>& lFunc);
     };
 
     /// metric retriever interface specialization; exposes utility functions to recursively parse metrics through all work batches
     template<DatasetEvalList eDatasetEval, DatasetList eDataset>
     struct MetricRetriever_ : protected virtual IIMetricRetriever {
-        /// accumulates and returns a sum of all base evaluation metrics for children batches, e.g. sums all classification counters (provides group-impl only)
+        /// accumulates and returns a sum of all base evaluation metrics for children batches, e.g. sums all classification counters (provides group-impl only; cached until children metrics change)
         virtual IIMetricsAccumulatorConstPtr getMetricsBase() const override {
             lvAssert_(this->isGroup(),"non-group data reporter specialization attempt to call non-overridden method");
+            const size_t nRevision = this->getMetricsRevision();
+            {
+                std::mutex_lock_guard sync_lock(m_oMetricsCacheMutex);
+                if(m_pCachedMetricsBase && m_nCachedMetricsBaseRevision==nRevision)
+                    return m_pCachedMetricsBase;
+            }
+            const IDataHandlerPtrArray vpBatches = this->getBatches(true);
+            std::vector<IIMetricsAccumulatorConstPtr> vpBatchMetricsBases(vpBatches.size());
+            parallelForBatches(vpBatches.size(),[&](size_t nBatchIdx) {
+                vpBatchMetricsBases[nBatchIdx] = dynamic_cast<const IIMetricRetriever&>(*vpBatches[nBatchIdx]).getMetricsBase();
+            });
+            // children are reduced in their original order, as some accumulators keep per-packet results
             IIMetricsAccumulatorPtr pMetricsBase = IIMetricsAccumulator::create<MetricsAccumulator_<eDatasetEval,eDataset>>();
-            for(const auto& pBatch : this->getBatches(true))
-                pMetricsBase->accumulate(dynamic_cast<const IIMetricRetriever&>(*pBatch).getMetricsBase());
+            for(const auto& pBatchMetricsBase : vpBatchMetricsBases)
+                pMetricsBase->accumulate(pBatchMetricsBase);
+            std::mutex_lock_guard sync_lock(m_oMetricsCacheMutex);
+            m_pCachedMetricsBase = pMetricsBase;
+            m_nCachedMetricsBaseRevision = nRevision;
             return pMetricsBase;
         }
-        /// accumulates and returns high-level evaluation metrics, e.g. computes F-Measure from classification counters
+        /// accumulates and returns high-level evaluation metrics, e.g. computes F-Measure from classification counters (cached until metrics change; always returns a new copy)
         virtual IIMetricsCalculatorPtr getMetrics(bool bAverage) const override final {
+            const size_t nRevision = this->getMetricsRevision();
+            {
+                std::mutex_lock_guard sync_lock(m_oMetricsCacheMutex);
+                if(m_apCachedMetrics[bAverage] && m_anCachedMetricsRevisions[bAverage]==nRevision)
+                    return copyMetrics(*m_apCachedMetrics[bAverage]);
+            }
+            IIMetricsCalculatorPtr pMetrics;
             if(bAverage && this->isGroup() && !this->isBare()) {
                 IDataHandlerPtrArray vpBatches = this->getBatches(true);
-                auto ppBatchIter = vpBatches.begin();
-                for(; ppBatchIter!=vpBatches.end() && (*ppBatchIter)->getCurrentOutputCount()==0; ++ppBatchIter);
-                lvAssert_(ppBatchIter!=vpBatches.end(),"found no processed output packets");
-                IIMetricsCalculatorPtr pMetrics = dynamic_cast<const IIMetricRetriever&>(**ppBatchIter).getMetrics(bAverage);
-                for(; ppBatchIter!=vpBatches.end(); ++ppBatchIter)
-                    if((*ppBatchIter)->getCurrentOutputCount()>0)
-                        pMetrics->accumulate(dynamic_cast<const IIMetricRetriever&>(**ppBatchIter).getMetrics(bAverage));
-                return pMetrics;
+                vpBatches.erase(std::remove_if(vpBatches.begin(),vpBatches.end(),[](const IDataHandlerPtr& pBatch){return pBatch->getCurrentOutputCount()==0;}),vpBatches.end());
+                lvAssert_(!vpBatches.empty(),"found no processed output packets");
+                std::vector<IIMetricsCalculatorPtr> vpBatchMetrics(vpBatches.size());
+                parallelForBatches(vpBatches.size(),[&](size_t nBatchIdx) {
+                    vpBatchMetrics[nBatchIdx] = dynamic_cast<const IIMetricRetriever&>(*vpBatches[nBatchIdx]).getMetrics(bAverage);
+                });
+                pMetrics = vpBatchMetrics[0];
+                for(size_t nBatchIdx=1; nBatchIdx<vpBatchMetrics.size(); ++nBatchIdx)
+                    pMetrics->accumulate(vpBatchMetrics[nBatchIdx]);
             }
-            return IIMetricsCalculator::create<MetricsCalculator_<eDatasetEval,eDataset>>(getMetricsBase());
+            else
+                pMetrics = IIMetricsCalculator::create<MetricsCalculator_<eDatasetEval,eDataset>>(getMetricsBase());
+            std::mutex_lock_guard sync_lock(m_oMetricsCacheMutex);
+            m_apCachedMetrics[bAverage] = pMetrics;
+            m_anCachedMetricsRevisions[bAverage] = nRevision;
+            return copyMetrics(*pMetrics);
+        }
+    protected:
+        /// default constructor (metrics caches start empty)
+        inline MetricRetriever_() : m_nCachedMetricsBaseRevision(0),m_anCachedMetricsRevisions{{0,0}} {}
+    private:
+        /// returns a new copy of a high-level metrics object, so that cached ones can never be altered by callers
+        static IIMetricsCalculatorPtr copyMetrics(const IIMetricsCalculator& oMetrics) {
+            return IIMetricsCalculator::create<MetricsCalculator_<eDatasetEval,eDataset>>(dynamic_cast<const MetricsCalculator_<eDatasetEval,eDataset>&>(oMetrics));
         }
+        mutable std::mutex m_oMetricsCacheMutex;
+        mutable IIMetricsAccumulatorConstPtr m_pCachedMetricsBase;
+        mutable size_t m_nCachedMetricsBaseRevision;
+        mutable std::array<IIMetricsCalculatorConstPtr,2> m_apCachedMetrics;
+        mutable std::array<size_t,2> m_anCachedMetricsRevisions;
     };
 
 
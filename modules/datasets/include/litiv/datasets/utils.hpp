@@ -24,6 +24,8 @@
 #include <opencv2/imgproc.hpp>
 #include <opencv2/imgcodecs.hpp>
 
+#define DATASETUTILS_ASYNC_EVAL_GT_READER_IDX 1 // data loader reader index used by async evaluation workers (reader 0 stays with the processing thread)
+
 namespace lv {
 
     enum DatasetTaskList { // from the task type, we can derive the source and eval types
@@ -181,6 +183,8 @@ namespace lv {
     }
 
     struct IDataHandler;
+    struct DataIndexCache;
+    struct IIMetricsCalculator;
     using IDataHandlerPtr = std::shared_ptr<IDataHandler>;
     using IDataHandlerPtrArray = std::vector<IDataHandlerPtr>;
     using IDataHandlerConstPtr = std::shared_ptr<const IDataHandler>;
@@ -188,6 +192,40 @@ namespace lv {
     using IDataHandlerPtrQueue = std::priority_queue<IDataHandlerPtr,IDataHandlerPtrArray,std::function<bool(const IDataHandlerPtr&,const IDataHandlerPtr&)>>;
     using AsyncDataCallbackFunc = std::function<void(const cv::Mat& /*oInput*/,const cv::Mat& /*oDebug*/,const cv::Mat& /*oOutput*/,const cv::Mat& /*oGT*/,const cv::Mat& /*oGTROI*/,size_t /*nIdx*/)>;
 
+    /// lock-free log-linear (hdr-style) histogram of packet latencies, with ~3% relative precision from 1us up to ~25 days
+    struct LatencyHistogram {
+        /// default constructor (empty histogram)
+        LatencyHistogram();
+        /// copy constructor (takes a snapshot of the counters of 'o')
+        LatencyHistogram(const LatencyHistogram& o);
+        /// copy assignment operator (takes a snapshot of the counters of 'o')
+        LatencyHistogram& operator=(const LatencyHistogram& o);
+        /// records a latency value, in seconds (safe to call concurrently with any other method)
+        void record(double dSeconds);
+        /// adds all values recorded in 'o' to this histogram
+        void merge(const LatencyHistogram& o);
+        /// removes the values of 'o' (an older copy of this histogram) so that only the values recorded since remain; the max becomes the upper bound of the highest remaining bucket
+        void subtract(const LatencyHistogram& o);
+        /// clears all recorded values
+        void reset();
+        /// returns the number of recorded values
+        inline size_t getCount() const {return (size_t)m_nTotalCount.load(std::memory_order_relaxed);}
+        /// returns the latency (in seconds) below which the given percentage [0,100] of values fall (bucket upper bound, i.e. never underestimated; 0 if empty)
+        double getPercentile(double dPercentile) const;
+        /// returns the highest recorded latency, in seconds (exact up to 1us; 0 if empty)
+        double getMax() const;
+    private:
+        static constexpr size_t s_nSubBucketBits = 5;
+        static constexpr size_t s_nSubBucketCount = size_t(1)<<s_nSubBucketBits;
+        static constexpr size_t s_nMaxShift = 35; ///< values are clamped to 2^(s_nMaxShift+s_nSubBucketBits+1)-1 microseconds
+        static constexpr size_t s_nBucketCount = (2+s_nMaxShift)*s_nSubBucketCount;
+        static size_t getBucketIdx(uint64_t nValue);
+        static uint64_t getBucketUpperValue(size_t nBucketIdx);
+        std::array<std::atomic<uint64_t>,s_nBucketCount> m_anBucketCounts;
+        std::atomic<uint64_t> m_nTotalCount;
+        std::atomic<uint64_t> m_nMaxValue;
+    };
+
     /// fully abstract data handler interface (work batch and work group implementations will derive from this)
     struct IDataHandler : lv::enable_shared_from_this<IDataHandler> {
         /// virtual destructor for adequate cleanup from IDataHandler pointers
@@ -230,10 +268,22 @@ namespace lv {
         virtual double getCurrentProcessTime() const = 0;
         /// returns the final time taken to process the work batch/group data, blocking if processing is not finished yet
         virtual double getFinalProcessTime() = 0;
+        /// adds the per-packet latencies recorded so far for the work batch/group to the given histogram
+        virtual void mergeLatencyHistogram(LatencyHistogram& oHist) const = 0;
+        /// returns a counter that increases whenever the evaluation metrics of the work batch/group may have changed (used to invalidate cached metrics)
+        virtual size_t getMetricsRevision() const = 0;
+        /// returns the per-packet latency histogram of the work batch/group (intervals between consecutive output packets)
+        inline LatencyHistogram getLatencyHistogram() const {
+            LatencyHistogram oHist;
+            mergeLatencyHistogram(oHist);
+            return oHist;
+        }
         /// returns the top-level data handler (typically a work batch group) for this dataset
         virtual IDataHandlerConstPtr getRoot() const = 0;
         /// returns the current data handler's parent (will be null if already top level)
         virtual IDataHandlerConstPtr getParent() const = 0;
+        /// returns the persistent directory/image index shared by all data handlers of this dataset (owned by the root)
+        virtual DataIndexCache& getIndexCache() const = 0;
         /// resets internal work batch/group evaluation and packet count metrics
         virtual void resetMetrics() = 0;
         /// returns whether this data handler interface points to the dataset's top level (root) interface or not
@@ -325,6 +375,8 @@ namespace lv {
         virtual IDataHandlerConstPtr getRoot() const override;
         /// returns the current data handler's parent (will be null if already top level)
         virtual IDataHandlerConstPtr getParent() const override;
+        /// returns the persistent directory/image index shared by all data handlers of this dataset (owned by the root)
+        virtual DataIndexCache& getIndexCache() const override final;
         /// returns whether this data handler interface points to the dataset's top level (root) interface or not (always false here)
         virtual bool isRoot() const override final;
         /// returns whether loaded data should be 4-byte aligned or not (4-byte alignment is ideal for GPU upload)
@@ -372,6 +424,10 @@ namespace lv {
         virtual double getCurrentProcessTime() const override final;
         /// accumulates and returns the final time taken to process all children work batches, blocking if processing is not finished yet
         virtual double getFinalProcessTime() override final;
+        /// merges the per-packet latency histograms of all children work batches into the given histogram
+        virtual void mergeLatencyHistogram(LatencyHistogram& oHist) const override final;
+        /// accumulates and returns the metrics revision counters of all children work batches
+        virtual size_t getMetricsRevision() const override final;
         /// resets all internal children work batch evaluation and packet count metrics
         virtual void resetMetrics() override final;
         /// returns whether *any* children work batch is currently processing data
@@ -391,6 +447,8 @@ namespace lv {
     protected:
         /// creates and returns a work batch for a given relative dataset path
         virtual IDataHandlerPtr createWorkBatch(const std::string& sBatchName, const std::string& sRelativePath) const = 0;
+        /// creates and parses work batches concurrently from (name, relative path) pairs; the output keeps the input order, and all parsing errors are reported together
+        IDataHandlerPtrArray createWorkBatches(const std::vector<std::pair<std::string,std::string>>& vsBatchNamesAndPaths) const;
         /// creates group/nongroup workbatches based on internal datset info and current relative path, and recursively calls parse data on all childrens
         virtual void parseData() override;
         /// protected default constructor; automatically sets 'isBare' to true
@@ -405,6 +463,42 @@ namespace lv {
     template<DatasetTaskList eDatasetTask, DatasetSourceList eDatasetSource, DatasetList eDataset>
     struct DataGroupHandler_ : public DataGroupHandler {};
 
+    /// dynamic work batch scheduler; batches are started longest-expected-duration-first on a fixed number of persistent workers, and durations are re-estimated from throughputs measured on finished batches
+    struct BatchScheduler {
+        /// batch processing callback; receives the batch, its initial thread budget, and a printable progress/worker name (budgets exceed one only when workers would otherwise be idle, and may grow as other batches finish; see 'lv::getThreadBudget')
+        using TaskFunc = std::function<void(const IDataHandlerPtr& /*pBatch*/, size_t /*nThreadBudget*/, const std::string& /*sWorkerName*/)>;
+        /// generic job processing callback; same as 'TaskFunc', but receives the index of a job instead of a batch
+        using JobFunc = std::function<void(size_t /*nJobIdx*/, size_t /*nThreadBudget*/, const std::string& /*sWorkerName*/)>;
+        /// initializes the scheduler and starts its workers (0 = use hardware concurrency)
+        BatchScheduler(size_t nWorkers=0);
+        /// stops and joins the scheduler's workers
+        ~BatchScheduler();
+        /// processes all given batches and blocks until they are done; the first exception thrown by a task stops dispatching, and is rethrown once running tasks return
+        void run(const IDataHandlerPtrArray& vpBatches, const TaskFunc& lTask);
+        /// processes jobs with the given expected loads and throughput keys the same way batches are processed above (keys group jobs that behave similarly)
+        void run(const std::vector<double>& vdLoads, const std::vector<std::string>& vsThroughputKeys, const JobFunc& lJob);
+        /// returns the expected duration of a batch (in seconds) based on throughputs measured so far, or its raw expected load if nothing was measured yet
+        double getExpectedDuration(const IDataHandler& oBatch) const;
+        /// returns the worker count used to process batches
+        inline size_t getWorkerCount() const {return m_nWorkers;}
+    private:
+        /// returns the expected duration of a job with a given throughput key and load (mutex must be held)
+        double getExpectedDuration(const std::string& sThroughputKey, double dLoad) const;
+        /// returns the key used to group throughput measurements (batches of the same parent are assumed to behave similarly)
+        static std::string getThroughputKey(const IDataHandler& oBatch);
+        /// runs queued jobs on a persistent worker until the scheduler is destroyed
+        void workerLoop();
+        const size_t m_nWorkers;
+        mutable std::mutex m_oMutex;
+        std::condition_variable m_oJobSync;
+        std::queue<std::function<void()>> m_qJobs;
+        bool m_bStopping;
+        std::map<std::string,std::pair<double,double>> m_mThroughputs; // throughput key (or empty for global) => accumulated load, accumulated time
+        std::vector<std::thread> m_vhWorkers;
+        BatchScheduler(const BatchScheduler&) = delete;
+        BatchScheduler& operator=(const BatchScheduler&) = delete;
+    };
+
     /// data handler specialized templace getters interface (shared by work batches, groups, and dataset interfaces)
     template<DatasetTaskList eDatasetTask, DatasetSourceList eDatasetSource, DatasetList eDataset, DatasetEvalList eDatasetEval>
     struct DataTemplSpec_ : public virtual IDataHandler {
@@ -420,34 +514,93 @@ namespace lv {
 
     /// general-purpose data packet precacher, fully implemented (i.e. can be used stand-alone)
     struct DataPrecacher {
-        /// attaches to data loader (will halt auto-precaching if an empty packet is fetched)
-        DataPrecacher(std::function<const cv::Mat&(size_t)> lDataLoaderCallback);
+        /// cache memory allocator given to in-place loaders; returns a packet header pointing into the cache, or an empty mat if it is full (loading should then be aborted)
+        using PacketAllocator = std::function<cv::Mat(const cv::Size& /*oSize*/,int /*nType*/)>;
+        /// attaches to data loader (will halt auto-precaching if an empty packet is fetched); the optional by-value loader must be reentrant, and enables multi-threaded decoding; the optional in-place loader decodes straight into the cache
+        DataPrecacher(std::function<const cv::Mat&(size_t)> lDataLoaderCallback, std::function<cv::Mat(size_t)> lReentrantLoaderCallback=nullptr, std::function<cv::Mat(size_t,const PacketAllocator&)> lInPlaceLoaderCallback=nullptr);
         /// default destructor (joins the precaching thread, if still running)
         ~DataPrecacher();
-        /// fetches a packet, with or without precaching enabled (should never be called concurrently, returned packets should never be altered directly, and a single packet loaded twice is assumed identical)
-        const cv::Mat& getPacket(size_t nIdx);
-        /// initializes precaching with a given buffer size (starts up thread)
-        bool startAsyncPrecaching(size_t nSuggestedBufferSize);
-        /// joins precaching thread and clears all internal buffers
+        /// fetches a packet for a given reader, with or without precaching enabled (readers may call concurrently, returned packets stay valid until the same reader's next call and should never be altered directly, and a single packet loaded twice is assumed identical)
+        const cv::Mat& getPacket(size_t nIdx, size_t nReaderIdx=0);
+        /// sets how many already-fetched packets stay in the ring for look-behind access, and the memory budget of the lru cache holding packets loaded outside the ring window (precaching must be stopped)
+        void setRandomAccessPolicy(size_t nLookBehind, size_t nLRUCacheSize);
+        /// initializes precaching with a given buffer size, decode thread count and lookahead packet count (starts up threads; lookahead defaults to twice the decode thread count)
+        bool startAsyncPrecaching(size_t nSuggestedBufferSize, size_t nDecodeThreads=1, size_t nLookahead=0);
+        /// joins precaching threads and clears all internal buffers
         void stopAsyncPrecaching();
         /// returns whether the precaching thread has already been started or not
         inline bool isActive() const {return m_bIsActive;}
     private:
         void entry(const size_t nBufferSize);
+        void decode();
+        void joinWorkers();
         const std::function<const cv::Mat&(size_t)> m_lCallback;
+        const std::function<cv::Mat(size_t)> m_lReentrantCallback;
+        const std::function<cv::Mat(size_t,const PacketAllocator&)> m_lInPlaceCallback;
         std::thread m_hWorker;
-        std::exception_ptr m_pWorkerException;
+        std::vector<std::thread> m_vhDecodeWorkers;
+        std::exception_ptr m_pWorkerException,m_pDecodeException;
+        /// decode workers fill the reorder buffer out-of-order within [window begin, window begin + lookahead)
+        std::mutex m_oDecodeMutex;
+        std::condition_variable m_oDecodeReqCondVar;
+        std::condition_variable m_oDecodeAnswCondVar;
+        std::map<size_t,cv::Mat> m_mDecodedPackets;
+        size_t m_nDecodeWindowBegin,m_nNextDecodeIdx,m_nDecodeEndIdx,m_nDecodeLookahead,m_nDecodeEpoch;
         std::mutex m_oSyncMutex;
         std::condition_variable m_oReqCondVar;
         std::condition_variable m_oSyncCondVar;
+        std::mutex m_oReqMutex;
         std::atomic_bool m_bIsActive;
-        size_t m_nReqIdx,m_nLastReqIdx;
+        size_t m_nReqIdx,m_nReqReaderIdx;
         std::atomic_size_t m_nAnswIdx;
-        cv::Mat m_oReqPacket,m_oLastReqPacket;
+        cv::Mat m_oReqPacket;
+        /// last packet index/data given to each reader (deques keep references valid when new readers show up)
+        std::deque<size_t> m_vnLastReqIdxs;
+        std::deque<cv::Mat> m_voLastReqPackets;
+        size_t m_nLookBehind,m_nLRUCacheSize;
         DataPrecacher& operator=(const DataPrecacher&) = delete;
         DataPrecacher(const DataPrecacher&) = delete;
     };
 
+    /// multi-threaded video file reader; the stream is split at keyframes into segments decoded concurrently by independent (software) decoders, and frames are served in order from a bounded decode-ahead window
+    struct ParallelVideoReader {
+        /// opens a video file given its frame count & keyframe indices (see 'buildKeyFrameIndex'), with a max decode thread count (0 = hardware concurrency) and decode-ahead frame count; threads are only started on the first read, and only as many as the decode-ahead window can keep busy
+        ParallelVideoReader(const std::string& sFilePath, size_t nFrameCount, const std::vector<size_t>& vnKeyFrameIdxs, size_t nDecodeThreads, size_t nMaxBufferedFrames);
+        /// default destructor (joins the decode threads, if still running)
+        ~ParallelVideoReader();
+        /// fetches a frame by index, reusing the given mat's memory if its size/type match (jumps outside of the decode-ahead window restart decoding at the enclosing segment); returns false past the end of the stream
+        bool read(size_t nFrameIdx, cv::Mat& oFrame);
+        /// returns the total frame count given at construction
+        inline size_t getFrameCount() const {return m_nFrameCount;}
+        /// returns the number of independently decodable segments the stream was split into
+        inline size_t getSegmentCount() const {return m_vnSegmentBeginIdxs.size();}
+        /// returns the number of decode threads used (bounded so that each one can hold a whole segment in the decode-ahead window)
+        inline size_t getDecodeThreadCount() const {return m_nDecodeThreads;}
+        /// returns the number of decode threads that started decoding at least one segment so far
+        size_t getActiveDecodeThreadCount();
+        /// demuxes a video file (without decoding it) to list its keyframe indices; returns its exact frame count, or zero if keyframes cannot be located with the current backend
+        static size_t buildKeyFrameIndex(const std::string& sFilePath, std::vector<size_t>& vnKeyFrameIdxs);
+    private:
+        void decode();
+        void joinWorkers();
+        const std::string m_sFilePath;
+        const size_t m_nFrameCount,m_nMaxBufferedFrames;
+        size_t m_nDecodeThreads;
+        /// first frame index of each segment (segments are made of consecutive gops, and are each seeked to once)
+        std::vector<size_t> m_vnSegmentBeginIdxs;
+        std::vector<std::thread> m_vhDecodeWorkers;
+        std::exception_ptr m_pDecodeException;
+        /// decode workers fill the reorder buffer out-of-order within [read idx, read idx + max buffered frames)
+        std::mutex m_oMutex;
+        std::condition_variable m_oReqCondVar;
+        std::condition_variable m_oAnswCondVar;
+        std::map<size_t,cv::Mat> m_mDecodedFrames;
+        size_t m_nReadIdx,m_nNextSegmentIdx,m_nEndIdx,m_nEpoch,m_nActiveDecodeThreads;
+        bool m_bStopping;
+        ParallelVideoReader& operator=(const ParallelVideoReader&) = delete;
+        ParallelVideoReader(const ParallelVideoReader&) = delete;
+    };
+
     /// data loader super-interface for work batch, exposes basic packet get functions and internal precacher wiring
     struct IIDataLoader : public virtual IDataHandler {
         /// returns the input data packet type policy (used for internal packet auto-transformations)
@@ -464,10 +617,18 @@ namespace lv {
         virtual void startPrecaching(bool bPrecacheGT=false, size_t nSuggestedBufferSize=SIZE_MAX) override;
         /// kills the asynchronyzed precacher, and clears internal buffers
         virtual void stopPrecaching() override;
-        /// returns an input packet by index (works both with and without precaching enabled)
-        const cv::Mat& getInput(size_t nPacketIdx);
-        /// returns a gt packet by index (works both with and without precaching enabled)
-        const cv::Mat& getGT(size_t nPacketIdx);
+        /// returns an input packet by index for a given reader (works both with and without precaching enabled)
+        const cv::Mat& getInput(size_t nPacketIdx, size_t nReaderIdx=0);
+        /// returns a gt packet by index for a given reader (works both with and without precaching enabled)
+        const cv::Mat& getGT(size_t nPacketIdx, size_t nReaderIdx=0);
+        /// writes all (transformed) input packets, and optionally gt packets, of this batch to a single packed binary file meant for memory-mapped playback
+        void writePackedCache(const std::string& sFilePath, bool bWithGT=true);
+        /// memory-maps a packed cache file previously written for this batch, and serves packets from it; returns false if the file is missing or stale
+        bool openPackedCache(const std::string& sFilePath);
+        /// releases the memory-mapped packed cache (packets will be loaded from the dataset again)
+        void closePackedCache();
+        /// returns whether packets are currently served from a memory-mapped packed cache
+        inline bool isUsingPackedCache() const {return bool(m_pPackedCache);}
         /// returns the ROI associated with an input packet by index (returns empty mat by default)
         virtual const cv::Mat& getInputROI(size_t nPacketIdx) const;
         /// returns the ROI associated with a gt packet by index (returns empty mat by default)
@@ -487,15 +648,37 @@ namespace lv {
         virtual cv::Mat getRawInput(size_t nPacketIdx) = 0;
         /// gt packet load function, pre-transformations (can return empty mats)
         virtual cv::Mat getRawGT(size_t nPacketIdx) = 0;
+        /// input packet load function, pre-transformations, which reuses the given packet's memory if its size/type match (default impl forwards to getRawInput)
+        virtual void getRawInput_inplace(size_t nPacketIdx, cv::Mat& oPacket);
         /// input packet transformation function (used e.g. for rescaling and color space conversion)
         virtual const cv::Mat& getInput_redirect(size_t nPacketIdx);
         /// gt packet transformation function (used e.g. for rescaling and color space conversion)
         virtual const cv::Mat& getGT_redirect(size_t nPacketIdx);
+        /// returns whether getRawInput can be called concurrently by multiple precacher decode threads (false by default)
+        virtual bool isInputLoadingReentrant() const {return false;}
+        /// returns whether getRawGT can be called concurrently by multiple precacher decode threads (false by default)
+        virtual bool isGTLoadingReentrant() const {return false;}
     private:
+        /// loads and transforms an input packet by value (reentrant if getRawInput is)
+        cv::Mat loadInput(size_t nPacketIdx);
+        /// loads and transforms a gt packet by value (reentrant if getRawGT is)
+        cv::Mat loadGT(size_t nPacketIdx);
+        /// loads and transforms an input packet straight into precacher memory (not reentrant)
+        cv::Mat loadInput_inplace(size_t nPacketIdx, const DataPrecacher::PacketAllocator& lAllocator);
         /// holds the loaded copies of the latest input/gt packets queried by the precachers
         cv::Mat m_oLatestInput,m_oLatestGT;
+        /// holds the reused raw/intermediary input buffers for in-place loading
+        cv::Mat m_oRawInputBuffer,m_oTempInputBuffer;
+        /// layout of the last input packet loaded without transformations (next one is decoded straight into the cache if it matches)
+        cv::Size m_oInPlaceInputSize;
+        int m_nInPlaceInputType;
+        /// index of the packet currently held in the raw input buffer (kept if the cache was full, so that it is not decoded again)
+        size_t m_nRawInputBufferIdx;
         /// precacher objects which may spin up a thread to pre-fetch data packets
         DataPrecacher m_oInputPrecacher,m_oGTPrecacher;
+        /// memory-mapped packed cache file, and packet headers pointing inside it (gt array is empty if not packed)
+        std::unique_ptr<MemoryMappedFile> m_pPackedCache;
+        std::vector<cv::Mat> m_vPackedInputs,m_vPackedGTs;
         /// input/gt/output packet policy types
         const PacketPolicy m_eInputType,m_eGTType,m_eOutputType;
         /// output-gt and input-output mapping policy types
@@ -527,8 +710,8 @@ namespace lv {
         virtual std::string getGTStreamName(size_t nStreamIdx) const;
         /// unpacks and returns an input array by packet index, with each stream its own cv::Mat (works both with and without precaching enabled)
         const std::vector<cv::Mat>& getInputArray(size_t nPacketIdx);
-        /// unpacks and returns a gt array by packet index, with each stream its own cv::Mat (works both with and without precaching enabled)
-        const std::vector<cv::Mat>& getGTArray(size_t nPacketIdx);
+        /// unpacks and returns a gt array by packet index for a given reader, with each stream its own cv::Mat (works both with and without precaching enabled)
+        const std::vector<cv::Mat>& getGTArray(size_t nPacketIdx, size_t nReaderIdx=0);
         /// unpacks and returns an input ROI array by packet index, with each stream its own cv::Mat
         virtual const std::vector<cv::Mat>& getInputROIArray(size_t nPacketIdx) const;
         /// unpacks and returns a gt ROI array by packet index, with each stream its own cv::Mat
@@ -557,9 +740,11 @@ namespace lv {
         /// input 'unpacking' function, which essentially unmerges the streams in a packet and assigns them to individual mats in the vector
         virtual void unpackInput(size_t nPacketIdx, std::vector<cv::Mat>& vUnpackedInput);
         /// gt 'unpacking' function, which essentially unmerges the streams in a packet and assigns them to individual mats in the vector
-        virtual void unpackGT(size_t nPacketIdx, std::vector<cv::Mat>& vUnpackedGT);
+        virtual void unpackGT(size_t nPacketIdx, std::vector<cv::Mat>& vUnpackedGT, size_t nReaderIdx=0);
     private:
-        std::vector<cv::Mat> m_vLatestUnpackedInput,m_vLatestUnpackedGT;
+        std::vector<cv::Mat> m_vLatestUnpackedInput;
+        std::deque<std::vector<cv::Mat>> m_vvLatestUnpackedGT; ///< one per gt reader (deque, so growing it keeps other readers' arrays in place)
+        std::mutex m_oUnpackedGTMutex;
     };
 
     /// default (specializable) forward declaration of the data producer interface
@@ -595,12 +780,17 @@ namespace lv {
         virtual const cv::Size& getGTMaxSize() const override;
         virtual cv::Mat getRawInput(size_t nPacketIdx) override;
         virtual cv::Mat getRawGT(size_t nPacketIdx) override;
+        virtual void getRawInput_inplace(size_t nPacketIdx, cv::Mat& oPacket) override;
+        virtual bool isInputLoadingReentrant() const override {return !m_voVideoReader.isOpened() && !m_pVideoReader;}
+        virtual bool isGTLoadingReentrant() const override {return true;}
         virtual void parseData() override;
         size_t m_nFrameCount; ///< needed as a separate variable for VideoCapture+imread support
         std::unordered_map<size_t,size_t> m_mGTIndexLUT;
         std::vector<std::string> m_vsInputPaths,m_vsGTPaths;
         cv::VideoCapture m_voVideoReader;
         size_t m_nNextExpectedVideoReaderFrameIdx;
+        /// keyframe-indexed multi-threaded reader used instead of 'm_voVideoReader' for single video files (if the backend can demux them)
+        std::unique_ptr<ParallelVideoReader> m_pVideoReader;
         cv::Mat m_oInputROI,m_oGTROI;
         cv::Size m_oInputSize,m_oGTSize;
     };
@@ -634,6 +824,8 @@ namespace lv {
         virtual const cv::Size& getGTMaxSize() const override;
         virtual cv::Mat getRawInput(size_t nPacketIdx) override; ///< loads and returns a 'packed' input packet
         virtual cv::Mat getRawGT(size_t nPacketIdx) override; ///< loads and returns a 'packed' gt packet
+        virtual bool isInputLoadingReentrant() const override {return true;}
+        virtual bool isGTLoadingReentrant() const override {return true;}
         //virtual void parseData() override;
         std::unordered_map<size_t,size_t> m_mGTIndexLUT;
         std::vector<std::vector<std::string>> m_vvsInputPaths,m_vvsGTPaths; // first dimension is packet index, 2nd is stream index
@@ -675,6 +867,8 @@ namespace lv {
         IDataProducer_(PacketPolicy eGTType, PacketPolicy eOutputType, MappingPolicy eGTMappingType, MappingPolicy eIOMappingType);
         virtual cv::Mat getRawInput(size_t nPacketIdx) override;
         virtual cv::Mat getRawGT(size_t nPacketIdx) override;
+        virtual bool isInputLoadingReentrant() const override {return true;}
+        virtual bool isGTLoadingReentrant() const override {return true;}
         virtual void parseData() override;
         std::unordered_map<size_t,size_t> m_mGTIndexLUT;
         std::vector<std::string> m_vsInputPaths,m_vsGTPaths;
@@ -714,6 +908,8 @@ namespace lv {
         IDataProducer_(PacketPolicy eGTType, PacketPolicy eOutputType, MappingPolicy eGTMappingType, MappingPolicy eIOMappingType);
         virtual cv::Mat getRawInput(size_t nPacketIdx) override; ///< loads and returns a 'packed' input packet
         virtual cv::Mat getRawGT(size_t nPacketIdx) override; ///< loads and returns a 'packed' gt packet
+        virtual bool isInputLoadingReentrant() const override {return true;}
+        virtual bool isGTLoadingReentrant() const override {return true;}
         //virtual void parseData() override;
         std::unordered_map<size_t,size_t> m_mGTIndexLUT;
         std::vector<std::vector<std::string>> m_vvsInputPaths,m_vvsGTPaths; ///< one path per packet per stream
@@ -734,40 +930,168 @@ namespace lv {
 
     /// general-purpose, stand-alone data packet writer
     struct DataWriter {
-        /// attaches to data archiver (the callback is the actual 'writing' action, with a signature similar to 'queue')
-        DataWriter(std::function<size_t(const cv::Mat&,size_t)> lDataArchiverCallback);
-        /// default destructor (joins the writing thread, if still running)
+        /// attaches to data archiver (the callback is the actual 'writing' action, with a signature similar to 'queue'); if an encoder is also given, it runs in parallel on all workers, and its outputs are committed to the archiver in queue order
+        DataWriter(std::function<size_t(const cv::Mat&,size_t)> lDataArchiverCallback, std::function<cv::Mat(const cv::Mat&,size_t)> lDataEncoderCallback=nullptr);
+        /// default destructor (joins the writing threads, if still running)
         ~DataWriter();
-        /// queues a packet, with or without async writing enabled, and returns its position in queue
+        /// queues a copy of a packet, with or without async writing enabled, and returns the number of packets queued before it (or SIZE_MAX if dropped)
         size_t queue(const cv::Mat& oPacket, size_t nIdx);
+        /// queues a packet without copying its data (the caller's header is released, even if the packet is dropped), and returns the same as the copying overload
+        size_t queue(cv::Mat&& oPacket, size_t nIdx);
         /// returns the current queue size, in packets
         inline size_t getCurrentQueueCount() const {return m_nQueueCount;}
         /// returns the current queue size, in bytes
         inline size_t getCurrentQueueSize() const {return m_nQueueSize;}
+        /// returns the highest queue size reached since async writing was started, in packets
+        inline size_t getPeakQueueCount() const {return m_nPeakQueueCount;}
+        /// returns the number of packets dropped since async writing was started
+        inline size_t getDroppedPacketCount() const {return m_nDroppedPacketCount;}
         /// initializes async writing with a given queue size (in bytes) and a number of threads
         bool startAsyncWriting(size_t nSuggestedQueueSize, bool bDropPacketsIfFull=false, size_t nWorkers=1);
-        /// joins writing thread and clears all internal buffers
+        /// joins writing threads and clears all internal buffers
         void stopAsyncWriting();
-        /// returns whether the wariting thread has already been started or not
+        /// returns whether the writing threads have already been started or not
         inline bool isActive() const {return m_bIsActive;}
     private:
+        /// ring buffer slot; its sequence number tells producers/consumers whose turn it is to use it
+        struct RingSlot {
+            std::atomic_size_t nSeq;
+            cv::Mat oPacket;
+            size_t nIdx;
+        };
+        /// popped (and possibly encoded) packet waiting in the reorder buffer for its turn to be committed
+        struct PendingPacket {
+            cv::Mat oPacket;
+            size_t nIdx;
+            size_t nPacketSize;
+            bool bValid;
+        };
         void entry();
+        size_t enqueue(const cv::Mat& oPacket, size_t nIdx, bool bCopy);
+        bool tryPush(const cv::Mat& oPacket, size_t nIdx);
+        bool tryPop(cv::Mat& oPacket, size_t& nIdx, size_t& nTicket);
+        void commit(size_t nTicket, PendingPacket&& oPacket);
+        void addWorkerException(std::exception_ptr pException, size_t nIdx);
         const std::function<size_t(const cv::Mat&,size_t)> m_lCallback;
+        const std::function<cv::Mat(const cv::Mat&,size_t)> m_lEncoderCallback;
         std::vector<std::thread> m_vhWorkers;
         std::stack<std::pair<std::exception_ptr,size_t>> m_vWorkerExceptions;
         std::mutex m_oSyncMutex;
         std::condition_variable m_oQueueCondVar;
         std::condition_variable m_oClearCondVar;
-        std::map<size_t,cv::Mat> m_mQueue;
+        std::mutex m_oCommitMutex;
+        std::map<size_t,PendingPacket> m_mPendingPackets;
+        size_t m_nNextCommitTicket;
+        bool m_bCommitting;
+        std::unique_ptr<RingSlot[]> m_aRingSlots;
+        size_t m_nRingMask;
+        std::atomic_size_t m_nEnqueuePos,m_nDequeuePos;
+        std::atomic_size_t m_nIdleWorkers,m_nBlockedWriters;
         std::atomic_bool m_bIsActive;
         bool m_bAllowPacketDrop;
         size_t m_nQueueMaxSize;
         std::atomic_size_t m_nQueueSize;
         std::atomic_size_t m_nQueueCount;
+        std::atomic_size_t m_nPeakQueueCount;
+        std::atomic_size_t m_nDroppedPacketCount;
         DataWriter& operator=(const DataWriter&) = delete;
         DataWriter(const DataWriter&) = delete;
     };
 
+    /// encodes a single-channel 8-bit mask into a compact blob (1-bit packed if strictly binary, or run-length encoded per row, whichever is smaller)
+    void encodeMask(const cv::Mat& oMask, std::vector<uchar>& vBuffer);
+    /// decodes a blob produced by 'encodeMask', reusing the given mask's memory if its size/type already match
+    void decodeMask(const uchar* pBuffer, size_t nBufferSize, cv::Mat& oMask);
+
+    /// single-file, indexed mask container; masks are stored via 'encodeMask', and can be written/read by index from any thread
+    struct MaskArchive {
+        /// opens (or creates) the container file at the given path, and loads its index (rebuilding it from records if the footer is missing)
+        MaskArchive(const std::string& sFilePath);
+        /// writes the index footer (if masks were appended) and closes the container file
+        ~MaskArchive();
+        /// appends a mask to the container (a mask previously written with the same index is superseded)
+        void write(const cv::Mat& oMask, size_t nIdx);
+        /// reads back a mask by index (returns an empty mat if it was never written)
+        cv::Mat read(size_t nIdx);
+        /// returns the number of distinct masks in the container
+        size_t getMaskCount();
+        /// writes the index footer right away, first compacting the file if masks were superseded (also done automatically on destruction)
+        void flush();
+        MaskArchive& operator=(const MaskArchive&) = delete;
+        MaskArchive(const MaskArchive&) = delete;
+    private:
+        const std::string m_sFilePath;
+        std::mutex m_oMutex;
+        std::fstream m_oFile;
+        std::map<size_t,std::pair<uint64_t,uint32_t>> m_mIndex; // packet idx => payload offset, payload size
+        uint64_t m_nDataEndOffset;
+        uint64_t m_nFileSize;
+        uint64_t m_nFooterOffset; // 0 if the file does not currently end with a valid index footer
+        uint64_t m_nSupersededSize; // bytes of records superseded by later writes (reclaimed on flush)
+        bool m_bIndexDirty;
+        std::vector<uchar> m_vBuffer;
+    };
+
+    /// persistent dataset index, caching directory listings, image sizes/types, small masks (e.g. ROIs) and video keyframe indices across runs (thread-safe)
+    struct DataIndexCache {
+        /// loads the index file at the given path if it exists and is valid (an empty path keeps the index in memory only)
+        DataIndexCache(const std::string& sIndexFilePath);
+        /// saves the index file if it was modified (errors are only reported)
+        ~DataIndexCache();
+        /// cached equivalent of lv::GetFilesFromDir; listings are invalidated when the directory's modification time changes
+        void getFilesFromDir(const std::string& sDirPath, std::vector<std::string>& vsFilePaths);
+        /// cached equivalent of lv::GetSubDirsFromDir; listings are invalidated when the directory's modification time changes
+        void getSubDirsFromDir(const std::string& sDirPath, std::vector<std::string>& vsSubDirPaths);
+        /// returns the size (and optionally the type) of an image as it would be read by cv::imread with the given flags (empty if unreadable)
+        cv::Size getImageSize(const std::string& sFilePath, int nFlags=cv::IMREAD_COLOR, int* pnType=nullptr);
+        /// returns the sizes of a list of images as they would be read by cv::imread with the given flags; uncached images are read in parallel
+        std::vector<cv::Size> getImageSizes(const std::vector<std::string>& vsFilePaths, int nFlags=cv::IMREAD_COLOR);
+        /// cached equivalent of cv::imread(...,cv::IMREAD_GRAYSCALE) for small masks such as ROIs (empty if unreadable)
+        cv::Mat readMask(const std::string& sFilePath);
+        /// cached equivalent of ParallelVideoReader::buildKeyFrameIndex; returns the video's frame count (zero if it cannot be demuxed)
+        size_t getVideoIndex(const std::string& sFilePath, std::vector<size_t>& vnKeyFrameIdxs);
+        /// writes the index file right away if it was modified since it was loaded/saved
+        void save();
+        /// returns the path of the index file (empty if the index is in memory only)
+        inline const std::string& getIndexFilePath() const {return m_sIndexFilePath;}
+        DataIndexCache& operator=(const DataIndexCache&) = delete;
+        DataIndexCache(const DataIndexCache&) = delete;
+    private:
+        struct DirEntry {
+            int64_t nModifTime;
+            bool bHasFiles,bHasSubDirs;
+            std::vector<std::string> vsFilePaths,vsSubDirPaths;
+        };
+        struct FileEntry {
+            uint64_t nFileSize;
+            int64_t nModifTime;
+        };
+        struct ImageEntry : FileEntry {
+            cv::Size oSize;
+            int nType;
+        };
+        struct MaskEntry : FileEntry {
+            std::vector<uchar> vBlob;
+        };
+        struct VideoEntry : FileEntry {
+            uint64_t nFrameCount;
+            std::vector<uint64_t> vnKeyFrameIdxs;
+        };
+        /// fetches (or lists and caches) a directory's files or subdirectories
+        void getDirListing(const std::string& sDirPath, bool bSubDirs, std::vector<std::string>& vsPaths);
+        /// returns whether a cached image entry exists and is still valid for the given file stats, filling it if so
+        bool findImageEntry(const std::string& sFilePath, int nFlags, const FileEntry& oStats, ImageEntry& oEntry);
+        /// reads an image header (via a full decode) and caches its size/type
+        ImageEntry readImageEntry(const std::string& sFilePath, int nFlags, const FileEntry& oStats);
+        const std::string m_sIndexFilePath;
+        std::mutex m_oMutex;
+        std::map<std::string,DirEntry> m_mDirs;
+        std::map<std::pair<std::string,int>,ImageEntry> m_mImages;
+        std::map<std::string,MaskEntry> m_mMasks;
+        std::map<std::string,VideoEntry> m_mVideos;
+        bool m_bDirty;
+    };
+
     /// default (specializable) forward declaration of the data archiver interface (used to save/load outputs)
     template<ArrayPolicy ePolicy>
     struct IDataArchiver_;
@@ -776,10 +1100,15 @@ namespace lv {
     template<>
     struct IDataArchiver_<NotArray> : public virtual IDataHandler {
     protected:
-        /// saves a processed data packet locally based on idx and packet name (if available), with optional flags (-1 = internal defaults)
+        /// saves a processed data packet locally based on idx and packet name (if available), with optional flags (-1 = internal defaults); masks go to packed files if the output suffix is '.lvm', or to a single container per batch if it is '.lvma'
         virtual void save(const cv::Mat& oOutput, size_t nIdx, int nFlags=-1);
         /// loads a processed data packet based on idx and packet name (if available), with optional flags (-1 = internal defaults)
         virtual cv::Mat load(size_t nIdx, int nFlags=-1);
+    private:
+        /// returns the batch-wide mask container, opening it on first use
+        MaskArchive& getMaskArchive();
+        std::mutex m_oMaskArchiveMutex;
+        std::unique_ptr<MaskArchive> m_pMaskArchive;
     };
 
     /// data archiver specialization for array output processing
@@ -792,11 +1121,29 @@ namespace lv {
         virtual std::vector<cv::Mat> loadArray(size_t nIdx, int nFlags=-1);
     };
 
+    /// live processing state of a work batch, published by its data consumer on request (see 'DataLiveReporter')
+    struct DataLiveSnapshot {
+        size_t nOutputCount; ///< output packet count processed so far
+        double dProcessTime; ///< time elapsed between the processing start and the latest output packet (in seconds)
+        std::shared_ptr<const IIMetricsCalculator> pMetrics; ///< evaluation metrics computed so far (null if unavailable)
+        bool bIsFinal; ///< whether processing was stopped once this snapshot was taken
+    };
+
     /// data counter interface for non-group work batches (exposes output packet counting logic)
     struct IDataCounter : public virtual IDataHandler {
+        /// toggles live snapshot tracking
+        void setLiveReporting(bool bEnabled);
+        /// moves the latest published live snapshot into 'oSnapshot' and requests a new one; returns false if none was published since the last call
+        bool fetchLiveSnapshot(DataLiveSnapshot& oSnapshot);
     protected:
         /// checks output with index 'nPacketIdx' as processed
         void countOutput(size_t nPacketIdx);
+        /// bumps the metrics revision counter (must be called by evaluators after their metrics are updated outside of 'countOutput'/'resetOutputCount')
+        inline void invalidateMetrics() {++m_nMetricsRevision;}
+        /// publishes a live snapshot if one was requested (called by data consumers once an output packet is fully consumed, and with 'bFinal' once processing stops)
+        void updateLiveSnapshot(bool bFinal=false);
+        /// returns the evaluation metrics attached to live snapshots (none by default; called from the thread consuming output packets)
+        virtual std::shared_ptr<const IIMetricsCalculator> getLiveMetrics() const {return nullptr;}
         /// sets the processed packets count promise for async count fetching
         void setOutputCountPromise();
         /// resets the processed packets count (and reinitializes promise)
@@ -805,13 +1152,54 @@ namespace lv {
         virtual size_t getCurrentOutputCount() const override final;
         /// returns the final output packet count processed by the work batch evaluator, blocking if processing is not finished yet
         virtual size_t getFinalOutputCount() override final;
+        /// merges the per-packet latencies recorded so far by the work batch evaluator into the given histogram
+        virtual void mergeLatencyHistogram(LatencyHistogram& oHist) const override final;
+        /// returns the work batch evaluator's metrics revision counter (bumped on every counted/consumed output, and on resets)
+        virtual size_t getMetricsRevision() const override final {return m_nMetricsRevision;}
         /// default constructor (calls resetOutputCount to initialize all members)
-        inline IDataCounter() {resetOutputCount();}
+        inline IDataCounter() : m_nMetricsRevision(0),m_bLiveReporting(false),m_bLiveSnapshotRequested(false),m_bLiveSnapshotReady(false) {resetOutputCount();}
     private:
         std::unordered_set<size_t> m_mProcessedPackets;
+        std::atomic_size_t m_nProcessedPacketCount; ///< mirrors the set size, so it can be read while packets are being counted
+        std::atomic_size_t m_nMetricsRevision; ///< never reset, so that cached metrics can never be mistaken for current ones
         std::promise<size_t> m_nPacketCountPromise;
         std::future<size_t> m_nPacketCountFuture;
         size_t m_nFinalPacketCount;
+        LatencyHistogram m_oLatencyHistogram;
+        std::chrono::high_resolution_clock::time_point m_nStartTick,m_nLastOutputTick;
+        std::atomic_bool m_bLiveReporting,m_bLiveSnapshotRequested;
+        std::mutex m_oLiveMutex;
+        double m_dLastOutputTime;
+        DataLiveSnapshot m_oLiveSnapshot;
+        bool m_bLiveSnapshotReady;
+    };
+
+    /// bounded packet queue used by data consumers to evaluate/archive outputs on a worker thread, off the processing thread (packets are handled in push order)
+    struct DataConsumerQueue {
+        /// attaches to the consumer's packet handling callback (called on the worker thread only)
+        DataConsumerQueue(std::function<void(const std::vector<cv::Mat>&,size_t)> lConsumerCallback, size_t nMaxQueuedPackets);
+        /// default destructor (joins the worker thread, dropping packets still queued; call 'flush' first to consume them)
+        ~DataConsumerQueue();
+        /// queues a packet array (which must not be modified by the caller afterwards), blocking while the queue is full; rethrows the worker's exception, if any
+        void push(std::vector<cv::Mat>&& vPacket, size_t nIdx);
+        /// blocks until all queued packets have been consumed; rethrows the worker's exception, if any
+        void flush();
+        /// returns the highest queue size reached since the queue was created, in packets
+        inline size_t getPeakQueueCount() const {return m_nPeakQueueCount;}
+    private:
+        void entry();
+        void rethrowWorkerException();
+        const std::function<void(const std::vector<cv::Mat>&,size_t)> m_lCallback;
+        const size_t m_nMaxQueuedPackets;
+        std::deque<std::pair<std::vector<cv::Mat>,size_t>> m_qPackets;
+        std::exception_ptr m_pWorkerException;
+        std::mutex m_oSyncMutex;
+        std::condition_variable m_oQueueCondVar;
+        std::condition_variable m_oClearCondVar;
+        std::atomic_size_t m_nPeakQueueCount;
+        bool m_bIsBusy;
+        bool m_bIsActive;
+        std::thread m_hWorker;
     };
 
     /// default (specializable) forward declaration of the data consumer interface
@@ -831,17 +1219,59 @@ namespace lv {
         virtual void resetMetrics() override {
             resetOutputCount();
         }
+        /// sets how many pushed packets may be queued for evaluation/writing on a worker thread (0 = consume them on the caller thread; must be set outside processing); the queue is drained after the processing stopwatch stops, so reported times only cover the caller
+        inline void setAsyncEvaluation(size_t nMaxQueuedPackets) {
+            lvAssert_(!isProcessing(),"async evaluation cannot be toggled while processing");
+            m_nMaxQueuedPackets = nMaxQueuedPackets;
+        }
         /// pushes an output (processed) data packet array for writing and/or evaluation
         inline void push(const cv::Mat& oOutput, size_t nPacketIdx) {
             lvAssert_(isProcessing(),"data processing must be toggled via 'startProcessing()' before pushing packets");
             countOutput(nPacketIdx);
-            processOutput(oOutput,nPacketIdx);
-            if(isSavingOutput() && !oOutput.empty())
-                this->save(oOutput,nPacketIdx);
+            if(m_nMaxQueuedPackets>0) {
+                if(!m_pConsumerQueue)
+                    m_pConsumerQueue = std::make_unique<DataConsumerQueue>([this](const std::vector<cv::Mat>& vPacket, size_t nIdx){consumeOutput(vPacket[0],nIdx);},m_nMaxQueuedPackets);
+                m_pConsumerQueue->push(std::vector<cv::Mat>{oOutput.clone()},nPacketIdx);
+            }
+            else
+                consumeOutput(oOutput,nPacketIdx);
         }
     protected:
         /// processes an output packet (does nothing by default, but may be overridden for evaluation/pipelining)
         virtual void processOutput(const cv::Mat& /*oOutput*/, size_t /*nPacketIdx*/) {}
+        /// returns the loader reader index to fetch gt packets with in 'processOutput' (async evaluation uses its own, so the processing thread may keep reading gt)
+        inline size_t getGTReaderIdx() const {
+            return m_nMaxQueuedPackets>0?DATASETUTILS_ASYNC_EVAL_GT_READER_IDX:0;
+        }
+        /// consumes all queued packets (if async evaluation is enabled) before the processing stop is finalized, and publishes the final live snapshot
+        virtual void stopProcessing_impl() override {
+            if(m_pConsumerQueue) {
+                std::unique_ptr<DataConsumerQueue> pConsumerQueue = std::move(m_pConsumerQueue);
+                pConsumerQueue->flush();
+            }
+            updateLiveSnapshot(true);
+        }
+        /// joins the async evaluation worker (if any) without consuming its queued packets; must be called by the most derived class before its own members go away
+        inline void stopAsyncEvaluation() {
+            m_pConsumerQueue = nullptr;
+        }
+        /// default constructor (async evaluation is disabled by default)
+        inline IDataConsumer_() : m_nMaxQueuedPackets(0) {}
+        /// default destructor (the async evaluation worker calls virtual functions, so it must already be joined via 'stopProcessing' or 'stopAsyncEvaluation')
+        inline ~IDataConsumer_() {
+            lvDbgAssert_(!m_pConsumerQueue,"async evaluation worker must be joined before data consumer destruction");
+        }
+    private:
+        /// evaluates and/or writes an output packet (on the worker thread, if async evaluation is enabled)
+        inline void consumeOutput(const cv::Mat& oOutput, size_t nPacketIdx) {
+            processOutput(oOutput,nPacketIdx);
+            invalidateMetrics();
+            if(isSavingOutput() && !oOutput.empty())
+                this->save(oOutput,nPacketIdx);
+            updateLiveSnapshot();
+        }
+        size_t m_nMaxQueuedPackets;
+        std::unique_ptr<DataConsumerQueue> m_pConsumerQueue;
     };
 
     /// data consumer specialization for receiving processed packet arrays (evaluation entrypoint)
@@ -868,18 +1298,63 @@ namespace lv {
         virtual std::string getOutputStreamName(size_t nStreamIdx) const {
             return cv::format("out[%02d]",(int)nStreamIdx);
         }
+        /// sets how many pushed packet arrays may be queued for evaluation/writing on a worker thread (0 = consume them on the caller thread; must be set outside processing); the queue is drained after the processing stopwatch stops, so reported times only cover the caller
+        inline void setAsyncEvaluation(size_t nMaxQueuedPackets) {
+            lvAssert_(!isProcessing(),"async evaluation cannot be toggled while processing");
+            m_nMaxQueuedPackets = nMaxQueuedPackets;
+        }
         /// pushes an output (processed) data packet array for writing and/or evaluation
         inline void push(const std::vector<cv::Mat>& vOutput, size_t nPacketIdx) {
             lvAssert_(isProcessing(),"data processing must be toggled via 'startProcessing()' before pushing packets");
             lvAssert_(vOutput.empty() || vOutput.size()==getOutputStreamCount(),"bad output array size");
             countOutput(nPacketIdx);
-            processOutput(vOutput,nPacketIdx);
-            if(isSavingOutput() && !vOutput.empty())
-                this->saveArray(vOutput,nPacketIdx);
+            if(m_nMaxQueuedPackets>0) {
+                if(!m_pConsumerQueue)
+                    m_pConsumerQueue = std::make_unique<DataConsumerQueue>([this](const std::vector<cv::Mat>& vPacket, size_t nIdx){consumeOutput(vPacket,nIdx);},m_nMaxQueuedPackets);
+                std::vector<cv::Mat> vOutputCopy(vOutput.size());
+                for(size_t s=0; s<vOutput.size(); ++s)
+                    vOutputCopy[s] = vOutput[s].clone();
+                m_pConsumerQueue->push(std::move(vOutputCopy),nPacketIdx);
+            }
+            else
+                consumeOutput(vOutput,nPacketIdx);
         }
     protected:
         /// processes an output array packet (does nothing by default, but may be overridden for evaluation/pipelining)
         virtual void processOutput(const std::vector<cv::Mat>& /*vOutput*/, size_t /*nPacketIdx*/) {}
+        /// returns the loader reader index to fetch gt arrays with in 'processOutput' (async evaluation uses its own, so the processing thread may keep reading gt)
+        inline size_t getGTReaderIdx() const {
+            return m_nMaxQueuedPackets>0?DATASETUTILS_ASYNC_EVAL_GT_READER_IDX:0;
+        }
+        /// consumes all queued packet arrays (if async evaluation is enabled) before the processing stop is finalized, and publishes the final live snapshot
+        virtual void stopProcessing_impl() override {
+            if(m_pConsumerQueue) {
+                std::unique_ptr<DataConsumerQueue> pConsumerQueue = std::move(m_pConsumerQueue);
+                pConsumerQueue->flush();
+            }
+            updateLiveSnapshot(true);
+        }
+        /// joins the async evaluation worker (if any) without consuming its queued packet arrays; must be called by the most derived class before its own members go away
+        inline void stopAsyncEvaluation() {
+            m_pConsumerQueue = nullptr;
+        }
+        /// default constructor (async evaluation is disabled by default)
+        inline IDataConsumer_() : m_nMaxQueuedPackets(0) {}
+        /// default destructor (the async evaluation worker calls virtual functions, so it must already be joined via 'stopProcessing' or 'stopAsyncEvaluation')
+        inline ~IDataConsumer_() {
+            lvDbgAssert_(!m_pConsumerQueue,"async evaluation worker must be joined before data consumer destruction");
+        }
+    private:
+        /// evaluates and/or writes an output packet array (on the worker thread, if async evaluation is enabled)
+        inline void consumeOutput(const std::vector<cv::Mat>& vOutput, size_t nPacketIdx) {
+            processOutput(vOutput,nPacketIdx);
+            invalidateMetrics();
+            if(isSavingOutput() && !vOutput.empty())
+                this->saveArray(vOutput,nPacketIdx);
+            updateLiveSnapshot();
+        }
+        size_t m_nMaxQueuedPackets;
+        std::unique_ptr<DataConsumerQueue> m_pConsumerQueue;
     };
 
     /// default (specializable) forward declaration of the async data consumer interface used for receiving processed packets (evaluation entrypoint)
@@ -921,6 +1396,8 @@ namespace lv {
             post_apply_gl(nNextIdx,bRebindAll);
         }
     protected:
+        /// no-op (GL outputs are consumed on the processing thread, and cpu-side evaluators own and join their workers)
+        inline void stopAsyncEvaluation() {}
         /// initializes internal async packet fetching indexes
         IAsyncDataConsumer_();
         /// called just before the GL algorithm/evaluator are initialized
@@ -970,6 +1447,8 @@ namespace lv {
         virtual IDataHandlerConstPtr getRoot() const override;
         /// returns the current data handler's parent (always null here, since we are the root)
         virtual IDataHandlerConstPtr getParent() const override;
+        /// returns the persistent directory/image index of this dataset (stored in the output directory)
+        virtual DataIndexCache& getIndexCache() const override final;
         /// returns whether this data handler interface points to the dataset's top level (root) interface or not (always true here)
         virtual bool isRoot() const override final;
         /// returns whether loaded data should be 4-byte aligned or not (4-byte alignment is ideal for GPU upload)
@@ -1010,6 +1489,7 @@ namespace lv {
         const bool m_bUsingEvaluator; ///< defines whether results should be fully evaluated, or simply acknowledged
         const bool m_bForce4ByteDataAlign; ///< defines whether data packets should be 4-byte aligned (useful for GPU upload)
         const double m_dScaleFactor; ///< defines the scale factor to use to resize/rescale read packets
+        mutable DataIndexCache m_oIndexCache; ///< persistent directory/image index shared by all data handlers of this dataset
     };
 
     /// dataset handler full (default) specialization --- can be overridden by dataset type in 'impl' headers
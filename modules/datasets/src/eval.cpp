@@ -31,8 +31,8 @@ void lv::IDataReporter_<lv::DatasetEval_None>::writeEvalReport() const {
     if(oMetricsOutput.is_open()) {
         oMetricsOutput << std::fixed;
         oMetricsOutput << "Default evaluation report for '" << getName() << "' :\n\n";
-        oMetricsOutput << "            |   Packets  |   Seconds  |     Hz     \n";
-        oMetricsOutput << "------------|------------|------------|------------\n";
+        oMetricsOutput << "            |   Packets  |   Seconds  |     Hz     |  p50 (ms)  |  p95 (ms)  |  p99 (ms)  |  max (ms)  \n";
+        oMetricsOutput << "------------|------------|------------|------------|------------|------------|------------|------------\n";
         oMetricsOutput << IDataReporter_<DatasetEval_None>::writeInlineBasicReport(0);
         oMetricsOutput << lv::getLogStamp();
     }
@@ -50,7 +50,19 @@ std::string lv::IDataReporter_<lv::DatasetEval_None>::writeInlineBasicReport(siz
     ssStr << lv::clampString((std::string(nIndentSize,'>')+' '+getName()),nCellSize) << "|" <<
              std::setw(nCellSize) << getCurrentOutputCount() << "|" <<
              std::setw(nCellSize) << getCurrentProcessTime() << "|" <<
-             std::setw(nCellSize) << getCurrentOutputCount()/getCurrentProcessTime() << "\n";
+             std::setw(nCellSize) << getCurrentOutputCount()/getCurrentProcessTime() << "|";
+    const LatencyHistogram oLatencies = getLatencyHistogram();
+    ssStr << std::setw(nCellSize) << oLatencies.getPercentile(50)*1000 << "|" <<
+             std::setw(nCellSize) << oLatencies.getPercentile(95)*1000 << "|" <<
+             std::setw(nCellSize) << oLatencies.getPercentile(99)*1000 << "|" <<
+             std::setw(nCellSize) << oLatencies.getMax()*1000 << "\n";
+    return ssStr.str();
+}
+
+std::string lv::IDataReporter_<lv::DatasetEval_None>::writeInlineLatencyReport() const {
+    const LatencyHistogram oLatencies = getLatencyHistogram();
+    std::stringstream ssStr;
+    ssStr << std::fixed << "Latency (ms): p50=" << oLatencies.getPercentile(50)*1000 << " p95=" << oLatencies.getPercentile(95)*1000 << " p99=" << oLatencies.getPercentile(99)*1000 << " max=" << oLatencies.getMax()*1000 << "\n";
     return ssStr.str();
 }
 
@@ -77,6 +89,7 @@ void lv::IDataReporter_<lv::DatasetEval_BinaryClassifier>::writeEvalReport() con
         oMetricsOutput << "------------|------------|------------|------------|------------|------------|------------|------------|------------\n";
         oMetricsOutput << IDataReporter_<DatasetEval_BinaryClassifier>::writeInlineBinClassifEvalReport(0);
         oMetricsOutput << "\nHz: " << getCurrentOutputCount()/getCurrentProcessTime() << "\n";
+        oMetricsOutput << writeInlineLatencyReport();
         oMetricsOutput << lv::getLogStamp();
     }
 }
@@ -133,6 +146,7 @@ void lv::IDataReporter_<lv::DatasetEval_BinaryClassifierArray>::writeEvalReport(
         oMetricsOutput << "------------|------------||------------|------------|------------|------------|------------|------------|------------|------------\n";
         oMetricsOutput << IDataReporter_<DatasetEval_BinaryClassifierArray>::writeInlineBinClassifArrayReducedEvalReport(0);
         oMetricsOutput << "\nHz: " << getCurrentOutputCount()/getCurrentProcessTime() << "\n";
+        oMetricsOutput << writeInlineLatencyReport();
         oMetricsOutput << lv::getLogStamp();
     }
 }
@@ -196,6 +210,168 @@ std::string lv::IDataReporter_<lv::DatasetEval_BinaryClassifierArray>::writeInli
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+    /// returns the full name of a work batch, with its parent group names as a slash-separated prefix (root excluded)
+    std::string getLiveReportBatchName(const lv::IDataHandlerPtr& pBatch) {
+        std::string sName = pBatch->getName();
+        for(lv::IDataHandlerConstPtr pParent=pBatch->getParent(); pParent && !pParent->isRoot(); pParent=pParent->getParent())
+            if(!pParent->isBare())
+                sName = pParent->getName()+"/"+sName;
+        return sName;
+    }
+
+    /// returns whether a file path has a '.csv' extension (case-insensitive)
+    bool isCSVFilePath(const std::string& sFilePath) {
+        if(sFilePath.size()<4)
+            return false;
+        std::string sExt = sFilePath.substr(sFilePath.size()-4);
+        std::transform(sExt.begin(),sExt.end(),sExt.begin(),::tolower);
+        return sExt==".csv";
+    }
+
+} // anonymous namespace
+
+lv::DataLiveReporter::DataLiveReporter(const IDataHandlerPtr& pDataset, const std::string& sOutputFilePath, size_t nPeriodMS) :
+        m_bUseCSV(isCSVFilePath(sOutputFilePath)),
+        m_nPeriodMS(std::max(nPeriodMS,size_t(1))),
+        m_bIsActive(true) {
+    lvAssert_(pDataset,"invalid dataset handle");
+    m_oOutput.open(sOutputFilePath);
+    lvAssert__(m_oOutput.is_open(),"could not open live report file at '%s'",sOutputFilePath.c_str());
+    m_oOutput << std::fixed << std::setprecision(4);
+    if(m_bUseCSV)
+        m_oOutput << "time,batch,packets,expected,seconds,hz,hz_window,lat_p50_ms,lat_p95_ms,lat_p99_ms,lat_max_ms,rcl,prc,fm,final\n" << std::flush;
+    const IDataHandlerPtrArray vpBatches = pDataset->isGroup()?pDataset->getBatches(false):IDataHandlerPtrArray{pDataset};
+    for(const IDataHandlerPtr& pBatch : vpBatches) {
+        IDataCounter* pCounter = dynamic_cast<IDataCounter*>(pBatch.get());
+        if(!pCounter)
+            continue;
+        pCounter->setLiveReporting(true);
+        m_vBatchStates.push_back(BatchState{pBatch,pCounter,getLiveReportBatchName(pBatch),0,0.0,pBatch->getLatencyHistogram()});
+    }
+    m_oStopWatch.tick();
+    m_hWorker = std::thread(&DataLiveReporter::entry,this);
+}
+
+lv::DataLiveReporter::~DataLiveReporter() {
+    {
+        std::mutex_lock_guard sync_lock(m_oSyncMutex);
+        m_bIsActive = false;
+    }
+    m_oStopCondVar.notify_all();
+    m_hWorker.join();
+    for(BatchState& oState : m_vBatchStates)
+        oState.pCounter->setLiveReporting(false);
+}
+
+void lv::DataLiveReporter::entry() {
+    std::mutex_unique_lock sync_lock(m_oSyncMutex);
+    while(m_bIsActive) {
+        m_oStopCondVar.wait_for(sync_lock,std::chrono::milliseconds(m_nPeriodMS));
+        writeRecords(); // also runs once after stopping, to flush final snapshots
+    }
+}
+
+void lv::DataLiveReporter::writeRecords() {
+    DataLiveSnapshot oSnapshot;
+    const double dCurrTime = m_oStopWatch.elapsed();
+    for(BatchState& oState : m_vBatchStates) {
+        if(!oState.pCounter->fetchLiveSnapshot(oSnapshot))
+            continue;
+        // windowed throughput is computed over the packets counted since the previous record of this batch
+        const bool bNewRun = oSnapshot.nOutputCount<oState.nLastOutputCount || oSnapshot.dProcessTime<oState.dLastProcessTime;
+        const size_t nWindowCount = oSnapshot.nOutputCount-(bNewRun?0:oState.nLastOutputCount);
+        const double dWindowTime = oSnapshot.dProcessTime-(bNewRun?0.0:oState.dLastProcessTime);
+        oState.nLastOutputCount = oSnapshot.nOutputCount;
+        oState.dLastProcessTime = oSnapshot.dProcessTime;
+        // latency percentiles are computed over the same window, by diffing the batch histogram with the one copied at the previous record
+        const LatencyHistogram oLatencies = oState.pBatch->getLatencyHistogram();
+        LatencyHistogram oWindowLatencies(oLatencies);
+        if(!bNewRun && oLatencies.getCount()>=oState.oLastLatencies.getCount())
+            oWindowLatencies.subtract(oState.oLastLatencies);
+        oState.oLastLatencies = oLatencies;
+        const BinClassifMetrics* pBinClassifMetrics = nullptr;
+        BinClassifMetricsCalculatorPtr pReducedMetrics;
+        if(const BinClassifMetricsCalculator* pCalc = dynamic_cast<const BinClassifMetricsCalculator*>(oSnapshot.pMetrics.get()))
+            pBinClassifMetrics = &pCalc->m_oMetrics;
+        else if(const BinClassifMetricsArrayCalculator* pArrayCalc = dynamic_cast<const BinClassifMetricsArrayCalculator*>(oSnapshot.pMetrics.get())) {
+            pReducedMetrics = pArrayCalc->reduce();
+            pBinClassifMetrics = &pReducedMetrics->m_oMetrics;
+        }
+        const std::string sNull = m_bUseCSV?"":"null";
+        const auto lValue = [&](bool bValid, double dVal) {
+            if(!bValid || !std::isfinite(dVal))
+                return sNull;
+            std::stringstream ssVal;
+            ssVal << std::fixed << std::setprecision(4) << dVal;
+            return ssVal.str();
+        };
+        const bool bHasLatencies = oWindowLatencies.getCount()>0;
+        const std::array<std::pair<const char*,std::string>,14> aFields = {{
+            {"time",lValue(true,dCurrTime)},
+            {"batch","\""+oState.sName+"\""},
+            {"packets",std::to_string(oSnapshot.nOutputCount)},
+            {"expected",std::to_string(oState.pBatch->getExpectedOutputCount())},
+            {"seconds",lValue(true,oSnapshot.dProcessTime)},
+            {"hz",lValue(oSnapshot.dProcessTime>0,oSnapshot.nOutputCount/oSnapshot.dProcessTime)},
+            {"hz_window",lValue(dWindowTime>0,nWindowCount/dWindowTime)},
+            {"lat_p50_ms",lValue(bHasLatencies,oWindowLatencies.getPercentile(50)*1000)},
+            {"lat_p95_ms",lValue(bHasLatencies,oWindowLatencies.getPercentile(95)*1000)},
+            {"lat_p99_ms",lValue(bHasLatencies,oWindowLatencies.getPercentile(99)*1000)},
+            {"lat_max_ms",lValue(bHasLatencies,oWindowLatencies.getMax()*1000)},
+            {"rcl",lValue(pBinClassifMetrics!=nullptr,pBinClassifMetrics?pBinClassifMetrics->dRecall:0.0)},
+            {"prc",lValue(pBinClassifMetrics!=nullptr,pBinClassifMetrics?pBinClassifMetrics->dPrecision:0.0)},
+            {"fm",lValue(pBinClassifMetrics!=nullptr,pBinClassifMetrics?pBinClassifMetrics->dFMeasure:0.0)},
+        }};
+        if(m_bUseCSV) {
+            for(const auto& oField : aFields)
+                m_oOutput << oField.second << ",";
+            m_oOutput << (oSnapshot.bIsFinal?"1":"0") << "\n";
+        }
+        else {
+            m_oOutput << "{";
+            for(const auto& oField : aFields)
+                m_oOutput << "\"" << oField.first << "\":" << oField.second << ",";
+            m_oOutput << "\"final\":" << (oSnapshot.bIsFinal?"true":"false") << "}\n";
+        }
+    }
+    m_oOutput.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+lv::CPUBinaryClassifierEvaluator::CPUBinaryClassifierEvaluator(size_t nMaxQueuedPackets) :
+        m_pMetricsBase(IIMetricsAccumulator::create<IMetricsAccumulator_<DatasetEval_BinaryClassifier>>()),
+        m_oCountingQueue([this](const std::vector<cv::Mat>& vPacket, size_t) {
+            lvDbgAssert(vPacket.size()==3);
+            m_pMetricsBase->m_oCounters.accumulate(vPacket[0],vPacket[1],vPacket[2]);
+        },nMaxQueuedPackets) {}
+
+void lv::CPUBinaryClassifierEvaluator::apply(const cv::Mat& oOutput, const cv::Mat& oGT, const cv::Mat& oROI) {
+    lvAssert_(!oOutput.empty() && !oGT.empty(),"provided output and gt mats need to be non-empty");
+    // the caller's output buffer is recycled for the next packets, so the worker gets its own copy
+    m_oCountingQueue.push(std::vector<cv::Mat>{oOutput.clone(),oGT,oROI},0);
+}
+
+lv::BinClassifMetricsAccumulatorPtr lv::CPUBinaryClassifierEvaluator::getMetricsBase() {
+    m_oCountingQueue.flush();
+    BinClassifMetricsAccumulatorPtr pMetricsBase = IIMetricsAccumulator::create<IMetricsAccumulator_<DatasetEval_BinaryClassifier>>();
+    pMetricsBase->m_oCounters = m_pMetricsBase->m_oCounters;
+    return pMetricsBase;
+}
+
+void lv::CPUBinaryClassifierEvaluator::resetMetrics() {
+    m_oCountingQueue.flush();
+    m_pMetricsBase = IIMetricsAccumulator::create<IMetricsAccumulator_<DatasetEval_BinaryClassifier>>();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 #if HAVE_GLSL
 
 lv::GLBinaryClassifierEvaluator::GLBinaryClassifierEvaluator(const std::shared_ptr<GLImageProcAlgo>& pParent,size_t nTotFrameCount) :
@@ -18,6 +18,11 @@
 #include "litiv/datasets.hpp"
 #include "litiv/imgproc.hpp"
 #include "litiv/utils/console.hpp"
+#include "BSDS500_edges.hpp"
+
+#define BSDS500_EVAL_MAX_THREADS       0 // threshold bins & gt masks are matched (and image scores are updated) concurrently (0 = use hardware concurrency)
+#define BSDS500_EVAL_INCREMENTAL_SWEEP 0 // sweeps bins from high to low threshold, re-thinning only the edge components grown since the previous bin (serial; only pays off when bins cannot be thinned in parallel; both paths are always compiled)
+
 #if USE_BSDS500_BENCHMARK
 #ifdef __clang__
 #pragma clang diagnostic push
@@ -80,19 +85,70 @@ void lv::MetricsAccumulator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS50
     lvAssert(oClassif.step.p[0]==oGT.step.p[0]);
 
     const double dMaxDist = DATASETS_BSDS500_EVAL_IMAGE_DIAG_RATIO_DIST*sqrt(double(oClassif.cols*oClassif.cols+oClassif.rows*oClassif.rows));
-    const double dMaxDistSqr = dMaxDist*dMaxDist;
     const int nMaxDist = (int)ceil(dMaxDist);
     lvAssert(dMaxDist>0 && nMaxDist>0);
+    // window spans are given as offsets from gt pixels to segm pixels; the mirrored ones are used for lookups the other way around
+    const std::vector<DiskSpan> voDiskSpans_GTToSEGM = getDiskSpans(dMaxDist,nMaxDist);
+    const std::vector<DiskSpan> voDiskSpans_SEGMToGT = getMirroredDiskSpans(voDiskSpans_GTToSEGM);
+    const size_t nGTMaskCount = size_t(oGT.rows/oClassif.rows);
+    std::vector<EdgePixelIndex> voGTIndices; // gt edge maps do not depend on the threshold, so they are only indexed once
+    voGTIndices.reserve(nGTMaskCount);
+    for(size_t nGTMaskIdx=0; nGTMaskIdx<nGTMaskCount; ++nGTMaskIdx)
+        voGTIndices.emplace_back(oGT(cv::Rect(0,int(oClassif.rows*nGTMaskIdx),oClassif.cols,oClassif.rows)));
 
     BSDS500Counters oMetricsBase(m_nThresholdBins);
     const std::vector<uchar> vuEvalUniqueVals = lv::unique<uchar>(oClassif);
-    cv::Mat oCurrSegmMask(oClassif.size(),CV_8UC1), oTmpSegmMask(oClassif.size(),CV_8UC1);
-    cv::Mat oSegmTPAccumulator(oClassif.size(),CV_8UC1);
+    // bins whose threshold does not pass a new output value give the same segm mask as the previous bin, so only the others are evaluated
+    std::vector<size_t> vnEvalBinIdxs;
     size_t nNextEvalUniqueValIdx = 0;
     size_t nThresholdBinIdx = 0;
     while(nThresholdBinIdx<oMetricsBase.vnThresholds.size()) {
-        cv::compare(oClassif,oMetricsBase.vnThresholds[nThresholdBinIdx],oTmpSegmMask,cv::CMP_GE);
-        lv::thinning(oTmpSegmMask,oCurrSegmMask);
+        vnEvalBinIdxs.push_back(nThresholdBinIdx);
+        while(nNextEvalUniqueValIdx+1<vuEvalUniqueVals.size() && vuEvalUniqueVals[nNextEvalUniqueValIdx]<=oMetricsBase.vnThresholds[nThresholdBinIdx])
+            ++nNextEvalUniqueValIdx;
+        while(++nThresholdBinIdx<oMetricsBase.vnThresholds.size() && oMetricsBase.vnThresholds[nThresholdBinIdx]<=vuEvalUniqueVals[nNextEvalUniqueValIdx]) {}
+    }
+    const size_t nEvalBinCount = vnEvalBinIdxs.size();
+
+    std::vector<std::unique_ptr<EdgePixelIndex>> vpSegmIndices(nEvalBinCount);
+    if(BSDS500_EVAL_INCREMENTAL_SWEEP) {
+        // segm edge maps are first thresholded, thinned & indexed from high to low threshold, so that each mask only grows from the
+        // previous one, and only the components that did grow need to be re-thinned...
+        cv::Mat oPrevSegmMask, oCurrSegmMask, oThinnedSegmMask;
+        for(size_t nEvalBinIdx=nEvalBinCount; nEvalBinIdx-->0;) {
+            cv::compare(oClassif,oMetricsBase.vnThresholds[vnEvalBinIdxs[nEvalBinIdx]],oCurrSegmMask,cv::CMP_GE);
+            if(oPrevSegmMask.empty())
+                lv::thinning(oCurrSegmMask,oThinnedSegmMask);
+            else
+                updateThinning(oPrevSegmMask,oCurrSegmMask,oThinnedSegmMask);
+            vpSegmIndices[nEvalBinIdx] = std::make_unique<EdgePixelIndex>(oThinnedSegmMask);
+            std::swap(oPrevSegmMask,oCurrSegmMask);
+        }
+    }
+    else {
+        // all bins are independent: segm edge maps are first thresholded, thinned & indexed in parallel...
+        lv::parallel_for(nEvalBinCount,BSDS500_EVAL_MAX_THREADS,[&](size_t nEvalBinIdx) {
+            static thread_local cv::Mat s_oTmpSegmMask,s_oCurrSegmMask; // per-thread scratch buffers
+            cv::compare(oClassif,oMetricsBase.vnThresholds[vnEvalBinIdxs[nEvalBinIdx]],s_oTmpSegmMask,cv::CMP_GE);
+            lv::thinning(s_oTmpSegmMask,s_oCurrSegmMask);
+            vpSegmIndices[nEvalBinIdx] = std::make_unique<EdgePixelIndex>(s_oCurrSegmMask);
+        });
+    }
+
+    // ...then matched against each gt mask in separate jobs, whose results are reduced in bin/mask order below
+    struct MatchResult {
+        uint64_t nIndivTP; // cntR += ...
+        std::vector<uchar> vbSegmMatched; // accP |= ... (one flag per segm edge pixel)
+    };
+    std::vector<MatchResult> voMatchResults(nEvalBinCount*nGTMaskCount);
+    std::mutex oProgressMutex;
+    size_t nMatchJobsDone = 0;
+    lv::parallel_for(voMatchResults.size(),BSDS500_EVAL_MAX_THREADS,[&](size_t nMatchJobIdx) {
+        const size_t nGTMaskIdx = nMatchJobIdx%nGTMaskCount;
+        const EdgePixelIndex& oIndex_SEGM = *vpSegmIndices[nMatchJobIdx/nGTMaskCount];
+        const EdgePixelIndex& oIndex_GT = voGTIndices[nGTMaskIdx];
+        uint64_t nIndivTP = 0;
+        std::vector<uchar> vbSegmMatched(oIndex_SEGM.m_voPoints.size(),0);
 
 #if USE_BSDS500_BENCHMARK
 
@@ -102,333 +158,285 @@ void lv::MetricsAccumulator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS50
 
         const double dOutlierCost = 100*dMaxDist;
         lvAssert(dOutlierCost>1);
-        oSegmTPAccumulator = cv::Scalar_<uchar>(0);
-        cv::Mat oGTAccumulator(oCurrSegmMask.size(),CV_8UC1,cv::Scalar_<uchar>(0));
-        uint64_t nIndivTP = 0;
-        uint64_t nGTPosCount = 0;
 
         static constexpr int multiplier = 100;
         static constexpr int degree = 6;
         static_assert(degree>0,"csa config bad; degree of outlier connections should be > 0");
         static_assert(multiplier>0,"csa config bad; floating-point weights to integers should be > 0");
+        // outlier connections are drawn at random; seeding per job keeps the counters independent of the thread that runs it
+        BSDS500::seedKOfN((unsigned int)nMatchJobIdx);
+
+        const cv::Mat oCurrGTSegmMask = oGT(cv::Rect(0,int(oClassif.rows*nGTMaskIdx),oClassif.cols,oClassif.rows));
+        // Figure out which nodes are matchable, i.e. within maxDist
+        // of another node.
+        std::vector<uchar> vbMatchable_SEGM(oIndex_SEGM.m_voPoints.size());
+        std::vector<uchar> vbMatchable_GT(oIndex_GT.m_voPoints.size());
+        for(size_t nPointIdx=0; nPointIdx<vbMatchable_SEGM.size(); ++nPointIdx)
+            vbMatchable_SEGM[nPointIdx] = (uchar)oIndex_GT.isInWindow(oIndex_SEGM.m_voPoints[nPointIdx].y,oIndex_SEGM.m_voPoints[nPointIdx].x,voDiskSpans_SEGMToGT);
+        for(size_t nPointIdx=0; nPointIdx<vbMatchable_GT.size(); ++nPointIdx)
+            vbMatchable_GT[nPointIdx] = (uchar)oIndex_SEGM.isInWindow(oIndex_GT.m_voPoints[nPointIdx].y,oIndex_GT.m_voPoints[nPointIdx].x,voDiskSpans_GTToSEGM);
+
+        // Count the number of nodes on each side of the match.
+        // Node IDs range from [0,nNodeCount_SEGM) and [0,nNodeCount_GT),
+        // and are given by the row-major rank of matchable pixels.
+        const EdgePixelIndex oMatchableIndex_SEGM(oIndex_SEGM,vbMatchable_SEGM);
+        const EdgePixelIndex oMatchableIndex_GT(oIndex_GT,vbMatchable_GT);
+        const std::vector<cv::Point2i>& voNodeToPxLUT_SEGM = oMatchableIndex_SEGM.m_voPoints;
+        const std::vector<cv::Point2i>& voNodeToPxLUT_GT = oMatchableIndex_GT.m_voPoints;
+        const int nNodeCount_SEGM = (int)voNodeToPxLUT_SEGM.size();
+        const int nNodeCount_GT = (int)voNodeToPxLUT_GT.size();
+        std::vector<int> vnNodeToPointLUT_SEGM; // node ID -> segm edge pixel index
+        vnNodeToPointLUT_SEGM.reserve(voNodeToPxLUT_SEGM.size());
+        for(size_t nPointIdx=0; nPointIdx<vbMatchable_SEGM.size(); ++nPointIdx)
+            if(vbMatchable_SEGM[nPointIdx])
+                vnNodeToPointLUT_SEGM.push_back((int)nPointIdx);
+
+        struct Edge {
+            int nNodeIdx_SEGM;
+            int nNodeIdx_GT;
+            double dEdgeDist;
+        };
+        static thread_local std::vector<Edge> s_voEdges; // per-thread scratch buffer
+        std::vector<Edge>& voEdges = s_voEdges;
+        voEdges.clear();
+        // Construct the list of edges between pixels within maxDist.
+        for(int nNodeIdx_GT=0; nNodeIdx_GT<nNodeCount_GT; ++nNodeIdx_GT) {
+            oMatchableIndex_SEGM.visitWindow(voNodeToPxLUT_GT[nNodeIdx_GT].y,voNodeToPxLUT_GT[nNodeIdx_GT].x,voDiskSpans_GTToSEGM,[&](int nNodeIdx_SEGM, int u, int v) {
+                Edge e;
+                e.nNodeIdx_SEGM = nNodeIdx_SEGM;
+                e.nNodeIdx_GT = nNodeIdx_GT;
+                e.dEdgeDist = sqrt(double(u*u+v*v));
+                lvDbgAssert(e.nNodeIdx_SEGM>=0 && e.nNodeIdx_SEGM<nNodeCount_SEGM);
+                voEdges.push_back(e);
+                return false;
+            });
+        }
 
-        for(size_t nGTMaskIdx=0; nGTMaskIdx<size_t(oGT.rows/oCurrSegmMask.rows); ++nGTMaskIdx) {
-            cv::Mat oCurrGTSegmMask = oGT(cv::Rect(0,int(oCurrSegmMask.rows*nGTMaskIdx),oCurrSegmMask.cols,oCurrSegmMask.rows));
-            cv::Mat oMatchable_SEGM(oCurrSegmMask.size(),CV_8UC1,cv::Scalar_<uchar>(0));
-            cv::Mat oMatchable_GT(oCurrSegmMask.size(),CV_8UC1,cv::Scalar_<uchar>(0));
-            // Figure out which nodes are matchable, i.e. within maxDist
-            // of another node.
-            for(int i=0; i<oCurrSegmMask.rows; ++i) {
-                for(int j=0; j<oCurrSegmMask.cols; ++j) {
-                    if(!oCurrGTSegmMask.at<uchar>(i,j)) continue;
-                    for(int u=-nMaxDist; u<=nMaxDist; ++u) {
-                        if(i+u<0) continue;
-                        if(i+u>=oCurrSegmMask.rows) continue;
-                        if(double(u)>dMaxDist) continue;
-                        for(int v=-nMaxDist; v<=nMaxDist; ++v) {
-                            if(j+v<0) continue;
-                            if(j+v>=oCurrSegmMask.cols) continue;
-                            if(double(v)>dMaxDist) continue;
-                            const double dCurrDistSqr = u*u+v*v;
-                            if(dCurrDistSqr>dMaxDistSqr) continue;
-                            if(oCurrSegmMask.at<uchar>(i+u,j+v)) {
-                                oMatchable_SEGM.at<uchar>(i+u,j+v) = UCHAR_MAX;
-                                oMatchable_GT.at<uchar>(i,j) = UCHAR_MAX;
-                            }
-                        }
-                    }
-                }
+        // The cardinality of the match is n.
+        const int n = nNodeCount_SEGM+nNodeCount_GT;
+        const int nmin = std::min(nNodeCount_SEGM,nNodeCount_GT);
+        const int nmax = std::max(nNodeCount_SEGM,nNodeCount_GT);
+
+        // Compute the degree of various outlier connections.
+        const int degree_SEGM = std::max(0,std::min(degree,nNodeCount_SEGM-1)); // from map1
+        const int degree_GT = std::max(0,std::min(degree,nNodeCount_GT-1)); // from map2
+        const int degree_mix = std::min(degree,std::min(nNodeCount_SEGM,nNodeCount_GT)); // between outliers
+        const int dmax = std::max(degree_SEGM,std::max(degree_GT,degree_mix));
+
+        lvDbgAssert(nNodeCount_SEGM==0 || (degree_SEGM>=0 && degree_SEGM<nNodeCount_SEGM));
+        lvDbgAssert(nNodeCount_GT==0 || (degree_GT>=0 && degree_GT<nNodeCount_GT));
+        lvDbgAssert(degree_mix>=0 && degree_mix<=nmin);
+
+        // Count the number of edges.
+        int m = 0;
+        m += (int)voEdges.size();         // real connections
+        m += degree_SEGM*nNodeCount_SEGM; // outlier connections
+        m += degree_GT*nNodeCount_GT;     // outlier connections
+        m += degree_mix*nmax;             // outlier-outlier connections
+        m += n;                           // high-cost perfect match overlay
+                                          // If the graph is empty, then there's nothing to do.
+        if(m>0) {
+            // Weight of outlier connections.
+            const int nOutlierWeight = (int)ceil(dOutlierCost*multiplier);
+            // Scratch array for outlier edges.
+            std::vector<int> vnOutliers(dmax);
+            // Construct the input graph for the assignment problem.
+            static thread_local std::vector<int> s_vnGraphBuffer,s_vnOutGraphBuffer; // per-thread scratch buffers
+            s_vnGraphBuffer.resize(size_t(m)*3);
+            cv::Mat oGraph(m,3,CV_32SC1,s_vnGraphBuffer.data());
+            int nGraphIdx = 0;
+            // real edges
+            for(int a=0; a<(int)voEdges.size(); ++a) {
+                int nNodeIdx_SEGM = voEdges[a].nNodeIdx_SEGM;
+                int nNodeIdx_GT = voEdges[a].nNodeIdx_GT;
+                lvDbgAssert(nNodeIdx_SEGM>=0 && nNodeIdx_SEGM<nNodeCount_SEGM);
+                lvDbgAssert(nNodeIdx_GT>=0 && nNodeIdx_GT<nNodeCount_GT);
+                oGraph.at<int>(nGraphIdx,0) = nNodeIdx_SEGM;
+                oGraph.at<int>(nGraphIdx,1) = nNodeIdx_GT;
+                oGraph.at<int>(nGraphIdx,2) = (int)rint(voEdges[a].dEdgeDist*multiplier);
+                nGraphIdx++;
             }
-
-            int nNodeCount_SEGM=0, nNodeCount_GT=0;
-            std::vector<cv::Point2i> voNodeToPxLUT_SEGM,voNodeToPxLUT_GT;
-            cv::Mat oPxToNodeLUT_SEGM(oCurrSegmMask.size(),CV_32SC1,cv::Scalar_<int>(-1));
-            cv::Mat oPxToNodeLUT_GT(oCurrSegmMask.size(),CV_32SC1,cv::Scalar_<int>(-1));
-            // Count the number of nodes on each side of the match.
-            // Construct nodeID->pixel and pixel->nodeID maps.
-            // Node IDs range from [0,nNodeCount_SEGM) and [0,nNodeCount_GT).
-            for(int i=0; i<oCurrSegmMask.rows; ++i) {
-                for(int j=0; j<oCurrSegmMask.cols; ++j) {
-                    cv::Point2i px(j,i);
-                    if(oMatchable_SEGM.at<uchar>(px)) {
-                        oPxToNodeLUT_SEGM.at<int>(px) = nNodeCount_SEGM;
-                        voNodeToPxLUT_SEGM.push_back(px);
-                        ++nNodeCount_SEGM;
-                    }
-                    if(oMatchable_GT.at<uchar>(px)) {
-                        oPxToNodeLUT_GT.at<int>(px) = nNodeCount_GT;
-                        voNodeToPxLUT_GT.push_back(px);
-                        ++nNodeCount_GT;
-                    }
-                }
-            }
-
-            struct Edge {
-                int nNodeIdx_SEGM;
-                int nNodeIdx_GT;
-                double dEdgeDist;
-            };
-            std::vector<Edge> voEdges;
-            // Construct the list of edges between pixels within maxDist.
-            for(int i=0; i<oCurrSegmMask.rows; ++i) {
-                for(int j=0; j<oCurrSegmMask.cols; ++j) {
-                    if(!oMatchable_GT.at<uchar>(i,j)) continue;
-                    for(int u=-nMaxDist; u<=nMaxDist; ++u) {
-                        if(i+u<0) continue;
-                        if(i+u>=oCurrSegmMask.rows) continue;
-                        if(double(u)>dMaxDist) continue;
-                        for(int v=-nMaxDist; v<=nMaxDist; ++v) {
-                            if(j+v<0) continue;
-                            if(j+v>=oCurrSegmMask.cols) continue;
-                            if(double(v)>dMaxDist) continue;
-                            if(!oMatchable_SEGM.at<uchar>(i+u,j+v)) continue;
-                            const double dCurrDistSqr = u*u+v*v;
-                            if(dCurrDistSqr>dMaxDistSqr) continue;
-                            Edge e;
-                            e.nNodeIdx_SEGM = oPxToNodeLUT_SEGM.at<int>(i+u,j+v);
-                            e.nNodeIdx_GT = oPxToNodeLUT_GT.at<int>(i,j);
-                            e.dEdgeDist = sqrt(dCurrDistSqr);
-                            lvDbgAssert(e.nNodeIdx_SEGM>=0 && e.nNodeIdx_SEGM<nNodeCount_SEGM);
-                            lvDbgAssert(e.nNodeIdx_GT>=0 && e.nNodeIdx_GT<nNodeCount_GT);
-                            voEdges.push_back(e);
-                        }
-                    }
+            // outliers edges for map1, exclude diagonal
+            for(int nNodeIdx_SEGM=0; nNodeIdx_SEGM<nNodeCount_SEGM; ++nNodeIdx_SEGM) {
+                BSDS500::kOfN(degree_SEGM,nNodeCount_SEGM-1,vnOutliers.data());
+                for(int a=0; a<degree_SEGM; a++) {
+                    int j = vnOutliers[a];
+                    if(j>=nNodeIdx_SEGM) {j++;}
+                    lvDbgAssert(nNodeIdx_SEGM!=j);
+                    lvDbgAssert(j>=0 && j<nNodeCount_SEGM);
+                    oGraph.at<int>(nGraphIdx,0) = nNodeIdx_SEGM;
+                    oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+j;
+                    oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
+                    nGraphIdx++;
                 }
             }
-
-            // The cardinality of the match is n.
-            const int n = nNodeCount_SEGM+nNodeCount_GT;
-            const int nmin = std::min(nNodeCount_SEGM,nNodeCount_GT);
-            const int nmax = std::max(nNodeCount_SEGM,nNodeCount_GT);
-
-            // Compute the degree of various outlier connections.
-            const int degree_SEGM = std::max(0,std::min(degree,nNodeCount_SEGM-1)); // from map1
-            const int degree_GT = std::max(0,std::min(degree,nNodeCount_GT-1)); // from map2
-            const int degree_mix = std::min(degree,std::min(nNodeCount_SEGM,nNodeCount_GT)); // between outliers
-            const int dmax = std::max(degree_SEGM,std::max(degree_GT,degree_mix));
-
-            lvDbgAssert(nNodeCount_SEGM==0 || (degree_SEGM>=0 && degree_SEGM<nNodeCount_SEGM));
-            lvDbgAssert(nNodeCount_GT==0 || (degree_GT>=0 && degree_GT<nNodeCount_GT));
-            lvDbgAssert(degree_mix>=0 && degree_mix<=nmin);
-
-            // Count the number of edges.
-            int m = 0;
-            m += (int)voEdges.size();         // real connections
-            m += degree_SEGM*nNodeCount_SEGM; // outlier connections
-            m += degree_GT*nNodeCount_GT;     // outlier connections
-            m += degree_mix*nmax;             // outlier-outlier connections
-            m += n;                           // high-cost perfect match overlay
-                                              // If the graph is empty, then there's nothing to do.
-            if(m>0) {
-                // Weight of outlier connections.
-                const int nOutlierWeight = (int)ceil(dOutlierCost*multiplier);
-                // Scratch array for outlier edges.
-                std::vector<int> vnOutliers(dmax);
-                // Construct the input graph for the assignment problem.
-                cv::Mat oGraph(m,3,CV_32SC1);
-                int nGraphIdx = 0;
-                // real edges
-                for(int a=0; a<(int)voEdges.size(); ++a) {
-                    int nNodeIdx_SEGM = voEdges[a].nNodeIdx_SEGM;
-                    int nNodeIdx_GT = voEdges[a].nNodeIdx_GT;
-                    lvDbgAssert(nNodeIdx_SEGM>=0 && nNodeIdx_SEGM<nNodeCount_SEGM);
-                    lvDbgAssert(nNodeIdx_GT>=0 && nNodeIdx_GT<nNodeCount_GT);
-                    oGraph.at<int>(nGraphIdx,0) = nNodeIdx_SEGM;
+            // outliers edges for map2, exclude diagonal
+            for(int nNodeIdx_GT = 0; nNodeIdx_GT<nNodeCount_GT; nNodeIdx_GT++) {
+                BSDS500::kOfN(degree_GT,nNodeCount_GT-1,vnOutliers.data());
+                for(int a = 0; a<degree_GT; a++) {
+                    int i = vnOutliers[a];
+                    if(i>=nNodeIdx_GT) {i++;}
+                    lvDbgAssert(i!=nNodeIdx_GT);
+                    lvDbgAssert(i>=0 && i<nNodeCount_GT);
+                    oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
                     oGraph.at<int>(nGraphIdx,1) = nNodeIdx_GT;
-                    oGraph.at<int>(nGraphIdx,2) = (int)rint(voEdges[a].dEdgeDist*multiplier);
+                    oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
                     nGraphIdx++;
                 }
-                // outliers edges for map1, exclude diagonal
-                for(int nNodeIdx_SEGM=0; nNodeIdx_SEGM<nNodeCount_SEGM; ++nNodeIdx_SEGM) {
-                    BSDS500::kOfN(degree_SEGM,nNodeCount_SEGM-1,vnOutliers.data());
-                    for(int a=0; a<degree_SEGM; a++) {
-                        int j = vnOutliers[a];
-                        if(j>=nNodeIdx_SEGM) {j++;}
-                        lvDbgAssert(nNodeIdx_SEGM!=j);
-                        lvDbgAssert(j>=0 && j<nNodeCount_SEGM);
-                        oGraph.at<int>(nGraphIdx,0) = nNodeIdx_SEGM;
-                        oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+j;
-                        oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
-                        nGraphIdx++;
-                    }
-                }
-                // outliers edges for map2, exclude diagonal
-                for(int nNodeIdx_GT = 0; nNodeIdx_GT<nNodeCount_GT; nNodeIdx_GT++) {
-                    BSDS500::kOfN(degree_GT,nNodeCount_GT-1,vnOutliers.data());
-                    for(int a = 0; a<degree_GT; a++) {
-                        int i = vnOutliers[a];
-                        if(i>=nNodeIdx_GT) {i++;}
-                        lvDbgAssert(i!=nNodeIdx_GT);
+            }
+            // outlier-to-outlier edges
+            for(int i = 0; i<nmax; i++) {
+                BSDS500::kOfN(degree_mix,nmin,vnOutliers.data());
+                for(int a = 0; a<degree_mix; a++) {
+                    const int j = vnOutliers[a];
+                    lvDbgAssert(j>=0 && j<nmin);
+                    if(nNodeCount_SEGM<nNodeCount_GT) {
                         lvDbgAssert(i>=0 && i<nNodeCount_GT);
+                        lvDbgAssert(j>=0 && j<nNodeCount_SEGM);
                         oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
-                        oGraph.at<int>(nGraphIdx,1) = nNodeIdx_GT;
-                        oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
-                        nGraphIdx++;
+                        oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+j;
                     }
-                }
-                // outlier-to-outlier edges
-                for(int i = 0; i<nmax; i++) {
-                    BSDS500::kOfN(degree_mix,nmin,vnOutliers.data());
-                    for(int a = 0; a<degree_mix; a++) {
-                        const int j = vnOutliers[a];
-                        lvDbgAssert(j>=0 && j<nmin);
-                        if(nNodeCount_SEGM<nNodeCount_GT) {
-                            lvDbgAssert(i>=0 && i<nNodeCount_GT);
-                            lvDbgAssert(j>=0 && j<nNodeCount_SEGM);
-                            oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
-                            oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+j;
-                        }
-                        else {
-                            lvDbgAssert(i>=0 && i<nNodeCount_SEGM);
-                            lvDbgAssert(j>=0 && j<nNodeCount_GT);
-                            oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+j;
-                            oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+i;
-                        }
-                        oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
-                        nGraphIdx++;
+                    else {
+                        lvDbgAssert(i>=0 && i<nNodeCount_SEGM);
+                        lvDbgAssert(j>=0 && j<nNodeCount_GT);
+                        oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+j;
+                        oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+i;
                     }
-                }
-                // perfect match overlay (diagonal)
-                for(int i = 0; i<nNodeCount_SEGM; i++) {
-                    oGraph.at<int>(nGraphIdx,0) = i;
-                    oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+i;
-                    oGraph.at<int>(nGraphIdx,2) = nOutlierWeight*multiplier;
+                    oGraph.at<int>(nGraphIdx,2) = nOutlierWeight;
                     nGraphIdx++;
                 }
-                for(int i = 0; i<nNodeCount_GT; i++) {
-                    oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
-                    oGraph.at<int>(nGraphIdx,1) = i;
-                    oGraph.at<int>(nGraphIdx,2) = nOutlierWeight*multiplier;
-                    nGraphIdx++;
-                }
-                lvDbgAssert(nGraphIdx==m);
-
-                // Check all the edges, and set the values up for CSA.
-                for(int i = 0; i<m; i++) {
-                    lvDbgAssert(oGraph.at<int>(i,0)>=0 && oGraph.at<int>(i,0)<n);
-                    lvDbgAssert(oGraph.at<int>(i,1)>=0 && oGraph.at<int>(i,1)<n);
-                    oGraph.at<int>(i,0) += 1;
-                    oGraph.at<int>(i,1) += 1+n;
-                }
+            }
+            // perfect match overlay (diagonal)
+            for(int i = 0; i<nNodeCount_SEGM; i++) {
+                oGraph.at<int>(nGraphIdx,0) = i;
+                oGraph.at<int>(nGraphIdx,1) = nNodeCount_GT+i;
+                oGraph.at<int>(nGraphIdx,2) = nOutlierWeight*multiplier;
+                nGraphIdx++;
+            }
+            for(int i = 0; i<nNodeCount_GT; i++) {
+                oGraph.at<int>(nGraphIdx,0) = nNodeCount_SEGM+i;
+                oGraph.at<int>(nGraphIdx,1) = i;
+                oGraph.at<int>(nGraphIdx,2) = nOutlierWeight*multiplier;
+                nGraphIdx++;
+            }
+            lvDbgAssert(nGraphIdx==m);
+
+            // Check all the edges, and set the values up for CSA.
+            for(int i = 0; i<m; i++) {
+                lvDbgAssert(oGraph.at<int>(i,0)>=0 && oGraph.at<int>(i,0)<n);
+                lvDbgAssert(oGraph.at<int>(i,1)>=0 && oGraph.at<int>(i,1)<n);
+                oGraph.at<int>(i,0) += 1;
+                oGraph.at<int>(i,1) += 1+n;
+            }
 
-                // Solve the assignment problem.
-                BSDS500::CSA oCSASolver(2*n,m,(int*)oGraph.data);
-                lvAssert(oCSASolver.edges()==n);
-
-                cv::Mat oOutGraph(n,3,CV_32SC1);
-                for(int i = 0; i<n; i++) {
-                    int a,b,c;
-                    oCSASolver.edge(i,a,b,c);
-                    oOutGraph.at<int>(i,0) = a-1;
-                    oOutGraph.at<int>(i,1) = b-1-n;
-                    oOutGraph.at<int>(i,2) = c;
-                }
+            // Solve the assignment problem.
+            BSDS500::CSA oCSASolver(2*n,m,(int*)oGraph.data);
+            lvAssert(oCSASolver.edges()==n);
+
+            s_vnOutGraphBuffer.resize(size_t(n)*3);
+            cv::Mat oOutGraph(n,3,CV_32SC1,s_vnOutGraphBuffer.data());
+            for(int i = 0; i<n; i++) {
+                int a,b,c;
+                oCSASolver.edge(i,a,b,c);
+                oOutGraph.at<int>(i,0) = a-1;
+                oOutGraph.at<int>(i,1) = b-1-n;
+                oOutGraph.at<int>(i,2) = c;
+            }
 
-                // Check the solution.
-                // Count the number of high-cost edges from the perfect match
-                // overlay that were used in the match.
-                int nOverlayCount = 0;
-                for(int a = 0; a<n; a++) {
-                    const int i = oOutGraph.at<int>(a,0);
-                    const int j = oOutGraph.at<int>(a,1);
-                    const int c = oOutGraph.at<int>(a,2);
-                    lvDbgAssert(i>=0 && i<n);
-                    lvDbgAssert(j>=0 && j<n);
-                    lvDbgAssert(c>=0);
-                    // edge from high-cost perfect match overlay
-                    if(c==nOutlierWeight*multiplier) {nOverlayCount++;}
-                    // skip outlier edges
-                    if(i>=nNodeCount_SEGM) {continue;}
-                    if(j>=nNodeCount_GT) {continue;}
-                    // for edges between real nodes, check the edge weight
-                    lvDbgAssert((int)rint(sqrt((voNodeToPxLUT_SEGM[i].x-voNodeToPxLUT_GT[j].x)*(voNodeToPxLUT_SEGM[i].x-voNodeToPxLUT_GT[j].x)+(voNodeToPxLUT_SEGM[i].y-voNodeToPxLUT_GT[j].y)*(voNodeToPxLUT_SEGM[i].y-voNodeToPxLUT_GT[j].y))*multiplier)==c);
-                }
+            // Check the solution.
+            // Count the number of high-cost edges from the perfect match
+            // overlay that were used in the match.
+            int nOverlayCount = 0;
+            for(int a = 0; a<n; a++) {
+                const int i = oOutGraph.at<int>(a,0);
+                const int j = oOutGraph.at<int>(a,1);
+                const int c = oOutGraph.at<int>(a,2);
+                lvDbgAssert(i>=0 && i<n);
+                lvDbgAssert(j>=0 && j<n);
+                lvDbgAssert(c>=0);
+                // edge from high-cost perfect match overlay
+                if(c==nOutlierWeight*multiplier) {nOverlayCount++;}
+                // skip outlier edges
+                if(i>=nNodeCount_SEGM) {continue;}
+                if(j>=nNodeCount_GT) {continue;}
+                // for edges between real nodes, check the edge weight
+                lvDbgAssert((int)rint(sqrt((voNodeToPxLUT_SEGM[i].x-voNodeToPxLUT_GT[j].x)*(voNodeToPxLUT_SEGM[i].x-voNodeToPxLUT_GT[j].x)+(voNodeToPxLUT_SEGM[i].y-voNodeToPxLUT_GT[j].y)*(voNodeToPxLUT_SEGM[i].y-voNodeToPxLUT_GT[j].y))*multiplier)==c);
+            }
 
-                // Print a warning if any of the edges from the perfect match overlay
-                // were used.  This should happen rarely.  If it happens frequently,
-                // then the outlier connectivity should be increased.
-                if(nOverlayCount>5) {
-                    fprintf(stderr,"%s:%d: WARNING: The match includes %d outlier(s) from the perfect match overlay.\n",__FILE__,__LINE__,nOverlayCount);
-                }
+            // Print a warning if any of the edges from the perfect match overlay
+            // were used.  This should happen rarely.  If it happens frequently,
+            // then the outlier connectivity should be increased.
+            if(nOverlayCount>5) {
+                fprintf(stderr,"%s:%d: WARNING: The match includes %d outlier(s) from the perfect match overlay.\n",__FILE__,__LINE__,nOverlayCount);
+            }
 
-                // Compute match arrays.
-                for(int a = 0; a<n; a++) {
-                    // node ids
-                    const int i = oOutGraph.at<int>(a,0);
-                    const int j = oOutGraph.at<int>(a,1);
-                    // skip outlier edges
-                    if(i>=nNodeCount_SEGM) {continue;}
-                    if(j>=nNodeCount_GT) {continue;}
-                    // for edges between real nodes, check the edge weight
-                    const cv::Point2i oPx_SEGM = voNodeToPxLUT_SEGM[i];
-                    const cv::Point2i oPx_GT = voNodeToPxLUT_GT[j];
-                    // record edges
-                    lvAssert(oCurrSegmMask.at<uchar>(oPx_SEGM) && oCurrGTSegmMask.at<uchar>(oPx_GT));
-                    oSegmTPAccumulator.at<uchar>(oPx_SEGM) = UCHAR_MAX;
-                    ++nIndivTP;
-                }
+            // Compute match arrays.
+            for(int a = 0; a<n; a++) {
+                // node ids
+                const int i = oOutGraph.at<int>(a,0);
+                const int j = oOutGraph.at<int>(a,1);
+                // skip outlier edges
+                if(i>=nNodeCount_SEGM) {continue;}
+                if(j>=nNodeCount_GT) {continue;}
+                // for edges between real nodes, check the edge weight
+                const cv::Point2i oPx_SEGM = voNodeToPxLUT_SEGM[i];
+                const cv::Point2i oPx_GT = voNodeToPxLUT_GT[j];
+                // record edges
+                lvAssert(oIndex_SEGM.m_voPoints[size_t(vnNodeToPointLUT_SEGM[i])]==oPx_SEGM && oCurrGTSegmMask.at<uchar>(oPx_GT));
+                vbSegmMatched[size_t(vnNodeToPointLUT_SEGM[i])] = UCHAR_MAX;
+                ++nIndivTP;
             }
-            nGTPosCount += cv::countNonZero(oCurrGTSegmMask);
-            oGTAccumulator |= oCurrGTSegmMask;
         }
 
 #else //(!USE_BSDS500_BENCHMARK)
 
-        oSegmTPAccumulator = cv::Scalar_<uchar>(0); // accP |= ...
-        uint64_t nIndivTP = 0; // cntR += ...
-        uint64_t nGTPosCount = 0; // sumR += ...
-        for(size_t nGTMaskIdx = 0; nGTMaskIdx<size_t(oGT.rows/oCurrSegmMask.rows); ++nGTMaskIdx) {
-            cv::Mat oCurrGTSegmMask = oGT(cv::Rect(0,int(oCurrSegmMask.rows*nGTMaskIdx),oCurrSegmMask.cols,oCurrSegmMask.rows));
-            for(int i = 0; i<oCurrSegmMask.rows; ++i) {
-                for(int j = 0; j<oCurrSegmMask.cols; ++j) {
-                    if(!oCurrGTSegmMask.at<uchar>(i,j)) continue;
-                    ++nGTPosCount;
-                    bool bFoundMatch = false;
-                    for(int u = -nMaxDist; u<=nMaxDist && !bFoundMatch; ++u) {
-                        if(i+u<0) continue;
-                        if(i+u>=oCurrSegmMask.rows) continue;
-                        if(double(u)>dMaxDist) continue;
-                        for(int v = -nMaxDist; v<=nMaxDist && !bFoundMatch; ++v) {
-                            if(j+v<0) continue;
-                            if(j+v>=oCurrSegmMask.cols) continue;
-                            if(double(v)>dMaxDist) continue;
-                            const double dCurrDistSqr = u*u+v*v;
-                            if(dCurrDistSqr>dMaxDistSqr) continue;
-                            if(oCurrSegmMask.at<uchar>(i+u,j+v)) {
-                                ++nIndivTP;
-                                oSegmTPAccumulator.at<uchar>(i+u,j+v) = UCHAR_MAX;
-                                bFoundMatch = true;
-                            }
-                        }
-                    }
-                }
-            }
+        // each gt pixel matches the first segm pixel met in a window scan, if any
+        for(const cv::Point2i& oPx_GT : oIndex_GT.m_voPoints) {
+            oIndex_SEGM.visitWindow(oPx_GT.y,oPx_GT.x,voDiskSpans_GTToSEGM,[&](int nPointIdx, int, int) {
+                ++nIndivTP;
+                vbSegmMatched[size_t(nPointIdx)] = UCHAR_MAX;
+                return true;
+            });
         }
 
 #endif //(!USE_BSDS500_BENCHMARK)
 
+        voMatchResults[nMatchJobIdx] = MatchResult{nIndivTP,std::move(vbSegmMatched)};
+        std::mutex_lock_guard oLock(oProgressMutex);
+        lv::updateConsoleProgressBar("BSDS500 eval:",float(++nMatchJobsDone)/voMatchResults.size());
+    });
+
+    for(size_t nEvalBinIdx=0; nEvalBinIdx<nEvalBinCount; ++nEvalBinIdx) {
+        const size_t nEvalThresholdBinIdx = vnEvalBinIdxs[nEvalBinIdx];
+        uint64_t nIndivTP = 0; // cntR += ...
+        uint64_t nGTPosCount = 0; // sumR += ...
+        std::vector<uchar> vbSegmTPAccumulator(vpSegmIndices[nEvalBinIdx]->m_voPoints.size(),0); // accP |= ...
+        for(size_t nGTMaskIdx=0; nGTMaskIdx<nGTMaskCount; ++nGTMaskIdx) {
+            const MatchResult& oMatchResult = voMatchResults[nEvalBinIdx*nGTMaskCount+nGTMaskIdx];
+            nIndivTP += oMatchResult.nIndivTP;
+            nGTPosCount += voGTIndices[nGTMaskIdx].m_voPoints.size();
+            for(size_t nPointIdx=0; nPointIdx<vbSegmTPAccumulator.size(); ++nPointIdx)
+                vbSegmTPAccumulator[nPointIdx] |= oMatchResult.vbSegmMatched[nPointIdx];
+        }
+
         //re = TP / (TP + FN)
         lvAssert(nGTPosCount>=nIndivTP);
-        oMetricsBase.vnIndivTP[nThresholdBinIdx] = nIndivTP;
-        oMetricsBase.vnIndivTPFN[nThresholdBinIdx] = nGTPosCount;
+        oMetricsBase.vnIndivTP[nEvalThresholdBinIdx] = nIndivTP;
+        oMetricsBase.vnIndivTPFN[nEvalThresholdBinIdx] = nGTPosCount;
 
         //pr = TP / (TP + FP)
-        uint64_t nSegmTPAccCount = uint64_t(cv::countNonZero(oSegmTPAccumulator));
-        uint64_t nSegmPosCount = uint64_t(cv::countNonZero(oCurrSegmMask));
+        uint64_t nSegmTPAccCount = uint64_t(std::count(vbSegmTPAccumulator.begin(),vbSegmTPAccumulator.end(),UCHAR_MAX));
+        uint64_t nSegmPosCount = uint64_t(vbSegmTPAccumulator.size());
         lvAssert(nSegmPosCount>=nSegmTPAccCount);
-        oMetricsBase.vnTotalTP[nThresholdBinIdx] = nSegmTPAccCount;
-        oMetricsBase.vnTotalTPFP[nThresholdBinIdx] = nSegmPosCount;
-        while(nNextEvalUniqueValIdx+1<vuEvalUniqueVals.size() && vuEvalUniqueVals[nNextEvalUniqueValIdx]<=oMetricsBase.vnThresholds[nThresholdBinIdx])
-            ++nNextEvalUniqueValIdx;
-        while(++nThresholdBinIdx<oMetricsBase.vnThresholds.size() && oMetricsBase.vnThresholds[nThresholdBinIdx]<=vuEvalUniqueVals[nNextEvalUniqueValIdx]) {
+        oMetricsBase.vnTotalTP[nEvalThresholdBinIdx] = nSegmTPAccCount;
+        oMetricsBase.vnTotalTPFP[nEvalThresholdBinIdx] = nSegmPosCount;
+        const size_t nNextEvalThresholdBinIdx = (nEvalBinIdx+1<nEvalBinCount)?vnEvalBinIdxs[nEvalBinIdx+1]:oMetricsBase.vnThresholds.size();
+        for(nThresholdBinIdx=nEvalThresholdBinIdx+1; nThresholdBinIdx<nNextEvalThresholdBinIdx; ++nThresholdBinIdx) {
             oMetricsBase.vnIndivTP[nThresholdBinIdx] = oMetricsBase.vnIndivTP[nThresholdBinIdx-1];
             oMetricsBase.vnIndivTPFN[nThresholdBinIdx] = oMetricsBase.vnIndivTPFN[nThresholdBinIdx-1];
             oMetricsBase.vnTotalTP[nThresholdBinIdx] = oMetricsBase.vnTotalTP[nThresholdBinIdx-1];
             oMetricsBase.vnTotalTPFP[nThresholdBinIdx] = oMetricsBase.vnTotalTPFP[nThresholdBinIdx-1];
         }
-
-        const float fCompltRatio = float(nThresholdBinIdx)/oMetricsBase.vnThresholds.size();
-        lv::updateConsoleProgressBar("BSDS500 eval:",fCompltRatio);
     }
     lv::cleanConsoleRow();
     m_voMetricsBase.push_back(oMetricsBase);
@@ -535,34 +543,44 @@ void lv::MetricsCalculator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500
     BSDS500Counters oMaxBinClassifMetricsAccumulator(1);
     const size_t nImageCount = m_voMetricsBase.size();
     voBestImageScores.resize(nImageCount);
-    for(size_t nImageIdx = 0; nImageIdx<nImageCount; ++nImageIdx) {
-        lvDbgAssert(!m_voMetricsBase[nImageIdx].vnIndivTP.empty() && !m_voMetricsBase[nImageIdx].vnIndivTPFN.empty());
-        lvDbgAssert(!m_voMetricsBase[nImageIdx].vnTotalTP.empty() && !m_voMetricsBase[nImageIdx].vnTotalTPFP.empty());
-        lvDbgAssert(m_voMetricsBase[nImageIdx].vnIndivTP.size()==m_voMetricsBase[nImageIdx].vnIndivTPFN.size());
-        lvDbgAssert(m_voMetricsBase[nImageIdx].vnTotalTP.size()==m_voMetricsBase[nImageIdx].vnTotalTPFP.size());
-        lvDbgAssert(m_voMetricsBase[nImageIdx].vnIndivTP.size()==m_voMetricsBase[nImageIdx].vnTotalTP.size());
-        lvDbgAssert(m_voMetricsBase[nImageIdx].vnThresholds.size()==m_voMetricsBase[nImageIdx].vnTotalTP.size());
-        lvDbgAssert(nImageIdx==0 || m_voMetricsBase[nImageIdx].vnIndivTP.size()==m_voMetricsBase[nImageIdx-1].vnIndivTP.size());
-        lvDbgAssert(nImageIdx==0 || m_voMetricsBase[nImageIdx].vnThresholds==m_voMetricsBase[nImageIdx-1].vnThresholds);
+    // per-image scores only read their own counters, so they are computed in parallel (the interpolated max f-measure search dominates here)...
+    std::vector<size_t> vnMaxFMeasureIdxs(nImageCount);
+    lv::parallel_for(nImageCount,BSDS500_EVAL_MAX_THREADS,[&](size_t nImageIdx) {
+        const BSDS500Counters& oImageMetricsBase = m_voMetricsBase[nImageIdx];
+        lvDbgAssert(!oImageMetricsBase.vnIndivTP.empty() && !oImageMetricsBase.vnIndivTPFN.empty());
+        lvDbgAssert(!oImageMetricsBase.vnTotalTP.empty() && !oImageMetricsBase.vnTotalTPFP.empty());
+        lvDbgAssert(oImageMetricsBase.vnIndivTP.size()==oImageMetricsBase.vnIndivTPFN.size());
+        lvDbgAssert(oImageMetricsBase.vnTotalTP.size()==oImageMetricsBase.vnTotalTPFP.size());
+        lvDbgAssert(oImageMetricsBase.vnIndivTP.size()==oImageMetricsBase.vnTotalTP.size());
+        lvDbgAssert(oImageMetricsBase.vnThresholds.size()==oImageMetricsBase.vnTotalTP.size());
+        lvDbgAssert(nImageIdx==0 || oImageMetricsBase.vnIndivTP.size()==m_voMetricsBase[nImageIdx-1].vnIndivTP.size());
+        lvDbgAssert(nImageIdx==0 || oImageMetricsBase.vnThresholds==m_voMetricsBase[nImageIdx-1].vnThresholds);
         std::vector<BSDS500Score> voImageScore_PerThreshold(m_nThresholdBins);
         for(size_t nThresholdIdx = 0; nThresholdIdx<m_nThresholdBins; ++nThresholdIdx) {
-            voImageScore_PerThreshold[nThresholdIdx].dRecall = lv::BinClassifMetrics::CalcRecall(m_voMetricsBase[nImageIdx].vnIndivTP[nThresholdIdx],m_voMetricsBase[nImageIdx].vnIndivTPFN[nThresholdIdx]);
-            voImageScore_PerThreshold[nThresholdIdx].dPrecision = lv::BinClassifMetrics::CalcPrecision(m_voMetricsBase[nImageIdx].vnTotalTP[nThresholdIdx],m_voMetricsBase[nImageIdx].vnTotalTPFP[nThresholdIdx]);
+            voImageScore_PerThreshold[nThresholdIdx].dRecall = lv::BinClassifMetrics::CalcRecall(oImageMetricsBase.vnIndivTP[nThresholdIdx],oImageMetricsBase.vnIndivTPFN[nThresholdIdx]);
+            voImageScore_PerThreshold[nThresholdIdx].dPrecision = lv::BinClassifMetrics::CalcPrecision(oImageMetricsBase.vnTotalTP[nThresholdIdx],oImageMetricsBase.vnTotalTPFP[nThresholdIdx]);
             voImageScore_PerThreshold[nThresholdIdx].dFMeasure = lv::BinClassifMetrics::CalcFMeasure(voImageScore_PerThreshold[nThresholdIdx].dRecall,voImageScore_PerThreshold[nThresholdIdx].dPrecision);
-            voImageScore_PerThreshold[nThresholdIdx].dThreshold = double(m_voMetricsBase[nImageIdx].vnThresholds[nThresholdIdx])/UCHAR_MAX;
-            oCumulMetricsBase.vnIndivTP[nThresholdIdx] += m_voMetricsBase[nImageIdx].vnIndivTP[nThresholdIdx];
-            oCumulMetricsBase.vnIndivTPFN[nThresholdIdx] += m_voMetricsBase[nImageIdx].vnIndivTPFN[nThresholdIdx];
-            oCumulMetricsBase.vnTotalTP[nThresholdIdx] += m_voMetricsBase[nImageIdx].vnTotalTP[nThresholdIdx];
-            oCumulMetricsBase.vnTotalTPFP[nThresholdIdx] += m_voMetricsBase[nImageIdx].vnTotalTPFP[nThresholdIdx];
+            voImageScore_PerThreshold[nThresholdIdx].dThreshold = double(oImageMetricsBase.vnThresholds[nThresholdIdx])/UCHAR_MAX;
         }
         voBestImageScores[nImageIdx] = FindMaxFMeasure(voImageScore_PerThreshold);
-        size_t nMaxFMeasureIdx = (size_t)std::distance(voImageScore_PerThreshold.begin(),std::max_element(voImageScore_PerThreshold.begin(),voImageScore_PerThreshold.end(),[](const BSDS500Score& n1, const BSDS500Score& n2){
+        vnMaxFMeasureIdxs[nImageIdx] = (size_t)std::distance(voImageScore_PerThreshold.begin(),std::max_element(voImageScore_PerThreshold.begin(),voImageScore_PerThreshold.end(),[](const BSDS500Score& n1, const BSDS500Score& n2){
             return n1.dFMeasure<n2.dFMeasure;
         }));
-        oMaxBinClassifMetricsAccumulator.vnIndivTP[0] += m_voMetricsBase[nImageIdx].vnIndivTP[nMaxFMeasureIdx];
-        oMaxBinClassifMetricsAccumulator.vnIndivTPFN[0] += m_voMetricsBase[nImageIdx].vnIndivTPFN[nMaxFMeasureIdx];
-        oMaxBinClassifMetricsAccumulator.vnTotalTP[0] += m_voMetricsBase[nImageIdx].vnTotalTP[nMaxFMeasureIdx];
-        oMaxBinClassifMetricsAccumulator.vnTotalTPFP[0] += m_voMetricsBase[nImageIdx].vnTotalTPFP[nMaxFMeasureIdx];
+    });
+    // ...and only integer counters are reduced afterwards, in image order, so the result does not depend on the thread count
+    for(size_t nImageIdx = 0; nImageIdx<nImageCount; ++nImageIdx) {
+        const BSDS500Counters& oImageMetricsBase = m_voMetricsBase[nImageIdx];
+        for(size_t nThresholdIdx = 0; nThresholdIdx<m_nThresholdBins; ++nThresholdIdx) {
+            oCumulMetricsBase.vnIndivTP[nThresholdIdx] += oImageMetricsBase.vnIndivTP[nThresholdIdx];
+            oCumulMetricsBase.vnIndivTPFN[nThresholdIdx] += oImageMetricsBase.vnIndivTPFN[nThresholdIdx];
+            oCumulMetricsBase.vnTotalTP[nThresholdIdx] += oImageMetricsBase.vnTotalTP[nThresholdIdx];
+            oCumulMetricsBase.vnTotalTPFP[nThresholdIdx] += oImageMetricsBase.vnTotalTPFP[nThresholdIdx];
+        }
+        const size_t nMaxFMeasureIdx = vnMaxFMeasureIdxs[nImageIdx];
+        oMaxBinClassifMetricsAccumulator.vnIndivTP[0] += oImageMetricsBase.vnIndivTP[nMaxFMeasureIdx];
+        oMaxBinClassifMetricsAccumulator.vnIndivTPFN[0] += oImageMetricsBase.vnIndivTPFN[nMaxFMeasureIdx];
+        oMaxBinClassifMetricsAccumulator.vnTotalTP[0] += oImageMetricsBase.vnTotalTP[nMaxFMeasureIdx];
+        oMaxBinClassifMetricsAccumulator.vnTotalTPFP[0] += oImageMetricsBase.vnTotalTPFP[nMaxFMeasureIdx];
     }
     // ^^^ voBestImageScores => eval_bdry_img.txt
     voThresholdScores.resize(m_nThresholdBins);
@@ -596,7 +614,7 @@ void lv::MetricsCalculator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500
             vdInterpReqIdx[n] = double(n)/nInterpReqIdxCount;
         std::vector<double> vdInterpVals = lv::interp1(vdCumulRecall_uniques,vdCumulPrecision_uniques,vdInterpReqIdx);
         if(!vdInterpVals.empty())
-            for(size_t n = 0; n<=vdInterpVals.size(); ++n)
+            for(size_t n = 0; n<vdInterpVals.size(); ++n)
                 dAreaPR += vdInterpVals[n]*0.01;
     }
     // ^^^ oCumulScore,dMaxRecall,dMaxPrecision,dMaxFMeasure,dAreaPR => eval_bdry.txt
@@ -675,7 +693,7 @@ void lv::DataEvaluator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500,lv:
     if(isEvaluating()) {
         lvAssert_(!oClassif.empty(),"output must be non-empty for evaluation");
         auto pLoader = shared_from_this_cast<IDataLoader_<NotArray>>(true);
-        m_pMetricsBase->accumulate(oClassif,pLoader->getGT(nIdx),pLoader->getGTROI(nIdx));
+        m_pMetricsBase->accumulate(oClassif,pLoader->getGT(nIdx,getGTReaderIdx()),pLoader->getGTROI(nIdx));
     }
 }
 
@@ -713,6 +731,7 @@ void lv::DatasetReporter_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500>:
                        std::setw(12) << oMetrics.oBestScore.dFMeasure << "|" <<
                        std::setw(12) << oMetrics.oBestScore.dThreshold << "\n";
         oMetricsOutput << "\nHz: " << getCurrentOutputCount()/getCurrentProcessTime() << "\n";
+        oMetricsOutput << writeInlineLatencyReport();
         oMetricsOutput << lv::getLogStamp();
     }
 }
@@ -0,0 +1,170 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// note: this private header holds the edge map thinning & matching helpers of the BSDS500 evaluation (see BSDS500.cpp);
+// it is only split off so that the datasets module's tests can check them against their brute-force counterparts
+
+#include "litiv/imgproc.hpp"
+
+namespace {
+
+    /// range of column offsets matched around a pixel on a given row offset of the max-distance window (empty if min>max)
+    struct DiskSpan {
+        int nMinOffset, nMaxOffset;
+    };
+
+    /// returns the column offset spans of the max-distance window for each row offset in [-nMaxDist,nMaxDist], using the exact same tests as the original window scans
+    inline std::vector<DiskSpan> getDiskSpans(double dMaxDist, int nMaxDist) {
+        const double dMaxDistSqr = dMaxDist*dMaxDist;
+        std::vector<DiskSpan> voSpans(size_t(2*nMaxDist+1),DiskSpan{1,0});
+        for(int u=-nMaxDist; u<=nMaxDist; ++u) {
+            if(double(u)>dMaxDist)
+                continue;
+            DiskSpan& oSpan = voSpans[size_t(u+nMaxDist)];
+            for(int v=-nMaxDist; v<=nMaxDist; ++v) {
+                if(double(v)>dMaxDist || double(u*u+v*v)>dMaxDistSqr)
+                    continue;
+                if(oSpan.nMinOffset>oSpan.nMaxOffset)
+                    oSpan.nMinOffset = v;
+                oSpan.nMaxOffset = v; // matched offsets are contiguous along a row
+            }
+        }
+        return voSpans;
+    }
+
+    /// returns the window spans seen from the other end of each pixel pair (i.e. with all offsets negated)
+    inline std::vector<DiskSpan> getMirroredDiskSpans(const std::vector<DiskSpan>& voSpans) {
+        std::vector<DiskSpan> voMirroredSpans(voSpans.rbegin(),voSpans.rend());
+        for(DiskSpan& oSpan : voMirroredSpans)
+            oSpan = DiskSpan{-oSpan.nMaxOffset,-oSpan.nMinOffset};
+        return voMirroredSpans;
+    }
+
+    /// row-major list of the (sparse) nonzero pixels of an edge mask, bucketed by row so that those around a pixel can be visited without scanning the whole window
+    struct EdgePixelIndex {
+        /// builds the index from the nonzero pixels of an 8-bit mask
+        explicit EdgePixelIndex(const cv::Mat& oMask) :
+                m_nRows(oMask.rows),m_vnRowOffsets(size_t(oMask.rows+1),0) {
+            lvDbgAssert(oMask.type()==CV_8UC1);
+            for(int nRowIdx=0; nRowIdx<oMask.rows; ++nRowIdx) {
+                const uchar* pMaskRow = oMask.ptr<uchar>(nRowIdx);
+                for(int nColIdx=0; nColIdx<oMask.cols; ++nColIdx)
+                    if(pMaskRow[nColIdx])
+                        m_voPoints.emplace_back(nColIdx,nRowIdx);
+                m_vnRowOffsets[size_t(nRowIdx+1)] = (int)m_voPoints.size();
+            }
+        }
+        /// builds the index from the subset of another index's pixels flagged in vbKeep
+        EdgePixelIndex(const EdgePixelIndex& oIndex, const std::vector<uchar>& vbKeep) :
+                m_nRows(oIndex.m_nRows),m_vnRowOffsets(oIndex.m_vnRowOffsets.size(),0) {
+            lvDbgAssert(vbKeep.size()==oIndex.m_voPoints.size());
+            for(int nRowIdx=0; nRowIdx<m_nRows; ++nRowIdx) {
+                for(int nPointIdx=oIndex.m_vnRowOffsets[size_t(nRowIdx)]; nPointIdx<oIndex.m_vnRowOffsets[size_t(nRowIdx+1)]; ++nPointIdx)
+                    if(vbKeep[size_t(nPointIdx)])
+                        m_voPoints.push_back(oIndex.m_voPoints[size_t(nPointIdx)]);
+                m_vnRowOffsets[size_t(nRowIdx+1)] = (int)m_voPoints.size();
+            }
+        }
+        /// calls lFunc(nPointIdx,u,v) for each indexed pixel at (i+u,j+v) in the window given by its spans, in the same (u,v) order as a window scan; returns true as soon as lFunc does
+        template<typename TFunc>
+        bool visitWindow(int i, int j, const std::vector<DiskSpan>& voSpans, TFunc&& lFunc) const {
+            const int nMaxDist = int(voSpans.size()/2);
+            for(int u=std::max(-nMaxDist,-i); u<=nMaxDist && i+u<m_nRows; ++u) {
+                const DiskSpan& oSpan = voSpans[size_t(u+nMaxDist)];
+                if(oSpan.nMinOffset>oSpan.nMaxOffset)
+                    continue;
+                const auto pRowEnd = m_voPoints.begin()+m_vnRowOffsets[size_t(i+u+1)];
+                auto pPoint = std::lower_bound(m_voPoints.begin()+m_vnRowOffsets[size_t(i+u)],pRowEnd,j+oSpan.nMinOffset,[](const cv::Point2i& oPt, int nCol) {return oPt.x<nCol;});
+                for(; pPoint!=pRowEnd && pPoint->x<=j+oSpan.nMaxOffset; ++pPoint)
+                    if(lFunc(int(pPoint-m_voPoints.begin()),u,pPoint->x-j))
+                        return true;
+            }
+            return false;
+        }
+        /// returns whether any indexed pixel lies in the window given by its spans around (i,j)
+        bool isInWindow(int i, int j, const std::vector<DiskSpan>& voSpans) const {
+            return visitWindow(i,j,voSpans,[](int,int,int){return true;});
+        }
+        int m_nRows; ///< number of rows in the indexed mask
+        std::vector<cv::Point2i> m_voPoints; ///< indexed pixel locations, in row-major order (i.e. their index is their rank)
+        std::vector<int> m_vnRowOffsets; ///< index of the first pixel of each row in m_voPoints (plus the end index)
+    };
+
+    /// updates the thinned version of a binary mask that grew from oPrevMask to oCurrMask by only re-thinning its 8-connected components that contain new pixels
+    inline void updateThinning(const cv::Mat& oPrevMask, const cv::Mat& oCurrMask, cv::Mat& oThinnedMask) {
+        // thinning only looks at 3x3 neighborhoods & never adds pixels, so each component is thinned independently of the others;
+        // components without new pixels are identical to the previous mask's, and so is their thinned version
+        lvDbgAssert(oPrevMask.size==oCurrMask.size && oThinnedMask.size==oCurrMask.size);
+        cv::Mat_<int> oLabels, oStats;
+        cv::Mat oCentroids;
+        const int nLabels = cv::connectedComponentsWithStats(oCurrMask,oLabels,oStats,oCentroids,8,CV_32S);
+        std::vector<uchar> vbDirtyLabels(size_t(nLabels),0);
+        for(int nRowIdx=0; nRowIdx<oCurrMask.rows; ++nRowIdx) {
+            const uchar* pPrevRow = oPrevMask.ptr<uchar>(nRowIdx);
+            const uchar* pCurrRow = oCurrMask.ptr<uchar>(nRowIdx);
+            const int* pLabelRow = oLabels.ptr<int>(nRowIdx);
+            for(int nColIdx=0; nColIdx<oCurrMask.cols; ++nColIdx)
+                if(pCurrRow[nColIdx] && !pPrevRow[nColIdx])
+                    vbDirtyLabels[size_t(pLabelRow[nColIdx])] = 1;
+        }
+        int nMinX = oCurrMask.cols, nMinY = oCurrMask.rows, nMaxX = -1, nMaxY = -1;
+        for(int nLabelIdx=1; nLabelIdx<nLabels; ++nLabelIdx) {
+            if(vbDirtyLabels[size_t(nLabelIdx)]) {
+                nMinX = std::min(nMinX,oStats(nLabelIdx,cv::CC_STAT_LEFT));
+                nMinY = std::min(nMinY,oStats(nLabelIdx,cv::CC_STAT_TOP));
+                nMaxX = std::max(nMaxX,oStats(nLabelIdx,cv::CC_STAT_LEFT)+oStats(nLabelIdx,cv::CC_STAT_WIDTH)-1);
+                nMaxY = std::max(nMaxY,oStats(nLabelIdx,cv::CC_STAT_TOP)+oStats(nLabelIdx,cv::CC_STAT_HEIGHT)-1);
+            }
+        }
+        if(nMaxX<0)
+            return;
+        // the re-thinned region keeps a (blank) 1px border where possible since thinning never touches border pixels, and it must be larger than 3x3
+        int nBeginX = std::max(nMinX-1,0), nBeginY = std::max(nMinY-1,0);
+        int nEndX = std::min(nMaxX+2,oCurrMask.cols), nEndY = std::min(nMaxY+2,oCurrMask.rows);
+        while(nEndX-nBeginX<4 && (nBeginX>0 || nEndX<oCurrMask.cols)) {
+            if(nEndX<oCurrMask.cols)
+                ++nEndX;
+            else
+                --nBeginX;
+        }
+        while(nEndY-nBeginY<4 && (nBeginY>0 || nEndY<oCurrMask.rows)) {
+            if(nEndY<oCurrMask.rows)
+                ++nEndY;
+            else
+                --nBeginY;
+        }
+        const cv::Rect oDirtyBBox(nBeginX,nBeginY,nEndX-nBeginX,nEndY-nBeginY);
+        cv::Mat oDirtyMask(oDirtyBBox.size(),CV_8UC1);
+        cv::Mat oThinnedRegion = oThinnedMask(oDirtyBBox);
+        for(int nRowIdx=0; nRowIdx<oDirtyBBox.height; ++nRowIdx) {
+            const int* pLabelRow = oLabels.ptr<int>(nRowIdx+oDirtyBBox.y)+oDirtyBBox.x;
+            uchar* pDirtyRow = oDirtyMask.ptr<uchar>(nRowIdx);
+            uchar* pThinnedRow = oThinnedRegion.ptr<uchar>(nRowIdx);
+            for(int nColIdx=0; nColIdx<oDirtyBBox.width; ++nColIdx) {
+                pDirtyRow[nColIdx] = vbDirtyLabels[size_t(pLabelRow[nColIdx])]?UCHAR_MAX:0;
+                if(pDirtyRow[nColIdx])
+                    pThinnedRow[nColIdx] = 0;
+            }
+        }
+        cv::Mat oDirtyThinnedMask;
+        lv::thinning(oDirtyMask,oDirtyThinnedMask);
+        oThinnedRegion |= oDirtyThinnedMask;
+    }
+
+} // namespace
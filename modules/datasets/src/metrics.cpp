@@ -17,46 +17,101 @@
 
 #include <litiv/datasets/metrics.hpp>
 #include "litiv/datasets/metrics.hpp"
+// note: the generic kernel table is compiled here with the baseline flags of the project, while the other tables are
+// compiled in their own translation units with extra ISA flags (see metrics_kernels.hpp and the module's CMakeLists)
+#define LV_BINCLASSIF_KERNELS_TABLE g_oBinClassifKernels_generic
+#include "metrics_kernels.hpp"
+#undef LV_BINCLASSIF_KERNELS_TABLE
+
+#define BINCLASSIF_PARALLEL_MIN_PIXELS  size_t(2*1024*1024) // smaller frames (times output count) are counted on the caller's thread only
+#define BINCLASSIF_PARALLEL_BLOCK_ROWS  64
+#define METRICS_REDUCE_MAX_THREADS      0 // children batch metrics are fetched in parallel at the topmost group level only (0 = hardware concurrency)
+
+namespace {
+
+    static_assert(lv::BinClassifKernels::Counter_TP==lv::BinClassif::Counter_TP && lv::BinClassifKernels::Counter_TN==lv::BinClassif::Counter_TN &&
+                  lv::BinClassifKernels::Counter_FP==lv::BinClassif::Counter_FP && lv::BinClassifKernels::Counter_FN==lv::BinClassif::Counter_FN &&
+                  lv::BinClassifKernels::Counter_SE==lv::BinClassif::Counter_SE && lv::BinClassifKernels::Counter_DC==lv::BinClassif::Counter_DC &&
+                  lv::BinClassifKernels::nCountersCount==lv::BinClassif::nCountersCount,"kernel counter indices must match the public ones");
+    static_assert(lv::BinClassifKernels::Label_Positive==DATASETUTILS_POSITIVE_VAL && lv::BinClassifKernels::Label_Negative==DATASETUTILS_NEGATIVE_VAL &&
+                  lv::BinClassifKernels::Label_OutOfScope==DATASETUTILS_OUTOFSCOPE_VAL && lv::BinClassifKernels::Label_Unknown==DATASETUTILS_UNKNOWN_VAL &&
+                  lv::BinClassifKernels::Label_Shadow==DATASETUTILS_SHADOW_VAL,"kernel label values must match the public ones");
+
+    /// returns the classification counting kernel table best suited for the current CPU (selected once, on first call)
+    const lv::BinClassifKernels& getBinClassifKernels() {
+        static const lv::BinClassifKernels& s_oKernels = lv::selectKernel<lv::BinClassifKernels>({{
+            &lv::g_oBinClassifKernels_generic,
+            &lv::g_oBinClassifKernels_sse4,
+            &lv::g_oBinClassifKernels_avx2,
+            &lv::g_oBinClassifKernels_avx512,
+        }});
+        return s_oKernels;
+    }
+
+} // namespace
 
 void lv::BinClassif::accumulate(const cv::Mat& oClassif, const cv::Mat& oGT, const cv::Mat& oROI) {
-    lvAssert_(!oClassif.empty() && oClassif.type()==CV_8UC1,"binary classifier results must be non-empty and of type 8UC1");
+    accumulate(&oClassif,1,oGT,oROI,this);
+}
+
+void lv::BinClassif::accumulate(const std::vector<cv::Mat>& vClassifs, const cv::Mat& oGT, const cv::Mat& oROI, std::vector<BinClassif>& vCounters) {
+    if(vCounters.empty())
+        vCounters.resize(vClassifs.size());
+    lvAssert_(vCounters.size()==vClassifs.size(),"counters array size must match classifier output array size");
+    if(!vClassifs.empty())
+        accumulate(vClassifs.data(),vClassifs.size(),oGT,oROI,vCounters.data());
+}
+
+void lv::BinClassif::accumulate(const cv::Mat* aClassifs, size_t nClassifs, const cv::Mat& oGT, const cv::Mat& oROI, BinClassif* aCounters) {
+    if(nClassifs==0)
+        return;
+    for(size_t nClassifIdx=0; nClassifIdx<nClassifs; ++nClassifIdx) {
+        const cv::Mat& oClassif = aClassifs[nClassifIdx];
+        lvAssert_(!oClassif.empty() && oClassif.type()==CV_8UC1,"binary classifier results must be non-empty and of type 8UC1");
+        lvAssert_(oClassif.size()==aClassifs[0].size(),"all classifier output sizes must match");
+    }
     lvAssert_(oGT.empty() || oGT.type()==CV_8UC1,"gt mat must be empty, or of type 8UC1")
     lvAssert_(oROI.empty() || oROI.type()==CV_8UC1,"ROI mat must be empty, or of type 8UC1");
-    lvAssert_((oGT.empty() || oClassif.size()==oGT.size()) && (oROI.empty() || oClassif.size()==oROI.size()),"all input mat sizes must match");
+    lvAssert_((oGT.empty() || aClassifs[0].size()==oGT.size()) && (oROI.empty() || aClassifs[0].size()==oROI.size()),"all input mat sizes must match");
     if(oGT.empty()) {
-        nDC += oClassif.size().area();
+        for(size_t nClassifIdx=0; nClassifIdx<nClassifs; ++nClassifIdx)
+            aCounters[nClassifIdx].nDC += aClassifs[nClassifIdx].size().area();
         return;
     }
-    const size_t step_row = oClassif.step.p[0];
-    for(size_t i = 0; i<(size_t)oClassif.rows; ++i) {
-        const size_t idx_nstep = step_row*i;
-        const uchar* input_step_ptr = oClassif.data+idx_nstep;
-        const uchar* gt_step_ptr = oGT.data+idx_nstep;
-        const uchar* roi_step_ptr = oROI.data+idx_nstep;
-        for(int j = 0; j<oClassif.cols; ++j) {
-            if(gt_step_ptr[j]!=DATASETUTILS_OUTOFSCOPE_VAL &&
-               gt_step_ptr[j]!=DATASETUTILS_UNKNOWN_VAL &&
-               (oROI.empty() || roi_step_ptr[j]!=DATASETUTILS_NEGATIVE_VAL)) {
-                if(input_step_ptr[j]==DATASETUTILS_POSITIVE_VAL) {
-                    if(gt_step_ptr[j]==DATASETUTILS_POSITIVE_VAL)
-                        ++nTP;
-                    else // gt_step_ptr[j]==s_nSegmNegative
-                        ++nFP;
-                }
-                else { // input_step_ptr[j]==s_nSegmNegative
-                    if(gt_step_ptr[j]==DATASETUTILS_POSITIVE_VAL)
-                        ++nFN;
-                    else // gt_step_ptr[j]==s_nSegmNegative
-                        ++nTN;
-                }
-                if(gt_step_ptr[j]==DATASETUTILS_SHADOW_VAL) {
-                    if(input_step_ptr[j]==DATASETUTILS_POSITIVE_VAL)
-                        ++nSE;
-                }
-            }
-            else
-                ++nDC;
+    const BinClassifKernels& oKernels = getBinClassifKernels();
+    const size_t nRows = (size_t)oGT.rows, nCols = (size_t)oGT.cols;
+    const auto lAccumulateRows = [&](size_t nRowBegin, size_t nRowEnd, uint64_t* anCounts) {
+        // all outputs are counted against each gt/ROI row while it is hot in cache
+        std::vector<const uchar*> vpClassifRows(nClassifs);
+        for(size_t nRowIdx=nRowBegin; nRowIdx<nRowEnd; ++nRowIdx) {
+            for(size_t nClassifIdx=0; nClassifIdx<nClassifs; ++nClassifIdx)
+                vpClassifRows[nClassifIdx] = aClassifs[nClassifIdx].ptr<uchar>((int)nRowIdx);
+            oKernels.accumulate_row(vpClassifRows.data(),nClassifs,oGT.ptr<uchar>((int)nRowIdx),oROI.empty()?nullptr:oROI.ptr<uchar>((int)nRowIdx),nCols,anCounts);
         }
+    };
+    std::vector<uint64_t> vnCounts(nClassifs*nCountersCount,0);
+    if(nRows*nCols*nClassifs<BINCLASSIF_PARALLEL_MIN_PIXELS)
+        lAccumulateRows(0,nRows,vnCounts.data());
+    else {
+        // large frames are split in row blocks with their own counters, which are summed afterwards
+        const size_t nBlocks = (nRows+BINCLASSIF_PARALLEL_BLOCK_ROWS-1)/BINCLASSIF_PARALLEL_BLOCK_ROWS;
+        std::vector<uint64_t> vnBlockCounts(nBlocks*vnCounts.size(),0);
+        lv::parallel_for(nBlocks,0,[&](size_t nBlockIdx) {
+            lAccumulateRows(nBlockIdx*BINCLASSIF_PARALLEL_BLOCK_ROWS,std::min((nBlockIdx+1)*BINCLASSIF_PARALLEL_BLOCK_ROWS,nRows),vnBlockCounts.data()+nBlockIdx*vnCounts.size());
+        });
+        for(size_t nBlockIdx=0; nBlockIdx<nBlocks; ++nBlockIdx)
+            for(size_t nCounterIdx=0; nCounterIdx<vnCounts.size(); ++nCounterIdx)
+                vnCounts[nCounterIdx] += vnBlockCounts[nBlockIdx*vnCounts.size()+nCounterIdx];
+    }
+    for(size_t nClassifIdx=0; nClassifIdx<nClassifs; ++nClassifIdx) {
+        const uint64_t* anCounts = vnCounts.data()+nClassifIdx*nCountersCount;
+        BinClassif& oCounters = aCounters[nClassifIdx];
+        oCounters.nTP += anCounts[Counter_TP];
+        oCounters.nTN += anCounts[Counter_TN];
+        oCounters.nFP += anCounts[Counter_FP];
+        oCounters.nFN += anCounts[Counter_FN];
+        oCounters.nSE += anCounts[Counter_SE];
+        oCounters.nDC += anCounts[Counter_DC];
     }
 }
 
@@ -261,3 +316,8 @@ lv::IMetricsCalculator_<lv::DatasetEval_BinaryClassifierArray>::IMetricsCalculat
         m_vMetrics(vm),m_vsStreamNames(vs) {
     lvAssert(m_vMetrics.size()==m_vsStreamNames.size());
 }
+
+void lv::IIMetricRetriever::parallelForBatches(size_t nBatches, const std::function<void(size_t)>& lFunc) {
+    // nested calls (i.e. from subgroups fetched by the workers) are serialized by lv::parallel_for itself
+    lv::parallel_for(nBatches,METRICS_REDUCE_MAX_THREADS,lFunc);
+}
@@ -0,0 +1,177 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// note: this private header is included by several translation units, each compiled for a different instruction set
+// level (see the datasets module's CMakeLists.txt); like the utils module's distance kernels, it must only include
+// intrinsics, plain C headers and the ISA-namespaced lv::SIMDVec_ wrappers, with all helpers kept in an anonymous
+// namespace; the counter indices and label values it needs are mirrored below (and checked against the public ones)
+
+#include "litiv/utils/simd.hpp"
+#include <climits>
+
+namespace lv {
+
+    /// table of binary classification counting kernels compiled for a given instruction set level
+    struct BinClassifKernels {
+        /// classification counter indices (mirrors Kernels::CountersList, see metrics.cpp)
+        enum CountersList {Counter_TP,Counter_TN,Counter_FP,Counter_FN,Counter_SE,Counter_DC,nCountersCount};
+        /// gt & classifier label values (mirrors the DATASETUTILS_*_VAL defines, see metrics.cpp)
+        enum LabelList : uchar {Label_Positive=255,Label_Negative=0,Label_OutOfScope=85,Label_Unknown=170,Label_Shadow=50};
+        /// accumulates the classification counts of the same row of several classifier outputs vs a shared gt row into consecutive counter sets indexed by BinClassif::CountersList (the ROI row may be null)
+        void (*accumulate_row)(const uchar* const* aaClassifs, size_t nClassifs, const uchar* aGT, const uchar* aROI, size_t nCols, uint64_t* anCounts);
+    };
+
+    extern const BinClassifKernels g_oBinClassifKernels_generic;
+    extern const BinClassifKernels g_oBinClassifKernels_sse4;
+    extern const BinClassifKernels g_oBinClassifKernels_avx2;
+    extern const BinClassifKernels g_oBinClassifKernels_avx512;
+
+} // namespace lv
+
+#ifdef LV_BINCLASSIF_KERNELS_TABLE
+
+namespace {
+
+    using Kernels = lv::BinClassifKernels;
+
+    /// max number of classifier outputs evaluated together against each gt vector (their lane-local counters must fit in registers; remainders go in groups of 2 and 1)
+    constexpr size_t s_nMaxClassifGroupSize = 4;
+
+#if LV_SIMD_SSE4
+    /// counts the classifications of all full vectors of a row for a group of outputs, starting at the given column (and returning the first one left); gt masks are only computed once per vector, and true negatives are left to the caller
+    template<typename TVec, size_t nGroupSize, bool bUseROI>
+    size_t accumulate_row_vec(const uchar* const* aaClassifs, const uchar* aGT, const uchar* aROI, size_t nCols, size_t nColIdx, uint64_t* anCounts) {
+        // comparison masks are all-ones (i.e. -1) where true, so subtracting them increments 8-bit lane-local counters,
+        // which are reduced via SAD before they can overflow (i.e. every 255 vectors)
+        constexpr size_t nMaxIters = UCHAR_MAX;
+        const TVec vPositive = TVec::set1(Kernels::Label_Positive);
+        const TVec vNegative = TVec::set1(Kernels::Label_Negative);
+        const TVec vOutOfScope = TVec::set1(Kernels::Label_OutOfScope);
+        const TVec vUnknown = TVec::set1(Kernels::Label_Unknown);
+        const TVec vShadow = TVec::set1(Kernels::Label_Shadow);
+        while(nColIdx+TVec::s_nLanes<=nCols) {
+            TVec avTP[nGroupSize], avFP[nGroupSize], avFN[nGroupSize], avSE[nGroupSize];
+            for(size_t nClassifIdx=0; nClassifIdx<nGroupSize; ++nClassifIdx)
+                avTP[nClassifIdx] = avFP[nClassifIdx] = avFN[nClassifIdx] = avSE[nClassifIdx] = TVec::zero();
+            TVec vDC = TVec::zero();
+            for(size_t nIter=0; nIter<nMaxIters && nColIdx+TVec::s_nLanes<=nCols; ++nIter, nColIdx+=TVec::s_nLanes) {
+                const TVec vGT = TVec::loadu(aGT+nColIdx);
+                TVec vDontCare = lv::cmpeq(vGT,vOutOfScope)|lv::cmpeq(vGT,vUnknown);
+                if(bUseROI)
+                    vDontCare |= lv::cmpeq(TVec::loadu(aROI+nColIdx),vNegative);
+                const TVec vGTPos = lv::cmpeq(vGT,vPositive);
+                const TVec vValidGTPos = lv::andnot(vGTPos,vDontCare);
+                const TVec vGTShadow = lv::cmpeq(vGT,vShadow);
+                vDC -= vDontCare;
+                for(size_t nClassifIdx=0; nClassifIdx<nGroupSize; ++nClassifIdx) {
+                    const TVec vClassifPos = lv::cmpeq(TVec::loadu(aaClassifs[nClassifIdx]+nColIdx),vPositive);
+                    const TVec vValidClassifPos = lv::andnot(vClassifPos,vDontCare);
+                    avTP[nClassifIdx] -= vValidClassifPos&vGTPos;
+                    avFP[nClassifIdx] -= lv::andnot(vValidClassifPos,vGTPos);
+                    avFN[nClassifIdx] -= lv::andnot(vValidGTPos,vClassifPos);
+                    avSE[nClassifIdx] -= vValidClassifPos&vGTShadow;
+                }
+            }
+            const uint64_t nDC = (uint64_t)vDC.hsum();
+            for(size_t nClassifIdx=0; nClassifIdx<nGroupSize; ++nClassifIdx) {
+                uint64_t* anClassifCounts = anCounts+nClassifIdx*Kernels::nCountersCount;
+                anClassifCounts[Kernels::Counter_TP] += (uint64_t)avTP[nClassifIdx].hsum();
+                anClassifCounts[Kernels::Counter_FP] += (uint64_t)avFP[nClassifIdx].hsum();
+                anClassifCounts[Kernels::Counter_FN] += (uint64_t)avFN[nClassifIdx].hsum();
+                anClassifCounts[Kernels::Counter_SE] += (uint64_t)avSE[nClassifIdx].hsum();
+                anClassifCounts[Kernels::Counter_DC] += nDC;
+            }
+        }
+        return nColIdx;
+    }
+
+    /// counts the classifications of all full vectors of a row for a group of outputs, with or without ROI (see accumulate_row_vec)
+    template<typename TVec, size_t nGroupSize>
+    size_t accumulate_row_simd(const uchar* const* aaClassifs, const uchar* aGT, const uchar* aROI, size_t nCols, size_t nColIdx, uint64_t* anCounts) {
+        if(aROI)
+            return accumulate_row_vec<TVec,nGroupSize,true>(aaClassifs,aGT,aROI,nCols,nColIdx,anCounts);
+        return accumulate_row_vec<TVec,nGroupSize,false>(aaClassifs,aGT,aROI,nCols,nColIdx,anCounts);
+    }
+#endif //LV_SIMD_SSE4
+
+    /// accumulates the classification counts of a row for a group of outputs (branch-free, vectorized at the widest available width)
+    template<size_t nGroupSize>
+    void accumulate_row_group(const uchar* const* aaClassifs, const uchar* aGT, const uchar* aROI, size_t nCols, uint64_t* anCounts) {
+        uint64_t anRowCounts[nGroupSize*Kernels::nCountersCount] = {};
+        size_t nColIdx = 0;
+#if LV_SIMD_AVX512
+        nColIdx = accumulate_row_simd<lv::SIMDVec_<uchar,512>,nGroupSize>(aaClassifs,aGT,aROI,nCols,nColIdx,anRowCounts);
+#endif //LV_SIMD_AVX512
+#if LV_SIMD_AVX2
+        nColIdx = accumulate_row_simd<lv::SIMDVec_<uchar,256>,nGroupSize>(aaClassifs,aGT,aROI,nCols,nColIdx,anRowCounts);
+#endif //LV_SIMD_AVX2
+#if LV_SIMD_SSE4
+        nColIdx = accumulate_row_simd<lv::SIMDVec_<uchar,128>,nGroupSize>(aaClassifs,aGT,aROI,nCols,nColIdx,anRowCounts);
+#endif //LV_SIMD_SSE4
+        // leftover columns are counted per output with register-held counters (byte loads could alias counter arrays)
+        for(size_t nClassifIdx=0; nClassifIdx<nGroupSize; ++nClassifIdx) {
+            const uchar* aClassif = aaClassifs[nClassifIdx];
+            uint64_t nTP = 0, nFP = 0, nFN = 0, nSE = 0, nDC = 0;
+            for(size_t nTailColIdx=nColIdx; nTailColIdx<nCols; ++nTailColIdx) {
+                const uchar nGT = aGT[nTailColIdx];
+                const uint64_t nDontCare = uint64_t(nGT==Kernels::Label_OutOfScope)|uint64_t(nGT==Kernels::Label_Unknown)|uint64_t(aROI && aROI[nTailColIdx]==Kernels::Label_Negative);
+                const uint64_t nValid = nDontCare^1;
+                const uint64_t nGTPos = uint64_t(nGT==Kernels::Label_Positive);
+                const uint64_t nClassifPos = uint64_t(aClassif[nTailColIdx]==Kernels::Label_Positive);
+                nTP += nClassifPos&nGTPos&nValid;
+                nFP += nClassifPos&(nGTPos^1)&nValid;
+                nFN += (nClassifPos^1)&nGTPos&nValid;
+                nSE += nClassifPos&uint64_t(nGT==Kernels::Label_Shadow)&nValid;
+                nDC += nDontCare;
+            }
+            uint64_t* anClassifCounts = anRowCounts+nClassifIdx*Kernels::nCountersCount;
+            anClassifCounts[Kernels::Counter_TP] += nTP;
+            anClassifCounts[Kernels::Counter_FP] += nFP;
+            anClassifCounts[Kernels::Counter_FN] += nFN;
+            anClassifCounts[Kernels::Counter_SE] += nSE;
+            anClassifCounts[Kernels::Counter_DC] += nDC;
+        }
+        for(size_t nClassifIdx=0; nClassifIdx<nGroupSize; ++nClassifIdx) {
+            const uint64_t* anClassifRowCounts = anRowCounts+nClassifIdx*Kernels::nCountersCount;
+            uint64_t* anClassifCounts = anCounts+nClassifIdx*Kernels::nCountersCount;
+            // every pixel is exactly one of TP/FP/FN/TN/DC, so true negatives are whatever remains
+            anClassifCounts[Kernels::Counter_TN] += uint64_t(nCols)-anClassifRowCounts[Kernels::Counter_TP]-anClassifRowCounts[Kernels::Counter_FP]-anClassifRowCounts[Kernels::Counter_FN]-anClassifRowCounts[Kernels::Counter_DC];
+            for(size_t nCounterIdx=0; nCounterIdx<Kernels::nCountersCount; ++nCounterIdx)
+                if(nCounterIdx!=Kernels::Counter_TN)
+                    anClassifCounts[nCounterIdx] += anClassifRowCounts[nCounterIdx];
+        }
+    }
+
+    /// accumulates the classification counts of the same row of several outputs vs a shared gt row, in groups sharing each gt/ROI load
+    void accumulate_row_impl(const uchar* const* aaClassifs, size_t nClassifs, const uchar* aGT, const uchar* aROI, size_t nCols, uint64_t* anCounts) {
+        size_t nClassifIdx = 0;
+        for(; nClassifIdx+s_nMaxClassifGroupSize<=nClassifs; nClassifIdx+=s_nMaxClassifGroupSize)
+            accumulate_row_group<s_nMaxClassifGroupSize>(aaClassifs+nClassifIdx,aGT,aROI,nCols,anCounts+nClassifIdx*Kernels::nCountersCount);
+        if(nClassifIdx+2<=nClassifs) {
+            accumulate_row_group<2>(aaClassifs+nClassifIdx,aGT,aROI,nCols,anCounts+nClassifIdx*Kernels::nCountersCount);
+            nClassifIdx += 2;
+        }
+        if(nClassifIdx<nClassifs)
+            accumulate_row_group<1>(aaClassifs+nClassifIdx,aGT,aROI,nCols,anCounts+nClassifIdx*Kernels::nCountersCount);
+    }
+
+} // namespace
+
+const lv::BinClassifKernels lv::LV_BINCLASSIF_KERNELS_TABLE = {&accumulate_row_impl};
+
+#endif //def(LV_BINCLASSIF_KERNELS_TABLE)
@@ -24,12 +24,363 @@
 #define PRECACHE_QUERY_TIMEOUT_MS          10
 #define PRECACHE_QUERY_END_TIMEOUT_MS      500
 #define PRECACHE_REFILL_TIMEOUT_MS         10000
+#define PRECACHE_MAX_DECODE_THREADS        4
+#define PRECACHE_DEFAULT_LOOKBEHIND        8
+#define DATAWRITER_RING_SIZE               1024 // max packet count in queue (must be a power of two)
+#define DATAWRITER_WAIT_TIMEOUT_MS         10
+#define DATASET_PARSE_MAX_THREADS          8 // per group level; parsing is mostly bound by filesystem latency, not cpu
+#define VIDEOREADER_MAX_DECODE_THREADS     8
+#define VIDEOREADER_MIN_SEGMENT_SIZE       64 // consecutive gops are merged up to this frame count, as each segment costs one seek
+#define VIDEOREADER_BUFFER_SIZE            size_t(256*1024*1024) // decode-ahead memory budget (in bytes)
+#define VIDEOREADER_QUERY_TIMEOUT_MS       10
+#define HAVE_VIDEOREADER_DEMUX             ((CV_VERSION_MAJOR>4) || (CV_VERSION_MAJOR==4 && CV_VERSION_MINOR>=7)) // raw stream demuxing w/ keyframe flags (ffmpeg backend)
 #if (!(defined(_M_X64) || defined(__amd64__)) && CACHE_MAX_SIZE_GB>2)
 #error "Cache max size exceeds system limit (x86)."
 #endif //(!(defined(_M_X64) || defined(__amd64__)) && CACHE_MAX_SIZE_GB>2)
 #define CACHE_MAX_SIZE size_t(((CACHE_MAX_SIZE_GB*1024)*1024)*1024)
 #define CACHE_MIN_SIZE size_t(((10)*1024)*1024) // 10mb
 
+namespace {
+
+    /// decodes an image file into the given packet, reusing its memory if the decoded size/type match (releases it on failure)
+    void imreadInto(const std::string& sFilePath, int nFlags, cv::Mat& oPacket) {
+        static thread_local std::vector<uchar> s_vcFileBuffer;
+        std::ifstream oFile(sFilePath,std::ios::in|std::ios::binary|std::ios::ate);
+        if(!oFile.is_open()) {
+            oPacket.release();
+            return;
+        }
+        s_vcFileBuffer.resize((size_t)oFile.tellg());
+        oFile.seekg(0);
+        if(s_vcFileBuffer.empty() || !oFile.read((char*)s_vcFileBuffer.data(),(std::streamsize)s_vcFileBuffer.size()) || cv::imdecode(s_vcFileBuffer,nFlags,&oPacket).empty())
+            oPacket.release();
+    }
+
+    /// packed cache file header (followed by the packet table, the input name table, and 64-byte-aligned packet data)
+    struct PackedCacheHeader {
+        char acMagic[8];
+        uint32_t nVersion;
+        uint32_t nFlags;
+        double dScaleFactor;
+        uint64_t nInputCount,nGTCount,nNameTableSize;
+    };
+
+    /// packed cache file packet table entry (offset is relative to the beginning of the file; empty packets have null sizes)
+    struct PackedCacheEntry {
+        uint64_t nOffset;
+        int32_t nRows,nCols,nType,nUnused;
+    };
+
+    /// packed cache file format identifiers & packet data alignment
+    constexpr char s_acPackedCacheMagic[8] = {'L','V','P','A','C','K','E','D'};
+    constexpr uint32_t s_nPackedCacheVersion = 1;
+    constexpr size_t s_nPackedCacheAlign = 64;
+
+    /// returns the index of the lowest set bit of a non-null value
+    inline int getLowestBitIdx(uint nVal) {
+#if defined(_MSC_VER)
+        unsigned long nIdx;
+        _BitScanForward(&nIdx,nVal);
+        return (int)nIdx;
+#else //(!defined(_MSC_VER))
+        return __builtin_ctz(nVal);
+#endif //(!defined(_MSC_VER))
+    }
+
+    /// packs a row of 0/255 mask values to 1 bit per pixel (lsb first); returns false if any other value is found
+    bool packMaskRow(const uchar* pRow, size_t nCols, uchar* pPacked) {
+        bool bBinary = true;
+        size_t nColIdx = 0;
+#if HAVE_SSE2
+        const __m128i anZero = _mm_setzero_si128(), anFull = _mm_set1_epi8(-1);
+        for(; nColIdx+16<=nCols; nColIdx+=16) {
+            const __m128i anVals = _mm_loadu_si128((const __m128i*)(pRow+nColIdx));
+            const __m128i anFullMask = _mm_cmpeq_epi8(anVals,anFull);
+            bBinary &= _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(anVals,anZero),anFullMask))==0xFFFF;
+            const int nBits = _mm_movemask_epi8(anFullMask);
+            pPacked[nColIdx/8] = uchar(nBits);
+            pPacked[nColIdx/8+1] = uchar(nBits>>8);
+        }
+#endif //HAVE_SSE2
+        std::fill(pPacked+nColIdx/8,pPacked+(nCols+7)/8,uchar(0));
+        for(; nColIdx<nCols; ++nColIdx) {
+            bBinary &= (pRow[nColIdx]==0 || pRow[nColIdx]==UCHAR_MAX);
+            if(pRow[nColIdx])
+                pPacked[nColIdx/8] |= uchar(1<<(nColIdx%8));
+        }
+        return bBinary;
+    }
+
+    /// unpacks a row of 1-bit pixels (lsb first) to 0/255 mask values
+    void unpackMaskRow(const uchar* pPacked, size_t nCols, uchar* pRow) {
+        size_t nColIdx = 0;
+#if HAVE_SSE2
+        const __m128i anBitMask = _mm_set_epi8(-128,64,32,16,8,4,2,1,-128,64,32,16,8,4,2,1);
+        for(; nColIdx+16<=nCols; nColIdx+=16) {
+            // broadcasts each packed byte over 8 lanes, then isolates one bit per lane
+            const uint64_t nLow = pPacked[nColIdx/8]*0x0101010101010101ULL, nHigh = pPacked[nColIdx/8+1]*0x0101010101010101ULL;
+            const __m128i anBits = _mm_and_si128(_mm_set_epi64x((long long)nHigh,(long long)nLow),anBitMask);
+            _mm_storeu_si128((__m128i*)(pRow+nColIdx),_mm_cmpeq_epi8(anBits,anBitMask));
+        }
+#endif //HAVE_SSE2
+        for(; nColIdx<nCols; ++nColIdx)
+            pRow[nColIdx] = ((pPacked[nColIdx/8]>>(nColIdx%8))&1)?UCHAR_MAX:uchar(0);
+    }
+
+    /// returns the end position of the run of 'nVal' values starting at the given column in a row
+    size_t findMaskRunEnd(const uchar* pRow, size_t nColIdx, size_t nCols, uchar nVal) {
+#if HAVE_SSE2
+        const __m128i anVal = _mm_set1_epi8((char)nVal);
+        for(; nColIdx+16<=nCols; nColIdx+=16) {
+            const int nMatches = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(pRow+nColIdx)),anVal));
+            if(nMatches!=0xFFFF)
+                return nColIdx+getLowestBitIdx(uint(~nMatches)&0xFFFF);
+        }
+#endif //HAVE_SSE2
+        while(nColIdx<nCols && pRow[nColIdx]==nVal)
+            ++nColIdx;
+        return nColIdx;
+    }
+
+    /// mask blob header (followed by packed rows, or by per-row (value,varint length) run pairs)
+    struct MaskBlobHeader {
+        uchar nMode;
+        uchar anUnused[3];
+        int32_t nRows,nCols;
+    };
+
+    /// mask blob encoding modes
+    enum MaskBlobMode {
+        MaskBlob_BitPacked=0,
+        MaskBlob_RunLength=1,
+    };
+
+    /// mask container format identifiers & record/footer layouts
+    constexpr char s_acMaskArchiveMagic[8] = {'L','V','M','A','S','K','A','R'};
+    constexpr char s_acMaskArchiveIndexMagic[8] = {'L','V','M','A','S','K','I','X'};
+    constexpr uint32_t s_nMaskArchiveRecordMagic = 0x524D564C; // 'LVMR'
+    struct MaskArchiveRecordHeader {
+        uint32_t nMagic;
+        uint32_t nSize;
+        uint64_t nIdx;
+    };
+    struct MaskArchiveIndexEntry {
+        uint64_t nIdx;
+        uint64_t nOffset;
+        uint64_t nSize;
+    };
+    struct MaskArchiveFooter {
+        uint64_t nIndexOffset;
+        uint64_t nEntryCount;
+        char acMagic[8];
+    };
+
+    /// dataset index file identifiers & header layout (followed by directory, image, mask and video entries)
+    constexpr char s_acDataIndexMagic[8] = {'L','V','D','S','I','N','D','X'};
+    constexpr uint32_t s_nDataIndexVersion = 2;
+    struct DataIndexHeader {
+        char acMagic[8];
+        uint32_t nVersion;
+        uint32_t nUnused;
+        uint64_t nDirCount,nImageCount,nMaskCount,nVideoCount;
+    };
+
+    /// appends a plain value to a dataset index buffer
+    template<typename T>
+    void writeIndexValue(std::vector<char>& vBuffer, const T& tVal) {
+        static_assert(std::is_trivial<T>::value,"only trivial types can be written as plain values");
+        vBuffer.insert(vBuffer.end(),(const char*)&tVal,(const char*)&tVal+sizeof(T));
+    }
+
+    /// appends a length-prefixed string to a dataset index buffer
+    void writeIndexValue(std::vector<char>& vBuffer, const std::string& sVal) {
+        writeIndexValue(vBuffer,(uint32_t)sVal.size());
+        vBuffer.insert(vBuffer.end(),sVal.begin(),sVal.end());
+    }
+
+    /// appends a length-prefixed string array to a dataset index buffer
+    void writeIndexValue(std::vector<char>& vBuffer, const std::vector<std::string>& vsVals) {
+        writeIndexValue(vBuffer,(uint32_t)vsVals.size());
+        for(const std::string& sVal : vsVals)
+            writeIndexValue(vBuffer,sVal);
+    }
+
+    /// appends a length-prefixed byte array to a dataset index buffer
+    void writeIndexValue(std::vector<char>& vBuffer, const std::vector<uchar>& vVals) {
+        writeIndexValue(vBuffer,(uint32_t)vVals.size());
+        vBuffer.insert(vBuffer.end(),vVals.begin(),vVals.end());
+    }
+
+    /// appends a length-prefixed 64-bit integer array to a dataset index buffer
+    void writeIndexValue(std::vector<char>& vBuffer, const std::vector<uint64_t>& vnVals) {
+        writeIndexValue(vBuffer,(uint32_t)vnVals.size());
+        vBuffer.insert(vBuffer.end(),(const char*)vnVals.data(),(const char*)(vnVals.data()+vnVals.size()));
+    }
+
+    /// bounds-checked reader for dataset index buffers (every read returns false once the buffer is exhausted)
+    struct DataIndexReader {
+        const char* pCurr;
+        const char* pEnd;
+        template<typename T>
+        bool read(T& tVal) {
+            static_assert(std::is_trivial<T>::value,"only trivial types can be read as plain values");
+            if(size_t(pEnd-pCurr)<sizeof(T))
+                return false;
+            std::memcpy(&tVal,pCurr,sizeof(T));
+            pCurr += sizeof(T);
+            return true;
+        }
+        bool read(std::string& sVal) {
+            uint32_t nSize;
+            if(!read(nSize) || size_t(pEnd-pCurr)<nSize)
+                return false;
+            sVal.assign(pCurr,nSize);
+            pCurr += nSize;
+            return true;
+        }
+        bool read(std::vector<std::string>& vsVals) {
+            uint32_t nCount;
+            if(!read(nCount) || size_t(pEnd-pCurr)/sizeof(uint32_t)<nCount)
+                return false;
+            vsVals.resize(nCount);
+            for(std::string& sVal : vsVals)
+                if(!read(sVal))
+                    return false;
+            return true;
+        }
+        bool read(std::vector<uchar>& vVals) {
+            uint32_t nSize;
+            if(!read(nSize) || size_t(pEnd-pCurr)<nSize)
+                return false;
+            vVals.assign((const uchar*)pCurr,(const uchar*)pCurr+nSize);
+            pCurr += nSize;
+            return true;
+        }
+        bool read(std::vector<uint64_t>& vnVals) {
+            uint32_t nCount;
+            if(!read(nCount) || size_t(pEnd-pCurr)/sizeof(uint64_t)<nCount)
+                return false;
+            vnVals.resize(nCount);
+            std::memcpy(vnVals.data(),pCurr,nCount*sizeof(uint64_t));
+            pCurr += nCount*sizeof(uint64_t);
+            return true;
+        }
+    };
+
+    /// returns the flags that packets cached for a given loader should have been transformed with
+    uint32_t getPackedCacheFlags(const lv::IIDataLoader& oLoader) {
+        return uint32_t(oLoader.is4ByteAligned())|(uint32_t(oLoader.isGrayscale())<<1);
+    }
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+constexpr size_t lv::LatencyHistogram::s_nSubBucketBits;
+constexpr size_t lv::LatencyHistogram::s_nSubBucketCount;
+constexpr size_t lv::LatencyHistogram::s_nMaxShift;
+constexpr size_t lv::LatencyHistogram::s_nBucketCount;
+
+lv::LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+lv::LatencyHistogram::LatencyHistogram(const LatencyHistogram& o) {
+    reset();
+    merge(o);
+}
+
+lv::LatencyHistogram& lv::LatencyHistogram::operator=(const LatencyHistogram& o) {
+    if(this!=&o) {
+        reset();
+        merge(o);
+    }
+    return *this;
+}
+
+size_t lv::LatencyHistogram::getBucketIdx(uint64_t nValue) {
+    // values below 2*s_nSubBucketCount get exact buckets; above, each power-of-two range is split in s_nSubBucketCount linear buckets
+    if(nValue<2*s_nSubBucketCount)
+        return (size_t)nValue;
+    const size_t nShift = std::min((size_t)std::ilogb((double)nValue)-s_nSubBucketBits,s_nMaxShift);
+    const size_t nSubBucketIdx = std::min((size_t)(nValue>>nShift),2*s_nSubBucketCount-1)-s_nSubBucketCount;
+    return 2*s_nSubBucketCount+(nShift-1)*s_nSubBucketCount+nSubBucketIdx;
+}
+
+uint64_t lv::LatencyHistogram::getBucketUpperValue(size_t nBucketIdx) {
+    if(nBucketIdx<2*s_nSubBucketCount)
+        return (uint64_t)nBucketIdx;
+    const size_t nShift = (nBucketIdx-2*s_nSubBucketCount)/s_nSubBucketCount+1;
+    const uint64_t nSubBucketVal = s_nSubBucketCount+(nBucketIdx-2*s_nSubBucketCount)%s_nSubBucketCount;
+    return ((nSubBucketVal+1)<<nShift)-1;
+}
+
+void lv::LatencyHistogram::record(double dSeconds) {
+    const uint64_t nMaxValue = getBucketUpperValue(s_nBucketCount-1);
+    const uint64_t nValue = (dSeconds>0.0)?(uint64_t)std::min(std::round(dSeconds*1e6),(double)nMaxValue):uint64_t(0);
+    m_anBucketCounts[getBucketIdx(nValue)].fetch_add(1,std::memory_order_relaxed);
+    m_nTotalCount.fetch_add(1,std::memory_order_relaxed);
+    uint64_t nCurrMaxValue = m_nMaxValue.load(std::memory_order_relaxed);
+    while(nValue>nCurrMaxValue && !m_nMaxValue.compare_exchange_weak(nCurrMaxValue,nValue,std::memory_order_relaxed)) {}
+}
+
+void lv::LatencyHistogram::merge(const LatencyHistogram& o) {
+    for(size_t nBucketIdx=0; nBucketIdx<s_nBucketCount; ++nBucketIdx) {
+        const uint64_t nCount = o.m_anBucketCounts[nBucketIdx].load(std::memory_order_relaxed);
+        if(nCount)
+            m_anBucketCounts[nBucketIdx].fetch_add(nCount,std::memory_order_relaxed);
+    }
+    m_nTotalCount.fetch_add(o.m_nTotalCount.load(std::memory_order_relaxed),std::memory_order_relaxed);
+    const uint64_t nOtherMaxValue = o.m_nMaxValue.load(std::memory_order_relaxed);
+    uint64_t nCurrMaxValue = m_nMaxValue.load(std::memory_order_relaxed);
+    while(nOtherMaxValue>nCurrMaxValue && !m_nMaxValue.compare_exchange_weak(nCurrMaxValue,nOtherMaxValue,std::memory_order_relaxed)) {}
+}
+
+void lv::LatencyHistogram::subtract(const LatencyHistogram& o) {
+    uint64_t nTotalCount = 0, nMaxValue = 0;
+    for(size_t nBucketIdx=0; nBucketIdx<s_nBucketCount; ++nBucketIdx) {
+        const uint64_t nCount = m_anBucketCounts[nBucketIdx].load(std::memory_order_relaxed);
+        const uint64_t nNewCount = nCount-std::min(o.m_anBucketCounts[nBucketIdx].load(std::memory_order_relaxed),nCount);
+        m_anBucketCounts[nBucketIdx].store(nNewCount,std::memory_order_relaxed);
+        nTotalCount += nNewCount;
+        if(nNewCount)
+            nMaxValue = getBucketUpperValue(nBucketIdx);
+    }
+    m_nTotalCount.store(nTotalCount,std::memory_order_relaxed);
+    m_nMaxValue.store(std::min(m_nMaxValue.load(std::memory_order_relaxed),nMaxValue),std::memory_order_relaxed);
+}
+
+void lv::LatencyHistogram::reset() {
+    for(std::atomic<uint64_t>& nCount : m_anBucketCounts)
+        nCount.store(0,std::memory_order_relaxed);
+    m_nTotalCount.store(0,std::memory_order_relaxed);
+    m_nMaxValue.store(0,std::memory_order_relaxed);
+}
+
+double lv::LatencyHistogram::getPercentile(double dPercentile) const {
+    // the total count is summed from the buckets themselves, as concurrent records might have updated them after the total was read
+    uint64_t nTotalCount = 0;
+    for(const std::atomic<uint64_t>& nCount : m_anBucketCounts)
+        nTotalCount += nCount.load(std::memory_order_relaxed);
+    if(nTotalCount==0)
+        return 0.0;
+    const uint64_t nRank = std::max((uint64_t)std::ceil(std::min(std::max(dPercentile,0.0),100.0)*nTotalCount/100.0),uint64_t(1));
+    const uint64_t nMaxValue = m_nMaxValue.load(std::memory_order_relaxed);
+    uint64_t nCumulCount = 0;
+    for(size_t nBucketIdx=0; nBucketIdx<s_nBucketCount; ++nBucketIdx) {
+        nCumulCount += m_anBucketCounts[nBucketIdx].load(std::memory_order_relaxed);
+        if(nCumulCount>=nRank)
+            return std::min(getBucketUpperValue(nBucketIdx),nMaxValue)/1e6;
+    }
+    return nMaxValue/1e6;
+}
+
+double lv::LatencyHistogram::getMax() const {
+    return m_nMaxValue.load(std::memory_order_relaxed)/1e6;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -113,6 +464,10 @@ lv::IDataHandlerConstPtr lv::DataHandler::getParent() const {
     return m_oParent.shared_from_this();
 }
 
+lv::DataIndexCache& lv::DataHandler::getIndexCache() const {
+    return m_oRoot.getIndexCache();
+}
+
 bool lv::DataHandler::isRoot() const {
     return false;
 }
@@ -188,6 +543,15 @@ double lv::DataGroupHandler::getFinalProcessTime() {
     return lv::accumulateMembers<double,IDataHandlerPtr>(getBatches(true),[](const IDataHandlerPtr& p){return p->getFinalProcessTime();});
 }
 
+void lv::DataGroupHandler::mergeLatencyHistogram(LatencyHistogram& oHist) const {
+    for(const auto& pBatch : getBatches(true))
+        pBatch->mergeLatencyHistogram(oHist);
+}
+
+size_t lv::DataGroupHandler::getMetricsRevision() const {
+    return lv::accumulateMembers<size_t,IDataHandlerPtr>(getBatches(true),[](const IDataHandlerPtr& p){return p->getMetricsRevision();});
+}
+
 void lv::DataGroupHandler::resetMetrics() {
     for(auto& pBatch : getBatches(true))
         pBatch->resetMetrics();
@@ -246,50 +610,256 @@ void lv::DataGroupHandler::parseData() {
     m_vpBatches.clear();
     m_bIsBare = true;
     if(!lv::string_contains_token(getName(),getSkippedDirTokens())) {
-        std::cout << "\tParsing directory '" << getDataPath() << "' for work group '" << getName() << "'..." << std::endl;
+        // note: sibling groups are parsed concurrently, so the message is assembled first to avoid interleaving
+        std::cout << (std::string("\tParsing directory '")+getDataPath()+"' for work group '"+getName()+"'...\n") << std::flush;
         std::vector<std::string> vsWorkBatchPaths;
         // by default, all subdirs are considered work batch directories (if none, the category directory itself is a batch, and 'bare')
-        lv::GetSubDirsFromDir(getDataPath(),vsWorkBatchPaths);
+        getIndexCache().getSubDirsFromDir(getDataPath(),vsWorkBatchPaths);
         if(vsWorkBatchPaths.empty())
             m_vpBatches.push_back(createWorkBatch(getName(),getRelativePath()));
         else {
             m_bIsBare = false;
+            std::vector<std::pair<std::string,std::string>> vsBatchNamesAndPaths;
             for(const auto& sPathIter : vsWorkBatchPaths) {
                 const size_t nLastSlashPos = sPathIter.find_last_of("/\\");
                 const std::string sNewBatchName = nLastSlashPos==std::string::npos?sPathIter:sPathIter.substr(nLastSlashPos+1);
                 if(!lv::string_contains_token(sNewBatchName,getSkippedDirTokens()))
-                    m_vpBatches.push_back(createWorkBatch(sNewBatchName,getRelativePath()+lv::AddDirSlashIfMissing(sNewBatchName)));
+                    vsBatchNamesAndPaths.emplace_back(sNewBatchName,getRelativePath()+lv::AddDirSlashIfMissing(sNewBatchName));
             }
+            m_vpBatches = createWorkBatches(vsBatchNamesAndPaths);
         }
     }
 }
 
+lv::IDataHandlerPtrArray lv::DataGroupHandler::createWorkBatches(const std::vector<std::pair<std::string,std::string>>& vsBatchNamesAndPaths) const {
+    lvDbgExceptionWatch;
+    IDataHandlerPtrArray vpBatches(vsBatchNamesAndPaths.size());
+    std::vector<std::exception_ptr> vpExceptions(vsBatchNamesAndPaths.size());
+    // each batch owns its slot, so the resulting order never depends on scheduling; failures are collected instead of aborting siblings
+    lv::parallel_for(vsBatchNamesAndPaths.size(),DATASET_PARSE_MAX_THREADS,[&](size_t nBatchIdx) {
+        try {
+            vpBatches[nBatchIdx] = createWorkBatch(vsBatchNamesAndPaths[nBatchIdx].first,vsBatchNamesAndPaths[nBatchIdx].second);
+        }
+        catch(...) {
+            vpExceptions[nBatchIdx] = std::current_exception();
+        }
+    });
+    size_t nFailedBatchCount = 0;
+    std::exception_ptr pFirstException;
+    std::string sErrorMessages;
+    for(size_t nBatchIdx=0; nBatchIdx<vpExceptions.size(); ++nBatchIdx) {
+        if(!vpExceptions[nBatchIdx])
+            continue;
+        ++nFailedBatchCount;
+        if(!pFirstException)
+            pFirstException = vpExceptions[nBatchIdx];
+        sErrorMessages += "\n\t'"+vsBatchNamesAndPaths[nBatchIdx].first+"': ";
+        try {
+            std::rethrow_exception(vpExceptions[nBatchIdx]);
+        }
+        catch(const std::exception& e) {
+            sErrorMessages += e.what();
+        }
+        catch(...) {
+            sErrorMessages += "unknown error";
+        }
+    }
+    if(nFailedBatchCount==1)
+        std::rethrow_exception(pFirstException);
+    else if(nFailedBatchCount>1)
+        lvError_("failed to parse %d work batches in '%s':%s",(int)nFailedBatchCount,getDataPath().c_str(),sErrorMessages.c_str());
+    return vpBatches;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-lv::DataPrecacher::DataPrecacher(std::function<const cv::Mat&(size_t)> lDataLoaderCallback) :
-        m_lCallback(lDataLoaderCallback) {
+lv::BatchScheduler::BatchScheduler(size_t nWorkers) :
+        m_nWorkers(nWorkers?nWorkers:std::max(size_t(std::thread::hardware_concurrency()),size_t(1))),m_bStopping(false) {
+    m_vhWorkers.reserve(m_nWorkers);
+    for(size_t nWorkerIdx=0; nWorkerIdx<m_nWorkers; ++nWorkerIdx)
+        m_vhWorkers.emplace_back(&BatchScheduler::workerLoop,this);
+}
+
+lv::BatchScheduler::~BatchScheduler() {
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        m_bStopping = true;
+    }
+    m_oJobSync.notify_all();
+    for(std::thread& oWorker : m_vhWorkers)
+        oWorker.join();
+}
+
+void lv::BatchScheduler::workerLoop() {
+    std::unique_lock<std::mutex> oLock(m_oMutex);
+    while(true) {
+        m_oJobSync.wait(oLock,[&]{return m_bStopping || !m_qJobs.empty();});
+        if(m_qJobs.empty())
+            return;
+        const std::function<void()> lJob = std::move(m_qJobs.front());
+        m_qJobs.pop();
+        oLock.unlock();
+        lJob(); // never throws, as exceptions are forwarded to 'run' by the job itself
+        oLock.lock();
+    }
+}
+
+std::string lv::BatchScheduler::getThroughputKey(const IDataHandler& oBatch) {
+    const IDataHandlerConstPtr pParent = oBatch.getParent();
+    return "/"+(pParent?pParent->getRelativePath():std::string()); // never empty, as that is the global key
+}
+
+double lv::BatchScheduler::getExpectedDuration(const IDataHandler& oBatch) const {
+    const double dLoad = oBatch.getExpectedLoad();
+    const std::string sThroughputKey = getThroughputKey(oBatch);
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    return getExpectedDuration(sThroughputKey,dLoad);
+}
+
+double lv::BatchScheduler::getExpectedDuration(const std::string& sThroughputKey, double dLoad) const {
+    // measurements on similar jobs are preferred, as load estimates are only comparable within similar data
+    auto pThroughput = m_mThroughputs.find(sThroughputKey);
+    if(pThroughput==m_mThroughputs.end())
+        pThroughput = m_mThroughputs.find(std::string());
+    if(pThroughput==m_mThroughputs.end() || pThroughput->second.first<=0.0 || pThroughput->second.second<=0.0)
+        return dLoad;
+    return dLoad*pThroughput->second.second/pThroughput->second.first;
+}
+
+void lv::BatchScheduler::run(const IDataHandlerPtrArray& vpBatches, const TaskFunc& lTask) {
+    lvAssert_(lTask,"batch scheduler requires a valid task callback");
+    // expected loads can be costly to compute (e.g. roi pixel counts), so they are only fetched once here
+    IDataHandlerPtrArray vpValidBatches;
+    std::vector<double> vdLoads;
+    std::vector<std::string> vsThroughputKeys;
+    for(const IDataHandlerPtr& pBatch : vpBatches) {
+        if(pBatch) {
+            vpValidBatches.push_back(pBatch);
+            vdLoads.push_back(pBatch->getExpectedLoad());
+            vsThroughputKeys.push_back(getThroughputKey(*pBatch));
+        }
+    }
+    run(vdLoads,vsThroughputKeys,[&](size_t nJobIdx, size_t nThreadBudget, const std::string& sWorkerName) {
+        lTask(vpValidBatches[nJobIdx],nThreadBudget,sWorkerName);
+    });
+}
+
+void lv::BatchScheduler::run(const std::vector<double>& vdLoads, const std::vector<std::string>& vsThroughputKeys, const JobFunc& lJob) {
+    lvDbgExceptionWatch;
+    lvAssert_(lJob,"batch scheduler requires a valid job callback");
+    lvAssert_(vdLoads.size()==vsThroughputKeys.size(),"job load and throughput key counts mismatch");
+    const size_t nTotJobs = vdLoads.size();
+    std::vector<size_t> vnPendingJobs(nTotJobs),vnRunningJobs;
+    std::iota(vnPendingJobs.begin(),vnPendingJobs.end(),size_t(0));
+    // budgets are read lock-free by the running jobs (through 'lv::getThreadBudget'), but only ever modified with the mutex held
+    std::unique_ptr<std::atomic_size_t[]> anThreadBudgets(new std::atomic_size_t[std::max(nTotJobs,size_t(1))]);
+    size_t nFreeThreads = m_nWorkers, nStartedJobs = 0;
+    std::exception_ptr pJobException;
+    std::condition_variable oDoneSync;
+    std::unique_lock<std::mutex> oLock(m_oMutex);
+    const auto lGetExpectedDuration = [&](size_t nJobIdx) {
+        return getExpectedDuration(vsThroughputKeys[nJobIdx],vdLoads[nJobIdx]);
+    };
+    while((!vnPendingJobs.empty() && !pJobException) || !vnRunningJobs.empty()) {
+        while(!vnPendingJobs.empty() && !pJobException && nFreeThreads>0) {
+            // longest-processing-time-first, using the latest throughput measurements (the order may change as jobs finish)
+            const auto pNextJob = std::max_element(vnPendingJobs.begin(),vnPendingJobs.end(),[&](size_t a, size_t b) {
+                return lGetExpectedDuration(a)<lGetExpectedDuration(b);
+            });
+            const size_t nJobIdx = *pNextJob;
+            vnPendingJobs.erase(pNextJob);
+            // once there are fewer jobs left than free workers, the remaining threads are handed out to the last jobs
+            const size_t nThreadBudget = std::max(nFreeThreads/(vnPendingJobs.size()+1),size_t(1));
+            nFreeThreads -= nThreadBudget;
+            anThreadBudgets[nJobIdx] = nThreadBudget;
+            vnRunningJobs.push_back(nJobIdx);
+            const std::string sWorkerName = std::to_string(++nStartedJobs)+"/"+std::to_string(nTotJobs);
+            m_qJobs.push([&,nJobIdx,nThreadBudget,sWorkerName]() {
+                lv::StopWatch oStopWatch;
+                std::exception_ptr pException;
+                try {
+                    // nested 'parallel_for' calls made by the job (e.g. by evaluators) are bounded by its share of the workers, which may grow while it runs
+                    lv::SharedThreadBudgetGuard oThreadBudget(anThreadBudgets[nJobIdx]);
+                    lJob(nJobIdx,nThreadBudget,sWorkerName);
+                }
+                catch(...) {
+                    pException = std::current_exception();
+                }
+                const double dElapsedTime = oStopWatch.elapsed();
+                std::lock_guard<std::mutex> oWorkerLock(m_oMutex);
+                if(pException) {
+                    if(!pJobException)
+                        pJobException = pException;
+                }
+                else if(dElapsedTime>0.0 && anThreadBudgets[nJobIdx]==1) {
+                    // multi-threaded runs are left out, as jobs may not use their whole budget (they only happen at the tail anyway)
+                    for(const std::string& sKey : {vsThroughputKeys[nJobIdx],std::string()}) {
+                        m_mThroughputs[sKey].first += vdLoads[nJobIdx];
+                        m_mThroughputs[sKey].second += dElapsedTime;
+                    }
+                }
+                nFreeThreads += anThreadBudgets[nJobIdx];
+                vnRunningJobs.erase(std::find(vnRunningJobs.begin(),vnRunningJobs.end(),nJobIdx));
+                oDoneSync.notify_all();
+            });
+            m_oJobSync.notify_one();
+        }
+        if((vnPendingJobs.empty() || pJobException) && !vnRunningJobs.empty()) {
+            // threads freed at the tail go one by one to the running job with the longest expected duration per thread
+            for(; nFreeThreads>0; --nFreeThreads) {
+                const size_t nJobIdx = *std::max_element(vnRunningJobs.begin(),vnRunningJobs.end(),[&](size_t a, size_t b) {
+                    return lGetExpectedDuration(a)/anThreadBudgets[a]<lGetExpectedDuration(b)/anThreadBudgets[b];
+                });
+                ++anThreadBudgets[nJobIdx];
+            }
+        }
+        oDoneSync.wait(oLock);
+    }
+    if(pJobException)
+        std::rethrow_exception(pJobException);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+lv::DataPrecacher::DataPrecacher(std::function<const cv::Mat&(size_t)> lDataLoaderCallback, std::function<cv::Mat(size_t)> lReentrantLoaderCallback, std::function<cv::Mat(size_t,const PacketAllocator&)> lInPlaceLoaderCallback) :
+        m_lCallback(lDataLoaderCallback),m_lReentrantCallback(lReentrantLoaderCallback),m_lInPlaceCallback(lInPlaceLoaderCallback) {
     lvAssert_(m_lCallback,"invalid data precacher callback");
     m_bIsActive = false;
-    m_pWorkerException = nullptr;
-    m_nAnswIdx = m_nReqIdx = m_nLastReqIdx = size_t(-1);
+    m_pWorkerException = m_pDecodeException = nullptr;
+    m_nAnswIdx = m_nReqIdx = m_nReqReaderIdx = size_t(-1);
+    m_nLookBehind = PRECACHE_DEFAULT_LOOKBEHIND;
+    m_nLRUCacheSize = CACHE_MIN_SIZE;
+    m_nDecodeWindowBegin = m_nNextDecodeIdx = m_nDecodeLookahead = m_nDecodeEpoch = 0;
+    m_nDecodeEndIdx = size_t(-1);
 }
 
 lv::DataPrecacher::~DataPrecacher() {
     stopAsyncPrecaching();
 }
 
-const cv::Mat& lv::DataPrecacher::getPacket(size_t nIdx) {
-    if(nIdx==m_nLastReqIdx)
-        return m_oLastReqPacket;
+const cv::Mat& lv::DataPrecacher::getPacket(size_t nIdx, size_t nReaderIdx) {
+    std::mutex_lock_guard req_lock(m_oReqMutex);
+    while(nReaderIdx>=m_vnLastReqIdxs.size()) {
+        m_vnLastReqIdxs.push_back(size_t(-1));
+        m_voLastReqPackets.emplace_back();
+    }
+    size_t& nLastReqIdx = m_vnLastReqIdxs[nReaderIdx];
+    cv::Mat& oLastReqPacket = m_voLastReqPackets[nReaderIdx];
+    if(nIdx==nLastReqIdx)
+        return oLastReqPacket;
     else if(!m_bIsActive) {
-        m_oLastReqPacket = m_lCallback(nIdx);
-        m_nLastReqIdx = nIdx;
-        return m_oLastReqPacket;
+        oLastReqPacket = m_lCallback(nIdx);
+        nLastReqIdx = nIdx;
+        return oLastReqPacket;
     }
     std::mutex_unique_lock sync_lock(m_oSyncMutex);
     m_nReqIdx = nIdx;
+    m_nReqReaderIdx = nReaderIdx;
+    m_nAnswIdx = size_t(-1);
     std::cv_status res;
     size_t nAnswIdx;
     do {
@@ -302,86 +872,267 @@ const cv::Mat& lv::DataPrecacher::getPacket(size_t nIdx) {
 #endif //CONSOLE_DEBUG
     } while(res==std::cv_status::timeout && nAnswIdx!=m_nReqIdx && !m_pWorkerException);
     if(m_pWorkerException) {
-        m_bIsActive = false;
-        m_hWorker.join();
-        std::rethrow_exception(m_pWorkerException);
+        joinWorkers();
+        const std::exception_ptr pWorkerException = m_pWorkerException;
+        m_pWorkerException = nullptr; // rethrown only once, not on destruction
+        std::rethrow_exception(pWorkerException);
     }
-    m_oLastReqPacket = m_oReqPacket;
-    m_nLastReqIdx = nAnswIdx;
-    return m_oLastReqPacket;
+    oLastReqPacket = m_oReqPacket;
+    nLastReqIdx = nAnswIdx;
+    return oLastReqPacket;
+}
+
+void lv::DataPrecacher::setRandomAccessPolicy(size_t nLookBehind, size_t nLRUCacheSize) {
+    lvAssert_(!m_bIsActive,"random access policy cannot be changed while precaching");
+    m_nLookBehind = nLookBehind;
+    m_nLRUCacheSize = nLRUCacheSize;
 }
 
-bool lv::DataPrecacher::startAsyncPrecaching(size_t nSuggestedBufferSize) {
+bool lv::DataPrecacher::startAsyncPrecaching(size_t nSuggestedBufferSize, size_t nDecodeThreads, size_t nLookahead) {
     static_assert(PRECACHE_REQUEST_TIMEOUT_MS>0,"Precache request timeout must be a positive value");
     static_assert(PRECACHE_QUERY_TIMEOUT_MS>0,"Precache query timeout must be a positive value");
     static_assert(PRECACHE_QUERY_END_TIMEOUT_MS>0,"Precache query post-end timeout must be a positive value");
     static_assert(PRECACHE_REFILL_TIMEOUT_MS>0,"Precache refill timeout must be a positive value");
+    lvAssert_(nDecodeThreads>0,"precacher needs at least one decode thread");
+    lvAssert_(nLookahead==0 || nLookahead>=nDecodeThreads,"precacher lookahead packet count should be at least as large as the decode thread count");
     stopAsyncPrecaching();
     if(nSuggestedBufferSize>0) {
         m_bIsActive = true;
-        m_pWorkerException = nullptr;
+        m_pWorkerException = m_pDecodeException = nullptr;
         m_nAnswIdx = m_nReqIdx = size_t(-1);
+        if(nDecodeThreads>1 && m_lReentrantCallback) {
+            // decode workers must exist before the entry thread starts, as it checks whether to use them or not
+            m_mDecodedPackets.clear();
+            m_nDecodeWindowBegin = m_nNextDecodeIdx = 0;
+            m_nDecodeEndIdx = size_t(-1);
+            m_nDecodeLookahead = nLookahead?nLookahead:nDecodeThreads*2;
+            ++m_nDecodeEpoch;
+            for(size_t nThreadIdx=0; nThreadIdx<nDecodeThreads; ++nThreadIdx)
+                m_vhDecodeWorkers.emplace_back(&DataPrecacher::decode,this);
+        }
         m_hWorker = std::thread(&DataPrecacher::entry,this,std::max(std::min(nSuggestedBufferSize,CACHE_MAX_SIZE),CACHE_MIN_SIZE));
     }
     return m_bIsActive;
 }
 
 void lv::DataPrecacher::stopAsyncPrecaching() {
-    if(m_bIsActive) {
-        m_bIsActive = false;
-        m_hWorker.join();
-    }
+    if(m_bIsActive)
+        joinWorkers();
     if(m_pWorkerException)
         std::rethrow_exception(m_pWorkerException);
 }
 
+void lv::DataPrecacher::joinWorkers() {
+    m_bIsActive = false;
+    {
+        std::mutex_lock_guard decode_lock(m_oDecodeMutex);
+        m_oDecodeReqCondVar.notify_all();
+        m_oDecodeAnswCondVar.notify_all();
+    }
+    if(m_hWorker.joinable())
+        m_hWorker.join();
+    for(std::thread& hDecodeWorker : m_vhDecodeWorkers)
+        hDecodeWorker.join();
+    m_vhDecodeWorkers.clear();
+    m_mDecodedPackets.clear();
+}
+
+void lv::DataPrecacher::decode() {
+    std::mutex_unique_lock decode_lock(m_oDecodeMutex);
+    try {
+        while(m_bIsActive) {
+            if(m_nNextDecodeIdx>=m_nDecodeEndIdx || m_nNextDecodeIdx>=m_nDecodeWindowBegin+m_nDecodeLookahead) {
+                m_oDecodeReqCondVar.wait_for(decode_lock,std::chrono::milliseconds(PRECACHE_QUERY_TIMEOUT_MS));
+                continue;
+            }
+            const size_t nDecodeIdx = m_nNextDecodeIdx++;
+            const size_t nDecodeEpoch = m_nDecodeEpoch;
+            decode_lock.unlock();
+            cv::Mat oPacket = m_lReentrantCallback(nDecodeIdx);
+            decode_lock.lock();
+            if(nDecodeEpoch!=m_nDecodeEpoch)
+                continue; // cache was reset while decoding, packet is stale
+            if(oPacket.empty())
+                m_nDecodeEndIdx = std::min(m_nDecodeEndIdx,nDecodeIdx);
+            else
+                m_mDecodedPackets[nDecodeIdx] = oPacket;
+            m_oDecodeAnswCondVar.notify_all();
+        }
+    }
+    catch(...) {
+        if(!decode_lock.owns_lock())
+            decode_lock.lock();
+        m_pDecodeException = std::current_exception();
+        m_oDecodeAnswCondVar.notify_all();
+    }
+}
+
 void lv::DataPrecacher::entry(const size_t nBufferSize) {
     std::mutex_unique_lock sync_lock(m_oSyncMutex);
     try {
 #if CONSOLE_DEBUG
         std::cout << "data precacher [" << uintptr_t(this) << "] init w/ buffer size = " << (nBufferSize/1024)/1024 << " mb" << std::endl;
 #endif //CONSOLE_DEBUG
-        std::queue<cv::Mat> qoCache;
+        // ring entries are kept in buffer order; 'live' ones form the contiguous [nLiveBeginIdx,nNextPrecacheIdx) packet range at the back
+        struct CacheEntry {size_t nIdx; cv::Mat oPacket; bool bLive;};
+        std::deque<CacheEntry> qoCache;
         std::vector<uchar> vcBuffer(nBufferSize);
         size_t nNextExpectedReqIdx = 0;
         size_t nNextPrecacheIdx = 0;
+        size_t nLiveBeginIdx = 0;
         size_t nFirstBufferIdx = size_t(-1);
         size_t nNextBufferIdx = size_t(-1);
+        size_t nStreamReaderIdx = size_t(-1);
         bool bReachedEnd = false;
-        const auto lCacheNextPacket = [&]() -> size_t {
-            const cv::Mat& oNextPacket = m_lCallback(nNextPrecacheIdx);
-            const size_t nNextPacketSize = oNextPacket.total()*oNextPacket.elemSize();
-            if(nNextPacketSize==0) {
-                bReachedEnd = true;
-                return 0;
+        // packet loaded for the ring while it was full; kept until there is room for it, so that it is not decoded again
+        cv::Mat oPendingPacket;
+        size_t nPendingPacketIdx = size_t(-1);
+        // packets last given to each reader stay pinned in the ring until that reader's next request; only the first reader drives the stream
+        std::vector<const uchar*> vpReaderPins;
+        // packets loaded outside the ring window are kept by value in an lru cache, up to a memory budget
+        std::list<std::pair<size_t,cv::Mat>> loLRUCache;
+        std::unordered_map<size_t,std::list<std::pair<size_t,cv::Mat>>::iterator> mLRUCacheMap;
+        size_t nLRUCacheSize = 0;
+        const auto lFetchLRUPacket = [&](size_t nIdx, cv::Mat& oPacket) -> bool {
+            const auto pEntry = mLRUCacheMap.find(nIdx);
+            if(pEntry==mLRUCacheMap.end())
+                return false;
+            loLRUCache.splice(loLRUCache.begin(),loLRUCache,pEntry->second);
+            oPacket = pEntry->second->second;
+            return true;
+        };
+        const auto lInsertLRUPacket = [&](size_t nIdx, const cv::Mat& oPacket) {
+            const size_t nPacketSize = oPacket.total()*oPacket.elemSize();
+            if(nPacketSize==0 || nPacketSize>m_nLRUCacheSize || mLRUCacheMap.count(nIdx))
+                return;
+            while(nLRUCacheSize+nPacketSize>m_nLRUCacheSize) {
+                nLRUCacheSize -= loLRUCache.back().second.total()*loLRUCache.back().second.elemSize();
+                mLRUCacheMap.erase(loLRUCache.back().first);
+                loLRUCache.pop_back();
+            }
+            loLRUCache.emplace_front(nIdx,oPacket);
+            mLRUCacheMap[nIdx] = loLRUCache.begin();
+            nLRUCacheSize += nPacketSize;
+        };
+        // releases ring entries which are neither pinned, pending, nor part of the look-behind window
+        const auto lReleaseCacheEntries = [&]() {
+            while(!qoCache.empty()) {
+                const CacheEntry& oEntry = qoCache.front();
+                if(std::find(vpReaderPins.begin(),vpReaderPins.end(),oEntry.oPacket.data)!=vpReaderPins.end())
+                    break;
+                if(oEntry.bLive) {
+                    if(oEntry.nIdx>=nNextExpectedReqIdx || nNextExpectedReqIdx-oEntry.nIdx<=m_nLookBehind)
+                        break;
+                    ++nLiveBeginIdx;
+                }
+                qoCache.pop_front();
             }
-            else if(nFirstBufferIdx<=nNextBufferIdx) {
-                bReachedEnd = false;
-                if(nNextBufferIdx==size_t(-1) || (nNextBufferIdx+nNextPacketSize>=nBufferSize)) {
-                    if((nFirstBufferIdx!=size_t(-1) && nNextPacketSize>=nFirstBufferIdx) || nNextPacketSize>=nBufferSize)
-                        return 0;
-                    cv::Mat oNextPacket_cache(oNextPacket.size(),oNextPacket.type(),vcBuffer.data());
-                    oNextPacket.copyTo(oNextPacket_cache);
-                    qoCache.push(oNextPacket_cache);
-                    nNextBufferIdx = nNextPacketSize;
-                    if(nFirstBufferIdx==size_t(-1))
-                        nFirstBufferIdx = 0;
+            if(qoCache.empty())
+                nFirstBufferIdx = nNextBufferIdx = size_t(-1);
+            else
+                nFirstBufferIdx = (size_t)(qoCache.front().oPacket.data-vcBuffer.data());
+        };
+        const bool bUseDecodeWorkers = !m_vhDecodeWorkers.empty();
+        const auto lFetchDecodedPacket = [&](cv::Mat& oPacket, bool bWait) -> bool {
+            std::mutex_unique_lock decode_lock(m_oDecodeMutex);
+            const auto lIsReady = [&]() {
+                return !m_bIsActive || m_pDecodeException || nNextPrecacheIdx>=m_nDecodeEndIdx || m_mDecodedPackets.count(nNextPrecacheIdx);
+            };
+            if(bWait)
+                m_oDecodeAnswCondVar.wait_for(decode_lock,std::chrono::milliseconds(PRECACHE_REFILL_TIMEOUT_MS),lIsReady);
+            if(m_pDecodeException)
+                std::rethrow_exception(m_pDecodeException);
+            if(nNextPrecacheIdx>=m_nDecodeEndIdx) {
+                oPacket = cv::Mat();
+                return true;
+            }
+            const auto pDecodedPacket = m_mDecodedPackets.find(nNextPrecacheIdx);
+            if(pDecodedPacket==m_mDecodedPackets.end())
+                return false;
+            oPacket = pDecodedPacket->second;
+            return true;
+        };
+        const auto lResetDecodeWindow = [&](size_t nNewBeginIdx) {
+            std::mutex_lock_guard decode_lock(m_oDecodeMutex);
+            ++m_nDecodeEpoch;
+            m_mDecodedPackets.clear();
+            m_nDecodeWindowBegin = m_nNextDecodeIdx = nNewBeginIdx;
+            m_nDecodeEndIdx = size_t(-1);
+            m_oDecodeReqCondVar.notify_all();
+        };
+        // returns a pointer to the next free contiguous cache region of the given size (or null if full), without committing it
+        const auto lReserveCacheSlot = [&](size_t nPacketSize, size_t& nNewNextBufferIdx) -> uchar* {
+            if(nFirstBufferIdx<=nNextBufferIdx) {
+                if(nNextBufferIdx==size_t(-1) || (nNextBufferIdx+nPacketSize>=nBufferSize)) {
+                    if((nFirstBufferIdx!=size_t(-1) && nPacketSize>=nFirstBufferIdx) || nPacketSize>=nBufferSize)
+                        return nullptr;
+                    nNewNextBufferIdx = nPacketSize;
+                    return vcBuffer.data();
                 }
-                else { // nNextBufferIdx+nNextPacketSize<m_nBufferSize
-                    cv::Mat oNextPacket_cache(oNextPacket.size(),oNextPacket.type(),vcBuffer.data()+nNextBufferIdx);
-                    oNextPacket.copyTo(oNextPacket_cache);
-                    qoCache.push(oNextPacket_cache);
-                    nNextBufferIdx += nNextPacketSize;
+                // nNextBufferIdx+nPacketSize<m_nBufferSize
+                nNewNextBufferIdx = nNextBufferIdx+nPacketSize;
+                return vcBuffer.data()+nNextBufferIdx;
+            }
+            else if(nNextBufferIdx+nPacketSize<nFirstBufferIdx) {
+                nNewNextBufferIdx = nNextBufferIdx+nPacketSize;
+                return vcBuffer.data()+nNextBufferIdx;
+            }
+            return nullptr; // nNextBufferIdx+nPacketSize>=nFirstBufferIdx
+        };
+        const auto lCacheNextPacket = [&](bool bWait) -> size_t {
+            cv::Mat oNextPacket_cache;
+            size_t nNewNextBufferIdx = size_t(-1);
+            if(!bUseDecodeWorkers && m_lInPlaceCallback) {
+                // the loader decodes straight into cache memory, and may re-request a slot if the packet layout changes
+                bool bCacheFull = false;
+                const PacketAllocator lAllocator = [&](const cv::Size& oSize, int nType) -> cv::Mat {
+                    uchar* pSlot = lReserveCacheSlot(size_t(oSize.area())*CV_ELEM_SIZE(nType),nNewNextBufferIdx);
+                    bCacheFull = (pSlot==nullptr);
+                    return bCacheFull?cv::Mat():cv::Mat(oSize,nType,pSlot);
+                };
+                const cv::Mat oNextPacket = m_lInPlaceCallback(nNextPrecacheIdx,lAllocator);
+                if(bCacheFull)
+                    return 0;
+                if(oNextPacket.empty()) {
+                    bReachedEnd = true;
+                    return 0;
                 }
+                lvDbgAssert_(nNewNextBufferIdx!=size_t(-1) && oNextPacket.data>=vcBuffer.data() && oNextPacket.data<vcBuffer.data()+nBufferSize,"in-place loader must return a packet allocated in cache memory");
+                oNextPacket_cache = oNextPacket;
             }
-            else if(nNextBufferIdx+nNextPacketSize<nFirstBufferIdx) {
-                cv::Mat oNextPacket_cache(oNextPacket.size(),oNextPacket.type(),vcBuffer.data()+nNextBufferIdx);
+            else {
+                cv::Mat oDecodedPacket;
+                if(bUseDecodeWorkers && !lFetchDecodedPacket(oDecodedPacket,bWait))
+                    return 0;
+                if(!bUseDecodeWorkers && nPendingPacketIdx!=nNextPrecacheIdx) {
+                    oPendingPacket = m_lCallback(nNextPrecacheIdx);
+                    nPendingPacketIdx = nNextPrecacheIdx;
+                }
+                const cv::Mat& oNextPacket = bUseDecodeWorkers?oDecodedPacket:oPendingPacket;
+                if(oNextPacket.empty()) {
+                    bReachedEnd = true;
+                    return 0;
+                }
+                uchar* pSlot = lReserveCacheSlot(oNextPacket.total()*oNextPacket.elemSize(),nNewNextBufferIdx);
+                if(!pSlot)
+                    return 0;
+                oNextPacket_cache = cv::Mat(oNextPacket.size(),oNextPacket.type(),pSlot);
                 oNextPacket.copyTo(oNextPacket_cache);
-                qoCache.push(oNextPacket_cache);
-                nNextBufferIdx += nNextPacketSize;
+                oPendingPacket = cv::Mat();
+                nPendingPacketIdx = size_t(-1);
+            }
+            const size_t nNextPacketSize = oNextPacket_cache.total()*oNextPacket_cache.elemSize();
+            qoCache.push_back({nNextPrecacheIdx,oNextPacket_cache,true});
+            nNextBufferIdx = nNewNextBufferIdx;
+            if(nFirstBufferIdx==size_t(-1))
+                nFirstBufferIdx = 0;
+            bReachedEnd = false;
+            if(bUseDecodeWorkers) {
+                std::mutex_lock_guard decode_lock(m_oDecodeMutex);
+                m_mDecodedPackets.erase(nNextPrecacheIdx);
+                m_nDecodeWindowBegin = nNextPrecacheIdx+1;
+                m_oDecodeReqCondVar.notify_all();
             }
-            else // nNextBufferIdx+nNextPacketSize>=nFirstBufferIdx
-                return 0;
             ++nNextPrecacheIdx;
 #if CONSOLE_DEBUG
             //std::cout << "data precacher [" << uintptr_t(this) << "] filled one packet w/ size = " << nNextPacketSize/1024 << " kb" << std::endl;
@@ -389,54 +1140,65 @@ void lv::DataPrecacher::entry(const size_t nBufferSize) {
             return nNextPacketSize;
         };
         const std::chrono::time_point<std::chrono::high_resolution_clock> nPrefillTick = std::chrono::high_resolution_clock::now();
-        while(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now()-nPrefillTick).count()<PRECACHE_REFILL_TIMEOUT_MS && lCacheNextPacket());
+        while(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now()-nPrefillTick).count()<PRECACHE_REFILL_TIMEOUT_MS && lCacheNextPacket(true));
         while(m_bIsActive) {
             if(m_oReqCondVar.wait_for(sync_lock,std::chrono::milliseconds(bReachedEnd?PRECACHE_QUERY_END_TIMEOUT_MS:PRECACHE_QUERY_TIMEOUT_MS))!=std::cv_status::timeout) {
-                if(m_nReqIdx!=nNextExpectedReqIdx-1) {
-                    if(!qoCache.empty()) {
-                        if(m_nReqIdx<nNextPrecacheIdx && m_nReqIdx>=nNextExpectedReqIdx) {
-#if CONSOLE_DEBUG
-                            if(m_nReqIdx>nNextExpectedReqIdx)
-                                std::cout << "data precacher [" << uintptr_t(this) << "] popping " << m_nReqIdx-nNextExpectedReqIdx << " extra packet(s) from cache" << std::endl;
-#endif //CONSOLE_DEBUG
-                            while(m_nReqIdx-nNextExpectedReqIdx+1>0) {
-                                m_oReqPacket = qoCache.front();
-                                m_nAnswIdx = m_nReqIdx;
-                                nFirstBufferIdx = (size_t)(m_oReqPacket.data-vcBuffer.data());
-                                qoCache.pop();
-                                ++nNextExpectedReqIdx;
-                            }
-                        }
-                        else {
+                const size_t nReqIdx = m_nReqIdx, nReaderIdx = m_nReqReaderIdx;
+                if(nReaderIdx>=vpReaderPins.size())
+                    vpReaderPins.resize(nReaderIdx+1,nullptr);
+                vpReaderPins[nReaderIdx] = nullptr; // previous packet given to this reader is now released
+                const bool bIsStreamReader = (nStreamReaderIdx==size_t(-1) || nStreamReaderIdx==nReaderIdx);
+                if(bUseDecodeWorkers && bIsStreamReader && nReqIdx>=nNextExpectedReqIdx && nReqIdx<nNextPrecacheIdx+m_nDecodeLookahead) {
+                    // requested packet is already being decoded; wait for it to reach the ring instead of dropping the cache
+                    lReleaseCacheEntries();
+                    while(nReqIdx>=nNextPrecacheIdx && lCacheNextPacket(true));
+                }
+                if(nReqIdx>=nLiveBeginIdx && nReqIdx<nNextPrecacheIdx) {
 #if CONSOLE_DEBUG
-                            std::cout << "data precacher [" << uintptr_t(this) << "] out-of-order request, destroying cache" << std::endl;
+                    if(nReqIdx>nNextExpectedReqIdx)
+                        std::cout << "data precacher [" << uintptr_t(this) << "] skipping " << nReqIdx-nNextExpectedReqIdx << " packet(s) in cache" << std::endl;
+                    else if(nReqIdx<nNextExpectedReqIdx)
+                        std::cout << "data precacher [" << uintptr_t(this) << "] answering request using look-behind window" << std::endl;
 #endif //CONSOLE_DEBUG
-                            qoCache = std::queue<cv::Mat>();
-                            m_oReqPacket = m_lCallback(m_nReqIdx);
-                            m_nAnswIdx = m_nReqIdx;
-                            nFirstBufferIdx = nNextBufferIdx = size_t(-1);
-                            nNextExpectedReqIdx = nNextPrecacheIdx = m_nReqIdx+1;
-                            bReachedEnd = false;
-                        }
+                    const CacheEntry& oEntry = qoCache[qoCache.size()-(nNextPrecacheIdx-nReqIdx)];
+                    lvDbgAssert(oEntry.bLive && oEntry.nIdx==nReqIdx);
+                    m_oReqPacket = oEntry.oPacket;
+                    vpReaderPins[nReaderIdx] = oEntry.oPacket.data;
+                    if(bIsStreamReader && nReqIdx>=nNextExpectedReqIdx) {
+                        nNextExpectedReqIdx = nReqIdx+1;
+                        nStreamReaderIdx = nReaderIdx;
                     }
-                    else {
+                }
+                else if(!lFetchLRUPacket(nReqIdx,m_oReqPacket)) {
+                    // the loader might reuse its buffers, so any packet kept for the ring is dropped before loading another one
+                    oPendingPacket = cv::Mat();
+                    nPendingPacketIdx = size_t(-1);
+                    m_oReqPacket = bUseDecodeWorkers?m_lReentrantCallback(nReqIdx):m_lCallback(nReqIdx);
+                    lInsertLRUPacket(nReqIdx,m_oReqPacket);
+                    if(bIsStreamReader) {
 #if CONSOLE_DEBUG
-                        std::cout << "data precacher [" << uintptr_t(this) << "] answering request manually, precaching is falling behind" << std::endl;
+                        std::cout << "data precacher [" << uintptr_t(this) << "] stream reader left the cache window, restarting precaching after packet #" << nReqIdx << std::endl;
 #endif //CONSOLE_DEBUG
-                        m_oReqPacket = m_lCallback(m_nReqIdx);
-                        m_nAnswIdx = m_nReqIdx;
-                        nFirstBufferIdx = nNextBufferIdx = size_t(-1);
-                        nNextExpectedReqIdx = nNextPrecacheIdx = m_nReqIdx+1;
+                        for(CacheEntry& oEntry : qoCache)
+                            oEntry.bLive = false;
+                        nLiveBeginIdx = nNextExpectedReqIdx = nNextPrecacheIdx = nReqIdx+1;
+                        nStreamReaderIdx = nReaderIdx;
+                        bReachedEnd = false;
+                        if(bUseDecodeWorkers)
+                            lResetDecodeWindow(nNextPrecacheIdx);
                     }
                 }
-#if CONSOLE_DEBUG
-                else
-                    std::cout << "data precacher [" << uintptr_t(this) << "] answering request using last packet" << std::endl;
-#endif //CONSOLE_DEBUG
+                m_nAnswIdx = nReqIdx;
+                lReleaseCacheEntries();
                 m_oSyncCondVar.notify_one();
-                lCacheNextPacket();
+                if(bUseDecodeWorkers)
+                    while(lCacheNextPacket(false));
+                else
+                    lCacheNextPacket(true);
             }
             else if(!bReachedEnd) {
+                if(bUseDecodeWorkers)
+                    while(lCacheNextPacket(false));
                 const size_t nUsedBufferSize = nFirstBufferIdx==size_t(-1)?0:(nFirstBufferIdx<nNextBufferIdx?nNextBufferIdx-nFirstBufferIdx:nBufferSize-nFirstBufferIdx+nNextBufferIdx);
                 if(nUsedBufferSize<nBufferSize/4) {
 #if CONSOLE_DEBUG
@@ -444,7 +1206,7 @@ void lv::DataPrecacher::entry(const size_t nBufferSize) {
 #endif //CONSOLE_DEBUG
                     size_t nFillCount = 0;
                     const std::chrono::time_point<std::chrono::high_resolution_clock> nRefillTick = std::chrono::high_resolution_clock::now();
-                    while(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now()-nRefillTick).count()<PRECACHE_REFILL_TIMEOUT_MS && nFillCount++<10 && lCacheNextPacket());
+                    while(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now()-nRefillTick).count()<PRECACHE_REFILL_TIMEOUT_MS && nFillCount++<10 && lCacheNextPacket(true));
                 }
             }
         }
@@ -458,9 +1220,177 @@ void lv::DataPrecacher::entry(const size_t nBufferSize) {
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+lv::ParallelVideoReader::ParallelVideoReader(const std::string& sFilePath, size_t nFrameCount, const std::vector<size_t>& vnKeyFrameIdxs, size_t nDecodeThreads, size_t nMaxBufferedFrames) :
+        m_sFilePath(sFilePath),
+        m_nFrameCount(nFrameCount),
+        m_nMaxBufferedFrames(nMaxBufferedFrames),
+        m_nDecodeThreads(nDecodeThreads?nDecodeThreads:std::max(std::thread::hardware_concurrency(),1u)),
+        m_nReadIdx(0),
+        m_nNextSegmentIdx(0),
+        m_nEndIdx(nFrameCount),
+        m_nEpoch(0),
+        m_nActiveDecodeThreads(0),
+        m_bStopping(false) {
+    lvAssert_(m_nFrameCount>0,"video reader requires a non-null frame count");
+    lvAssert_(m_nMaxBufferedFrames>0,"video reader needs to buffer at least one frame");
+    m_vnSegmentBeginIdxs.push_back(0);
+    for(size_t nKeyFrameIdx : vnKeyFrameIdxs)
+        if(nKeyFrameIdx<m_nFrameCount && nKeyFrameIdx>=m_vnSegmentBeginIdxs.back()+VIDEOREADER_MIN_SEGMENT_SIZE)
+            m_vnSegmentBeginIdxs.push_back(nKeyFrameIdx);
+    // workers block once their next frame falls outside the decode-ahead window, so extra workers only pay off if the window holds one whole segment for each of them
+    size_t nMaxSegmentSize = m_nFrameCount-m_vnSegmentBeginIdxs.back();
+    for(size_t nSegmentIdx=1; nSegmentIdx<m_vnSegmentBeginIdxs.size(); ++nSegmentIdx)
+        nMaxSegmentSize = std::max(nMaxSegmentSize,m_vnSegmentBeginIdxs[nSegmentIdx]-m_vnSegmentBeginIdxs[nSegmentIdx-1]);
+    m_nDecodeThreads = std::max(std::min(std::min(m_nDecodeThreads,m_vnSegmentBeginIdxs.size()),m_nMaxBufferedFrames/nMaxSegmentSize),size_t(1));
+}
+
+lv::ParallelVideoReader::~ParallelVideoReader() {
+    joinWorkers();
+}
+
+size_t lv::ParallelVideoReader::buildKeyFrameIndex(const std::string& sFilePath, std::vector<size_t>& vnKeyFrameIdxs) {
+    vnKeyFrameIdxs.clear();
+#if HAVE_VIDEOREADER_DEMUX
+    // raw stream mode only demuxes packets (one per frame), and flags those holding a keyframe
+    cv::VideoCapture oDemuxer(sFilePath,cv::CAP_FFMPEG,{cv::CAP_PROP_FORMAT,-1});
+    if(!oDemuxer.isOpened())
+        return 0;
+    size_t nFrameCount = 0;
+    for(; oDemuxer.grab(); ++nFrameCount)
+        if(oDemuxer.get(cv::CAP_PROP_LRF_HAS_KEY_FRAME)!=0)
+            vnKeyFrameIdxs.push_back(nFrameCount);
+    if(vnKeyFrameIdxs.empty() || vnKeyFrameIdxs[0]!=0) {
+        // streams that do not start on a keyframe cannot be split safely
+        vnKeyFrameIdxs.clear();
+        return 0;
+    }
+    return nFrameCount;
+#else //!HAVE_VIDEOREADER_DEMUX
+    lvIgnore(sFilePath);
+    return 0;
+#endif //!HAVE_VIDEOREADER_DEMUX
+}
+
+bool lv::ParallelVideoReader::read(size_t nFrameIdx, cv::Mat& oFrame) {
+    std::mutex_unique_lock oLock(m_oMutex);
+    if(m_vhDecodeWorkers.empty())
+        for(size_t nThreadIdx=0; nThreadIdx<m_nDecodeThreads; ++nThreadIdx)
+            m_vhDecodeWorkers.emplace_back(&ParallelVideoReader::decode,this);
+    if(nFrameIdx<m_nReadIdx || nFrameIdx>=m_nReadIdx+m_nMaxBufferedFrames) {
+        // random jump: in-flight segments are dropped, and decoding restarts from the segment holding the requested frame
+        ++m_nEpoch;
+        m_mDecodedFrames.clear();
+        m_nNextSegmentIdx = size_t(std::upper_bound(m_vnSegmentBeginIdxs.begin(),m_vnSegmentBeginIdxs.end(),nFrameIdx)-m_vnSegmentBeginIdxs.begin())-1;
+    }
+    m_nReadIdx = nFrameIdx;
+    m_mDecodedFrames.erase(m_mDecodedFrames.begin(),m_mDecodedFrames.lower_bound(nFrameIdx));
+    m_oReqCondVar.notify_all();
+    while(!m_pDecodeException && nFrameIdx<m_nEndIdx && !m_mDecodedFrames.count(nFrameIdx))
+        m_oAnswCondVar.wait_for(oLock,std::chrono::milliseconds(VIDEOREADER_QUERY_TIMEOUT_MS));
+    if(m_pDecodeException)
+        std::rethrow_exception(m_pDecodeException);
+    if(nFrameIdx>=m_nEndIdx)
+        return false;
+    auto pFrame = m_mDecodedFrames.find(nFrameIdx);
+    if(oFrame.empty())
+        oFrame = pFrame->second;
+    else
+        pFrame->second.copyTo(oFrame);
+    m_mDecodedFrames.erase(pFrame);
+    m_nReadIdx = nFrameIdx+1;
+    m_oReqCondVar.notify_all();
+    return true;
+}
+
+size_t lv::ParallelVideoReader::getActiveDecodeThreadCount() {
+    std::mutex_lock_guard oLock(m_oMutex);
+    return m_nActiveDecodeThreads;
+}
+
+void lv::ParallelVideoReader::joinWorkers() {
+    {
+        std::mutex_lock_guard oLock(m_oMutex);
+        m_bStopping = true;
+        m_oReqCondVar.notify_all();
+        m_oAnswCondVar.notify_all();
+    }
+    for(std::thread& hDecodeWorker : m_vhDecodeWorkers)
+        hDecodeWorker.join();
+    m_vhDecodeWorkers.clear();
+    m_mDecodedFrames.clear();
+}
+
+void lv::ParallelVideoReader::decode() {
+    // each worker owns its decoder, and only seeks when its new segment does not directly follow the last frame it decoded
+    cv::VideoCapture oReader;
+    size_t nNextReaderIdx = size_t(-1);
+    bool bActive = false;
+    std::mutex_unique_lock oLock(m_oMutex);
+    try {
+        while(!m_bStopping) {
+            if(m_nNextSegmentIdx>=m_vnSegmentBeginIdxs.size() || m_vnSegmentBeginIdxs[m_nNextSegmentIdx]>=std::min(m_nEndIdx,m_nReadIdx+m_nMaxBufferedFrames)) {
+                m_oReqCondVar.wait_for(oLock,std::chrono::milliseconds(VIDEOREADER_QUERY_TIMEOUT_MS));
+                continue;
+            }
+            const size_t nSegmentIdx = m_nNextSegmentIdx++;
+            const size_t nEpoch = m_nEpoch;
+            if(!bActive) {
+                bActive = true;
+                ++m_nActiveDecodeThreads;
+            }
+            const size_t nBeginIdx = m_vnSegmentBeginIdxs[nSegmentIdx];
+            const size_t nEndIdx = (nSegmentIdx+1<m_vnSegmentBeginIdxs.size())?m_vnSegmentBeginIdxs[nSegmentIdx+1]:m_nFrameCount;
+            oLock.unlock();
+            if(!oReader.isOpened()) {
+                lvAssert__(oReader.open(m_sFilePath),"could not open video file at '%s'",m_sFilePath.c_str());
+                nNextReaderIdx = 0;
+            }
+            if(nNextReaderIdx!=nBeginIdx) {
+                oReader.set(cv::CAP_PROP_POS_FRAMES,(double)nBeginIdx);
+                lvAssert__((size_t)oReader.get(cv::CAP_PROP_POS_FRAMES)==nBeginIdx,"could not seek to frame %d in video file at '%s'",(int)nBeginIdx,m_sFilePath.c_str());
+                nNextReaderIdx = nBeginIdx;
+            }
+            cv::Mat oFrame;
+            oLock.lock();
+            for(size_t nFrameIdx=nBeginIdx; nFrameIdx<nEndIdx; ++nFrameIdx) {
+                oLock.unlock();
+                const bool bDecoded = oReader.read(oFrame) && !oFrame.empty();
+                nNextReaderIdx = bDecoded?nFrameIdx+1:size_t(-1);
+                oLock.lock();
+                while(!m_bStopping && nEpoch==m_nEpoch && bDecoded && nFrameIdx>=m_nReadIdx+m_nMaxBufferedFrames)
+                    m_oReqCondVar.wait_for(oLock,std::chrono::milliseconds(VIDEOREADER_QUERY_TIMEOUT_MS));
+                if(m_bStopping || nEpoch!=m_nEpoch)
+                    break; // segment is stale, packets past the jump target will be decoded by another worker
+                if(!bDecoded) {
+                    m_nEndIdx = std::min(m_nEndIdx,nFrameIdx);
+                    m_oAnswCondVar.notify_all();
+                    break;
+                }
+                if(nFrameIdx>=m_nReadIdx) {
+                    m_mDecodedFrames[nFrameIdx] = oFrame;
+                    m_oAnswCondVar.notify_all();
+                }
+                oFrame.release(); // the buffered frame keeps its own data, the next one needs a new buffer
+            }
+        }
+    }
+    catch(...) {
+        if(!oLock.owns_lock())
+            oLock.lock();
+        m_pDecodeException = std::current_exception();
+        m_oAnswCondVar.notify_all();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void lv::IIDataLoader::startPrecaching(bool bPrecacheGT, size_t nSuggestedBufferSize) {
-    lvAssert_(m_oInputPrecacher.startAsyncPrecaching(nSuggestedBufferSize),"could not start precaching input packets");
-    lvAssert_(!bPrecacheGT || m_oGTPrecacher.startAsyncPrecaching(nSuggestedBufferSize),"could not start precaching gt packets");
+    const size_t nDecodeThreads = std::min(size_t(PRECACHE_MAX_DECODE_THREADS),std::max(size_t(std::thread::hardware_concurrency()),size_t(1)));
+    // packets served from a packed cache are already in memory (or a page fault away), so there is nothing to prefetch
+    lvAssert_(isUsingPackedCache() || m_oInputPrecacher.startAsyncPrecaching(nSuggestedBufferSize,isInputLoadingReentrant()?nDecodeThreads:1),"could not start precaching input packets");
+    lvAssert_(!bPrecacheGT || !m_vPackedGTs.empty() || m_oGTPrecacher.startAsyncPrecaching(nSuggestedBufferSize,isGTLoadingReentrant()?nDecodeThreads:1),"could not start precaching gt packets");
 }
 
 void lv::IIDataLoader::stopPrecaching() {
@@ -468,12 +1398,130 @@ void lv::IIDataLoader::stopPrecaching() {
     m_oGTPrecacher.stopAsyncPrecaching();
 }
 
-const cv::Mat& lv::IIDataLoader::getInput(size_t nPacketIdx) {
-    return m_oInputPrecacher.getPacket(nPacketIdx);
+const cv::Mat& lv::IIDataLoader::getInput(size_t nPacketIdx, size_t nReaderIdx) {
+    if(isUsingPackedCache())
+        return (nPacketIdx<m_vPackedInputs.size())?m_vPackedInputs[nPacketIdx]:cv::emptyMat();
+    return m_oInputPrecacher.getPacket(nPacketIdx,nReaderIdx);
+}
+
+const cv::Mat& lv::IIDataLoader::getGT(size_t nPacketIdx, size_t nReaderIdx) {
+    if(!m_vPackedGTs.empty())
+        return (nPacketIdx<m_vPackedGTs.size())?m_vPackedGTs[nPacketIdx]:cv::emptyMat();
+    return m_oGTPrecacher.getPacket(nPacketIdx,nReaderIdx);
+}
+
+void lv::IIDataLoader::writePackedCache(const std::string& sFilePath, bool bWithGT) {
+    lvAssert_(!m_oInputPrecacher.isActive() && !m_oGTPrecacher.isActive(),"precaching must be stopped before writing a packed cache");
+    lvAssert_(!isUsingPackedCache(),"packed cache must be closed before being rewritten");
+    const size_t nInputCount = getInputCount();
+    const size_t nGTCount = bWithGT?std::max(nInputCount,getGTCount()):size_t(0);
+    std::string sNameTable;
+    for(size_t nPacketIdx=0; nPacketIdx<nInputCount; ++nPacketIdx)
+        (sNameTable += getInputName(nPacketIdx)) += '\0';
+    PackedCacheHeader oHeader;
+    std::copy(s_acPackedCacheMagic,s_acPackedCacheMagic+sizeof(s_acPackedCacheMagic),oHeader.acMagic);
+    oHeader.nVersion = s_nPackedCacheVersion;
+    oHeader.nFlags = getPackedCacheFlags(*this);
+    oHeader.dScaleFactor = getScaleFactor();
+    oHeader.nInputCount = (uint64_t)nInputCount;
+    oHeader.nGTCount = (uint64_t)nGTCount;
+    oHeader.nNameTableSize = (uint64_t)sNameTable.size();
+    std::vector<PackedCacheEntry> vEntries(nInputCount+nGTCount);
+    // packets are written to a temporary file first, so that an interrupted run never leaves a truncated cache behind
+    const std::string sTempFilePath = sFilePath+".tmp";
+    std::ofstream oFile(sTempFilePath,std::ios::out|std::ios::binary|std::ios::trunc);
+    lvAssert__(oFile.is_open(),"could not create packed cache file at '%s'",sTempFilePath.c_str());
+    oFile.write((const char*)&oHeader,sizeof(oHeader));
+    oFile.write((const char*)vEntries.data(),std::streamsize(vEntries.size()*sizeof(PackedCacheEntry))); // rewritten once all offsets are known
+    oFile.write(sNameTable.data(),std::streamsize(sNameTable.size()));
+    size_t nFileOffset = sizeof(oHeader)+vEntries.size()*sizeof(PackedCacheEntry)+sNameTable.size();
+    const std::array<char,s_nPackedCacheAlign> acPadding = {};
+    const auto lAppendPacket = [&](const cv::Mat& oPacket, PackedCacheEntry& oEntry) {
+        oEntry = PackedCacheEntry{0,0,0,0,0};
+        if(oPacket.empty())
+            return;
+        lvAssert_(oPacket.dims==2,"packed cache only supports 2d packets");
+        const size_t nPaddingSize = (s_nPackedCacheAlign-nFileOffset%s_nPackedCacheAlign)%s_nPackedCacheAlign;
+        oFile.write(acPadding.data(),std::streamsize(nPaddingSize));
+        nFileOffset += nPaddingSize;
+        oEntry = PackedCacheEntry{(uint64_t)nFileOffset,oPacket.rows,oPacket.cols,oPacket.type(),0};
+        const size_t nRowSize = size_t(oPacket.cols)*oPacket.elemSize();
+        if(oPacket.isContinuous())
+            oFile.write((const char*)oPacket.data,std::streamsize(nRowSize*oPacket.rows));
+        else
+            for(int nRowIdx=0; nRowIdx<oPacket.rows; ++nRowIdx)
+                oFile.write((const char*)oPacket.ptr(nRowIdx),std::streamsize(nRowSize));
+        nFileOffset += nRowSize*oPacket.rows;
+    };
+    for(size_t nPacketIdx=0; nPacketIdx<nInputCount; ++nPacketIdx)
+        lAppendPacket(loadInput(nPacketIdx),vEntries[nPacketIdx]);
+    for(size_t nPacketIdx=0; nPacketIdx<nGTCount; ++nPacketIdx)
+        lAppendPacket(loadGT(nPacketIdx),vEntries[nInputCount+nPacketIdx]);
+    oFile.seekp(sizeof(oHeader));
+    oFile.write((const char*)vEntries.data(),std::streamsize(vEntries.size()*sizeof(PackedCacheEntry)));
+    oFile.close();
+    lvAssert__(!oFile.fail(),"could not write packed cache file at '%s'",sTempFilePath.c_str());
+    std::remove(sFilePath.c_str());
+    lvAssert__(std::rename(sTempFilePath.c_str(),sFilePath.c_str())==0,"could not move packed cache file to '%s'",sFilePath.c_str());
+}
+
+bool lv::IIDataLoader::openPackedCache(const std::string& sFilePath) {
+    lvAssert_(!m_oInputPrecacher.isActive() && !m_oGTPrecacher.isActive(),"precaching must be stopped before opening a packed cache");
+    closePackedCache();
+    {
+        // files too short to even hold a header (e.g. empty ones, which cannot be mapped) are as stale as missing ones
+        std::ifstream oFile(sFilePath,std::ios::in|std::ios::binary|std::ios::ate);
+        if(!oFile.is_open() || oFile.tellg()<std::streamoff(sizeof(PackedCacheHeader)))
+            return false;
+    }
+    std::unique_ptr<MemoryMappedFile> pPackedCache(new MemoryMappedFile(sFilePath));
+    uchar* pData = (uchar*)pPackedCache->data();
+    const size_t nFileSize = pPackedCache->size();
+    PackedCacheHeader oHeader;
+    if(nFileSize<sizeof(oHeader))
+        return false;
+    std::memcpy(&oHeader,pData,sizeof(oHeader));
+    // the cache is considered stale if it was written with other transformation parameters or for another set of packets
+    const size_t nInputCount = getInputCount();
+    if(std::memcmp(oHeader.acMagic,s_acPackedCacheMagic,sizeof(s_acPackedCacheMagic)) || oHeader.nVersion!=s_nPackedCacheVersion ||
+       oHeader.nFlags!=getPackedCacheFlags(*this) || oHeader.dScaleFactor!=getScaleFactor() || oHeader.nInputCount!=(uint64_t)nInputCount ||
+       (oHeader.nGTCount!=0 && oHeader.nGTCount!=(uint64_t)std::max(nInputCount,getGTCount())))
+        return false;
+    const size_t nGTCount = (size_t)oHeader.nGTCount;
+    const size_t nTableOffset = sizeof(oHeader), nNameTableOffset = nTableOffset+(nInputCount+nGTCount)*sizeof(PackedCacheEntry);
+    if(nFileSize<nNameTableOffset || oHeader.nNameTableSize>nFileSize-nNameTableOffset)
+        return false;
+    const char* pNameTable = (const char*)pData+nNameTableOffset;
+    size_t nNameTableSize = (size_t)oHeader.nNameTableSize;
+    for(size_t nPacketIdx=0; nPacketIdx<nInputCount; ++nPacketIdx) {
+        const std::string sName = getInputName(nPacketIdx);
+        if(nNameTableSize<=sName.size() || sName.compare(0,sName.size(),pNameTable,sName.size()) || pNameTable[sName.size()]!='\0')
+            return false;
+        pNameTable += sName.size()+1;
+        nNameTableSize -= sName.size()+1;
+    }
+    std::vector<cv::Mat> vPackets(nInputCount+nGTCount);
+    for(size_t nEntryIdx=0; nEntryIdx<vPackets.size(); ++nEntryIdx) {
+        PackedCacheEntry oEntry;
+        std::memcpy(&oEntry,pData+nTableOffset+nEntryIdx*sizeof(PackedCacheEntry),sizeof(oEntry));
+        if(oEntry.nRows==0 && oEntry.nCols==0)
+            continue;
+        // sizes are checked without overflowing, as corrupted entries may hold any value
+        if(oEntry.nRows<0 || oEntry.nCols<0 || oEntry.nType<0 || (oEntry.nType&~CV_MAT_TYPE_MASK) || oEntry.nOffset%s_nPackedCacheAlign ||
+           oEntry.nOffset>nFileSize || uint64_t(oEntry.nRows)*uint64_t(oEntry.nCols)>(nFileSize-oEntry.nOffset)/CV_ELEM_SIZE(oEntry.nType))
+            return false;
+        vPackets[nEntryIdx] = cv::Mat(oEntry.nRows,oEntry.nCols,oEntry.nType,pData+oEntry.nOffset);
+    }
+    m_vPackedInputs.assign(vPackets.begin(),vPackets.begin()+nInputCount);
+    m_vPackedGTs.assign(vPackets.begin()+nInputCount,vPackets.end());
+    m_pPackedCache = std::move(pPackedCache);
+    return true;
 }
 
-const cv::Mat& lv::IIDataLoader::getGT(size_t nPacketIdx) {
-    return m_oGTPrecacher.getPacket(nPacketIdx);
+void lv::IIDataLoader::closePackedCache() {
+    m_vPackedInputs.clear();
+    m_vPackedGTs.clear();
+    m_pPackedCache = nullptr;
 }
 
 const cv::Mat& lv::IIDataLoader::getInputROI(size_t /*nPacketIdx*/) const {
@@ -501,46 +1549,127 @@ const cv::Size& lv::IIDataLoader::getGTMaxSize() const {
 }
 
 lv::IIDataLoader::IIDataLoader(PacketPolicy eInputType, PacketPolicy eGTType, PacketPolicy eOutputType, MappingPolicy eGTMappingType, MappingPolicy eIOMappingType) :
-        m_oInputPrecacher(std::bind(&IIDataLoader::getInput_redirect,this,std::placeholders::_1)),
-        m_oGTPrecacher(std::bind(&IIDataLoader::getGT_redirect,this,std::placeholders::_1)),
+        m_nInPlaceInputType(-1),
+        m_nRawInputBufferIdx(size_t(-1)),
+        m_oInputPrecacher(std::bind(&IIDataLoader::getInput_redirect,this,std::placeholders::_1),std::bind(&IIDataLoader::loadInput,this,std::placeholders::_1),std::bind(&IIDataLoader::loadInput_inplace,this,std::placeholders::_1,std::placeholders::_2)),
+        m_oGTPrecacher(std::bind(&IIDataLoader::getGT_redirect,this,std::placeholders::_1),std::bind(&IIDataLoader::loadGT,this,std::placeholders::_1)),
         m_eInputType(eInputType),m_eGTType(eGTType),m_eOutputType(eOutputType),m_eGTMappingType(eGTMappingType),m_eIOMappingType(eIOMappingType) {}
 
+void lv::IIDataLoader::getRawInput_inplace(size_t nPacketIdx, cv::Mat& oPacket) {
+    oPacket = getRawInput(nPacketIdx);
+}
+
 const cv::Mat& lv::IIDataLoader::getInput_redirect(size_t nIdx) {
-    m_oLatestInput = getRawInput(nIdx);
-    if(!m_oLatestInput.empty()) {
+    m_oLatestInput = loadInput(nIdx);
+    return m_oLatestInput;
+}
+
+const cv::Mat& lv::IIDataLoader::getGT_redirect(size_t nIdx) {
+    m_oLatestGT = loadGT(nIdx);
+    return m_oLatestGT;
+}
+
+cv::Mat lv::IIDataLoader::loadInput(size_t nIdx) {
+    cv::Mat oInput = getRawInput(nIdx);
+    if(!oInput.empty()) {
         if(m_eInputType==ImagePacket) {
 #if HARDCODE_IMAGE_PACKET_INDEX
             std::stringstream sstr;
             sstr << "Packet #" << nIdx;
-            cv::putText(m_oLatestInput,sstr.str(),cv::Scalar_<uchar>::all(255));
+            cv::putText(oInput,sstr.str(),cv::Scalar_<uchar>::all(255));
 #endif //HARDCODE_IMAGE_PACKET_INDEX
-            if(is4ByteAligned() && m_oLatestInput.channels()==3)
-                cv::cvtColor(m_oLatestInput,m_oLatestInput,cv::COLOR_BGR2BGRA);
+            if(is4ByteAligned() && oInput.channels()==3)
+                cv::cvtColor(oInput,oInput,cv::COLOR_BGR2BGRA);
             const cv::Size& oPacketSize = getInputSize(nIdx);
-            if(oPacketSize.area()>0 && m_oLatestInput.size()!=oPacketSize)
-                cv::resize(m_oLatestInput,m_oLatestInput,oPacketSize,0,0,cv::INTER_NEAREST);
+            if(oPacketSize.area()>0 && oInput.size()!=oPacketSize)
+                cv::resize(oInput,oInput,oPacketSize,0,0,cv::INTER_NEAREST);
         }
     }
-    return m_oLatestInput;
+    return oInput;
 }
 
-const cv::Mat& lv::IIDataLoader::getGT_redirect(size_t nIdx) {
-    m_oLatestGT = getRawGT(nIdx);
-    if(!m_oLatestGT.empty()) {
+cv::Mat lv::IIDataLoader::loadInput_inplace(size_t nIdx, const DataPrecacher::PacketAllocator& lAllocator) {
+    if(m_nRawInputBufferIdx==nIdx) {
+        // raw packet was already decoded by a previous call which ran out of cache space; only its transformation is left
+    }
+    else if(m_oInPlaceInputSize.area()>0) {
+        // last packet needed no transformation, so try decoding this one straight into the cache
+        cv::Mat oPacket = lAllocator(m_oInPlaceInputSize,m_nInPlaceInputType);
+        if(oPacket.empty())
+            return oPacket; // cache is full, retry later
+        const uchar* pCacheSlot = oPacket.data;
+        getRawInput_inplace(nIdx,oPacket);
+        if(oPacket.empty())
+            return oPacket;
+        else if(oPacket.data!=pCacheSlot)
+            m_oRawInputBuffer = oPacket; // packet layout changed (or loader reallocated), transform below
+        else if(m_eInputType==ImagePacket && getInputSize(nIdx).area()>0 && getInputSize(nIdx)!=oPacket.size())
+            oPacket.copyTo(m_oRawInputBuffer); // cache slot will be reused as output of the transformation below
+        else
+            return oPacket;
+        m_nRawInputBufferIdx = nIdx;
+    }
+    else {
+        getRawInput_inplace(nIdx,m_oRawInputBuffer);
+        m_nRawInputBufferIdx = nIdx;
+    }
+    if(m_oRawInputBuffer.empty())
+        return cv::Mat();
+    cv::Size oPacketSize = m_oRawInputBuffer.size();
+    int nPacketType = m_oRawInputBuffer.type();
+    bool bConvert = false, bResize = false;
+    if(m_eInputType==ImagePacket) {
+        bConvert = is4ByteAligned() && m_oRawInputBuffer.channels()==3;
+        if(bConvert)
+            nPacketType = CV_MAKETYPE(m_oRawInputBuffer.depth(),4);
+        const cv::Size& oInputSize = getInputSize(nIdx);
+        bResize = oInputSize.area()>0 && oPacketSize!=oInputSize;
+        if(bResize)
+            oPacketSize = oInputSize;
+    }
+    m_oInPlaceInputSize = (bConvert||bResize||HARDCODE_IMAGE_PACKET_INDEX)?cv::Size():oPacketSize;
+    m_nInPlaceInputType = nPacketType;
+    // cv output arrays which already have the right size/type are written in place, i.e. directly in the cache
+    cv::Mat oPacket = lAllocator(oPacketSize,nPacketType);
+    if(oPacket.empty())
+        return oPacket;
+    if(bConvert && bResize) {
+        cv::resize(m_oRawInputBuffer,m_oTempInputBuffer,oPacketSize,0,0,cv::INTER_NEAREST);
+        cv::cvtColor(m_oTempInputBuffer,oPacket,cv::COLOR_BGR2BGRA);
+    }
+    else if(bConvert)
+        cv::cvtColor(m_oRawInputBuffer,oPacket,cv::COLOR_BGR2BGRA);
+    else if(bResize)
+        cv::resize(m_oRawInputBuffer,oPacket,oPacketSize,0,0,cv::INTER_NEAREST);
+    else
+        m_oRawInputBuffer.copyTo(oPacket);
+#if HARDCODE_IMAGE_PACKET_INDEX
+    if(m_eInputType==ImagePacket) {
+        std::stringstream sstr;
+        sstr << "Packet #" << nIdx;
+        cv::putText(oPacket,sstr.str(),cv::Scalar_<uchar>::all(255));
+    }
+#endif //HARDCODE_IMAGE_PACKET_INDEX
+    return oPacket;
+}
+
+cv::Mat lv::IIDataLoader::loadGT(size_t nIdx) {
+    cv::Mat oGT = getRawGT(nIdx);
+    if(!oGT.empty()) {
         if(m_eGTType==ImagePacket) {
 #if HARDCODE_IMAGE_PACKET_INDEX
             std::stringstream sstr;
             sstr << "Packet #" << nIdx;
-            cv::putText(m_oLatestGT,sstr.str(),cv::Scalar_<uchar>::all(255));
+            cv::putText(oGT,sstr.str(),cv::Scalar_<uchar>::all(255));
 #endif //HARDCODE_IMAGE_PACKET_INDEX
-            if(is4ByteAligned() && m_oLatestGT.channels()==3)
-                cv::cvtColor(m_oLatestGT,m_oLatestGT,cv::COLOR_BGR2BGRA);
+            if(is4ByteAligned() && oGT.channels()==3)
+                cv::cvtColor(oGT,oGT,cv::COLOR_BGR2BGRA);
             const cv::Size& oPacketSize = getGTSize(nIdx);
-            if(oPacketSize.area()>0 && m_oLatestGT.size()!=oPacketSize)
-                cv::resize(m_oLatestGT,m_oLatestGT,oPacketSize,0,0,cv::INTER_NEAREST);
+            if(oPacketSize.area()>0 && oGT.size()!=oPacketSize)
+                cv::resize(oGT,oGT,oPacketSize,0,0,cv::INTER_NEAREST);
         }
     }
-    return m_oLatestGT;
+    return oGT;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -570,13 +1699,20 @@ const std::vector<cv::Mat>& lv::IDataLoader_<lv::Array>::getInputArray(size_t nP
     return m_vLatestUnpackedInput;
 }
 
-const std::vector<cv::Mat>& lv::IDataLoader_<lv::Array>::getGTArray(size_t nPacketIdx) {
+const std::vector<cv::Mat>& lv::IDataLoader_<lv::Array>::getGTArray(size_t nPacketIdx, size_t nReaderIdx) {
     if(getGTStreamCount()==0)
         return cv::emptyMatArray();
     // add last check logic...?
-    m_vLatestUnpackedGT.resize(getGTStreamCount());
-    unpackGT(nPacketIdx,m_vLatestUnpackedGT);
-    return m_vLatestUnpackedGT;
+    std::vector<cv::Mat>* pLatestUnpackedGT;
+    {
+        std::mutex_lock_guard sync_lock(m_oUnpackedGTMutex);
+        while(nReaderIdx>=m_vvLatestUnpackedGT.size())
+            m_vvLatestUnpackedGT.emplace_back();
+        pLatestUnpackedGT = &m_vvLatestUnpackedGT[nReaderIdx];
+    }
+    pLatestUnpackedGT->resize(getGTStreamCount());
+    unpackGT(nPacketIdx,*pLatestUnpackedGT,nReaderIdx);
+    return *pLatestUnpackedGT;
 }
 
 const std::vector<cv::Mat>& lv::IDataLoader_<lv::Array>::getInputROIArray(size_t /*nPacketIdx*/) const {
@@ -629,9 +1765,9 @@ void lv::IDataLoader_<lv::Array>::unpackInput(size_t nPacketIdx, std::vector<cv:
         lvError("unhandled packet type in unpackInput");
 }
 
-void lv::IDataLoader_<lv::Array>::unpackGT(size_t nPacketIdx, std::vector<cv::Mat>& vUnpackedGT) {
-    // no need to clone if getGT does not allow reentrancy --- output mats in the vector will stay valid for as long as oGT is valid (typically until next getGT call)
-    const cv::Mat& oGT = getGT(nPacketIdx)/*.clone()*/;
+void lv::IDataLoader_<lv::Array>::unpackGT(size_t nPacketIdx, std::vector<cv::Mat>& vUnpackedGT, size_t nReaderIdx) {
+    // no need to clone if getGT does not allow reentrancy --- output mats in the vector will stay valid for as long as oGT is valid (typically until the reader's next getGT call)
+    const cv::Mat& oGT = getGT(nPacketIdx,nReaderIdx)/*.clone()*/;
     if(getGTPacketType()==ImagePacket)
         vUnpackedGT[0] = oGT;
     else if(getGTPacketType()==ImageArrayPacket) {
@@ -716,8 +1852,17 @@ const cv::Size& lv::IDataProducer_<lv::DatasetSource_Video>::getGTMaxSize() cons
 
 cv::Mat lv::IDataProducer_<lv::DatasetSource_Video>::getRawInput(size_t nPacketIdx) {
     cv::Mat oFrame;
-    if(!m_voVideoReader.isOpened() && nPacketIdx<m_vsInputPaths.size())
-        oFrame = cv::imread(m_vsInputPaths[nPacketIdx],isGrayscale()?cv::IMREAD_GRAYSCALE:cv::IMREAD_COLOR);
+    getRawInput_inplace(nPacketIdx,oFrame);
+    return oFrame;
+}
+
+void lv::IDataProducer_<lv::DatasetSource_Video>::getRawInput_inplace(size_t nPacketIdx, cv::Mat& oFrame) {
+    if(m_pVideoReader) {
+        if(!m_pVideoReader->read(nPacketIdx,oFrame))
+            oFrame.release();
+    }
+    else if(!m_voVideoReader.isOpened() && nPacketIdx<m_vsInputPaths.size())
+        imreadInto(m_vsInputPaths[nPacketIdx],isGrayscale()?cv::IMREAD_GRAYSCALE:cv::IMREAD_COLOR,oFrame);
     else {
         if(m_nNextExpectedVideoReaderFrameIdx!=nPacketIdx) {
             m_voVideoReader.set(cv::CAP_PROP_POS_FRAMES,(double)nPacketIdx);
@@ -725,15 +1870,14 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_Video>::getRawInput(size_t nPacketI
         }
         else
             ++m_nNextExpectedVideoReaderFrameIdx;
-        m_voVideoReader >> oFrame;
+        m_voVideoReader >> oFrame; // frames are retrieved in place when their size/type match
     }
-    return oFrame;
 }
 
 cv::Mat lv::IDataProducer_<lv::DatasetSource_Video>::getRawGT(size_t nPacketIdx) {
     lvAssert_(getGTPacketType()==ImagePacket,"default impl only works for image gt packets");
     if(m_mGTIndexLUT.count(nPacketIdx)) {
-        const size_t nGTIdx = m_mGTIndexLUT[nPacketIdx];
+        const size_t nGTIdx = m_mGTIndexLUT.at(nPacketIdx);
         if(nGTIdx<m_vsGTPaths.size())
             return cv::imread(m_vsGTPaths[nGTIdx],cv::IMREAD_GRAYSCALE); // default = load as grayscale (override if not ok)
     }
@@ -742,30 +1886,42 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_Video>::getRawGT(size_t nPacketIdx)
 
 void lv::IDataProducer_<lv::DatasetSource_Video>::parseData() {
     lvDbgExceptionWatch;
-    cv::Mat oTempImg;
+    cv::Size oFrameSize;
+    m_pVideoReader.reset();
     m_voVideoReader.open(getDataPath());
     if(!m_voVideoReader.isOpened()) {
-        lv::GetFilesFromDir(getDataPath(),m_vsInputPaths);
+        getIndexCache().getFilesFromDir(getDataPath(),m_vsInputPaths);
         if(m_vsInputPaths.size()>1) {
-            oTempImg = cv::imread(m_vsInputPaths[0]);
+            oFrameSize = getIndexCache().getImageSize(m_vsInputPaths[0]);
             m_nFrameCount = m_vsInputPaths.size();
         }
         else if(m_vsInputPaths.size()==1)
             m_voVideoReader.open(m_vsInputPaths[0]);
     }
     if(m_voVideoReader.isOpened()) {
+        cv::Mat oTempImg;
         m_voVideoReader.set(cv::CAP_PROP_POS_FRAMES,0);
         m_voVideoReader >> oTempImg;
         m_voVideoReader.set(cv::CAP_PROP_POS_FRAMES,0);
         m_nFrameCount = (size_t)m_voVideoReader.get(cv::CAP_PROP_FRAME_COUNT);
+        oFrameSize = oTempImg.size();
+        std::vector<size_t> vnKeyFrameIdxs;
+        const size_t nIndexedFrameCount = (m_vsInputPaths.size()==1 && !oTempImg.empty())?getIndexCache().getVideoIndex(m_vsInputPaths[0],vnKeyFrameIdxs):0;
+        if(nIndexedFrameCount>0) {
+            // demuxed frame counts are exact (unlike container estimates); the sequential reader is closed, as it cannot be used concurrently anyway
+            m_nFrameCount = nIndexedFrameCount;
+            const size_t nMaxBufferedFrames = std::max(VIDEOREADER_BUFFER_SIZE/(oTempImg.total()*oTempImg.elemSize()),size_t(1));
+            m_pVideoReader = std::make_unique<ParallelVideoReader>(m_vsInputPaths[0],m_nFrameCount,vnKeyFrameIdxs,std::min(size_t(VIDEOREADER_MAX_DECODE_THREADS),(size_t)std::thread::hardware_concurrency()),nMaxBufferedFrames);
+            m_voVideoReader.release();
+        }
     }
-    if(oTempImg.empty())
+    if(oFrameSize.area()==0)
         lvError_("Sequence '%s': video could not be opened via VideoReader or imread (you might need to implement your own DataProducer_ interface)",getName().c_str());
     const double dScale = getScaleFactor();
     if(dScale!=1.0)
-        cv::resize(oTempImg,oTempImg,cv::Size(),dScale,dScale,cv::INTER_NEAREST);
-    m_oInputROI = cv::Mat(oTempImg.size(),CV_8UC1,cv::Scalar_<uchar>(255));
-    m_oInputSize = oTempImg.size();
+        oFrameSize = cv::Size(cvRound(oFrameSize.width*dScale),cvRound(oFrameSize.height*dScale)); // same rounding as cv::resize
+    m_oInputROI = cv::Mat(oFrameSize,CV_8UC1,cv::Scalar_<uchar>(255));
+    m_oInputSize = oFrameSize;
     m_nNextExpectedVideoReaderFrameIdx = 0;
     lvAssert_(m_nFrameCount>0,"could not find any input frames");
 }
@@ -864,7 +2020,7 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_VideoArray>::getRawInput(size_t nPa
 cv::Mat lv::IDataProducer_<lv::DatasetSource_VideoArray>::getRawGT(size_t nPacketIdx) {
     lvAssert_(getGTPacketType()<=ImageArrayPacket,"default impl only works for image array or image gt packets");
     if(m_mGTIndexLUT.count(nPacketIdx)) {
-        const size_t nGTIdx = m_mGTIndexLUT[nPacketIdx];
+        const size_t nGTIdx = m_mGTIndexLUT.at(nPacketIdx);
         if(nGTIdx<m_vvsGTPaths.size()) {
             const std::vector<std::string>& vsGTPaths = m_vvsGTPaths[nGTIdx];
             if(vsGTPaths.empty())
@@ -969,7 +2125,7 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_Image>::getRawInput(size_t nPacketI
 cv::Mat lv::IDataProducer_<lv::DatasetSource_Image>::getRawGT(size_t nPacketIdx) {
     lvAssert_(getGTPacketType()==ImagePacket,"default impl only works for image gt packets");
     if(m_mGTIndexLUT.count(nPacketIdx)) {
-        const size_t nGTIdx = m_mGTIndexLUT[nPacketIdx];
+        const size_t nGTIdx = m_mGTIndexLUT.at(nPacketIdx);
         if(nGTIdx<m_vsGTPaths.size())
             return cv::imread(m_vsGTPaths[nGTIdx],cv::IMREAD_GRAYSCALE); // default = load as grayscale (override if not ok)
     }
@@ -978,7 +2134,7 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_Image>::getRawGT(size_t nPacketIdx)
 
 void lv::IDataProducer_<lv::DatasetSource_Image>::parseData() {
     lvDbgExceptionWatch;
-    lv::GetFilesFromDir(getDataPath(),m_vsInputPaths);
+    getIndexCache().getFilesFromDir(getDataPath(),m_vsInputPaths);
     lv::FilterFilePaths(m_vsInputPaths,{},{".jpg",".png",".bmp"});
     if(m_vsInputPaths.empty())
         lvError_("Set '%s' did not possess any jpg/png/bmp image file",getName().c_str());
@@ -988,25 +2144,25 @@ void lv::IDataProducer_<lv::DatasetSource_Image>::parseData() {
     m_vInputSizes.reserve(m_vsInputPaths.size());
     cv::Size oLastSize;
     const double dScale = getScaleFactor();
+    // image sizes come from the dataset index when valid; otherwise, all images are read in parallel (unreadable ones are dropped)
+    const std::vector<cv::Size> voImageSizes = getIndexCache().getImageSizes(m_vsInputPaths,isGrayscale()?cv::IMREAD_GRAYSCALE:cv::IMREAD_COLOR);
+    std::vector<std::string> vsReadablePaths;
+    vsReadablePaths.reserve(m_vsInputPaths.size());
     for(size_t n = 0; n<m_vsInputPaths.size(); ++n) {
-        cv::Mat oCurrInput = cv::imread(m_vsInputPaths[n],isGrayscale()?cv::IMREAD_GRAYSCALE:cv::IMREAD_COLOR);
-        while(oCurrInput.empty()) {
-            m_vsInputPaths.erase(m_vsInputPaths.begin()+n);
-            if(n>=m_vsInputPaths.size())
-                break;
-            oCurrInput = cv::imread(m_vsInputPaths[n],isGrayscale()?cv::IMREAD_GRAYSCALE:cv::IMREAD_COLOR);
-        }
-        if(oCurrInput.empty())
-            break;
+        if(voImageSizes[n].area()==0)
+            continue;
+        vsReadablePaths.push_back(m_vsInputPaths[n]);
+        cv::Size oCurrSize = voImageSizes[n];
         if(dScale!=1.0)
-            cv::resize(oCurrInput,oCurrInput,cv::Size(),dScale,dScale,cv::INTER_NEAREST);
-        m_vInputSizes.push_back(oCurrInput.size());
-        m_oInputMaxSize.width = std::max(oCurrInput.cols,m_oInputMaxSize.width);
-        m_oInputMaxSize.height = std::max(oCurrInput.rows,m_oInputMaxSize.height);
-        if(oLastSize.area() && oCurrInput.size()!=oLastSize)
+            oCurrSize = cv::Size(cvRound(oCurrSize.width*dScale),cvRound(oCurrSize.height*dScale)); // same rounding as cv::resize
+        m_vInputSizes.push_back(oCurrSize);
+        m_oInputMaxSize.width = std::max(oCurrSize.width,m_oInputMaxSize.width);
+        m_oInputMaxSize.height = std::max(oCurrSize.height,m_oInputMaxSize.height);
+        if(oLastSize.area() && oCurrSize!=oLastSize)
             m_bIsInputConstantSize = false;
-        oLastSize = oCurrInput.size();
+        oLastSize = oCurrSize;
     }
+    m_vsInputPaths = std::move(vsReadablePaths);
     lvAssert_(!m_vInputSizes.empty(),"could not find any input images");
 }
 
@@ -1099,7 +2255,7 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_ImageArray>::getRawInput(size_t nPa
 cv::Mat lv::IDataProducer_<lv::DatasetSource_ImageArray>::getRawGT(size_t nPacketIdx) {
     lvAssert_(getGTPacketType()<=ImageArrayPacket,"default impl only works for image array or image gt packets");
     if(m_mGTIndexLUT.count(nPacketIdx)) {
-        const size_t nGTIdx = m_mGTIndexLUT[nPacketIdx];
+        const size_t nGTIdx = m_mGTIndexLUT.at(nPacketIdx);
         if(nGTIdx<m_vvsGTPaths.size()) {
             const std::vector<std::string>& vsGTPaths = m_vvsGTPaths[nGTIdx];
             if(vsGTPaths.empty())
@@ -1139,8 +2295,50 @@ cv::Mat lv::IDataProducer_<lv::DatasetSource_ImageArray>::getRawGT(size_t nPacke
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void lv::IDataCounter::setLiveReporting(bool bEnabled) {
+    std::mutex_lock_guard sync_lock(m_oLiveMutex);
+    m_bLiveReporting = bEnabled;
+    m_bLiveSnapshotRequested = bEnabled;
+    m_bLiveSnapshotReady = false;
+    m_oLiveSnapshot = DataLiveSnapshot();
+}
+
+bool lv::IDataCounter::fetchLiveSnapshot(DataLiveSnapshot& oSnapshot) {
+    std::mutex_lock_guard sync_lock(m_oLiveMutex);
+    m_bLiveSnapshotRequested = true;
+    if(!m_bLiveSnapshotReady)
+        return false;
+    oSnapshot = std::move(m_oLiveSnapshot);
+    m_oLiveSnapshot = DataLiveSnapshot();
+    m_bLiveSnapshotReady = false;
+    return true;
+}
+
 void lv::IDataCounter::countOutput(size_t nPacketIdx) {
-    m_mProcessedPackets.insert(nPacketIdx);
+    if(m_mProcessedPackets.insert(nPacketIdx).second)
+        ++m_nProcessedPacketCount;
+    ++m_nMetricsRevision;
+    const std::chrono::high_resolution_clock::time_point nNow = std::chrono::high_resolution_clock::now();
+    if(m_bLiveReporting) {
+        std::mutex_lock_guard sync_lock(m_oLiveMutex);
+        m_dLastOutputTime = std::chrono::duration<double>(nNow-m_nStartTick).count();
+    }
+    m_oLatencyHistogram.record(std::chrono::duration<double>(nNow-m_nLastOutputTick).count());
+    m_nLastOutputTick = nNow;
+}
+
+void lv::IDataCounter::updateLiveSnapshot(bool bFinal) {
+    if(!m_bLiveReporting || (!bFinal && !m_bLiveSnapshotRequested))
+        return;
+    m_bLiveSnapshotRequested = false;
+    // metrics are computed outside the lock, as they might take a while for large accumulators
+    std::shared_ptr<const IIMetricsCalculator> pMetrics = isEvaluating()?getLiveMetrics():nullptr;
+    std::mutex_lock_guard sync_lock(m_oLiveMutex);
+    m_oLiveSnapshot.nOutputCount = m_nProcessedPacketCount;
+    m_oLiveSnapshot.dProcessTime = m_dLastOutputTime;
+    m_oLiveSnapshot.pMetrics = std::move(pMetrics);
+    m_oLiveSnapshot.bIsFinal = bFinal;
+    m_bLiveSnapshotReady = true;
 }
 
 void lv::IDataCounter::setOutputCountPromise() {
@@ -1149,30 +2347,133 @@ void lv::IDataCounter::setOutputCountPromise() {
 
 void lv::IDataCounter::resetOutputCount() {
     m_mProcessedPackets.clear();
+    m_nProcessedPacketCount = 0;
+    ++m_nMetricsRevision;
+    m_oLatencyHistogram.reset();
+    m_nStartTick = m_nLastOutputTick = std::chrono::high_resolution_clock::now();
+    {
+        std::mutex_lock_guard sync_lock(m_oLiveMutex);
+        m_dLastOutputTime = 0.0;
+    }
     m_nPacketCountPromise = std::promise<size_t>();
     m_nPacketCountFuture = m_nPacketCountPromise.get_future();
     m_nFinalPacketCount = 0;
 }
 
 size_t lv::IDataCounter::getCurrentOutputCount() const {
-    return m_mProcessedPackets.size();
+    return m_nProcessedPacketCount;
 }
 
 size_t lv::IDataCounter::getFinalOutputCount() {
     return m_nPacketCountFuture.valid()?(m_nFinalPacketCount=m_nPacketCountFuture.get()):m_nFinalPacketCount;
 }
 
+void lv::IDataCounter::mergeLatencyHistogram(LatencyHistogram& oHist) const {
+    oHist.merge(m_oLatencyHistogram);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+lv::DataConsumerQueue::DataConsumerQueue(std::function<void(const std::vector<cv::Mat>&,size_t)> lConsumerCallback, size_t nMaxQueuedPackets) :
+        m_lCallback(lConsumerCallback),
+        m_nMaxQueuedPackets(nMaxQueuedPackets),
+        m_nPeakQueueCount(0),
+        m_bIsBusy(false),
+        m_bIsActive(true) {
+    lvAssert_(m_lCallback,"invalid data consumer callback");
+    lvAssert_(m_nMaxQueuedPackets>0,"data consumer queue must hold at least one packet");
+    m_hWorker = std::thread(&DataConsumerQueue::entry,this);
+}
+
+lv::DataConsumerQueue::~DataConsumerQueue() {
+    {
+        std::mutex_lock_guard sync_lock(m_oSyncMutex);
+        m_bIsActive = false;
+    }
+    m_oQueueCondVar.notify_all();
+    m_hWorker.join();
+}
+
+void lv::DataConsumerQueue::push(std::vector<cv::Mat>&& vPacket, size_t nIdx) {
+    std::mutex_unique_lock sync_lock(m_oSyncMutex);
+    m_oClearCondVar.wait(sync_lock,[&]{return m_qPackets.size()<m_nMaxQueuedPackets || m_pWorkerException;});
+    rethrowWorkerException();
+    m_qPackets.emplace_back(std::move(vPacket),nIdx);
+    if(m_qPackets.size()>m_nPeakQueueCount)
+        m_nPeakQueueCount = m_qPackets.size();
+    sync_lock.unlock();
+    m_oQueueCondVar.notify_one();
+}
+
+void lv::DataConsumerQueue::flush() {
+    std::mutex_unique_lock sync_lock(m_oSyncMutex);
+    m_oClearCondVar.wait(sync_lock,[&]{return (m_qPackets.empty() && !m_bIsBusy) || m_pWorkerException;});
+    rethrowWorkerException();
+}
+
+void lv::DataConsumerQueue::rethrowWorkerException() {
+    if(m_pWorkerException) {
+        // packets queued behind the failed one are dropped along with it
+        std::exception_ptr pWorkerException = m_pWorkerException;
+        m_pWorkerException = nullptr;
+        m_qPackets.clear();
+        std::rethrow_exception(pWorkerException);
+    }
+}
+
+void lv::DataConsumerQueue::entry() {
+    // the queue's thread already runs alongside the processing thread, so nested parallel loops (e.g. large frame evaluation) stay serial here
+    lv::ParallelRegionGuard oGuard;
+    std::mutex_unique_lock sync_lock(m_oSyncMutex);
+    while(true) {
+        m_oQueueCondVar.wait(sync_lock,[&]{return !m_bIsActive || (!m_qPackets.empty() && !m_pWorkerException);});
+        if(!m_bIsActive)
+            break;
+        std::pair<std::vector<cv::Mat>,size_t> oPacket = std::move(m_qPackets.front());
+        m_qPackets.pop_front();
+        m_bIsBusy = true;
+        sync_lock.unlock();
+        m_oClearCondVar.notify_all();
+        std::exception_ptr pException;
+        try {
+            m_lCallback(oPacket.first,oPacket.second);
+        }
+        catch(...) {
+            pException = std::current_exception();
+        }
+        sync_lock.lock();
+        m_bIsBusy = false;
+        if(pException)
+            m_pWorkerException = pException;
+        m_oClearCondVar.notify_all();
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-lv::DataWriter::DataWriter(std::function<size_t(const cv::Mat&,size_t)> lDataArchiverCallback) :
-        m_lCallback(lDataArchiverCallback) {
+lv::DataWriter::DataWriter(std::function<size_t(const cv::Mat&,size_t)> lDataArchiverCallback, std::function<cv::Mat(const cv::Mat&,size_t)> lDataEncoderCallback) :
+        m_lCallback(lDataArchiverCallback),
+        m_lEncoderCallback(lDataEncoderCallback) {
+    static_assert(DATAWRITER_RING_SIZE>0 && (DATAWRITER_RING_SIZE&(DATAWRITER_RING_SIZE-1))==0,"data writer ring size must be a power of two");
     lvAssert_(m_lCallback,"invalid data writer callback");
+    m_nRingMask = DATAWRITER_RING_SIZE-1;
+    m_nEnqueuePos = 0;
+    m_nDequeuePos = 0;
+    m_nNextCommitTicket = 0;
+    m_bCommitting = false;
+    m_nIdleWorkers = 0;
+    m_nBlockedWriters = 0;
     m_bIsActive = false;
     m_bAllowPacketDrop = false;
+    m_nQueueMaxSize = 0;
     m_nQueueSize = 0;
     m_nQueueCount = 0;
+    m_nPeakQueueCount = 0;
+    m_nDroppedPacketCount = 0;
 }
 
 lv::DataWriter::~DataWriter() {
@@ -1180,50 +2481,35 @@ lv::DataWriter::~DataWriter() {
 }
 
 size_t lv::DataWriter::queue(const cv::Mat& oPacket, size_t nIdx) {
-    if(!m_bIsActive)
-        return m_lCallback(oPacket,nIdx);
-    const size_t nPacketSize = oPacket.total()*oPacket.elemSize();
-    if(nPacketSize>m_nQueueMaxSize)
-        return m_lCallback(oPacket,nIdx);
-    cv::Mat oPacketCopy = oPacket.clone();
-    size_t nPacketPosition;
-    {
-        std::mutex_unique_lock sync_lock(m_oSyncMutex);
-        if(!m_bAllowPacketDrop && m_nQueueSize+nPacketSize>m_nQueueMaxSize)
-            m_oClearCondVar.wait(sync_lock,[&]{return m_nQueueSize+nPacketSize<=m_nQueueMaxSize;});
-        if(m_nQueueSize+nPacketSize<=m_nQueueMaxSize) {
-            m_mQueue[nIdx] = std::move(oPacketCopy);
-            m_nQueueSize += nPacketSize;
-            // @@@ could cut a find operation here using C++17's map::insert_or_assign above
-            nPacketPosition = std::distance(m_mQueue.begin(),m_mQueue.find(nIdx));
-            ++m_nQueueCount;
-            m_oQueueCondVar.notify_one();
-        }
-        else {
-#if CONSOLE_DEBUG
-            std::cout << "data writer [" << uintptr_t(this) << "] dropping packet #" << nIdx << std::endl;
-#endif //CONSOLE_DEBUG
-            nPacketPosition = SIZE_MAX; // packet dropped
-        }
-    }
-#if CONSOLE_DEBUG
-    if((nIdx%50)==0)
-        std::cout << "data writer [" << uintptr_t(this) << "] queue @ " << (int)(((float)m_nQueueSize*100)/m_nQueueMaxSize) << "% capacity" << std::endl;
-#endif //CONSOLE_DEBUG
+    return enqueue(oPacket,nIdx,true);
+}
+
+size_t lv::DataWriter::queue(cv::Mat&& oPacket, size_t nIdx) {
+    const size_t nPacketPosition = enqueue(oPacket,nIdx,false);
+    // the writer now holds the only reference; releasing ours keeps the caller from reallocating over queued data
+    oPacket.release();
     return nPacketPosition;
 }
 
 bool lv::DataWriter::startAsyncWriting(size_t nSuggestedQueueSize, bool bDropPacketsIfFull, size_t nWorkers) {
     stopAsyncWriting();
     if(nSuggestedQueueSize>0) {
-        m_bIsActive = true;
         m_bAllowPacketDrop = bDropPacketsIfFull;
         m_nQueueMaxSize = std::max(std::min(nSuggestedQueueSize,CACHE_MAX_SIZE),CACHE_MIN_SIZE);
         m_nQueueSize = 0;
         m_nQueueCount = 0;
-        m_mQueue.clear();
+        m_nPeakQueueCount = 0;
+        m_nDroppedPacketCount = 0;
+        m_aRingSlots.reset(new RingSlot[m_nRingMask+1]);
+        for(size_t nSlotIdx=0; nSlotIdx<=m_nRingMask; ++nSlotIdx)
+            m_aRingSlots[nSlotIdx].nSeq = nSlotIdx;
+        m_nEnqueuePos = 0;
+        m_nDequeuePos = 0;
+        m_nNextCommitTicket = 0;
+        m_bCommitting = false;
+        m_bIsActive = true;
         m_vhWorkers.clear();
-        for(size_t n=0; n<nWorkers; ++n)
+        for(size_t n=0; n<std::max(nWorkers,size_t(1)); ++n)
             m_vhWorkers.emplace_back(std::bind(&DataWriter::entry,this));
     }
     return m_bIsActive;
@@ -1231,10 +2517,16 @@ bool lv::DataWriter::startAsyncWriting(size_t nSuggestedQueueSize, bool bDropPac
 
 void lv::DataWriter::stopAsyncWriting() {
     if(m_bIsActive) {
-        m_bIsActive = false;
+        {
+            std::lock_guard<std::mutex> sync_lock(m_oSyncMutex);
+            m_bIsActive = false;
+        }
         m_oQueueCondVar.notify_all();
         for(std::thread& oWorker : m_vhWorkers)
             oWorker.join();
+        m_vhWorkers.clear();
+        m_aRingSlots.reset();
+        lvDbgAssert_(m_mPendingPackets.empty(),"all popped packets should have been committed by the workers");
     }
     while(!m_vWorkerExceptions.empty()) {
         std::exception_ptr pLatestException = m_vWorkerExceptions.top().first; // add packet idx to exception...? somewhow?
@@ -1243,34 +2535,688 @@ void lv::DataWriter::stopAsyncWriting() {
     }
 }
 
+size_t lv::DataWriter::enqueue(const cv::Mat& oPacket, size_t nIdx, bool bCopy) {
+    if(!m_bIsActive)
+        return m_lCallback(m_lEncoderCallback?m_lEncoderCallback(oPacket,nIdx):oPacket,nIdx);
+    // packets larger than the whole queue simply reserve all of it (they are only pushed once the queue has drained)
+    const size_t nPacketSize = std::min(oPacket.total()*oPacket.elemSize(),m_nQueueMaxSize);
+    const auto lWaitForRoom = [&]() {
+        ++m_nBlockedWriters;
+        {
+            std::mutex_unique_lock sync_lock(m_oSyncMutex);
+            m_oClearCondVar.wait_for(sync_lock,std::chrono::milliseconds(DATAWRITER_WAIT_TIMEOUT_MS));
+        }
+        --m_nBlockedWriters;
+    };
+    size_t nCurrQueueSize = m_nQueueSize;
+    while(nCurrQueueSize+nPacketSize>m_nQueueMaxSize || !m_nQueueSize.compare_exchange_weak(nCurrQueueSize,nCurrQueueSize+nPacketSize)) {
+        if(nCurrQueueSize+nPacketSize<=m_nQueueMaxSize)
+            continue; // lost the race against another writer, but there might still be room left
+        if(m_bAllowPacketDrop) {
+#if CONSOLE_DEBUG
+            std::cout << "data writer [" << uintptr_t(this) << "] dropping packet #" << nIdx << std::endl;
+#endif //CONSOLE_DEBUG
+            ++m_nDroppedPacketCount;
+            return SIZE_MAX;
+        }
+        lWaitForRoom();
+        nCurrQueueSize = m_nQueueSize;
+    }
+    const cv::Mat oPacketRef = bCopy?oPacket.clone():oPacket;
+    const size_t nPacketPosition = m_nQueueCount++; // counted before the push so that workers never see it negative
+    while(!tryPush(oPacketRef,nIdx)) {
+        if(m_bAllowPacketDrop) {
+            m_nQueueSize -= nPacketSize;
+            --m_nQueueCount;
+            ++m_nDroppedPacketCount;
+            return SIZE_MAX;
+        }
+        lWaitForRoom();
+    }
+    size_t nPeakQueueCount = m_nPeakQueueCount;
+    while(nPacketPosition+1>nPeakQueueCount && !m_nPeakQueueCount.compare_exchange_weak(nPeakQueueCount,nPacketPosition+1));
+    if(m_nIdleWorkers>0) {
+        std::lock_guard<std::mutex> sync_lock(m_oSyncMutex);
+        m_oQueueCondVar.notify_one();
+    }
+#if CONSOLE_DEBUG
+    if((nIdx%50)==0)
+        std::cout << "data writer [" << uintptr_t(this) << "] queue @ " << (int)(((float)m_nQueueSize*100)/m_nQueueMaxSize) << "% capacity" << std::endl;
+#endif //CONSOLE_DEBUG
+    return nPacketPosition;
+}
+
+bool lv::DataWriter::tryPush(const cv::Mat& oPacket, size_t nIdx) {
+    // bounded multi-producer/multi-consumer ring (see D. Vyukov's design); slots are claimed via CAS on the ring position
+    size_t nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+    RingSlot* pSlot;
+    while(true) {
+        pSlot = &m_aRingSlots[nPos&m_nRingMask];
+        const size_t nSeq = pSlot->nSeq.load(std::memory_order_acquire);
+        const ptrdiff_t nDiff = (ptrdiff_t)nSeq-(ptrdiff_t)nPos;
+        if(nDiff==0) {
+            if(m_nEnqueuePos.compare_exchange_weak(nPos,nPos+1,std::memory_order_relaxed))
+                break;
+        }
+        else if(nDiff<0)
+            return false; // ring is full
+        else
+            nPos = m_nEnqueuePos.load(std::memory_order_relaxed);
+    }
+    pSlot->oPacket = oPacket;
+    pSlot->nIdx = nIdx;
+    pSlot->nSeq.store(nPos+1,std::memory_order_release);
+    return true;
+}
+
+bool lv::DataWriter::tryPop(cv::Mat& oPacket, size_t& nIdx, size_t& nTicket) {
+    size_t nPos = m_nDequeuePos.load(std::memory_order_relaxed);
+    RingSlot* pSlot;
+    while(true) {
+        pSlot = &m_aRingSlots[nPos&m_nRingMask];
+        const size_t nSeq = pSlot->nSeq.load(std::memory_order_acquire);
+        const ptrdiff_t nDiff = (ptrdiff_t)nSeq-(ptrdiff_t)(nPos+1);
+        if(nDiff==0) {
+            if(m_nDequeuePos.compare_exchange_weak(nPos,nPos+1,std::memory_order_relaxed))
+                break;
+        }
+        else if(nDiff<0)
+            return false; // ring is empty
+        else
+            nPos = m_nDequeuePos.load(std::memory_order_relaxed);
+    }
+    oPacket = pSlot->oPacket;
+    pSlot->oPacket.release();
+    nIdx = pSlot->nIdx;
+    nTicket = nPos; // ring positions are contiguous (drops never reach the ring), so they double as commit tickets
+    pSlot->nSeq.store(nPos+m_nRingMask+1,std::memory_order_release);
+    return true;
+}
+
 void lv::DataWriter::entry() {
-    std::mutex_unique_lock sync_lock(m_oSyncMutex);
 #if CONSOLE_DEBUG
     std::cout << "data writer [" << uintptr_t(this) << "] init w/ max buffer size = " << (m_nQueueMaxSize/1024)/1024 << " mb" << std::endl;
 #endif //CONSOLE_DEBUG
-    while(m_bIsActive || m_nQueueCount>0) {
-        if(m_nQueueCount==0)
-            m_oQueueCondVar.wait(sync_lock);
-        if(m_nQueueCount>0) {
-            auto pCurrPacket = m_mQueue.begin();
-            if(pCurrPacket!=m_mQueue.end()) {
-                const size_t nPacketSize = pCurrPacket->second.total()*pCurrPacket->second.elemSize();
-                if(nPacketSize<=m_nQueueSize) {
-                    try {
-                        std::unlock_guard<std::mutex_unique_lock> oUnlock(sync_lock);
-                        m_lCallback(pCurrPacket->second,pCurrPacket->first);
-                    }
-                    catch(...) {
-                        m_vWorkerExceptions.push(std::make_pair(std::current_exception(),pCurrPacket->first));
-                    }
-                    m_nQueueSize -= nPacketSize;
-                    m_mQueue.erase(pCurrPacket);
-                    --m_nQueueCount;
-                    m_oClearCondVar.notify_all();
+    cv::Mat oPacket;
+    size_t nIdx,nTicket;
+    while(true) {
+        if(!tryPop(oPacket,nIdx,nTicket)) {
+            if(!m_bIsActive && m_nEnqueuePos==m_nDequeuePos)
+                break;
+            ++m_nIdleWorkers;
+            {
+                // timeout covers the (rare) wakeup lost between a push and the idle worker count check
+                std::mutex_unique_lock sync_lock(m_oSyncMutex);
+                m_oQueueCondVar.wait_for(sync_lock,std::chrono::milliseconds(DATAWRITER_WAIT_TIMEOUT_MS),[&]{return !m_bIsActive || m_nEnqueuePos!=m_nDequeuePos;});
+            }
+            --m_nIdleWorkers;
+            continue;
+        }
+        PendingPacket oPendingPacket = {cv::Mat(),nIdx,std::min(oPacket.total()*oPacket.elemSize(),m_nQueueMaxSize),true};
+        if(m_lEncoderCallback) {
+            try {
+                oPendingPacket.oPacket = m_lEncoderCallback(oPacket,nIdx);
+            }
+            catch(...) {
+                addWorkerException(std::current_exception(),nIdx);
+                oPendingPacket.bValid = false; // still committed (as a no-op) so that the packets behind it do not stall
+            }
+        }
+        else
+            oPendingPacket.oPacket = oPacket;
+        oPacket.release();
+        commit(nTicket,std::move(oPendingPacket));
+    }
+}
+
+void lv::DataWriter::commit(size_t nTicket, PendingPacket&& oPacket) {
+    // packets are parked in the reorder buffer by whichever worker popped them; the first worker to find the next
+    // expected ticket in there becomes the committer, and drains it in queue order while the others keep encoding
+    std::mutex_unique_lock commit_lock(m_oCommitMutex);
+    m_mPendingPackets.emplace(nTicket,std::move(oPacket));
+    if(m_bCommitting)
+        return;
+    m_bCommitting = true;
+    while(!m_mPendingPackets.empty() && m_mPendingPackets.begin()->first==m_nNextCommitTicket) {
+        PendingPacket oNextPacket = std::move(m_mPendingPackets.begin()->second);
+        m_mPendingPackets.erase(m_mPendingPackets.begin());
+        ++m_nNextCommitTicket;
+        commit_lock.unlock();
+        if(oNextPacket.bValid) {
+            try {
+                m_lCallback(oNextPacket.oPacket,oNextPacket.nIdx);
+            }
+            catch(...) {
+                addWorkerException(std::current_exception(),oNextPacket.nIdx);
+            }
+        }
+        oNextPacket.oPacket.release();
+        m_nQueueSize -= oNextPacket.nPacketSize;
+        --m_nQueueCount;
+        if(m_nBlockedWriters>0) {
+            std::lock_guard<std::mutex> sync_lock(m_oSyncMutex);
+            m_oClearCondVar.notify_all();
+        }
+        commit_lock.lock();
+    }
+    m_bCommitting = false;
+}
+
+void lv::DataWriter::addWorkerException(std::exception_ptr pException, size_t nIdx) {
+    std::lock_guard<std::mutex> sync_lock(m_oSyncMutex);
+    m_vWorkerExceptions.push(std::make_pair(pException,nIdx));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void lv::encodeMask(const cv::Mat& oMask, std::vector<uchar>& vBuffer) {
+    lvAssert_(!oMask.empty() && oMask.type()==CV_8UC1 && oMask.dims==2,"mask encoding requires a non-empty 2d single-channel 8-bit mat");
+    const size_t nRows = (size_t)oMask.rows, nCols = (size_t)oMask.cols, nPackedRowSize = (nCols+7)/8;
+    MaskBlobHeader oHeader = {MaskBlob_BitPacked,{0,0,0},oMask.rows,oMask.cols};
+    vBuffer.resize(sizeof(oHeader)+nRows*nPackedRowSize);
+    bool bBinary = true;
+    for(size_t nRowIdx=0; nRowIdx<nRows && bBinary; ++nRowIdx)
+        bBinary = packMaskRow(oMask.ptr<uchar>((int)nRowIdx),nCols,vBuffer.data()+sizeof(oHeader)+nRowIdx*nPackedRowSize);
+    // run-length encoding is kept only if it beats bit packing (when the latter is possible at all)
+    const size_t nMaxRunLengthSize = bBinary?vBuffer.size():SIZE_MAX;
+    static thread_local std::vector<uchar> s_vRunLengthBuffer;
+    s_vRunLengthBuffer.resize(sizeof(oHeader));
+    for(size_t nRowIdx=0; nRowIdx<nRows && s_vRunLengthBuffer.size()<nMaxRunLengthSize; ++nRowIdx) {
+        const uchar* pRow = oMask.ptr<uchar>((int)nRowIdx);
+        for(size_t nColIdx=0; nColIdx<nCols;) {
+            const size_t nRunEnd = findMaskRunEnd(pRow,nColIdx+1,nCols,pRow[nColIdx]);
+            s_vRunLengthBuffer.push_back(pRow[nColIdx]);
+            for(size_t nRunLength=nRunEnd-nColIdx; ; nRunLength>>=7) {
+                if(nRunLength<0x80) {
+                    s_vRunLengthBuffer.push_back(uchar(nRunLength));
+                    break;
                 }
+                s_vRunLengthBuffer.push_back(uchar((nRunLength&0x7F)|0x80));
             }
+            nColIdx = nRunEnd;
         }
     }
+    if(s_vRunLengthBuffer.size()<nMaxRunLengthSize) {
+        oHeader.nMode = MaskBlob_RunLength;
+        vBuffer.swap(s_vRunLengthBuffer);
+    }
+    std::memcpy(vBuffer.data(),&oHeader,sizeof(oHeader));
+}
+
+void lv::decodeMask(const uchar* pBuffer, size_t nBufferSize, cv::Mat& oMask) {
+    MaskBlobHeader oHeader;
+    lvAssert_(pBuffer && nBufferSize>=sizeof(oHeader),"bad mask blob size");
+    std::memcpy(&oHeader,pBuffer,sizeof(oHeader));
+    lvAssert_(oHeader.nRows>0 && oHeader.nCols>0 && (oHeader.nMode==MaskBlob_BitPacked || oHeader.nMode==MaskBlob_RunLength),"bad mask blob header");
+    oMask.create(oHeader.nRows,oHeader.nCols,CV_8UC1);
+    const size_t nRows = (size_t)oHeader.nRows, nCols = (size_t)oHeader.nCols;
+    const uchar* pData = pBuffer+sizeof(oHeader);
+    const uchar* const pDataEnd = pBuffer+nBufferSize;
+    if(oHeader.nMode==MaskBlob_BitPacked) {
+        const size_t nPackedRowSize = (nCols+7)/8;
+        lvAssert_(size_t(pDataEnd-pData)==nRows*nPackedRowSize,"bad bit-packed mask blob size");
+        for(size_t nRowIdx=0; nRowIdx<nRows; ++nRowIdx)
+            unpackMaskRow(pData+nRowIdx*nPackedRowSize,nCols,oMask.ptr<uchar>((int)nRowIdx));
+        return;
+    }
+    for(size_t nRowIdx=0; nRowIdx<nRows; ++nRowIdx) {
+        uchar* pRow = oMask.ptr<uchar>((int)nRowIdx);
+        for(size_t nColIdx=0; nColIdx<nCols;) {
+            lvAssert_(pData<pDataEnd,"truncated run-length mask blob");
+            const uchar nVal = *pData++;
+            size_t nRunLength = 0;
+            for(size_t nShift=0; ; nShift+=7) {
+                lvAssert_(pData<pDataEnd && nShift<64,"truncated run-length mask blob");
+                nRunLength |= size_t(*pData&0x7F)<<nShift;
+                if(!(*pData++&0x80))
+                    break;
+            }
+            lvAssert_(nRunLength>0 && nRunLength<=nCols-nColIdx,"bad run length in mask blob");
+            std::fill_n(pRow+nColIdx,nRunLength,nVal);
+            nColIdx += nRunLength;
+        }
+    }
+    lvAssert_(pData==pDataEnd,"bad run-length mask blob size");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+lv::MaskArchive::MaskArchive(const std::string& sFilePath) :
+        m_sFilePath(sFilePath),m_nDataEndOffset(0),m_nFileSize(0),m_nFooterOffset(0),m_nSupersededSize(0),m_bIndexDirty(false) {
+    m_oFile.open(m_sFilePath,std::ios::in|std::ios::out|std::ios::binary);
+    if(!m_oFile.is_open()) {
+        m_oFile.open(m_sFilePath,std::ios::out|std::ios::binary|std::ios::trunc);
+        lvAssert__(m_oFile.is_open(),"could not create mask archive at '%s'",m_sFilePath.c_str());
+        m_oFile.write(s_acMaskArchiveMagic,sizeof(s_acMaskArchiveMagic));
+        m_oFile.close();
+        m_oFile.open(m_sFilePath,std::ios::in|std::ios::out|std::ios::binary);
+        lvAssert__(m_oFile.is_open(),"could not reopen mask archive at '%s'",m_sFilePath.c_str());
+    }
+    char acMagic[sizeof(s_acMaskArchiveMagic)];
+    lvAssert__(m_oFile.read(acMagic,sizeof(acMagic)) && !std::memcmp(acMagic,s_acMaskArchiveMagic,sizeof(acMagic)),"file at '%s' is not a mask archive",m_sFilePath.c_str());
+    m_oFile.seekg(0,std::ios::end);
+    const uint64_t nFileSize = m_nFileSize = (uint64_t)m_oFile.tellg();
+    // the index footer is only trusted if it exactly ends the file; otherwise, records are rescanned (e.g. after a crash)
+    MaskArchiveFooter oFooter;
+    if(nFileSize>=sizeof(s_acMaskArchiveMagic)+sizeof(oFooter) && m_oFile.seekg(nFileSize-sizeof(oFooter)) && m_oFile.read((char*)&oFooter,sizeof(oFooter)) &&
+       !std::memcmp(oFooter.acMagic,s_acMaskArchiveIndexMagic,sizeof(oFooter.acMagic)) && oFooter.nIndexOffset>=sizeof(s_acMaskArchiveMagic) &&
+       oFooter.nIndexOffset+oFooter.nEntryCount*sizeof(MaskArchiveIndexEntry)+sizeof(oFooter)==nFileSize) {
+        std::vector<MaskArchiveIndexEntry> vEntries((size_t)oFooter.nEntryCount);
+        m_oFile.seekg(oFooter.nIndexOffset);
+        if(m_oFile.read((char*)vEntries.data(),std::streamsize(vEntries.size()*sizeof(MaskArchiveIndexEntry)))) {
+            // every entry must point to a payload inside the data section, past its own record header
+            bool bValid = true;
+            for(const MaskArchiveIndexEntry& oEntry : vEntries)
+                bValid &= oEntry.nOffset>=sizeof(s_acMaskArchiveMagic)+sizeof(MaskArchiveRecordHeader) && oEntry.nSize<=UINT32_MAX &&
+                          oEntry.nSize<=oFooter.nIndexOffset && oEntry.nOffset<=oFooter.nIndexOffset-oEntry.nSize;
+            for(size_t nEntryIdx=0; bValid && nEntryIdx<vEntries.size(); ++nEntryIdx)
+                m_mIndex[(size_t)vEntries[nEntryIdx].nIdx] = std::make_pair(vEntries[nEntryIdx].nOffset,(uint32_t)vEntries[nEntryIdx].nSize);
+            if(bValid) {
+                m_nDataEndOffset = oFooter.nIndexOffset;
+                m_nFooterOffset = nFileSize-sizeof(oFooter);
+            }
+        }
+    }
+    if(m_nDataEndOffset==0) {
+        m_oFile.clear();
+        m_mIndex.clear();
+        m_nDataEndOffset = sizeof(s_acMaskArchiveMagic);
+        MaskArchiveRecordHeader oRecord;
+        while(m_nDataEndOffset+sizeof(oRecord)<=nFileSize && m_oFile.seekg(m_nDataEndOffset) && m_oFile.read((char*)&oRecord,sizeof(oRecord)) &&
+              oRecord.nMagic==s_nMaskArchiveRecordMagic && m_nDataEndOffset+sizeof(oRecord)+oRecord.nSize<=nFileSize) {
+            m_mIndex[(size_t)oRecord.nIdx] = std::make_pair(m_nDataEndOffset+sizeof(oRecord),oRecord.nSize);
+            m_nDataEndOffset += sizeof(oRecord)+oRecord.nSize;
+        }
+        m_bIndexDirty = (!m_mIndex.empty() || m_nDataEndOffset!=nFileSize);
+    }
+    uint64_t nLiveDataSize = sizeof(s_acMaskArchiveMagic);
+    for(const auto& oEntry : m_mIndex)
+        nLiveDataSize += sizeof(MaskArchiveRecordHeader)+oEntry.second.second;
+    m_nSupersededSize = m_nDataEndOffset-std::min(nLiveDataSize,m_nDataEndOffset);
+    m_oFile.clear();
+}
+
+lv::MaskArchive::~MaskArchive() {
+    try {
+        flush();
+    }
+    catch(...) {
+        std::cerr << "failed to write mask archive index for '" << m_sFilePath << "'" << std::endl;
+    }
+}
+
+void lv::MaskArchive::write(const cv::Mat& oMask, size_t nIdx) {
+    static thread_local std::vector<uchar> s_vBuffer;
+    lv::encodeMask(oMask,s_vBuffer);
+    lvAssert_(s_vBuffer.size()<=size_t(UINT32_MAX),"mask blob too large for archive");
+    const MaskArchiveRecordHeader oRecord = {s_nMaskArchiveRecordMagic,(uint32_t)s_vBuffer.size(),(uint64_t)nIdx};
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    m_oFile.clear();
+    if(m_nFooterOffset>0) {
+        // new records overwrite the on-disk index, so its footer is invalidated first to force a record rescan if we crash before the next flush
+        const char acNoMagic[sizeof(s_acMaskArchiveIndexMagic)] = {};
+        m_oFile.seekp(m_nFooterOffset+offsetof(MaskArchiveFooter,acMagic));
+        m_oFile.write(acNoMagic,sizeof(acNoMagic));
+        m_oFile.flush();
+        lvAssert__(m_oFile.good(),"could not invalidate index of mask archive at '%s'",m_sFilePath.c_str());
+        m_nFooterOffset = 0;
+    }
+    m_oFile.seekp(m_nDataEndOffset);
+    m_oFile.write((const char*)&oRecord,sizeof(oRecord));
+    m_oFile.write((const char*)s_vBuffer.data(),std::streamsize(s_vBuffer.size()));
+    lvAssert__(m_oFile.good(),"could not write to mask archive at '%s'",m_sFilePath.c_str());
+    auto pEntry = m_mIndex.find(nIdx);
+    if(pEntry!=m_mIndex.end())
+        m_nSupersededSize += sizeof(oRecord)+pEntry->second.second;
+    m_mIndex[nIdx] = std::make_pair(m_nDataEndOffset+sizeof(oRecord),oRecord.nSize);
+    m_nDataEndOffset += sizeof(oRecord)+oRecord.nSize;
+    m_nFileSize = std::max(m_nFileSize,m_nDataEndOffset);
+    m_bIndexDirty = true;
+}
+
+cv::Mat lv::MaskArchive::read(size_t nIdx) {
+    cv::Mat oMask;
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        auto pEntry = m_mIndex.find(nIdx);
+        if(pEntry==m_mIndex.end())
+            return oMask;
+        m_vBuffer.resize(pEntry->second.second);
+        m_oFile.clear();
+        m_oFile.seekg(pEntry->second.first);
+        lvAssert__(m_oFile.read((char*)m_vBuffer.data(),std::streamsize(m_vBuffer.size())),"could not read from mask archive at '%s'",m_sFilePath.c_str());
+        lv::decodeMask(m_vBuffer.data(),m_vBuffer.size(),oMask);
+    }
+    return oMask;
+}
+
+size_t lv::MaskArchive::getMaskCount() {
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    return m_mIndex.size();
+}
+
+void lv::MaskArchive::flush() {
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if(!m_bIndexDirty)
+        return;
+    m_oFile.clear();
+    const uint64_t nIndexSize = m_mIndex.size()*sizeof(MaskArchiveIndexEntry)+sizeof(MaskArchiveFooter);
+    if(m_nSupersededSize>0 || m_nDataEndOffset+nIndexSize<m_nFileSize) {
+        // superseded records (or stale bytes past the new footer) are dropped by rewriting the live records to a new file
+        const std::string sTempFilePath = m_sFilePath+".tmp";
+        std::ofstream oTempFile(sTempFilePath,std::ios::out|std::ios::binary|std::ios::trunc);
+        lvAssert__(oTempFile.is_open(),"could not create temporary mask archive at '%s'",sTempFilePath.c_str());
+        oTempFile.write(s_acMaskArchiveMagic,sizeof(s_acMaskArchiveMagic));
+        uint64_t nDataEndOffset = sizeof(s_acMaskArchiveMagic);
+        for(auto& oEntry : m_mIndex) {
+            m_vBuffer.resize(oEntry.second.second);
+            m_oFile.seekg(oEntry.second.first);
+            lvAssert__(m_oFile.read((char*)m_vBuffer.data(),std::streamsize(m_vBuffer.size())),"could not read from mask archive at '%s'",m_sFilePath.c_str());
+            const MaskArchiveRecordHeader oRecord = {s_nMaskArchiveRecordMagic,oEntry.second.second,(uint64_t)oEntry.first};
+            oTempFile.write((const char*)&oRecord,sizeof(oRecord));
+            oTempFile.write((const char*)m_vBuffer.data(),std::streamsize(m_vBuffer.size()));
+            oEntry.second.first = nDataEndOffset+sizeof(oRecord);
+            nDataEndOffset += sizeof(oRecord)+oRecord.nSize;
+        }
+        oTempFile.close();
+        lvAssert__(!oTempFile.fail(),"could not write temporary mask archive at '%s'",sTempFilePath.c_str());
+        m_oFile.close();
+        std::remove(m_sFilePath.c_str());
+        lvAssert__(std::rename(sTempFilePath.c_str(),m_sFilePath.c_str())==0,"could not move compacted mask archive to '%s'",m_sFilePath.c_str());
+        m_oFile.open(m_sFilePath,std::ios::in|std::ios::out|std::ios::binary);
+        lvAssert__(m_oFile.is_open(),"could not reopen mask archive at '%s'",m_sFilePath.c_str());
+        m_nDataEndOffset = m_nFileSize = nDataEndOffset;
+        m_nSupersededSize = 0;
+    }
+    std::vector<MaskArchiveIndexEntry> vEntries;
+    vEntries.reserve(m_mIndex.size());
+    for(const auto& oEntry : m_mIndex)
+        vEntries.push_back(MaskArchiveIndexEntry{(uint64_t)oEntry.first,oEntry.second.first,(uint64_t)oEntry.second.second});
+    MaskArchiveFooter oFooter = {m_nDataEndOffset,(uint64_t)vEntries.size(),{}};
+    std::copy(s_acMaskArchiveIndexMagic,s_acMaskArchiveIndexMagic+sizeof(s_acMaskArchiveIndexMagic),oFooter.acMagic);
+    m_oFile.seekp(m_nDataEndOffset);
+    m_oFile.write((const char*)vEntries.data(),std::streamsize(vEntries.size()*sizeof(MaskArchiveIndexEntry)));
+    m_oFile.write((const char*)&oFooter,sizeof(oFooter));
+    m_oFile.flush();
+    lvAssert__(m_oFile.good(),"could not write index of mask archive at '%s'",m_sFilePath.c_str());
+    m_nFooterOffset = m_nDataEndOffset+nIndexSize-sizeof(oFooter);
+    m_nFileSize = m_nDataEndOffset+nIndexSize;
+    m_bIndexDirty = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////
+
+lv::DataIndexCache::DataIndexCache(const std::string& sIndexFilePath) :
+        m_sIndexFilePath(sIndexFilePath),m_bDirty(false) {
+    if(m_sIndexFilePath.empty())
+        return;
+    std::ifstream oFile(m_sIndexFilePath,std::ios::in|std::ios::binary|std::ios::ate);
+    if(!oFile.is_open())
+        return;
+    std::vector<char> vBuffer((size_t)oFile.tellg());
+    oFile.seekg(0);
+    if(vBuffer.empty() || !oFile.read(vBuffer.data(),(std::streamsize)vBuffer.size()))
+        return;
+    DataIndexReader oReader = {vBuffer.data(),vBuffer.data()+vBuffer.size()};
+    DataIndexHeader oHeader;
+    if(!oReader.read(oHeader) || std::memcmp(oHeader.acMagic,s_acDataIndexMagic,sizeof(oHeader.acMagic)) || oHeader.nVersion!=s_nDataIndexVersion)
+        return; // stale or foreign file; it will be overwritten on the next save
+    bool bValid = true;
+    for(uint64_t nEntryIdx=0; bValid && nEntryIdx<oHeader.nDirCount; ++nEntryIdx) {
+        std::string sDirPath;
+        DirEntry oEntry;
+        uint8_t nFlags;
+        bValid = oReader.read(sDirPath) && oReader.read(oEntry.nModifTime) && oReader.read(nFlags) && oReader.read(oEntry.vsFilePaths) && oReader.read(oEntry.vsSubDirPaths);
+        oEntry.bHasFiles = (nFlags&1)!=0;
+        oEntry.bHasSubDirs = (nFlags&2)!=0;
+        if(bValid)
+            m_mDirs[sDirPath] = std::move(oEntry);
+    }
+    for(uint64_t nEntryIdx=0; bValid && nEntryIdx<oHeader.nImageCount; ++nEntryIdx) {
+        std::string sFilePath;
+        int32_t nFlags,nRows,nCols,nType;
+        ImageEntry oEntry;
+        bValid = oReader.read(sFilePath) && oReader.read(nFlags) && oReader.read(oEntry.nFileSize) && oReader.read(oEntry.nModifTime) &&
+                 oReader.read(nRows) && oReader.read(nCols) && oReader.read(nType);
+        oEntry.oSize = cv::Size(nCols,nRows);
+        oEntry.nType = nType;
+        if(bValid)
+            m_mImages[std::make_pair(sFilePath,(int)nFlags)] = oEntry;
+    }
+    for(uint64_t nEntryIdx=0; bValid && nEntryIdx<oHeader.nMaskCount; ++nEntryIdx) {
+        std::string sFilePath;
+        MaskEntry oEntry;
+        bValid = oReader.read(sFilePath) && oReader.read(oEntry.nFileSize) && oReader.read(oEntry.nModifTime) && oReader.read(oEntry.vBlob);
+        if(bValid)
+            m_mMasks[sFilePath] = std::move(oEntry);
+    }
+    for(uint64_t nEntryIdx=0; bValid && nEntryIdx<oHeader.nVideoCount; ++nEntryIdx) {
+        std::string sFilePath;
+        VideoEntry oEntry;
+        bValid = oReader.read(sFilePath) && oReader.read(oEntry.nFileSize) && oReader.read(oEntry.nModifTime) && oReader.read(oEntry.nFrameCount) && oReader.read(oEntry.vnKeyFrameIdxs);
+        if(bValid)
+            m_mVideos[sFilePath] = std::move(oEntry);
+    }
+    if(!bValid) {
+        std::cerr << "dataset index at '" << m_sIndexFilePath << "' is corrupted; it will be rebuilt" << std::endl;
+        m_mDirs.clear();
+        m_mImages.clear();
+        m_mMasks.clear();
+        m_mVideos.clear();
+    }
+}
+
+lv::DataIndexCache::~DataIndexCache() {
+    try {
+        save();
+    }
+    catch(...) {
+        std::cerr << "failed to write dataset index at '" << m_sIndexFilePath << "'" << std::endl;
+    }
+}
+
+void lv::DataIndexCache::getFilesFromDir(const std::string& sDirPath, std::vector<std::string>& vsFilePaths) {
+    getDirListing(sDirPath,false,vsFilePaths);
+}
+
+void lv::DataIndexCache::getSubDirsFromDir(const std::string& sDirPath, std::vector<std::string>& vsSubDirPaths) {
+    getDirListing(sDirPath,true,vsSubDirPaths);
+}
+
+void lv::DataIndexCache::getDirListing(const std::string& sDirPath, bool bSubDirs, std::vector<std::string>& vsPaths) {
+    // note: adding/removing/renaming an entry always updates the directory's modification time, so a matching time means the listing is still valid
+    FileEntry oStats;
+    if(!lv::GetPathStats(sDirPath,oStats.nFileSize,oStats.nModifTime)) {
+        vsPaths.clear(); // missing directories are never cached
+        return;
+    }
+    const std::string sKey = lv::AddDirSlashIfMissing(sDirPath);
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        auto pEntry = m_mDirs.find(sKey);
+        if(pEntry!=m_mDirs.end() && pEntry->second.nModifTime==oStats.nModifTime && (bSubDirs?pEntry->second.bHasSubDirs:pEntry->second.bHasFiles)) {
+            vsPaths = bSubDirs?pEntry->second.vsSubDirPaths:pEntry->second.vsFilePaths;
+            return;
+        }
+    }
+    // the directory is stat'ed before being listed, so a concurrent modification can only cause a spurious refresh on the next run
+    if(bSubDirs)
+        lv::GetSubDirsFromDir(sDirPath,vsPaths);
+    else
+        lv::GetFilesFromDir(sDirPath,vsPaths);
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    DirEntry& oEntry = m_mDirs[sKey];
+    if(oEntry.nModifTime!=oStats.nModifTime) {
+        oEntry.nModifTime = oStats.nModifTime;
+        oEntry.bHasFiles = oEntry.bHasSubDirs = false;
+        oEntry.vsFilePaths.clear();
+        oEntry.vsSubDirPaths.clear();
+    }
+    (bSubDirs?oEntry.bHasSubDirs:oEntry.bHasFiles) = true;
+    (bSubDirs?oEntry.vsSubDirPaths:oEntry.vsFilePaths) = vsPaths;
+    m_bDirty = true;
+}
+
+bool lv::DataIndexCache::findImageEntry(const std::string& sFilePath, int nFlags, const FileEntry& oStats, ImageEntry& oEntry) {
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    auto pEntry = m_mImages.find(std::make_pair(sFilePath,nFlags));
+    if(pEntry==m_mImages.end() || pEntry->second.nFileSize!=oStats.nFileSize || pEntry->second.nModifTime!=oStats.nModifTime)
+        return false;
+    oEntry = pEntry->second;
+    return true;
+}
+
+lv::DataIndexCache::ImageEntry lv::DataIndexCache::readImageEntry(const std::string& sFilePath, int nFlags, const FileEntry& oStats) {
+    const cv::Mat oImage = cv::imread(sFilePath,nFlags);
+    ImageEntry oEntry;
+    oEntry.nFileSize = oStats.nFileSize;
+    oEntry.nModifTime = oStats.nModifTime;
+    oEntry.oSize = oImage.size();
+    oEntry.nType = oImage.empty()?-1:oImage.type();
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    m_mImages[std::make_pair(sFilePath,nFlags)] = oEntry;
+    m_bDirty = true;
+    return oEntry;
+}
+
+cv::Size lv::DataIndexCache::getImageSize(const std::string& sFilePath, int nFlags, int* pnType) {
+    FileEntry oStats;
+    ImageEntry oEntry;
+    if(!lv::GetPathStats(sFilePath,oStats.nFileSize,oStats.nModifTime)) {
+        oEntry.oSize = cv::Size();
+        oEntry.nType = -1;
+    }
+    else if(!findImageEntry(sFilePath,nFlags,oStats,oEntry))
+        oEntry = readImageEntry(sFilePath,nFlags,oStats);
+    if(pnType)
+        *pnType = oEntry.nType;
+    return oEntry.oSize;
+}
+
+std::vector<cv::Size> lv::DataIndexCache::getImageSizes(const std::vector<std::string>& vsFilePaths, int nFlags) {
+    std::vector<cv::Size> voSizes(vsFilePaths.size());
+    std::vector<FileEntry> voStats(vsFilePaths.size());
+    std::vector<size_t> vnMissedIdxs;
+    for(size_t nFileIdx=0; nFileIdx<vsFilePaths.size(); ++nFileIdx) {
+        ImageEntry oEntry;
+        if(!lv::GetPathStats(vsFilePaths[nFileIdx],voStats[nFileIdx].nFileSize,voStats[nFileIdx].nModifTime))
+            continue;
+        if(findImageEntry(vsFilePaths[nFileIdx],nFlags,voStats[nFileIdx],oEntry))
+            voSizes[nFileIdx] = oEntry.oSize;
+        else
+            vnMissedIdxs.push_back(nFileIdx);
+    }
+    // cold entries require a full decode each, which is what dominates parsing time on a fresh index
+    lv::parallel_for(vnMissedIdxs.size(),0,[&](size_t nMissedIdx) {
+        const size_t nFileIdx = vnMissedIdxs[nMissedIdx];
+        voSizes[nFileIdx] = readImageEntry(vsFilePaths[nFileIdx],nFlags,voStats[nFileIdx]).oSize;
+    });
+    return voSizes;
+}
+
+cv::Mat lv::DataIndexCache::readMask(const std::string& sFilePath) {
+    FileEntry oStats;
+    if(!lv::GetPathStats(sFilePath,oStats.nFileSize,oStats.nModifTime))
+        return cv::Mat();
+    cv::Mat oMask;
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        auto pEntry = m_mMasks.find(sFilePath);
+        if(pEntry!=m_mMasks.end() && pEntry->second.nFileSize==oStats.nFileSize && pEntry->second.nModifTime==oStats.nModifTime) {
+            if(!pEntry->second.vBlob.empty())
+                lv::decodeMask(pEntry->second.vBlob.data(),pEntry->second.vBlob.size(),oMask);
+            return oMask;
+        }
+    }
+    oMask = cv::imread(sFilePath,cv::IMREAD_GRAYSCALE);
+    MaskEntry oEntry;
+    oEntry.nFileSize = oStats.nFileSize;
+    oEntry.nModifTime = oStats.nModifTime;
+    if(!oMask.empty())
+        lv::encodeMask(oMask,oEntry.vBlob);
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    m_mMasks[sFilePath] = std::move(oEntry);
+    m_bDirty = true;
+    return oMask;
+}
+
+size_t lv::DataIndexCache::getVideoIndex(const std::string& sFilePath, std::vector<size_t>& vnKeyFrameIdxs) {
+    vnKeyFrameIdxs.clear();
+    FileEntry oStats;
+    if(!lv::GetPathStats(sFilePath,oStats.nFileSize,oStats.nModifTime))
+        return 0;
+    {
+        std::lock_guard<std::mutex> oLock(m_oMutex);
+        auto pEntry = m_mVideos.find(sFilePath);
+        if(pEntry!=m_mVideos.end() && pEntry->second.nFileSize==oStats.nFileSize && pEntry->second.nModifTime==oStats.nModifTime) {
+            vnKeyFrameIdxs.assign(pEntry->second.vnKeyFrameIdxs.begin(),pEntry->second.vnKeyFrameIdxs.end());
+            return (size_t)pEntry->second.nFrameCount;
+        }
+    }
+    // demuxing touches the whole file, but skips decoding; it is only done once per video (failures are cached too)
+    const size_t nFrameCount = ParallelVideoReader::buildKeyFrameIndex(sFilePath,vnKeyFrameIdxs);
+    VideoEntry oEntry;
+    oEntry.nFileSize = oStats.nFileSize;
+    oEntry.nModifTime = oStats.nModifTime;
+    oEntry.nFrameCount = (uint64_t)nFrameCount;
+    oEntry.vnKeyFrameIdxs.assign(vnKeyFrameIdxs.begin(),vnKeyFrameIdxs.end());
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    m_mVideos[sFilePath] = std::move(oEntry);
+    m_bDirty = true;
+    return nFrameCount;
+}
+
+void lv::DataIndexCache::save() {
+    std::lock_guard<std::mutex> oLock(m_oMutex);
+    if(!m_bDirty || m_sIndexFilePath.empty())
+        return;
+    std::vector<char> vBuffer;
+    DataIndexHeader oHeader = {{},s_nDataIndexVersion,0,(uint64_t)m_mDirs.size(),(uint64_t)m_mImages.size(),(uint64_t)m_mMasks.size(),(uint64_t)m_mVideos.size()};
+    std::copy(s_acDataIndexMagic,s_acDataIndexMagic+sizeof(s_acDataIndexMagic),oHeader.acMagic);
+    writeIndexValue(vBuffer,oHeader);
+    for(const auto& oDir : m_mDirs) {
+        writeIndexValue(vBuffer,oDir.first);
+        writeIndexValue(vBuffer,oDir.second.nModifTime);
+        writeIndexValue(vBuffer,uint8_t(uint8_t(oDir.second.bHasFiles)|(uint8_t(oDir.second.bHasSubDirs)<<1)));
+        writeIndexValue(vBuffer,oDir.second.vsFilePaths);
+        writeIndexValue(vBuffer,oDir.second.vsSubDirPaths);
+    }
+    for(const auto& oImage : m_mImages) {
+        writeIndexValue(vBuffer,oImage.first.first);
+        writeIndexValue(vBuffer,(int32_t)oImage.first.second);
+        writeIndexValue(vBuffer,oImage.second.nFileSize);
+        writeIndexValue(vBuffer,oImage.second.nModifTime);
+        writeIndexValue(vBuffer,(int32_t)oImage.second.oSize.height);
+        writeIndexValue(vBuffer,(int32_t)oImage.second.oSize.width);
+        writeIndexValue(vBuffer,(int32_t)oImage.second.nType);
+    }
+    for(const auto& oMask : m_mMasks) {
+        writeIndexValue(vBuffer,oMask.first);
+        writeIndexValue(vBuffer,oMask.second.nFileSize);
+        writeIndexValue(vBuffer,oMask.second.nModifTime);
+        writeIndexValue(vBuffer,oMask.second.vBlob);
+    }
+    for(const auto& oVideo : m_mVideos) {
+        writeIndexValue(vBuffer,oVideo.first);
+        writeIndexValue(vBuffer,oVideo.second.nFileSize);
+        writeIndexValue(vBuffer,oVideo.second.nModifTime);
+        writeIndexValue(vBuffer,oVideo.second.nFrameCount);
+        writeIndexValue(vBuffer,oVideo.second.vnKeyFrameIdxs);
+    }
+    // the index is written to a temporary file first, so that an interrupted run never leaves a truncated index behind
+    const std::string sTempFilePath = m_sIndexFilePath+".tmp";
+    std::ofstream oFile(sTempFilePath,std::ios::out|std::ios::binary|std::ios::trunc);
+    lvAssert__(oFile.is_open(),"could not create dataset index file at '%s'",sTempFilePath.c_str());
+    oFile.write(vBuffer.data(),std::streamsize(vBuffer.size()));
+    oFile.close();
+    lvAssert__(!oFile.fail(),"could not write dataset index file at '%s'",sTempFilePath.c_str());
+    std::remove(m_sIndexFilePath.c_str());
+    lvAssert__(std::rename(sTempFilePath.c_str(),m_sIndexFilePath.c_str())==0,"could not move dataset index file to '%s'",m_sIndexFilePath.c_str());
+    m_bDirty = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1292,8 +3238,21 @@ void lv::IDataArchiver_<lv::NotArray>::save(const cv::Mat& oOutput, size_t nIdx,
                 cv::bitwise_and(oOutputClone,UCHAR_MAX/2,oOutputClone,oROI==0);
             }
         }
-        const std::vector<int> vnComprParams = {cv::IMWRITE_PNG_COMPRESSION,9};
-        cv::imwrite(sOutputFilePath.str(),oOutputClone,vnComprParams);
+        if(getOutputNameSuffix()==".lvma")
+            getMaskArchive().write(oOutputClone,nIdx);
+        else if(getOutputNameSuffix()==".lvm") {
+            static thread_local std::vector<uchar> s_vBuffer;
+            lv::encodeMask(oOutputClone,s_vBuffer);
+            std::ofstream oFile(sOutputFilePath.str(),std::ios::out|std::ios::binary|std::ios::trunc);
+            lvAssert__(oFile.is_open(),"could not create packed mask file at '%s'",sOutputFilePath.str().c_str());
+            oFile.write((const char*)s_vBuffer.data(),std::streamsize(s_vBuffer.size()));
+            oFile.close();
+            lvAssert__(!oFile.fail(),"could not write packed mask file at '%s'",sOutputFilePath.str().c_str());
+        }
+        else {
+            const std::vector<int> vnComprParams = {cv::IMWRITE_PNG_COMPRESSION,9};
+            cv::imwrite(sOutputFilePath.str(),oOutputClone,vnComprParams);
+        }
     }
     else {
         // @@@@ save to YML/bin file?
@@ -1305,8 +3264,22 @@ cv::Mat lv::IDataArchiver_<lv::NotArray>::load(size_t nIdx, int nFlags) {
     const auto pLoader = shared_from_this_cast<const IIDataLoader>(true);
     if(pLoader->getOutputPacketType()==ImagePacket) {
         lvAssert_(!getOutputNameSuffix().empty(),"data archiver requires packet output name suffix (i.e. file extension)");
+        if(getOutputNameSuffix()==".lvma")
+            return getMaskArchive().read(nIdx);
         std::stringstream sOutputFilePath;
         sOutputFilePath << getOutputPath() << getOutputNamePrefix() << getOutputName(nIdx) << getOutputNameSuffix();
+        if(getOutputNameSuffix()==".lvm") {
+            std::ifstream oFile(sOutputFilePath.str(),std::ios::in|std::ios::binary|std::ios::ate);
+            cv::Mat oOutput;
+            if(!oFile.is_open())
+                return oOutput;
+            static thread_local std::vector<uchar> s_vBuffer;
+            s_vBuffer.resize((size_t)oFile.tellg());
+            oFile.seekg(0);
+            lvAssert__(oFile.read((char*)s_vBuffer.data(),std::streamsize(s_vBuffer.size())),"could not read packed mask file at '%s'",sOutputFilePath.str().c_str());
+            lv::decodeMask(s_vBuffer.data(),s_vBuffer.size(),oOutput);
+            return oOutput;
+        }
         return cv::imread(sOutputFilePath.str(),(nFlags==-1)?cv::IMREAD_GRAYSCALE:cv::IMREAD_COLOR);
     }
     else {
@@ -1315,6 +3288,13 @@ cv::Mat lv::IDataArchiver_<lv::NotArray>::load(size_t nIdx, int nFlags) {
     }
 }
 
+lv::MaskArchive& lv::IDataArchiver_<lv::NotArray>::getMaskArchive() {
+    std::lock_guard<std::mutex> oLock(m_oMaskArchiveMutex);
+    if(!m_pMaskArchive)
+        m_pMaskArchive = std::unique_ptr<MaskArchive>(new MaskArchive(getOutputPath()+getOutputNamePrefix()+getName()+getOutputNameSuffix()));
+    return *m_pMaskArchive;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void lv::IDataArchiver_<lv::Array>::saveArray(const std::vector<cv::Mat>& /*vOutput*/, size_t /*nIdx*/, int /*nFlags*/) {
@@ -1403,8 +3383,9 @@ void lv::IAsyncDataConsumer_<lv::DatasetEval_BinaryClassifier,lv::GLSL>::post_ap
         m_oCurrInput.copyTo(m_oLastInput);
         m_oNextInput.copyTo(m_oCurrInput);
         if(isEvaluating()) {
-            m_oCurrGT.copyTo(m_oLastGT);
-            m_oNextGT.copyTo(m_oCurrGT);
+            // gt buffers are rotated instead of overwritten, as the last one may still be shared with an async evaluator
+            m_oLastGT = m_oCurrGT;
+            m_oCurrGT = m_oNextGT.clone();
         }
     }
     if(m_nNextIdx<getInputCount()) {
@@ -1431,6 +3412,8 @@ void lv::IAsyncDataConsumer_<lv::DatasetEval_BinaryClassifier,lv::GLSL>::post_ap
             m_pAlgo->m_pDisplayHelper->display(m_oLastInput,oLastDebug,oLastOutput,m_nLastIdx);
         }
     }
+    invalidateMetrics();
+    updateLiveSnapshot();
 }
 
 void lv::IAsyncDataConsumer_<lv::DatasetEval_BinaryClassifier,lv::GLSL>::getColoredMasks(cv::Mat& oOutput, cv::Mat& oDebug, const cv::Mat& /*oGT*/, const cv::Mat& oGTROI) {
@@ -1498,6 +3481,10 @@ lv::IDataHandlerConstPtr lv::DatasetHandler::getParent() const {
     return IDataHandlerConstPtr();
 }
 
+lv::DataIndexCache& lv::DatasetHandler::getIndexCache() const {
+    return m_oIndexCache;
+}
+
 bool lv::DatasetHandler::isRoot() const {
     return true;
 }
@@ -1533,4 +3520,5 @@ lv::DatasetHandler::DatasetHandler(const std::string& sDatasetName,const std::st
         m_bSavingOutput(bSaveOutput),
         m_bUsingEvaluator(bUseEvaluator),
         m_bForce4ByteDataAlign(bForce4ByteDataAlign),
-        m_dScaleFactor(dScaleFactor) {}
+        m_dScaleFactor(dScaleFactor),
+        m_oIndexCache(m_sOutputPath.empty()?std::string():m_sOutputPath+"dataset_index.bin") {}
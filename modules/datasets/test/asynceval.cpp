@@ -0,0 +1,78 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks that work batches return the same evaluation metrics whether outputs are consumed on the processing thread or queued for async evaluation
+
+#include "litiv_test.hpp"
+#include "testdataset.hpp"
+
+namespace {
+
+    /// directory (created in the working directory) used as the datasets root path by this test
+    const std::string s_sRootDirPath = "litiv_test_asynceval/";
+
+    /// pushes the same outputs to all batches of a new dataset instance, with async evaluation enabled if 'nMaxQueuedPackets>0', and returns the dataset
+    lv::test::TestDatasetType::Ptr process(const std::string& sOutputDirName, size_t nMaxQueuedPackets, bool bStopProcessing=true) {
+        lv::test::TestDatasetType::Ptr pDataset = lv::test::createTestDataset(sOutputDirName);
+        for(const lv::IDataHandlerPtr& pBatch : pDataset->getBatches(false)) {
+            lv::test::TestDatasetType::WorkBatch& oBatch = dynamic_cast<lv::test::TestDatasetType::WorkBatch&>(*pBatch);
+            lvAssert_(oBatch.getFrameCount()==lv::test::g_nTestFrameCount,"unexpected test sequence length");
+            oBatch.setAsyncEvaluation(nMaxQueuedPackets);
+            oBatch.startProcessing();
+            for(size_t nPacketIdx=0; nPacketIdx<lv::test::g_nTestFrameCount; ++nPacketIdx) {
+                cv::Mat oOutput = lv::test::getTestOutput(oBatch.getName(),nPacketIdx);
+                oBatch.push(oOutput,nPacketIdx);
+                oOutput = 0; // async evaluation must have kept its own copy of the packet
+            }
+            if(bStopProcessing)
+                oBatch.stopProcessing();
+        }
+        return pDataset;
+    }
+
+    /// returns whether both metrics calculators hold identical binary classification metrics
+    bool isEqual(const lv::IIMetricsCalculatorPtr& pMetrics1, const lv::IIMetricsCalculatorPtr& pMetrics2) {
+        return lv::test::isEqual(lv::test::getBinClassifMetrics(pMetrics1),lv::test::getBinClassifMetrics(pMetrics2));
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("asynceval",[]() {
+        lv::test::writeTestDataset(s_sRootDirPath);
+        lv::test::TestDatasetType::Ptr pSyncDataset = process("sync",0);
+        for(size_t nMaxQueuedPackets : {size_t(1),size_t(4),lv::test::g_nTestFrameCount*2}) {
+            lv::test::TestDatasetType::Ptr pAsyncDataset = process("async",nMaxQueuedPackets);
+            const lv::IDataHandlerPtrArray vpSyncBatches = pSyncDataset->getBatches(false);
+            const lv::IDataHandlerPtrArray vpAsyncBatches = pAsyncDataset->getBatches(false);
+            lvTestCheck_(vpSyncBatches.size()==vpAsyncBatches.size(),"queue size = %d",(int)nMaxQueuedPackets);
+            for(size_t nBatchIdx=0; nBatchIdx<vpSyncBatches.size() && nBatchIdx<vpAsyncBatches.size(); ++nBatchIdx) {
+                lv::test::TestDatasetType::WorkBatch& oSyncBatch = dynamic_cast<lv::test::TestDatasetType::WorkBatch&>(*vpSyncBatches[nBatchIdx]);
+                lv::test::TestDatasetType::WorkBatch& oAsyncBatch = dynamic_cast<lv::test::TestDatasetType::WorkBatch&>(*vpAsyncBatches[nBatchIdx]);
+                lvTestCheck_(oSyncBatch.getName()==oAsyncBatch.getName(),"queue size = %d",(int)nMaxQueuedPackets);
+                lvTestCheck_(oAsyncBatch.getFinalOutputCount()==lv::test::g_nTestFrameCount,"queue size = %d, batch '%s'",(int)nMaxQueuedPackets,oAsyncBatch.getName().c_str());
+                lvTestCheck_(isEqual(oSyncBatch.getMetrics(false),oAsyncBatch.getMetrics(false)),"queue size = %d, batch '%s'",(int)nMaxQueuedPackets,oAsyncBatch.getName().c_str());
+            }
+            lvTestCheck_(isEqual(pSyncDataset->getMetrics(false),pAsyncDataset->getMetrics(false)),"queue size = %d",(int)nMaxQueuedPackets);
+            lvTestCheck_(isEqual(pSyncDataset->getMetrics(true),pAsyncDataset->getMetrics(true)),"queue size = %d",(int)nMaxQueuedPackets);
+        }
+        // batches destroyed mid-processing must join their evaluation worker before it can reach partly destroyed members
+        process("abandoned",2,false).reset();
+        pSyncDataset.reset();
+        lv::test::removeDirs(s_sRootDirPath);
+    });
+}
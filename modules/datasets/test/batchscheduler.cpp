@@ -0,0 +1,140 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks the batch scheduler's dispatch order (longest expected duration first, re-estimated from measured throughputs), its thread budget split and tail rebalancing, and the reuse of its workers across runs
+
+#include "litiv_test.hpp"
+#include "litiv/datasets/utils.hpp"
+
+namespace {
+
+    /// start order and initial thread budget of a fake job
+    struct JobStart {
+        size_t nJobIdx;
+        size_t nThreadBudget;
+        size_t nActualThreadBudget;
+    };
+
+    /// runs fake jobs (which only record how they were started) with the given loads and a single throughput key, and returns their start order
+    std::vector<JobStart> runFakeJobs(lv::BatchScheduler& oScheduler, const std::vector<double>& vdLoads) {
+        std::mutex oMutex;
+        std::vector<JobStart> vStarts;
+        oScheduler.run(vdLoads,std::vector<std::string>(vdLoads.size(),"/fake"),[&](size_t nJobIdx, size_t nThreadBudget, const std::string&) {
+            std::mutex_lock_guard oLock(oMutex);
+            vStarts.push_back(JobStart{nJobIdx,nThreadBudget,lv::getThreadBudget()});
+        });
+        return vStarts;
+    }
+
+    /// waits (with a timeout) until the given predicate is true, and returns its last value
+    template<typename TPred>
+    bool waitFor(TPred&& lPred) {
+        const auto nDeadline = std::chrono::steady_clock::now()+std::chrono::seconds(10);
+        while(!lPred() && std::chrono::steady_clock::now()<nDeadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return lPred();
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("batchscheduler",[]() {
+        {
+            // a single worker starts jobs strictly by decreasing load (nothing distinguishes them otherwise), each with a budget of one thread
+            lv::BatchScheduler oScheduler(1);
+            const std::vector<double> vdLoads = {3,1,4,1,5,9,2,6,5,3};
+            const std::vector<JobStart> vStarts = runFakeJobs(oScheduler,vdLoads);
+            lvTestCheck(vStarts.size()==vdLoads.size());
+            for(size_t nStartIdx=0; nStartIdx<vStarts.size(); ++nStartIdx) {
+                lvTestCheck_(vStarts[nStartIdx].nThreadBudget==1 && vStarts[nStartIdx].nActualThreadBudget==1,"start %d",(int)nStartIdx);
+                if(nStartIdx>0)
+                    lvTestCheck_(vdLoads[vStarts[nStartIdx-1].nJobIdx]>=vdLoads[vStarts[nStartIdx].nJobIdx],"start %d",(int)nStartIdx);
+            }
+        }
+        {
+            // all jobs fit at once on four workers; the last ones to start share the threads left over by the first ones
+            lv::BatchScheduler oScheduler(4);
+            const std::vector<JobStart> vStarts = runFakeJobs(oScheduler,{1,3,2});
+            lvTestCheck(vStarts.size()==size_t(3));
+            std::array<size_t,3> anBudgets = {};
+            for(const JobStart& oStart : vStarts)
+                anBudgets[oStart.nJobIdx] = oStart.nThreadBudget;
+            lvTestCheck_(anBudgets[1]==1 && anBudgets[2]==1 && anBudgets[0]==2,"budgets = {%d,%d,%d}",(int)anBudgets[0],(int)anBudgets[1],(int)anBudgets[2]);
+            for(const JobStart& oStart : vStarts)
+                lvTestCheck_(oStart.nActualThreadBudget>=oStart.nThreadBudget,"job %d",(int)oStart.nJobIdx);
+        }
+        {
+            // once the short job finishes, its threads are handed over to the long job that is still running
+            lv::BatchScheduler oScheduler(4);
+            std::atomic_bool bShortJobDone(false);
+            std::array<size_t,2> anInitBudgets = {},anFinalBudgets = {};
+            oScheduler.run({10,1},{"/fake","/fake"},[&](size_t nJobIdx, size_t nThreadBudget, const std::string&) {
+                anInitBudgets[nJobIdx] = nThreadBudget;
+                if(nJobIdx==0)
+                    waitFor([&]{return bShortJobDone && lv::getThreadBudget()==size_t(4);});
+                anFinalBudgets[nJobIdx] = lv::getThreadBudget();
+                if(nJobIdx==1)
+                    bShortJobDone = true;
+            });
+            lvTestCheck_(anInitBudgets[0]==2 && anInitBudgets[1]==2,"initial budgets = {%d,%d}",(int)anInitBudgets[0],(int)anInitBudgets[1]);
+            lvTestCheck_(anFinalBudgets[0]==4,"final budget = %d",(int)anFinalBudgets[0]);
+            lvTestCheck(lv::getThreadBudget()==0);
+        }
+        {
+            // throughputs measured on a first run reorder jobs whose raw loads are misleading (the slow kind is 100x slower per load unit)
+            lv::BatchScheduler oScheduler(1);
+            const auto lRun = [&](const std::vector<double>& vdLoads, const std::vector<std::string>& vsKeys) {
+                std::vector<size_t> vnOrder;
+                oScheduler.run(vdLoads,vsKeys,[&](size_t nJobIdx, size_t, const std::string&) {
+                    vnOrder.push_back(nJobIdx);
+                    const double dTimePerLoad = (vsKeys[nJobIdx]=="/slow")?0.02:0.0002;
+                    std::this_thread::sleep_for(std::chrono::duration<double>(vdLoads[nJobIdx]*dTimePerLoad));
+                });
+                return vnOrder;
+            };
+            const std::vector<size_t> vnFirstOrder = lRun({10,1},{"/fast","/slow"});
+            lvTestCheck(vnFirstOrder==std::vector<size_t>({0,1}));
+            const std::vector<size_t> vnSecondOrder = lRun({100,5},{"/fast","/slow"});
+            lvTestCheck(vnSecondOrder==std::vector<size_t>({1,0}));
+        }
+        {
+            // jobs always run on the scheduler's own workers, which are kept across runs; the first exception is rethrown, and does not break later runs
+            lv::BatchScheduler oScheduler(2);
+            std::mutex oMutex;
+            std::set<std::thread::id> vWorkerIDs;
+            const auto lRecordWorker = [&](size_t, size_t, const std::string&) {
+                std::mutex_lock_guard oLock(oMutex);
+                vWorkerIDs.insert(std::this_thread::get_id());
+            };
+            oScheduler.run(std::vector<double>(16,1.0),std::vector<std::string>(16,"/fake"),lRecordWorker);
+            bool bCaught = false;
+            try {
+                oScheduler.run({2,1},{"/fake","/fake"},[&](size_t nJobIdx, size_t nThreadBudget, const std::string& sWorkerName) {
+                    lRecordWorker(nJobIdx,nThreadBudget,sWorkerName);
+                    lvAssert__(nJobIdx!=0,"fake job %d failed",(int)nJobIdx);
+                });
+            }
+            catch(const std::exception&) {
+                bCaught = true;
+            }
+            lvTestCheck(bCaught);
+            oScheduler.run(std::vector<double>(16,1.0),std::vector<std::string>(16,"/fake"),lRecordWorker);
+            lvTestCheck_(vWorkerIDs.size()<=oScheduler.getWorkerCount(),"%d worker threads used",(int)vWorkerIDs.size());
+            lvTestCheck(vWorkerIDs.find(std::this_thread::get_id())==vWorkerIDs.end());
+        }
+    });
+}
@@ -0,0 +1,79 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks that BSDS500 threshold bins & gt masks give the same counters whether they are evaluated serially or in parallel
+
+#include "litiv_test.hpp"
+#include "litiv/datasets.hpp"
+#include "litiv/imgproc.hpp"
+
+namespace {
+
+    using BSDS500Accumulator = lv::MetricsAccumulator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500>;
+
+    /// returns a random 8-bit edge strength map
+    cv::Mat getRandomEdgeMap(cv::RNG& oRNG, const cv::Size& oSize) {
+        cv::Mat oNoise(oSize,CV_8UC1), oEdgeMap;
+        oRNG.fill(oNoise,cv::RNG::UNIFORM,0,256);
+        cv::GaussianBlur(oNoise,oEdgeMap,cv::Size(),oRNG.uniform(0.5,2.0));
+        cv::normalize(oEdgeMap,oEdgeMap,0,255,cv::NORM_MINMAX);
+        return oEdgeMap;
+    }
+
+    /// returns several thin random gt edge masks, stacked vertically (as given by the BSDS500 data producer)
+    cv::Mat getRandomGTMasks(cv::RNG& oRNG, const cv::Size& oSize, int nGTMaskCount) {
+        cv::Mat oGT(oSize.height*nGTMaskCount,oSize.width,CV_8UC1);
+        for(int nGTMaskIdx=0; nGTMaskIdx<nGTMaskCount; ++nGTMaskIdx) {
+            cv::Mat oThinnedMask;
+            lv::thinning(getRandomEdgeMap(oRNG,oSize)>oRNG.uniform(160,224),oThinnedMask);
+            oThinnedMask.copyTo(oGT(cv::Rect(0,oSize.height*nGTMaskIdx,oSize.width,oSize.height)));
+        }
+        return oGT;
+    }
+
+    /// returns the counters accumulated for the given images with the given thread budget (0 = unbounded)
+    lv::IIMetricsAccumulatorPtr getCounters(const std::vector<std::pair<cv::Mat,cv::Mat>>& voImages, size_t nThreshBins, size_t nThreadBudget) {
+        auto pAccumulator = lv::IIMetricsAccumulator::create<BSDS500Accumulator>(nThreshBins);
+        std::unique_ptr<lv::ThreadBudgetGuard> pGuard(nThreadBudget?new lv::ThreadBudgetGuard(nThreadBudget):nullptr);
+        for(const auto& oImage : voImages)
+            pAccumulator->accumulate(oImage.first,oImage.second,cv::Mat());
+        return pAccumulator;
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("bsds500bins",[]() {
+        cv::RNG oRNG(42);
+        std::vector<std::pair<cv::Mat,cv::Mat>> voImages;
+        for(int nImageIdx=0; nImageIdx<4; ++nImageIdx) {
+            const cv::Size oSize = (nImageIdx%2)?cv::Size(160,120):cv::Size(120,160);
+            voImages.emplace_back(getRandomEdgeMap(oRNG,oSize),getRandomGTMasks(oRNG,oSize,1+nImageIdx));
+        }
+        // an image with a single output value only has one bin to evaluate, and an empty gt has nothing to match
+        voImages.emplace_back(cv::Mat(120,160,CV_8UC1,cv::Scalar_<uchar>(200)),getRandomGTMasks(oRNG,cv::Size(160,120),2));
+        voImages.emplace_back(getRandomEdgeMap(oRNG,cv::Size(160,120)),cv::Mat(240,160,CV_8UC1,cv::Scalar_<uchar>(0)));
+        for(size_t nThreshBins : {size_t(5),size_t(24),size_t(DATASETS_BSDS500_EVAL_DEFAULT_THRESH_BINS)}) {
+            const lv::IIMetricsAccumulatorPtr pSerialCounters = getCounters(voImages,nThreshBins,1);
+            for(size_t nThreadBudget : {size_t(2),size_t(0)}) {
+                // parallel runs are repeated, as their job-to-thread assignments differ from one run to the next
+                for(size_t nRunIdx=0; nRunIdx<2; ++nRunIdx)
+                    lvTestCheck_(pSerialCounters->isEqual(getCounters(voImages,nThreshBins,nThreadBudget)),"%d bins, thread budget %d, run %d",(int)nThreshBins,(int)nThreadBudget,(int)nRunIdx);
+            }
+        }
+    });
+}
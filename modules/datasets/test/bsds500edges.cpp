@@ -0,0 +1,127 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks the BSDS500 evaluation's edge map helpers (incremental thinning, indexed window lookups) against their brute-force counterparts on random edge maps
+
+#include "litiv_test.hpp"
+#include "impl/BSDS500_edges.hpp"
+
+namespace {
+
+    /// returns a random 8-bit edge strength map, smoothed so that thresholding it gives blobs that grow & merge as the threshold drops
+    cv::Mat getRandomEdgeMap(cv::RNG& oRNG, const cv::Size& oSize) {
+        cv::Mat oNoise(oSize,CV_8UC1), oEdgeMap;
+        oRNG.fill(oNoise,cv::RNG::UNIFORM,0,256);
+        cv::GaussianBlur(oNoise,oEdgeMap,cv::Size(),oRNG.uniform(0.5,2.0));
+        cv::normalize(oEdgeMap,oEdgeMap,0,255,cv::NORM_MINMAX);
+        return oEdgeMap;
+    }
+
+    /// sweeps the thresholds of a random edge map from high to low, checking incremental re-thinning against full re-thinning at each step
+    void testUpdateThinning(cv::RNG& oRNG, const cv::Size& oSize, int nThresholdStep) {
+        const cv::Mat oEdgeMap = getRandomEdgeMap(oRNG,oSize);
+        cv::Mat oPrevMask, oCurrMask, oThinnedMask, oRefThinnedMask;
+        for(int nThreshold=255; nThreshold>0; nThreshold-=nThresholdStep) {
+            cv::compare(oEdgeMap,nThreshold,oCurrMask,cv::CMP_GE);
+            if(oPrevMask.empty())
+                lv::thinning(oCurrMask,oThinnedMask);
+            else
+                updateThinning(oPrevMask,oCurrMask,oThinnedMask);
+            lv::thinning(oCurrMask,oRefThinnedMask);
+            lvTestCheck_(cv::countNonZero(oThinnedMask!=oRefThinnedMask)==0,"%dx%d map, threshold %d",oSize.width,oSize.height,nThreshold);
+            std::swap(oPrevMask,oCurrMask);
+        }
+    }
+
+    /// returns a random sparse edge mask (with a random density, so that some windows are empty and others are crowded)
+    cv::Mat getRandomEdgeMask(cv::RNG& oRNG, const cv::Size& oSize) {
+        cv::Mat oNoise(oSize,CV_8UC1);
+        oRNG.fill(oNoise,cv::RNG::UNIFORM,0,256);
+        return oNoise<oRNG.uniform(1,128);
+    }
+
+    /// returns the (u,v) offsets of the mask's nonzero pixels around (i,j), in window scan order, using the same tests as the original brute-force scans (offsets are negated before testing if mirrored)
+    std::vector<cv::Point2i> getWindowScanOffsets(const cv::Mat& oMask, int i, int j, double dMaxDist, int nMaxDist, bool bMirrored) {
+        const double dMaxDistSqr = dMaxDist*dMaxDist;
+        std::vector<cv::Point2i> voOffsets;
+        for(int u=-nMaxDist; u<=nMaxDist; ++u) {
+            const int nTestU = bMirrored?-u:u;
+            if(i+u<0 || i+u>=oMask.rows || double(nTestU)>dMaxDist)
+                continue;
+            for(int v=-nMaxDist; v<=nMaxDist; ++v) {
+                const int nTestV = bMirrored?-v:v;
+                if(j+v<0 || j+v>=oMask.cols || double(nTestV)>dMaxDist || double(nTestU*nTestU+nTestV*nTestV)>dMaxDistSqr)
+                    continue;
+                if(oMask.at<uchar>(i+u,j+v))
+                    voOffsets.emplace_back(v,u);
+            }
+        }
+        return voOffsets;
+    }
+
+    /// checks window visits of an edge pixel index (built directly, or as a subset of another index) against brute-force window scans around every pixel
+    void testEdgePixelIndex(cv::RNG& oRNG, const cv::Size& oSize, double dMaxDist) {
+        const int nMaxDist = (int)ceil(dMaxDist);
+        const std::vector<DiskSpan> voSpans = getDiskSpans(dMaxDist,nMaxDist);
+        const std::vector<DiskSpan> voMirroredSpans = getMirroredDiskSpans(voSpans);
+        const cv::Mat oMask = getRandomEdgeMask(oRNG,oSize);
+        const EdgePixelIndex oIndex(oMask);
+        lvTestCheck_(oIndex.m_voPoints.size()==(size_t)cv::countNonZero(oMask),"%dx%d mask, radius %f",oSize.width,oSize.height,dMaxDist);
+        // the subset index must be identical to an index built from the subset mask
+        std::vector<uchar> vbKeep(oIndex.m_voPoints.size());
+        cv::Mat oSubsetMask(oSize,CV_8UC1,cv::Scalar_<uchar>(0));
+        for(size_t nPointIdx=0; nPointIdx<vbKeep.size(); ++nPointIdx)
+            if((vbKeep[nPointIdx] = uchar(oRNG.uniform(0,2)))!=0)
+                oSubsetMask.at<uchar>(oIndex.m_voPoints[nPointIdx]) = UCHAR_MAX;
+        const EdgePixelIndex oSubsetIndex(oIndex,vbKeep);
+        const EdgePixelIndex oRefSubsetIndex(oSubsetMask);
+        lvTestCheck_(oSubsetIndex.m_voPoints==oRefSubsetIndex.m_voPoints && oSubsetIndex.m_vnRowOffsets==oRefSubsetIndex.m_vnRowOffsets,"%dx%d mask, radius %f",oSize.width,oSize.height,dMaxDist);
+        const std::vector<std::pair<const EdgePixelIndex*,const cv::Mat*>> voIndexedMasks = {{&oIndex,&oMask},{&oSubsetIndex,&oSubsetMask}};
+        for(const auto& oIndexedMask : voIndexedMasks) {
+            for(bool bMirrored : {false,true}) {
+                size_t nMismatches = 0;
+                for(int i=0; i<oSize.height; ++i) {
+                    for(int j=0; j<oSize.width; ++j) {
+                        const std::vector<cv::Point2i> voRefOffsets = getWindowScanOffsets(*oIndexedMask.second,i,j,dMaxDist,nMaxDist,bMirrored);
+                        std::vector<cv::Point2i> voOffsets;
+                        oIndexedMask.first->visitWindow(i,j,bMirrored?voMirroredSpans:voSpans,[&](int nPointIdx, int u, int v) {
+                            // visited point indices must match the visited pixel locations
+                            nMismatches += size_t(oIndexedMask.first->m_voPoints[size_t(nPointIdx)]!=cv::Point2i(j+v,i+u));
+                            voOffsets.emplace_back(v,u);
+                            return false;
+                        });
+                        nMismatches += size_t(voOffsets!=voRefOffsets);
+                        nMismatches += size_t(oIndexedMask.first->isInWindow(i,j,bMirrored?voMirroredSpans:voSpans)!=!voRefOffsets.empty());
+                    }
+                }
+                lvTestCheck_(nMismatches==0,"%dx%d mask, radius %f, mirrored=%d, subset=%d",oSize.width,oSize.height,dMaxDist,(int)bMirrored,(int)(oIndexedMask.first==&oSubsetIndex));
+            }
+        }
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("bsds500edges",[]() {
+        cv::RNG oRNG(42);
+        for(size_t nMapIdx=0; nMapIdx<50; ++nMapIdx)
+            testUpdateThinning(oRNG,cv::Size(oRNG.uniform(4,96),oRNG.uniform(4,96)),oRNG.uniform(1,40));
+        for(double dMaxDist : {1.0,1.5,2.0,2.75,4.0,6.3})
+            for(size_t nMaskIdx=0; nMaskIdx<10; ++nMaskIdx)
+                testEdgePixelIndex(oRNG,cv::Size(oRNG.uniform(1,48),oRNG.uniform(1,48)),dMaxDist);
+    });
+}
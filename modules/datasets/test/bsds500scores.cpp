@@ -0,0 +1,96 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks that BSDS500 image set scores are bit-identical whether per-image scores are updated serially or in parallel
+
+#include "litiv_test.hpp"
+#include "litiv/datasets.hpp"
+#include <cstring>
+#include <random>
+
+namespace {
+
+    using BSDS500Accumulator = lv::MetricsAccumulator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500>;
+    using BSDS500Calculator = lv::MetricsCalculator_<lv::DatasetEval_BinaryClassifier,lv::Dataset_BSDS500>;
+
+    /// returns an accumulator filled with random (but consistent) per-image counters
+    lv::IIMetricsAccumulatorPtr getRandomAccumulator(std::mt19937& oRandGen, size_t nImageCount) {
+        auto pAccumulator = lv::IIMetricsAccumulator::create<BSDS500Accumulator>();
+        std::uniform_int_distribution<uint64_t> oCountDistrib(0,5000);
+        for(size_t nImageIdx=0; nImageIdx<nImageCount; ++nImageIdx) {
+            lv::BSDS500Counters oCounters(pAccumulator->m_nThresholdBins);
+            for(size_t nThresholdIdx=0; nThresholdIdx<pAccumulator->m_nThresholdBins; ++nThresholdIdx) {
+                oCounters.vnIndivTPFN[nThresholdIdx] = oCountDistrib(oRandGen)+1;
+                oCounters.vnIndivTP[nThresholdIdx] = oCountDistrib(oRandGen)%(oCounters.vnIndivTPFN[nThresholdIdx]+1);
+                oCounters.vnTotalTPFP[nThresholdIdx] = oCountDistrib(oRandGen)+1;
+                oCounters.vnTotalTP[nThresholdIdx] = oCountDistrib(oRandGen)%(oCounters.vnTotalTPFP[nThresholdIdx]+1);
+            }
+            pAccumulator->m_voMetricsBase.push_back(oCounters);
+        }
+        return pAccumulator;
+    }
+
+    /// returns whether two doubles have the exact same bit pattern
+    bool isIdentical(double a, double b) {
+        return std::memcmp(&a,&b,sizeof(double))==0;
+    }
+
+    /// returns whether two scores have the exact same bit patterns
+    bool isIdentical(const lv::BSDS500Score& a, const lv::BSDS500Score& b) {
+        return isIdentical(a.dThreshold,b.dThreshold) && isIdentical(a.dRecall,b.dRecall) && isIdentical(a.dPrecision,b.dPrecision) && isIdentical(a.dFMeasure,b.dFMeasure);
+    }
+
+    /// checks that two calculators hold bit-identical image set scores
+    void checkIdentical(const BSDS500Calculator& oSerial, const BSDS500Calculator& oParallel, const char* sStep) {
+        lvTestCheck_(oSerial.voBestImageScores.size()==oParallel.voBestImageScores.size(),"%s",sStep);
+        for(size_t nImageIdx=0; nImageIdx<std::min(oSerial.voBestImageScores.size(),oParallel.voBestImageScores.size()); ++nImageIdx)
+            lvTestCheck_(isIdentical(oSerial.voBestImageScores[nImageIdx],oParallel.voBestImageScores[nImageIdx]),"%s, image #%d",sStep,(int)nImageIdx);
+        lvTestCheck_(oSerial.voThresholdScores.size()==oParallel.voThresholdScores.size(),"%s",sStep);
+        for(size_t nThresholdIdx=0; nThresholdIdx<std::min(oSerial.voThresholdScores.size(),oParallel.voThresholdScores.size()); ++nThresholdIdx)
+            lvTestCheck_(isIdentical(oSerial.voThresholdScores[nThresholdIdx],oParallel.voThresholdScores[nThresholdIdx]),"%s, threshold #%d",sStep,(int)nThresholdIdx);
+        lvTestCheck_(isIdentical(oSerial.oBestScore,oParallel.oBestScore),"%s",sStep);
+        lvTestCheck_(isIdentical(oSerial.dMaxRecall,oParallel.dMaxRecall),"%s",sStep);
+        lvTestCheck_(isIdentical(oSerial.dMaxPrecision,oParallel.dMaxPrecision),"%s",sStep);
+        lvTestCheck_(isIdentical(oSerial.dMaxFMeasure,oParallel.dMaxFMeasure),"%s",sStep);
+        lvTestCheck_(isIdentical(oSerial.dAreaPR,oParallel.dAreaPR),"%s",sStep);
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("bsds500scores",[]() {
+        std::mt19937 oRandGen(42);
+        for(size_t nImageCount : {size_t(1),size_t(7),size_t(200)}) {
+            const lv::IIMetricsAccumulatorPtr pAccumulator = getRandomAccumulator(oRandGen,nImageCount);
+            const lv::IIMetricsAccumulatorPtr pExtraAccumulator = getRandomAccumulator(oRandGen,nImageCount);
+            std::shared_ptr<BSDS500Calculator> pSerialCalculator, pParallelCalculator;
+            {
+                lv::ThreadBudgetGuard oGuard(1);
+                pSerialCalculator = lv::IIMetricsCalculator::create<BSDS500Calculator>(pAccumulator);
+            }
+            pParallelCalculator = lv::IIMetricsCalculator::create<BSDS500Calculator>(pAccumulator);
+            checkIdentical(*pSerialCalculator,*pParallelCalculator,"construction");
+            // image set accumulation updates the scores over all images again
+            {
+                lv::ThreadBudgetGuard oGuard(1);
+                pSerialCalculator->accumulate(lv::IIMetricsCalculator::create<BSDS500Calculator>(pExtraAccumulator));
+            }
+            pParallelCalculator->accumulate(lv::IIMetricsCalculator::create<BSDS500Calculator>(pExtraAccumulator));
+            checkIdentical(*pSerialCalculator,*pParallelCalculator,"accumulation");
+        }
+    });
+}
@@ -0,0 +1,65 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks that the cpu binary classifier evaluator (used instead of the GLSL one when requested) counts the same as direct accumulation
+
+#include "litiv_test.hpp"
+#include "litiv/datasets/eval.hpp"
+
+namespace {
+
+    /// returns a random mask drawn from the given label values
+    cv::Mat getRandomMask(cv::RNG& oRNG, const std::vector<uchar>& vnLabels) {
+        cv::Mat oMask(cv::Size(320,240),CV_8UC1);
+        for(size_t nPxIter=0; nPxIter<oMask.total(); ++nPxIter)
+            oMask.data[nPxIter] = vnLabels[oRNG.uniform(0,(int)vnLabels.size())];
+        return oMask;
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("cpueval",[]() {
+        cv::RNG oRNG(42);
+        const std::vector<uchar> vnGTLabels = {DATASETUTILS_POSITIVE_VAL,DATASETUTILS_NEGATIVE_VAL,DATASETUTILS_OUTOFSCOPE_VAL,DATASETUTILS_UNKNOWN_VAL,DATASETUTILS_SHADOW_VAL};
+        const std::vector<uchar> vnBinLabels = {DATASETUTILS_POSITIVE_VAL,DATASETUTILS_NEGATIVE_VAL};
+        const size_t nPacketCount = 24;
+        std::vector<cv::Mat> vGTs(nPacketCount);
+        for(cv::Mat& oGT : vGTs)
+            oGT = getRandomMask(oRNG,vnGTLabels);
+        const cv::Mat oROI = getRandomMask(oRNG,vnBinLabels);
+        for(size_t nMaxQueuedPackets : {size_t(1),size_t(4),nPacketCount*2}) {
+            lv::CPUBinaryClassifierEvaluator oEvaluator(nMaxQueuedPackets);
+            for(bool bUseROI : {true,false}) {
+                lv::BinClassif oCounters;
+                cv::Mat oOutput(vGTs[0].size(),CV_8UC1);
+                for(size_t nPacketIdx=0; nPacketIdx<nPacketCount; ++nPacketIdx) {
+                    // the output buffer is reused right away, like the fetched GLSL outputs are
+                    getRandomMask(oRNG,vnBinLabels).copyTo(oOutput);
+                    oCounters.accumulate(oOutput,vGTs[nPacketIdx],bUseROI?oROI:cv::Mat());
+                    oEvaluator.apply(oOutput,vGTs[nPacketIdx],bUseROI?oROI:cv::Mat());
+                    oOutput = cv::Scalar_<uchar>(DATASETUTILS_POSITIVE_VAL);
+                }
+                const lv::BinClassifMetricsAccumulatorPtr pMetricsBase = oEvaluator.getMetricsBase();
+                lvTestCheck_(pMetricsBase && pMetricsBase->m_oCounters.isEqual(oCounters),"queue size = %d, roi = %d",(int)nMaxQueuedPackets,(int)bUseROI);
+                lvTestCheck_(pMetricsBase && pMetricsBase->m_oCounters.total(true)==nPacketCount*oOutput.total(),"queue size = %d, roi = %d",(int)nMaxQueuedPackets,(int)bUseROI);
+                oEvaluator.resetMetrics();
+                lvTestCheck_(oEvaluator.getMetricsBase()->m_oCounters.isEqual(lv::BinClassif()),"queue size = %d, roi = %d",(int)nMaxQueuedPackets,(int)bUseROI);
+            }
+        }
+    });
+}
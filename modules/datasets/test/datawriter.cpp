@@ -0,0 +1,138 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// stress-tests the data writer's multi-producer/multi-consumer ring with concurrent producers, with and without packet drops, and checks that packets are committed in queue order
+
+#include "litiv_test.hpp"
+#include "litiv/datasets/utils.hpp"
+
+namespace {
+
+    /// number of concurrent producer threads
+    constexpr size_t s_nProducers = 8;
+    /// number of packets queued by each producer (the total is well beyond the ring size, so it wraps around many times)
+    constexpr size_t s_nPacketsPerProducer = 2000;
+    /// number of values in each packet (used to detect torn or aliased packets)
+    constexpr int s_nPacketValues = 64;
+
+    void testWriter(size_t nWorkers, bool bDropPacketsIfFull) {
+        const size_t nTotalPackets = s_nProducers*s_nPacketsPerProducer;
+        std::mutex oWriteMutex;
+        std::vector<size_t> vnWriteCounts(nTotalPackets,0);
+        std::vector<size_t> vnLastWrittenSeqIdxs(s_nProducers,SIZE_MAX);
+        size_t nBadPackets = 0, nUnorderedPackets = 0;
+        lv::DataWriter oWriter([&](const cv::Mat& oPacket, size_t nIdx) {
+            bool bValid = oPacket.rows==1 && oPacket.cols==s_nPacketValues && oPacket.type()==CV_32SC1 && nIdx<nTotalPackets;
+            for(int nValIdx=0; bValid && nValIdx<s_nPacketValues; ++nValIdx)
+                bValid = oPacket.at<int>(0,nValIdx)==int(nIdx);
+            std::mutex_lock_guard write_lock(oWriteMutex);
+            if(!bValid) {
+                ++nBadPackets;
+                return size_t(0);
+            }
+            ++vnWriteCounts[nIdx];
+            // regardless of the worker count, each producer's packets must be written in the order they were queued
+            const size_t nProducerIdx = nIdx%s_nProducers, nSeqIdx = nIdx/s_nProducers;
+            if(vnLastWrittenSeqIdxs[nProducerIdx]!=SIZE_MAX && vnLastWrittenSeqIdxs[nProducerIdx]>=nSeqIdx)
+                ++nUnorderedPackets;
+            vnLastWrittenSeqIdxs[nProducerIdx] = nSeqIdx;
+            return size_t(0);
+        });
+        lvTestCheck(oWriter.startAsyncWriting(1,bDropPacketsIfFull,nWorkers));
+        std::atomic_size_t nDroppedPackets(0);
+        std::vector<std::thread> vhProducers;
+        for(size_t nProducerIdx=0; nProducerIdx<s_nProducers; ++nProducerIdx) {
+            vhProducers.emplace_back([&,nProducerIdx]() {
+                cv::Mat oPacket(1,s_nPacketValues,CV_32SC1);
+                for(size_t nSeqIdx=0; nSeqIdx<s_nPacketsPerProducer; ++nSeqIdx) {
+                    const size_t nIdx = nSeqIdx*s_nProducers+nProducerIdx;
+                    oPacket = cv::Scalar::all(int(nIdx));
+                    if(oWriter.queue(oPacket,nIdx)==SIZE_MAX)
+                        ++nDroppedPackets;
+                    oPacket = cv::Scalar::all(-1); // queued packets must have been copied
+                }
+            });
+        }
+        for(std::thread& hProducer : vhProducers)
+            hProducer.join();
+        oWriter.stopAsyncWriting();
+        size_t nWrittenPackets = 0, nDuplicatePackets = 0;
+        for(size_t nWriteCount : vnWriteCounts) {
+            nWrittenPackets += size_t(nWriteCount>0);
+            nDuplicatePackets += size_t(nWriteCount>1);
+        }
+        lvTestCheck_(nBadPackets==0,"%d worker(s), drop=%d",(int)nWorkers,(int)bDropPacketsIfFull);
+        lvTestCheck_(nDuplicatePackets==0,"%d worker(s), drop=%d",(int)nWorkers,(int)bDropPacketsIfFull);
+        lvTestCheck_(nUnorderedPackets==0,"%d worker(s), drop=%d",(int)nWorkers,(int)bDropPacketsIfFull);
+        lvTestCheck_(nWrittenPackets+nDroppedPackets==nTotalPackets,"%d worker(s), drop=%d",(int)nWorkers,(int)bDropPacketsIfFull);
+        lvTestCheck_(oWriter.getDroppedPacketCount()==nDroppedPackets,"%d worker(s), drop=%d",(int)nWorkers,(int)bDropPacketsIfFull);
+        lvTestCheck_(bDropPacketsIfFull || nDroppedPackets==0,"%d worker(s), drop=%d",(int)nWorkers,(int)bDropPacketsIfFull);
+        lvTestCheck_(oWriter.getCurrentQueueCount()==0 && oWriter.getCurrentQueueSize()==0,"%d worker(s), drop=%d",(int)nWorkers,(int)bDropPacketsIfFull);
+    }
+
+    void testOrderedEncoding(size_t nWorkers) {
+        constexpr size_t nTotalPackets = 500;
+        std::vector<size_t> vnWrittenIdxs;
+        size_t nBadPackets = 0;
+        std::atomic_size_t nConcurrentWrites(0);
+        bool bOverlappingWrites = false;
+        lv::DataWriter oWriter([&](const cv::Mat& oPacket, size_t nIdx) {
+            // the archiver is never called concurrently, so no lock is needed here
+            bOverlappingWrites |= (nConcurrentWrites++)>0;
+            bool bValid = oPacket.rows==1 && oPacket.cols==s_nPacketValues && oPacket.type()==CV_32SC1;
+            for(int nValIdx=0; bValid && nValIdx<s_nPacketValues; ++nValIdx)
+                bValid = oPacket.at<int>(0,nValIdx)==-int(nIdx);
+            nBadPackets += size_t(!bValid);
+            vnWrittenIdxs.push_back(nIdx);
+            --nConcurrentWrites;
+            return size_t(0);
+        },[&](const cv::Mat& oPacket, size_t nIdx) {
+            // uneven encoding delays make the workers finish out of order
+            std::this_thread::sleep_for(std::chrono::microseconds((nIdx*7919)%200));
+            return cv::Mat(-oPacket);
+        });
+        lvTestCheck(oWriter.startAsyncWriting(1,false,nWorkers));
+        size_t nMovedPackets = 0;
+        for(size_t nIdx=0; nIdx<nTotalPackets; ++nIdx) {
+            cv::Mat oPacket(1,s_nPacketValues,CV_32SC1,cv::Scalar::all(int(nIdx)));
+            if(nIdx%2)
+                lvTestCheck(oWriter.queue(oPacket,nIdx)!=SIZE_MAX && !oPacket.empty());
+            else {
+                lvTestCheck(oWriter.queue(std::move(oPacket),nIdx)!=SIZE_MAX);
+                nMovedPackets += size_t(oPacket.empty()); // the writer takes over moved packets without copying them
+            }
+        }
+        oWriter.stopAsyncWriting();
+        lvTestCheck_(nBadPackets==0,"%d worker(s)",(int)nWorkers);
+        lvTestCheck_(!bOverlappingWrites,"%d worker(s)",(int)nWorkers);
+        lvTestCheck_(nMovedPackets==nTotalPackets/2,"%d worker(s)",(int)nWorkers);
+        lvTestCheck_(vnWrittenIdxs.size()==nTotalPackets,"%d worker(s)",(int)nWorkers);
+        for(size_t nIdx=0; nIdx<vnWrittenIdxs.size(); ++nIdx)
+            lvTestCheck_(vnWrittenIdxs[nIdx]==nIdx,"%d worker(s), packet #%d written at position %d",(int)nWorkers,(int)vnWrittenIdxs[nIdx],(int)nIdx);
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("datawriter",[]() {
+        for(size_t nWorkers : {size_t(1),size_t(4)})
+            for(bool bDropPacketsIfFull : {false,true})
+                testWriter(nWorkers,bDropPacketsIfFull);
+        for(size_t nWorkers : {size_t(1),size_t(4)})
+            testOrderedEncoding(nWorkers);
+    });
+}
@@ -0,0 +1,129 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks that the persistent dataset index returns the same listings, image sizes and masks as uncached calls, across reloads and file changes
+
+#include "litiv_test.hpp"
+#include "litiv/datasets/utils.hpp"
+
+namespace {
+
+    /// directory (created in the working directory) holding the files indexed by this test
+    const std::string s_sDataDirPath = "litiv_test_indexcache/";
+    /// path of the index file used by this test
+    const std::string s_sIndexFilePath = "litiv_test_indexcache.idx";
+
+    /// returns whether both masks have the same size, type and content
+    bool isEqual(const cv::Mat& oMask1, const cv::Mat& oMask2) {
+        return oMask1.size()==oMask2.size() && oMask1.type()==oMask2.type() && (oMask1.empty() || cv::countNonZero(oMask1!=oMask2)==0);
+    }
+
+    /// checks every cached query of the given index against its uncached equivalent
+    void checkIndex(lv::DataIndexCache& oIndex, const char* sStep) {
+        std::vector<std::string> vsExpectedFilePaths, vsFilePaths;
+        lv::GetFilesFromDir(s_sDataDirPath,vsExpectedFilePaths);
+        oIndex.getFilesFromDir(s_sDataDirPath,vsFilePaths);
+        lvTestCheck_(vsFilePaths==vsExpectedFilePaths,"%s",sStep);
+        std::vector<std::string> vsExpectedSubDirPaths, vsSubDirPaths;
+        lv::GetSubDirsFromDir(s_sDataDirPath,vsExpectedSubDirPaths);
+        oIndex.getSubDirsFromDir(s_sDataDirPath,vsSubDirPaths);
+        lvTestCheck_(vsSubDirPaths==vsExpectedSubDirPaths,"%s",sStep);
+        for(int nFlags : {cv::IMREAD_COLOR,cv::IMREAD_GRAYSCALE}) {
+            const std::vector<cv::Size> voSizes = oIndex.getImageSizes(vsExpectedFilePaths,nFlags);
+            lvTestCheck_(voSizes.size()==vsExpectedFilePaths.size(),"%s",sStep);
+            for(size_t nFileIdx=0; nFileIdx<vsExpectedFilePaths.size() && nFileIdx<voSizes.size(); ++nFileIdx) {
+                const cv::Mat oImage = cv::imread(vsExpectedFilePaths[nFileIdx],nFlags);
+                int nType = -2;
+                lvTestCheck_(voSizes[nFileIdx]==oImage.size(),"%s, %s",sStep,vsExpectedFilePaths[nFileIdx].c_str());
+                lvTestCheck_(oIndex.getImageSize(vsExpectedFilePaths[nFileIdx],nFlags,&nType)==oImage.size(),"%s, %s",sStep,vsExpectedFilePaths[nFileIdx].c_str());
+                lvTestCheck_(nType==(oImage.empty()?-1:oImage.type()),"%s, %s",sStep,vsExpectedFilePaths[nFileIdx].c_str());
+            }
+        }
+        for(const std::string& sFilePath : vsExpectedFilePaths)
+            lvTestCheck_(isEqual(oIndex.readMask(sFilePath),cv::imread(sFilePath,cv::IMREAD_GRAYSCALE)),"%s, %s",sStep,sFilePath.c_str());
+        lvTestCheck_(oIndex.getImageSize(s_sDataDirPath+"missing.png")==cv::Size() && oIndex.readMask(s_sDataDirPath+"missing.png").empty(),"%s",sStep);
+    }
+
+    /// writes a small test image whose content depends on the given seed
+    void writeImage(const std::string& sFilePath, cv::Size oSize, int nType, int nSeed) {
+        cv::Mat oImage(oSize,nType);
+        cv::randu(oImage,cv::Scalar::all(0),cv::Scalar::all(2));
+        oImage = (oImage+nSeed%2)*UCHAR_MAX;
+        lvAssert__(cv::imwrite(sFilePath,oImage),"could not write test image at '%s'",sFilePath.c_str());
+    }
+
+    /// removes all files written by this test
+    void cleanup() {
+        std::vector<std::string> vsFilePaths;
+        lv::GetFilesFromDir(s_sDataDirPath,vsFilePaths);
+        for(const std::string& sFilePath : vsFilePaths)
+            std::remove(sFilePath.c_str());
+        std::remove(s_sDataDirPath.c_str());
+        std::remove(s_sIndexFilePath.c_str());
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("indexcache",[]() {
+        cleanup();
+        lvAssert_(lv::CreateDirIfNotExist(s_sDataDirPath),"could not create test data directory");
+        writeImage(s_sDataDirPath+"a.png",cv::Size(31,17),CV_8UC1,0);
+        writeImage(s_sDataDirPath+"b.png",cv::Size(8,64),CV_8UC3,1);
+        writeImage(s_sDataDirPath+"roi.png",cv::Size(40,30),CV_8UC1,2);
+        {
+            lv::DataIndexCache oIndex(s_sIndexFilePath);
+            checkIndex(oIndex,"cold index");
+            checkIndex(oIndex,"warm index");
+        }
+        {
+            // everything must be reloaded from the saved index file, then refreshed for entries whose files changed
+            lv::DataIndexCache oIndex(s_sIndexFilePath);
+            checkIndex(oIndex,"reloaded index");
+            writeImage(s_sDataDirPath+"a.png",cv::Size(45,3),CV_8UC1,3);
+            writeImage(s_sDataDirPath+"roi.png",cv::Size(20,60),CV_8UC1,4);
+            writeImage(s_sDataDirPath+"c.png",cv::Size(5,5),CV_8UC1,5);
+            checkIndex(oIndex,"modified files");
+            std::remove((s_sDataDirPath+"b.png").c_str());
+            checkIndex(oIndex,"removed file");
+        }
+        {
+            lv::DataIndexCache oIndex(s_sIndexFilePath);
+            checkIndex(oIndex,"reloaded modified index");
+        }
+        {
+            // a corrupted index file must be ignored (and then overwritten)
+            std::ofstream oFile(s_sIndexFilePath,std::ios::out|std::ios::binary|std::ios::trunc);
+            oFile << "LVDSINDX garbage";
+        }
+        {
+            lv::DataIndexCache oIndex(s_sIndexFilePath);
+            checkIndex(oIndex,"corrupted index");
+        }
+        {
+            lv::DataIndexCache oIndex(s_sIndexFilePath);
+            checkIndex(oIndex,"rewritten index");
+        }
+        {
+            // in-memory indexes must never touch the disk
+            lv::DataIndexCache oIndex("");
+            checkIndex(oIndex,"in-memory index");
+            lvTestCheck(oIndex.getIndexFilePath().empty());
+        }
+        cleanup();
+    });
+}
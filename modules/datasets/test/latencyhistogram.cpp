@@ -0,0 +1,94 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks the bucket bounds of the packet latency histogram (exact/linear boundary and clamped max), and the windowed percentiles obtained by diffing copies
+
+#include "litiv_test.hpp"
+#include "litiv/datasets/utils.hpp"
+
+namespace {
+
+    /// largest recordable latency (in microseconds), as clamped by the histogram
+    constexpr uint64_t s_nMaxValue = (uint64_t(1)<<41)-1;
+
+    /// returns the median of a histogram holding the given latency (in microseconds) and a much larger one, i.e. the upper bound of the first value's bucket
+    double getBucketUpperBound(uint64_t nValue) {
+        lv::LatencyHistogram oHist;
+        oHist.record(nValue/1e6);
+        oHist.record(s_nMaxValue/1e6);
+        return oHist.getPercentile(50);
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("latencyhistogram",[]() {
+        {
+            const lv::LatencyHistogram oHist;
+            lvTestCheck(oHist.getCount()==0 && oHist.getPercentile(50)==0.0 && oHist.getMax()==0.0);
+        }
+        // values below 64us get exact buckets, and the first linear buckets span two values each
+        lvTestCheck(getBucketUpperBound(0)==0.0);
+        lvTestCheck(getBucketUpperBound(1)==1/1e6);
+        lvTestCheck(getBucketUpperBound(62)==62/1e6);
+        lvTestCheck(getBucketUpperBound(63)==63/1e6);
+        lvTestCheck(getBucketUpperBound(64)==65/1e6);
+        lvTestCheck(getBucketUpperBound(65)==65/1e6);
+        lvTestCheck(getBucketUpperBound(66)==67/1e6);
+        lvTestCheck(getBucketUpperBound(127)==127/1e6);
+        lvTestCheck(getBucketUpperBound(128)==131/1e6);
+        // the last bucket spans [63<<35,2^41-1], and larger values are clamped into it
+        lvTestCheck(getBucketUpperBound((uint64_t(63)<<35)-1)==((uint64_t(63)<<35)-1)/1e6);
+        lvTestCheck(getBucketUpperBound(uint64_t(63)<<35)==s_nMaxValue/1e6);
+        {
+            lv::LatencyHistogram oHist;
+            oHist.record(s_nMaxValue/1e6);
+            oHist.record(1e12);
+            lvTestCheck(oHist.getCount()==2);
+            lvTestCheck(oHist.getMax()==s_nMaxValue/1e6);
+            lvTestCheck(oHist.getPercentile(0)==s_nMaxValue/1e6 && oHist.getPercentile(100)==s_nMaxValue/1e6);
+        }
+        {
+            // percentiles are bucket upper bounds, but never exceed the exact max
+            lv::LatencyHistogram oHist;
+            for(uint64_t nValue=1; nValue<=100; ++nValue)
+                oHist.record(nValue/1e6);
+            lvTestCheck(oHist.getCount()==100);
+            lvTestCheck(oHist.getPercentile(50)==50/1e6);
+            lvTestCheck(oHist.getPercentile(98)==99/1e6 && oHist.getPercentile(99)==99/1e6);
+            lvTestCheck(oHist.getPercentile(100)==100/1e6 && oHist.getMax()==100/1e6);
+            lv::LatencyHistogram oMergedHist(oHist);
+            oMergedHist.merge(oHist);
+            lvTestCheck(oMergedHist.getCount()==200 && oMergedHist.getPercentile(50)==oHist.getPercentile(50));
+        }
+        {
+            // windows are obtained by subtracting an older copy; the window max is bounded by its highest bucket
+            lv::LatencyHistogram oHist;
+            for(int n=0; n<100; ++n)
+                oHist.record(1.0);
+            const lv::LatencyHistogram oLastHist(oHist);
+            for(int n=0; n<10; ++n)
+                oHist.record(10/1e6);
+            lv::LatencyHistogram oWindowHist(oHist);
+            oWindowHist.subtract(oLastHist);
+            lvTestCheck(oWindowHist.getCount()==10);
+            lvTestCheck(oWindowHist.getPercentile(50)==10/1e6 && oWindowHist.getPercentile(100)==10/1e6 && oWindowHist.getMax()==10/1e6);
+            oWindowHist.subtract(oHist);
+            lvTestCheck(oWindowHist.getCount()==0 && oWindowHist.getPercentile(50)==0.0 && oWindowHist.getMax()==0.0);
+        }
+    });
+}
@@ -0,0 +1,194 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks mask blob encoding round trips (bit-packed and run-length paths) and mask archive reopening, appending, compaction and crash recovery
+
+#include "litiv_test.hpp"
+#include "litiv/datasets/utils.hpp"
+
+namespace {
+
+    /// path of the archive file used by this test (created in the working directory)
+    const std::string s_sArchivePath = "litiv_test_maskarchive.lvma";
+
+    /// returns whether both masks have the same size, type and content
+    bool isEqual(const cv::Mat& oMask1, const cv::Mat& oMask2) {
+        return oMask1.size()==oMask2.size() && oMask1.type()==oMask2.type() && (oMask1.empty() || cv::countNonZero(oMask1!=oMask2)==0);
+    }
+
+    /// returns a pseudo-random mask whose values are drawn from the given set (seeded by its index)
+    cv::Mat getMask(size_t nIdx, int nRows, int nCols, std::initializer_list<uchar> lnValues) {
+        const std::vector<uchar> vnValues(lnValues);
+        cv::Mat oMask(nRows,nCols,CV_8UC1);
+        cv::RNG oRNG(nIdx+1);
+        for(int nRowIdx=0; nRowIdx<nRows; ++nRowIdx)
+            for(int nColIdx=0; nColIdx<nCols; ++nColIdx)
+                oMask.at<uchar>(nRowIdx,nColIdx) = vnValues[oRNG.uniform(0,(int)vnValues.size())];
+        return oMask;
+    }
+
+    /// returns the archive mask associated with an index (its content depends on the 'version' so rewrites can be told apart)
+    cv::Mat getArchiveMask(size_t nIdx, size_t nVersion) {
+        return getMask(nIdx*31+nVersion,17+int(nIdx%5),23+int(nIdx%7),{0,UCHAR_MAX});
+    }
+
+    /// reads the whole content of a file
+    std::vector<char> readFile(const std::string& sFilePath) {
+        std::ifstream oFile(sFilePath,std::ios::in|std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(oFile),std::istreambuf_iterator<char>());
+    }
+
+    /// overwrites a file with the given content
+    void writeFile(const std::string& sFilePath, const std::vector<char>& vData) {
+        std::ofstream oFile(sFilePath,std::ios::out|std::ios::binary|std::ios::trunc);
+        oFile.write(vData.data(),std::streamsize(vData.size()));
+    }
+
+    void testRoundTrip(const cv::Mat& oMask, const char* sName) {
+        std::vector<uchar> vBuffer;
+        lv::encodeMask(oMask,vBuffer);
+        cv::Mat oDecodedMask;
+        lv::decodeMask(vBuffer.data(),vBuffer.size(),oDecodedMask);
+        lvTestCheck_(isEqual(oMask,oDecodedMask),"%s (%dx%d)",sName,oMask.rows,oMask.cols);
+        // decoding must overwrite whatever was in a reused output mat
+        oDecodedMask = cv::Scalar(77);
+        lv::decodeMask(vBuffer.data(),vBuffer.size(),oDecodedMask);
+        lvTestCheck_(isEqual(oMask,oDecodedMask),"%s (%dx%d, reused)",sName,oMask.rows,oMask.cols);
+    }
+
+    void testEncoding() {
+        for(int nCols : {1,7,8,9,15,16,17,33,63,64,65,321}) {
+            for(int nRows : {1,3,16}) {
+                testRoundTrip(cv::Mat(nRows,nCols,CV_8UC1,cv::Scalar(0)),"all-unset");
+                testRoundTrip(cv::Mat(nRows,nCols,CV_8UC1,cv::Scalar(UCHAR_MAX)),"all-set");
+                testRoundTrip(getMask(size_t(nRows*1000+nCols),nRows,nCols,{0,UCHAR_MAX}),"binary");
+                testRoundTrip(getMask(size_t(nRows*1000+nCols),nRows,nCols,{0,50,85,170,UCHAR_MAX}),"multi-label");
+            }
+        }
+        // non-continuous masks (e.g. roi views) must be encoded row by row
+        const cv::Mat oLargeMask = getMask(0,40,80,{0,UCHAR_MAX});
+        testRoundTrip(oLargeMask(cv::Rect(3,5,37,21)),"sub-view");
+        // noisy binary masks must be bit-packed (12-byte header + packed rows), while flat masks must be run-length encoded
+        std::vector<uchar> vBinaryBuffer, vLabelBuffer;
+        lv::encodeMask(oLargeMask,vBinaryBuffer);
+        lvTestCheck(vBinaryBuffer.size()==12+size_t(oLargeMask.rows)*((oLargeMask.cols+7)/8));
+        lv::encodeMask(cv::Mat(40,80,CV_8UC1,cv::Scalar(85)),vLabelBuffer);
+        lvTestCheck(vLabelBuffer.size()<vBinaryBuffer.size());
+        // empty masks and truncated blobs must be rejected
+        const auto lThrows = [](const std::function<void()>& lFunc) {
+            try {lFunc();} catch(const std::exception&) {return true;}
+            return false;
+        };
+        cv::Mat oDecodedMask;
+        lvTestCheck(lThrows([&]() {lv::encodeMask(cv::Mat(),vBinaryBuffer);}));
+        lv::encodeMask(oLargeMask,vBinaryBuffer);
+        lvTestCheck(lThrows([&]() {lv::decodeMask(vBinaryBuffer.data(),vBinaryBuffer.size()-1,oDecodedMask);}));
+        lvTestCheck(lThrows([&]() {lv::decodeMask(vLabelBuffer.data(),vLabelBuffer.size()-1,oDecodedMask);}));
+    }
+
+    void testArchive() {
+        constexpr size_t nMaskCount = 40;
+        std::remove(s_sArchivePath.c_str());
+        {
+            lv::MaskArchive oArchive(s_sArchivePath);
+            lvTestCheck(oArchive.getMaskCount()==0 && oArchive.read(0).empty());
+            for(size_t nIdx=0; nIdx<nMaskCount; ++nIdx)
+                oArchive.write(getArchiveMask(nIdx,0),nIdx);
+        }
+        const size_t nInitialFileSize = readFile(s_sArchivePath).size();
+        {
+            // reopening loads the index from the footer; appending new masks and rewriting old ones must both persist
+            lv::MaskArchive oArchive(s_sArchivePath);
+            lvTestCheck(oArchive.getMaskCount()==nMaskCount);
+            for(size_t nIdx=0; nIdx<nMaskCount; ++nIdx)
+                lvTestCheck_(isEqual(oArchive.read(nIdx),getArchiveMask(nIdx,0)),"reopened mask #%d",(int)nIdx);
+            for(size_t nIdx=0; nIdx<nMaskCount/2; ++nIdx)
+                oArchive.write(getArchiveMask(nIdx,1),nIdx);
+            for(size_t nIdx=nMaskCount; nIdx<nMaskCount+5; ++nIdx)
+                oArchive.write(getArchiveMask(nIdx,0),nIdx);
+            lvTestCheck(oArchive.getMaskCount()==nMaskCount+5);
+            lvTestCheck(isEqual(oArchive.read(0),getArchiveMask(0,1)));
+        }
+        {
+            lv::MaskArchive oArchive(s_sArchivePath);
+            lvTestCheck(oArchive.getMaskCount()==nMaskCount+5);
+            for(size_t nIdx=0; nIdx<nMaskCount+5; ++nIdx)
+                lvTestCheck_(isEqual(oArchive.read(nIdx),getArchiveMask(nIdx,(nIdx<nMaskCount/2)?1:0)),"appended/rewritten mask #%d",(int)nIdx);
+        }
+        // superseded records must have been compacted away on flush
+        size_t nAppendedSize = 0;
+        {
+            std::vector<uchar> vBuffer;
+            for(size_t nIdx=nMaskCount; nIdx<nMaskCount+5; ++nIdx) {
+                lv::encodeMask(getArchiveMask(nIdx,0),vBuffer);
+                nAppendedSize += 16+vBuffer.size()+24; // record header + payload + index entry
+            }
+        }
+        const std::vector<char> vCleanFile = readFile(s_sArchivePath);
+        lvTestCheck(vCleanFile.size()==nInitialFileSize+nAppendedSize);
+        {
+            // a write after reopening must invalidate the on-disk footer before touching the old index, so a crash falls back on a rescan
+            lv::MaskArchive oArchive(s_sArchivePath);
+            oArchive.write(getArchiveMask(0,2),0);
+            const std::vector<char> vCrashedFile = readFile(s_sArchivePath);
+            writeFile(s_sArchivePath+".crash",vCrashedFile);
+            lv::MaskArchive oCrashedArchive(s_sArchivePath+".crash");
+            lvTestCheck(oCrashedArchive.getMaskCount()==nMaskCount+5);
+            for(size_t nIdx=1; nIdx<nMaskCount+5; ++nIdx)
+                lvTestCheck_(isEqual(oCrashedArchive.read(nIdx),getArchiveMask(nIdx,(nIdx<nMaskCount/2)?1:0)),"crashed archive mask #%d",(int)nIdx);
+        }
+        std::remove((s_sArchivePath+".crash").c_str());
+        {
+            // a missing footer and a torn trailing record must both be recovered from by rescanning the records
+            std::vector<char> vTornFile(vCleanFile.begin(),vCleanFile.end()-(nMaskCount+5)*24-24);
+            std::vector<uchar> vBuffer;
+            lv::encodeMask(getArchiveMask(99,0),vBuffer);
+            const uint32_t anRecordHeader[4] = {0x524D564C,(uint32_t)vBuffer.size(),99,0};
+            vTornFile.insert(vTornFile.end(),(const char*)anRecordHeader,(const char*)anRecordHeader+sizeof(anRecordHeader));
+            vTornFile.insert(vTornFile.end(),vBuffer.begin(),vBuffer.begin()+vBuffer.size()/2);
+            writeFile(s_sArchivePath,vTornFile);
+            {
+                lv::MaskArchive oArchive(s_sArchivePath);
+                lvTestCheck(oArchive.getMaskCount()==nMaskCount+5 && oArchive.read(99).empty());
+                for(size_t nIdx=0; nIdx<nMaskCount+5; ++nIdx)
+                    lvTestCheck_(isEqual(oArchive.read(nIdx),getArchiveMask(nIdx,(nIdx<nMaskCount/2)?1:0)),"recovered mask #%d",(int)nIdx);
+            }
+            // the rebuilt index must drop the torn record and end the file again
+            lvTestCheck(readFile(s_sArchivePath)==vCleanFile);
+        }
+        {
+            // index entries pointing outside the data section must not be trusted
+            std::vector<char> vBadFile(vCleanFile);
+            const size_t nEntryOffset = vBadFile.size()-24-(nMaskCount+5)*24;
+            const uint64_t nBadOffset = uint64_t(vBadFile.size());
+            std::memcpy(vBadFile.data()+nEntryOffset+8,&nBadOffset,sizeof(nBadOffset));
+            writeFile(s_sArchivePath,vBadFile);
+            lv::MaskArchive oArchive(s_sArchivePath);
+            lvTestCheck(oArchive.getMaskCount()==nMaskCount+5);
+            lvTestCheck(isEqual(oArchive.read(0),getArchiveMask(0,1)));
+        }
+        std::remove(s_sArchivePath.c_str());
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("maskarchive",[]() {
+        testEncoding();
+        testArchive();
+    });
+}
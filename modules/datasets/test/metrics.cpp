@@ -0,0 +1,145 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks every runtime-dispatched binary classification counting kernel table the current CPU supports against a scalar reference
+
+#include "litiv_test.hpp"
+#include "litiv/datasets/metrics.hpp"
+#include "metrics_kernels.hpp"
+#include <random>
+
+namespace {
+
+    /// scalar reference for the classification counts of one output row vs a gt row (the ROI row may be null)
+    void accumulate_row_ref(const uchar* aClassif, const uchar* aGT, const uchar* aROI, size_t nCols, uint64_t* anCounts) {
+        for(size_t nColIdx=0; nColIdx<nCols; ++nColIdx) {
+            const uchar nGT = aGT[nColIdx];
+            if(nGT==DATASETUTILS_OUTOFSCOPE_VAL || nGT==DATASETUTILS_UNKNOWN_VAL || (aROI && aROI[nColIdx]==DATASETUTILS_NEGATIVE_VAL)) {
+                ++anCounts[lv::BinClassif::Counter_DC];
+                continue;
+            }
+            const bool bClassifPos = aClassif[nColIdx]==DATASETUTILS_POSITIVE_VAL, bGTPos = nGT==DATASETUTILS_POSITIVE_VAL;
+            ++anCounts[bClassifPos?(bGTPos?lv::BinClassif::Counter_TP:lv::BinClassif::Counter_FP):(bGTPos?lv::BinClassif::Counter_FN:lv::BinClassif::Counter_TN)];
+            if(bClassifPos && nGT==DATASETUTILS_SHADOW_VAL)
+                ++anCounts[lv::BinClassif::Counter_SE];
+        }
+    }
+
+    /// returns a random row drawn mostly from the given label values (with a few arbitrary values mixed in)
+    std::vector<uchar> getRandomRow(std::mt19937& oRandGen, size_t nCols, const std::vector<uchar>& vnLabels) {
+        std::uniform_int_distribution<int> oLabelDistrib(0,(int)vnLabels.size()), oByteDistrib(0,UCHAR_MAX);
+        std::vector<uchar> vRow(nCols);
+        for(uchar& nVal : vRow) {
+            const int nLabelIdx = oLabelDistrib(oRandGen);
+            nVal = (nLabelIdx<(int)vnLabels.size())?vnLabels[nLabelIdx]:(uchar)oByteDistrib(oRandGen);
+        }
+        return vRow;
+    }
+
+    /// checks one kernel table on random rows for a given row size and output count
+    void testKernels(const lv::BinClassifKernels& oKernels, const char* sISAName, std::mt19937& oRandGen, size_t nCols, size_t nClassifs) {
+        const std::vector<uchar> vnGTLabels = {DATASETUTILS_POSITIVE_VAL,DATASETUTILS_NEGATIVE_VAL,DATASETUTILS_OUTOFSCOPE_VAL,DATASETUTILS_UNKNOWN_VAL,DATASETUTILS_SHADOW_VAL};
+        const std::vector<uchar> vGT = getRandomRow(oRandGen,nCols,vnGTLabels), vROI = getRandomRow(oRandGen,nCols,{DATASETUTILS_POSITIVE_VAL,DATASETUTILS_NEGATIVE_VAL});
+        std::vector<std::vector<uchar>> vvClassifs(nClassifs);
+        std::vector<const uchar*> vpClassifs(nClassifs);
+        for(size_t nClassifIdx=0; nClassifIdx<nClassifs; ++nClassifIdx) {
+            vvClassifs[nClassifIdx] = getRandomRow(oRandGen,nCols,{DATASETUTILS_POSITIVE_VAL,DATASETUTILS_NEGATIVE_VAL});
+            vpClassifs[nClassifIdx] = vvClassifs[nClassifIdx].data();
+        }
+        if(nClassifs>0) // worst case for lane-local counters: every pixel of the first output is a true positive
+            vvClassifs[0] = vGT;
+        for(const uchar* aROI : {(const uchar*)nullptr,vROI.data()}) {
+            // counters are accumulated into (i.e. not reset by the kernels), so they start from a non-zero value
+            std::vector<uint64_t> vnCounts(nClassifs*lv::BinClassif::nCountersCount,7), vnRefCounts(vnCounts);
+            oKernels.accumulate_row(vpClassifs.data(),nClassifs,vGT.data(),aROI,nCols,vnCounts.data());
+            for(size_t nClassifIdx=0; nClassifIdx<nClassifs; ++nClassifIdx)
+                accumulate_row_ref(vpClassifs[nClassifIdx],vGT.data(),aROI,nCols,vnRefCounts.data()+nClassifIdx*lv::BinClassif::nCountersCount);
+            for(size_t nCounterIdx=0; nCounterIdx<vnCounts.size(); ++nCounterIdx)
+                lvTestCheck_(vnCounts[nCounterIdx]==vnRefCounts[nCounterIdx],"%s accumulate_row, %d cols, %d outputs, roi=%d, output %d, counter %d",
+                             sISAName,(int)nCols,(int)nClassifs,(int)(aROI!=nullptr),(int)(nCounterIdx/lv::BinClassif::nCountersCount),(int)(nCounterIdx%lv::BinClassif::nCountersCount));
+        }
+    }
+
+    /// checks the public entrypoint on a whole frame (large enough to be split in row blocks, unless the caller's thread budget forbids it)
+    void testAccumulate(std::mt19937& oRandGen, const cv::Size& oSize, size_t nClassifs) {
+        cv::Mat oGT(oSize,CV_8UC1), oROI(oSize,CV_8UC1);
+        std::vector<cv::Mat> vClassifs(nClassifs);
+        std::vector<lv::BinClassif> vRefCounters(nClassifs);
+        for(int nRowIdx=0; nRowIdx<oSize.height; ++nRowIdx) {
+            const std::vector<uchar> vGT = getRandomRow(oRandGen,(size_t)oSize.width,{DATASETUTILS_POSITIVE_VAL,DATASETUTILS_NEGATIVE_VAL,DATASETUTILS_UNKNOWN_VAL,DATASETUTILS_SHADOW_VAL});
+            const std::vector<uchar> vROI = getRandomRow(oRandGen,(size_t)oSize.width,{DATASETUTILS_POSITIVE_VAL,DATASETUTILS_POSITIVE_VAL,DATASETUTILS_NEGATIVE_VAL});
+            std::copy(vGT.begin(),vGT.end(),oGT.ptr<uchar>(nRowIdx));
+            std::copy(vROI.begin(),vROI.end(),oROI.ptr<uchar>(nRowIdx));
+        }
+        for(size_t nClassifIdx=0; nClassifIdx<nClassifs; ++nClassifIdx) {
+            vClassifs[nClassifIdx] = cv::Mat(oSize,CV_8UC1);
+            for(int nRowIdx=0; nRowIdx<oSize.height; ++nRowIdx) {
+                const std::vector<uchar> vRow = getRandomRow(oRandGen,(size_t)oSize.width,{DATASETUTILS_POSITIVE_VAL,DATASETUTILS_NEGATIVE_VAL});
+                std::copy(vRow.begin(),vRow.end(),vClassifs[nClassifIdx].ptr<uchar>(nRowIdx));
+                uint64_t anCounts[lv::BinClassif::nCountersCount] = {};
+                accumulate_row_ref(vClassifs[nClassifIdx].ptr<uchar>(nRowIdx),oGT.ptr<uchar>(nRowIdx),oROI.ptr<uchar>(nRowIdx),(size_t)oSize.width,anCounts);
+                lv::BinClassif& oRefCounters = vRefCounters[nClassifIdx];
+                oRefCounters.nTP += anCounts[lv::BinClassif::Counter_TP];
+                oRefCounters.nTN += anCounts[lv::BinClassif::Counter_TN];
+                oRefCounters.nFP += anCounts[lv::BinClassif::Counter_FP];
+                oRefCounters.nFN += anCounts[lv::BinClassif::Counter_FN];
+                oRefCounters.nSE += anCounts[lv::BinClassif::Counter_SE];
+                oRefCounters.nDC += anCounts[lv::BinClassif::Counter_DC];
+            }
+        }
+        std::vector<lv::BinClassif> vCounters(nClassifs);
+        lv::BinClassif::accumulate(vClassifs,oGT,oROI,vCounters);
+        for(size_t nClassifIdx=0; nClassifIdx<nClassifs; ++nClassifIdx)
+            lvTestCheck_(vCounters[nClassifIdx].isEqual(vRefCounters[nClassifIdx]),"accumulate, %dx%d, %d outputs, output %d, thread budget %d",
+                         oSize.width,oSize.height,(int)nClassifs,(int)nClassifIdx,(int)lv::getThreadBudget());
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("metrics",[]() {
+        const std::array<const lv::BinClassifKernels*,lv::ISALevelCount> apKernels = {{
+            &lv::g_oBinClassifKernels_generic,
+            &lv::g_oBinClassifKernels_sse4,
+            &lv::g_oBinClassifKernels_avx2,
+            &lv::g_oBinClassifKernels_avx512,
+        }};
+        // row sizes cover tails, multiple full vectors, and rows long enough to overflow 8-bit lane-local counters if they were not reduced
+        const size_t anCols[] = {0,1,15,16,17,31,32,33,63,64,65,100,1000,16384,20000};
+        // output counts cover full groups and the remainders in groups of 2 and 1
+        const size_t anClassifCounts[] = {0,1,2,3,4,5,6,7,9};
+        std::mt19937 oRandGen(42);
+        for(int nLevel=(int)lv::ISALevel_Generic; nLevel<=(int)lv::getISALevel(); ++nLevel) {
+            const char* sISAName = lv::getISALevelName((lv::ISALevelList)nLevel);
+            std::printf("testing '%s' binary classification kernels...\n",sISAName);
+            for(size_t nCols : anCols)
+                for(size_t nClassifs : anClassifCounts)
+                    testKernels(*apKernels[nLevel],sISAName,oRandGen,nCols,nClassifs);
+        }
+        // the public entrypoint should agree with the references on small frames, on frames split in row blocks, and inside parallel regions
+        testAccumulate(oRandGen,cv::Size(37,11),3);
+        testAccumulate(oRandGen,cv::Size(1920,1100),1);
+        {
+            lv::ParallelRegionGuard oGuard;
+            testAccumulate(oRandGen,cv::Size(1920,1100),2);
+        }
+        {
+            lv::ThreadBudgetGuard oBudget(2);
+            testAccumulate(oRandGen,cv::Size(1920,1100),1);
+        }
+    });
+}
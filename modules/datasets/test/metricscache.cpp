@@ -0,0 +1,89 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks that cached batch and group metrics are invalidated whenever outputs are pushed, by comparing them with metrics computed from scratch
+
+#include "litiv_test.hpp"
+#include "testdataset.hpp"
+
+namespace {
+
+    /// directory (created in the working directory) used as the datasets root path by this test
+    const std::string s_sRootDirPath = "litiv_test_metricscache/";
+
+    /// pushes the given test outputs to a batch, and accumulates them into the batch's reference counters
+    void push(lv::test::TestDatasetType::WorkBatch& oBatch, size_t nBeginIdx, size_t nEndIdx, lv::BinClassif& oCounters) {
+        for(size_t nPacketIdx=nBeginIdx; nPacketIdx<nEndIdx; ++nPacketIdx) {
+            const cv::Mat oOutput = lv::test::getTestOutput(oBatch.getName(),nPacketIdx);
+            oCounters.accumulate(oOutput,oBatch.getGT(nPacketIdx).clone(),oBatch.getGTROI(nPacketIdx));
+            oBatch.push(oOutput,nPacketIdx);
+        }
+    }
+
+    /// checks the (possibly cached) metrics of all batches and of the dataset against their reference counters
+    void checkMetrics(const lv::test::TestDatasetType::Ptr& pDataset, const std::vector<lv::BinClassif>& voCounters, const char* sStep) {
+        const lv::IDataHandlerPtrArray vpBatches = pDataset->getBatches(false);
+        lv::BinClassif oTotalCounters;
+        for(size_t nBatchIdx=0; nBatchIdx<vpBatches.size(); ++nBatchIdx) {
+            const lv::test::TestDatasetType::WorkBatch& oBatch = dynamic_cast<const lv::test::TestDatasetType::WorkBatch&>(*vpBatches[nBatchIdx]);
+            lvTestCheck_(lv::test::isEqual(lv::test::getBinClassifMetrics(oBatch.getMetrics(false)),lv::BinClassifMetrics(voCounters[nBatchIdx])),"%s, batch '%s'",sStep,oBatch.getName().c_str());
+            oTotalCounters.accumulate(voCounters[nBatchIdx]);
+        }
+        for(int nQueryIdx=0; nQueryIdx<2; ++nQueryIdx) // the second query must hit the cache, and return the same metrics
+            lvTestCheck_(lv::test::isEqual(lv::test::getBinClassifMetrics(pDataset->getMetrics(false)),lv::BinClassifMetrics(oTotalCounters)),"%s, query %d",sStep,nQueryIdx);
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("metricscache",[]() {
+        lv::test::writeTestDataset(s_sRootDirPath);
+        lv::test::TestDatasetType::Ptr pDataset = lv::test::createTestDataset("cache");
+        const lv::IDataHandlerPtrArray vpBatches = pDataset->getBatches(false);
+        lvAssert_(vpBatches.size()>1,"test dataset should have several batches");
+        std::vector<lv::BinClassif> voCounters(vpBatches.size());
+        const size_t nHalfFrameCount = lv::test::g_nTestFrameCount/2;
+        for(size_t nBatchIdx=0; nBatchIdx<vpBatches.size(); ++nBatchIdx) {
+            lv::test::TestDatasetType::WorkBatch& oBatch = dynamic_cast<lv::test::TestDatasetType::WorkBatch&>(*vpBatches[nBatchIdx]);
+            oBatch.startProcessing();
+            push(oBatch,0,nHalfFrameCount,voCounters[nBatchIdx]);
+        }
+        checkMetrics(pDataset,voCounters,"first half");
+        {
+            // a single packet pushed to a single batch must invalidate the caches of its batch, group and dataset
+            lv::test::TestDatasetType::WorkBatch& oBatch = dynamic_cast<lv::test::TestDatasetType::WorkBatch&>(*vpBatches.back());
+            push(oBatch,nHalfFrameCount,nHalfFrameCount+1,voCounters.back());
+            checkMetrics(pDataset,voCounters,"single packet");
+        }
+        for(size_t nBatchIdx=0; nBatchIdx<vpBatches.size(); ++nBatchIdx) {
+            lv::test::TestDatasetType::WorkBatch& oBatch = dynamic_cast<lv::test::TestDatasetType::WorkBatch&>(*vpBatches[nBatchIdx]);
+            push(oBatch,nBatchIdx+1==vpBatches.size()?nHalfFrameCount+1:nHalfFrameCount,lv::test::g_nTestFrameCount,voCounters[nBatchIdx]);
+            oBatch.stopProcessing();
+        }
+        checkMetrics(pDataset,voCounters,"second half");
+        // restarting processing resets the batch counts, which must also invalidate all caches
+        lv::test::TestDatasetType::WorkBatch& oFirstBatch = dynamic_cast<lv::test::TestDatasetType::WorkBatch&>(*vpBatches.front());
+        oFirstBatch.resetMetrics();
+        voCounters.front() = lv::BinClassif();
+        oFirstBatch.startProcessing();
+        push(oFirstBatch,0,1,voCounters.front());
+        oFirstBatch.stopProcessing();
+        checkMetrics(pDataset,voCounters,"restarted batch");
+        pDataset.reset();
+        lv::test::removeDirs(s_sRootDirPath);
+    });
+}
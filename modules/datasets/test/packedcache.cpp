@@ -0,0 +1,171 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks that packed cache files written for work batches are read back (after being reopened by new batch instances) with the same packets, and that stale, truncated or corrupted files are rejected
+
+#include "litiv_test.hpp"
+#include "testdataset.hpp"
+
+namespace {
+
+    /// directory (created in the working directory) used as the datasets root path by this test
+    const std::string s_sRootDirPath = "litiv_test_packedcache/";
+    /// size of the packed cache file header, followed by the packet table (see 'PackedCacheHeader' in the module sources)
+    constexpr size_t s_nHeaderSize = 48;
+    /// size of a packed cache packet table entry, which starts with its packet's file offset (see 'PackedCacheEntry' in the module sources)
+    constexpr size_t s_nEntrySize = 24;
+
+    /// returns whether both packets have the same size, type and content
+    bool isEqual(const cv::Mat& oPacket1, const cv::Mat& oPacket2) {
+        return oPacket1.size()==oPacket2.size() && oPacket1.type()==oPacket2.type() && (oPacket1.empty() || cv::norm(oPacket1,oPacket2,cv::NORM_INF)==0);
+    }
+
+    /// returns the path of the packed cache file of a work batch (test sequences all share the same name, so their relative paths are used instead)
+    std::string getPackedCacheFilePath(const lv::IDataHandler& oBatch) {
+        std::string sFileName = oBatch.getRelativePath();
+        std::replace(sFileName.begin(),sFileName.end(),'/','_');
+        return s_sRootDirPath+"packed_"+sFileName+".bin";
+    }
+
+    /// returns the content of a binary file
+    std::vector<char> readFile(const std::string& sFilePath) {
+        std::ifstream oFile(sFilePath,std::ios::in|std::ios::binary);
+        lvAssert__(oFile.is_open(),"could not open file at '%s'",sFilePath.c_str());
+        return std::vector<char>(std::istreambuf_iterator<char>(oFile),std::istreambuf_iterator<char>());
+    }
+
+    /// overwrites a binary file with the given content
+    void writeFile(const std::string& sFilePath, const std::vector<char>& vcData) {
+        std::ofstream oFile(sFilePath,std::ios::out|std::ios::binary|std::ios::trunc);
+        lvAssert__(oFile.is_open(),"could not create file at '%s'",sFilePath.c_str());
+        oFile.write(vcData.data(),std::streamsize(vcData.size()));
+    }
+
+    /// returns all input (and gt) packets of a work batch, loaded without packed cache
+    std::vector<cv::Mat> getPackets(lv::test::TestDatasetType::WorkBatch& oBatch, bool bGT) {
+        std::vector<cv::Mat> voPackets(bGT?oBatch.getGTCount():oBatch.getInputCount());
+        for(size_t nPacketIdx=0; nPacketIdx<voPackets.size(); ++nPacketIdx)
+            voPackets[nPacketIdx] = (bGT?oBatch.getGT(nPacketIdx):oBatch.getInput(nPacketIdx)).clone();
+        return voPackets;
+    }
+
+    /// checks that a work batch returns the given input (and gt) packets
+    void checkPackets(lv::test::TestDatasetType::WorkBatch& oBatch, const std::vector<cv::Mat>& voInputs, const std::vector<cv::Mat>& voGTs, const char* sStep) {
+        for(size_t nPacketIdx=0; nPacketIdx<voInputs.size(); ++nPacketIdx)
+            lvTestCheck_(isEqual(oBatch.getInput(nPacketIdx),voInputs[nPacketIdx]),"%s, batch '%s', input #%d",sStep,oBatch.getName().c_str(),(int)nPacketIdx);
+        for(size_t nPacketIdx=0; nPacketIdx<voGTs.size(); ++nPacketIdx)
+            lvTestCheck_(isEqual(oBatch.getGT(nPacketIdx),voGTs[nPacketIdx]),"%s, batch '%s', gt #%d",sStep,oBatch.getName().c_str(),(int)nPacketIdx);
+    }
+
+    /// returns the work batches of a new test dataset instance
+    std::vector<lv::test::TestDatasetType::WorkBatch*> getBatches(const lv::test::TestDatasetType::Ptr& pDataset) {
+        std::vector<lv::test::TestDatasetType::WorkBatch*> vpBatches;
+        for(const lv::IDataHandlerPtr& pBatch : pDataset->getBatches(false))
+            vpBatches.push_back(&dynamic_cast<lv::test::TestDatasetType::WorkBatch&>(*pBatch));
+        return vpBatches;
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("packedcache",[]() {
+        lv::test::writeTestDataset(s_sRootDirPath);
+        std::vector<std::vector<cv::Mat>> vvoInputs,vvoGTs;
+        {
+            // round trip: packets are written, then read back from the mapped file by the same batches
+            lv::test::TestDatasetType::Ptr pDataset = lv::test::createTestDataset("write");
+            for(lv::test::TestDatasetType::WorkBatch* pBatch : getBatches(pDataset)) {
+                vvoInputs.push_back(getPackets(*pBatch,false));
+                vvoGTs.push_back(getPackets(*pBatch,true));
+                pBatch->writePackedCache(getPackedCacheFilePath(*pBatch));
+                lvTestCheck_(pBatch->openPackedCache(getPackedCacheFilePath(*pBatch)),"batch '%s'",pBatch->getName().c_str());
+                lvTestCheck_(pBatch->isUsingPackedCache(),"batch '%s'",pBatch->getName().c_str());
+                checkPackets(*pBatch,vvoInputs.back(),vvoGTs.back(),"write");
+                pBatch->closePackedCache();
+                checkPackets(*pBatch,vvoInputs.back(),vvoGTs.back(),"close");
+            }
+        }
+        {
+            // reopen: new batch instances map the files written above
+            lv::test::TestDatasetType::Ptr pDataset = lv::test::createTestDataset("reopen");
+            const std::vector<lv::test::TestDatasetType::WorkBatch*> vpBatches = getBatches(pDataset);
+            lvTestCheck(vpBatches.size()==vvoInputs.size());
+            for(size_t nBatchIdx=0; nBatchIdx<vpBatches.size() && nBatchIdx<vvoInputs.size(); ++nBatchIdx) {
+                lv::test::TestDatasetType::WorkBatch& oBatch = *vpBatches[nBatchIdx];
+                lvTestCheck_(oBatch.openPackedCache(getPackedCacheFilePath(oBatch)),"batch '%s'",oBatch.getName().c_str());
+                checkPackets(oBatch,vvoInputs[nBatchIdx],vvoGTs[nBatchIdx],"reopen");
+                oBatch.closePackedCache();
+            }
+            // inputs only: gt packets keep being loaded from the dataset
+            lv::test::TestDatasetType::WorkBatch& oBatch = *vpBatches.front();
+            const std::string sInputOnlyFilePath = s_sRootDirPath+"packed_inputs.bin";
+            oBatch.writePackedCache(sInputOnlyFilePath,false);
+            lvTestCheck(oBatch.openPackedCache(sInputOnlyFilePath));
+            checkPackets(oBatch,vvoInputs.front(),vvoGTs.front(),"inputs only");
+            oBatch.closePackedCache();
+        }
+        {
+            // stale: batches loaded with other transformation parameters must not use the files written above
+            lv::test::TestDatasetType::Ptr pDataset = lv::test::TestDatasetType::create("stale",false,true,false,0.5,false);
+            for(lv::test::TestDatasetType::WorkBatch* pBatch : getBatches(pDataset)) {
+                lvTestCheck_(!pBatch->openPackedCache(getPackedCacheFilePath(*pBatch)),"batch '%s'",pBatch->getName().c_str());
+                lvTestCheck_(!pBatch->isUsingPackedCache(),"batch '%s'",pBatch->getName().c_str());
+            }
+        }
+        {
+            // corrupt: truncated files and altered headers/tables are rejected (without throwing), and packets are then loaded from the dataset
+            lv::test::TestDatasetType::Ptr pDataset = lv::test::createTestDataset("corrupt");
+            lv::test::TestDatasetType::WorkBatch& oBatch = *getBatches(pDataset).front();
+            const std::string sFilePath = getPackedCacheFilePath(oBatch);
+            const std::vector<char> vcData = readFile(sFilePath);
+            lvAssert__(vcData.size()>s_nHeaderSize+s_nEntrySize,"unexpected packed cache file size (%d bytes)",(int)vcData.size());
+            std::vector<std::pair<std::string,std::vector<char>>> vCorruptFiles;
+            for(size_t nSize : {size_t(0),size_t(1),s_nHeaderSize/2,s_nHeaderSize-1,s_nHeaderSize,vcData.size()/2,vcData.size()-1})
+                vCorruptFiles.emplace_back("truncated to "+std::to_string(nSize)+" bytes",std::vector<char>(vcData.begin(),vcData.begin()+nSize));
+            const auto lAlter = [&](const std::string& sName, size_t nOffset, const std::vector<char>& vcBytes) {
+                std::vector<char> vcCorruptData = vcData;
+                std::copy(vcBytes.begin(),vcBytes.end(),vcCorruptData.begin()+nOffset);
+                vCorruptFiles.emplace_back(sName,vcCorruptData);
+            };
+            lAlter("bad magic",0,{'X'});
+            lAlter("bad version",8,{char(0x7F)});
+            lAlter("bad input count",24,{char(0x7F)});
+            lAlter("huge name table",40,std::vector<char>(8,char(0xFF)));
+            lAlter("huge packet offset",s_nHeaderSize,{char(0xC0),char(0xFF),char(0xFF),char(0xFF),char(0xFF),char(0xFF),char(0xFF),char(0xFF)});
+            lAlter("misaligned packet offset",s_nHeaderSize,{char(0x01)});
+            lAlter("huge packet size",s_nHeaderSize+8,{char(0xFF),char(0xFF),char(0xFF),char(0x7F),char(0xFF),char(0xFF),char(0xFF),char(0x7F)});
+            const std::string sCorruptFilePath = s_sRootDirPath+"packed_corrupt.bin";
+            for(const auto& oCorruptFile : vCorruptFiles) {
+                writeFile(sCorruptFilePath,oCorruptFile.second);
+                bool bOpened = true;
+                try {
+                    bOpened = oBatch.openPackedCache(sCorruptFilePath);
+                }
+                catch(const std::exception&) {
+                    lvTestCheck_(false,"%s: exception thrown",oCorruptFile.first.c_str());
+                }
+                lvTestCheck_(!bOpened && !oBatch.isUsingPackedCache(),"%s",oCorruptFile.first.c_str());
+            }
+            checkPackets(oBatch,vvoInputs.front(),vvoGTs.front(),"corrupt");
+            lvTestCheck(!oBatch.openPackedCache(s_sRootDirPath+"packed_missing.bin"));
+            lvTestCheck(oBatch.openPackedCache(sFilePath));
+            checkPackets(oBatch,vvoInputs.front(),vvoGTs.front(),"intact");
+            oBatch.closePackedCache();
+        }
+        lv::test::removeDirs(s_sRootDirPath);
+    });
+}
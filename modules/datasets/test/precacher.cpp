@@ -0,0 +1,258 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks that data precachers return the packets of a generated test sequence in order and intact, with one or more decode threads, including when stepping back through the look-behind window;
+// also checks that in-place loading decodes straight into cache memory and matches the copy path, both for raw precachers and for work batches (with and without packet transformations),
+// and that packets requested outside the ring window go through the lru cache in the right eviction order, while packets pinned by readers survive ring wrap-arounds
+
+#include "litiv_test.hpp"
+#include "testdataset.hpp"
+
+namespace {
+
+    /// directory (created in the working directory) used as the datasets root path by this test
+    const std::string s_sRootDirPath = "litiv_test_precacher/";
+    /// buffer size suggested to the precachers (large enough to hold the whole test sequence)
+    constexpr size_t s_nBufferSize = size_t(16*1024*1024);
+
+    /// returns whether both packets have the same size, type and content
+    bool isEqual(const cv::Mat& oPacket1, const cv::Mat& oPacket2) {
+        return oPacket1.size()==oPacket2.size() && oPacket1.type()==oPacket2.type() && (oPacket1.empty() || cv::norm(oPacket1,oPacket2,cv::NORM_INF)==0);
+    }
+
+    /// returns the path of an input frame of the generated 'baseline' test sequence
+    std::string getInputFilePath(size_t nPacketIdx) {
+        std::array<char,32> acBuffer;
+        snprintf(acBuffer.data(),acBuffer.size(),"in%06d.jpg",(int)nPacketIdx+1);
+        return s_sRootDirPath+"CDNet/dataset/baseline/seq/input/"+acBuffer.data();
+    }
+
+    /// input frame loader for the generated 'baseline' test sequence, which counts how many times each packet was decoded, and by which threads
+    struct TestLoader {
+        TestLoader() : m_vnLoadCounts(lv::test::g_nTestFrameCount,0) {}
+        /// decodes a packet by value (reentrant; small index-dependent delays make concurrent decode threads finish out of order)
+        cv::Mat load(size_t nPacketIdx) {
+            if(nPacketIdx>=lv::test::g_nTestFrameCount)
+                return cv::Mat();
+            std::this_thread::sleep_for(std::chrono::milliseconds((nPacketIdx*7)%5));
+            cv::Mat oPacket = cv::imread(getInputFilePath(nPacketIdx));
+            std::mutex_lock_guard oLock(m_oMutex);
+            ++m_vnLoadCounts[nPacketIdx];
+            m_vDecodeThreadIDs.insert(std::this_thread::get_id());
+            return oPacket;
+        }
+        /// decodes a packet into the loader's own buffer (not reentrant)
+        const cv::Mat& loadLatest(size_t nPacketIdx) {
+            m_oLatestPacket = load(nPacketIdx);
+            return m_oLatestPacket;
+        }
+        /// decodes a packet straight into the cache slot given by the precacher (not reentrant), and records that slot
+        cv::Mat loadInPlace(size_t nPacketIdx, const lv::DataPrecacher::PacketAllocator& lAllocator) {
+            if(nPacketIdx>=lv::test::g_nTestFrameCount)
+                return cv::Mat();
+            cv::Mat oPacket = lAllocator(lv::test::g_oTestFrameSize,CV_8UC3);
+            if(oPacket.empty())
+                return oPacket; // cache is full, the precacher will ask again later
+            const uchar* pCacheSlot = oPacket.data;
+            cv::imread(getInputFilePath(nPacketIdx)).copyTo(oPacket);
+            lvAssert__(oPacket.data==pCacheSlot,"test packet #%d does not fit its cache slot",(int)nPacketIdx);
+            std::mutex_lock_guard oLock(m_oMutex);
+            ++m_vnLoadCounts[nPacketIdx];
+            m_mInPlaceSlots[nPacketIdx] = pCacheSlot;
+            return oPacket;
+        }
+        std::mutex m_oMutex;
+        std::vector<size_t> m_vnLoadCounts;
+        std::set<std::thread::id> m_vDecodeThreadIDs;
+        std::map<size_t,const uchar*> m_mInPlaceSlots;
+        cv::Mat m_oLatestPacket;
+    };
+
+    /// reads the whole test sequence through a precacher, stepping back through the look-behind window after each packet, and checks packets against the given ones
+    void testStream(const std::vector<cv::Mat>& voPackets, size_t nDecodeThreads, size_t nLookahead, size_t nLookBehind) {
+        TestLoader oLoader;
+        lv::DataPrecacher oPrecacher([&](size_t nPacketIdx) -> const cv::Mat& {return oLoader.loadLatest(nPacketIdx);},[&](size_t nPacketIdx) {return oLoader.load(nPacketIdx);});
+        oPrecacher.setRandomAccessPolicy(nLookBehind,0);
+        lvTestCheck_(oPrecacher.startAsyncPrecaching(s_nBufferSize,nDecodeThreads,nLookahead),"%d decode thread(s)",(int)nDecodeThreads);
+        for(size_t nPacketIdx=0; nPacketIdx<voPackets.size(); ++nPacketIdx) {
+            lvTestCheck_(isEqual(oPrecacher.getPacket(nPacketIdx),voPackets[nPacketIdx]),"%d decode thread(s), lookahead %d, packet #%d",(int)nDecodeThreads,(int)nLookahead,(int)nPacketIdx);
+            for(size_t nStepBack=1; nStepBack<nLookBehind && nStepBack<=nPacketIdx; ++nStepBack)
+                lvTestCheck_(isEqual(oPrecacher.getPacket(nPacketIdx-nStepBack),voPackets[nPacketIdx-nStepBack]),"%d decode thread(s), lookahead %d, packet #%d, step back %d",(int)nDecodeThreads,(int)nLookahead,(int)nPacketIdx,(int)nStepBack);
+        }
+        lvTestCheck_(oPrecacher.getPacket(voPackets.size()).empty(),"%d decode thread(s), lookahead %d",(int)nDecodeThreads,(int)nLookahead);
+        oPrecacher.stopAsyncPrecaching();
+        // packets stepped back to must have been served from the ring, and never decoded again
+        for(size_t nPacketIdx=0; nPacketIdx<voPackets.size(); ++nPacketIdx)
+            lvTestCheck_(oLoader.m_vnLoadCounts[nPacketIdx]==1,"%d decode thread(s), lookahead %d, packet #%d loaded %d time(s)",(int)nDecodeThreads,(int)nLookahead,(int)nPacketIdx,(int)oLoader.m_vnLoadCounts[nPacketIdx]);
+        if(nDecodeThreads>1)
+            lvTestCheck_(oLoader.m_vDecodeThreadIDs.size()>1,"%d decode thread(s), lookahead %d",(int)nDecodeThreads,(int)nLookahead);
+    }
+
+    /// reads the whole test sequence through a precacher which also has an in-place loader, and checks that packets are served from the slots they were decoded in (unless decode threads are used)
+    void testInPlaceStream(const std::vector<cv::Mat>& voPackets, size_t nDecodeThreads) {
+        TestLoader oLoader;
+        lv::DataPrecacher oPrecacher([&](size_t nPacketIdx) -> const cv::Mat& {return oLoader.loadLatest(nPacketIdx);},[&](size_t nPacketIdx) {return oLoader.load(nPacketIdx);},
+                                     [&](size_t nPacketIdx, const lv::DataPrecacher::PacketAllocator& lAllocator) {return oLoader.loadInPlace(nPacketIdx,lAllocator);});
+        lvTestCheck_(oPrecacher.startAsyncPrecaching(s_nBufferSize,nDecodeThreads),"%d decode thread(s)",(int)nDecodeThreads);
+        for(size_t nPacketIdx=0; nPacketIdx<voPackets.size(); ++nPacketIdx) {
+            const cv::Mat& oPacket = oPrecacher.getPacket(nPacketIdx);
+            lvTestCheck_(isEqual(oPacket,voPackets[nPacketIdx]),"%d decode thread(s), packet #%d",(int)nDecodeThreads,(int)nPacketIdx);
+            if(nDecodeThreads==1) {
+                std::mutex_lock_guard oLock(oLoader.m_oMutex);
+                const auto pSlot = oLoader.m_mInPlaceSlots.find(nPacketIdx);
+                lvTestCheck_(pSlot!=oLoader.m_mInPlaceSlots.end() && pSlot->second==oPacket.data,"packet #%d",(int)nPacketIdx);
+            }
+        }
+        lvTestCheck_(oPrecacher.getPacket(voPackets.size()).empty(),"%d decode thread(s)",(int)nDecodeThreads);
+        oPrecacher.stopAsyncPrecaching();
+        // decode threads need by-value packets, so the in-place loader must be left unused when they are active
+        lvTestCheck_(oLoader.m_mInPlaceSlots.size()==(nDecodeThreads==1?voPackets.size():size_t(0)),"%d decode thread(s), %d packet(s) loaded in place",(int)nDecodeThreads,(int)oLoader.m_mInPlaceSlots.size());
+        for(size_t nPacketIdx=0; nPacketIdx<voPackets.size(); ++nPacketIdx)
+            lvTestCheck_(oLoader.m_vnLoadCounts[nPacketIdx]==1,"%d decode thread(s), packet #%d loaded %d time(s)",(int)nDecodeThreads,(int)nPacketIdx,(int)oLoader.m_vnLoadCounts[nPacketIdx]);
+    }
+
+    /// reads all input packets of a new test dataset instance without precaching (copy path) and with precaching (in-place path), and checks that both are identical
+    void testBatchInputs(bool bForce4ByteAlign, double dScaleFactor) {
+        lv::test::TestDatasetType::Ptr pDataset = lv::test::TestDatasetType::create("inplace",false,true,bForce4ByteAlign,dScaleFactor,false);
+        for(const lv::IDataHandlerPtr& pBatch : pDataset->getBatches(false)) {
+            lv::test::TestDatasetType::WorkBatch& oBatch = dynamic_cast<lv::test::TestDatasetType::WorkBatch&>(*pBatch);
+            std::vector<cv::Mat> voCopiedInputs(oBatch.getFrameCount());
+            for(size_t nPacketIdx=0; nPacketIdx<voCopiedInputs.size(); ++nPacketIdx)
+                voCopiedInputs[nPacketIdx] = oBatch.getInput(nPacketIdx).clone();
+            oBatch.startPrecaching(false,s_nBufferSize);
+            for(size_t nPacketIdx=0; nPacketIdx<voCopiedInputs.size(); ++nPacketIdx)
+                lvTestCheck_(isEqual(oBatch.getInput(nPacketIdx),voCopiedInputs[nPacketIdx]),"4-byte align = %d, scale = %f, batch '%s', packet #%d",(int)bForce4ByteAlign,dScaleFactor,oBatch.getName().c_str(),(int)nPacketIdx);
+            oBatch.stopPrecaching();
+        }
+    }
+
+    /// size of the synthetic packets used to wrap the ring around (the smallest ring only holds a few of them)
+    const cv::Size s_oLargePacketSize(1024,1024);
+    /// number of synthetic packets in the large packet sequence
+    constexpr size_t s_nLargePacketCount = 40;
+
+    /// returns a synthetic packet whose content only depends on its index
+    cv::Mat getLargePacket(size_t nPacketIdx) {
+        cv::Mat oPacket(s_oLargePacketSize,CV_8UC1);
+        cv::RNG oRNG((uint64)nPacketIdx+1);
+        oRNG.fill(oPacket,cv::RNG::UNIFORM,0,256);
+        return oPacket;
+    }
+
+    /// synthetic large packet loader, which counts how many times each packet was loaded
+    struct LargePacketLoader {
+        LargePacketLoader() : m_vnLoadCounts(s_nLargePacketCount,0) {}
+        /// generates a packet into a new buffer (not reentrant)
+        const cv::Mat& load(size_t nPacketIdx) {
+            m_oLatestPacket = (nPacketIdx<s_nLargePacketCount)?getLargePacket(nPacketIdx):cv::Mat();
+            std::mutex_lock_guard oLock(m_oMutex);
+            if(nPacketIdx<s_nLargePacketCount)
+                ++m_vnLoadCounts[nPacketIdx];
+            return m_oLatestPacket;
+        }
+        /// returns how many times a packet was loaded so far
+        size_t getLoadCount(size_t nPacketIdx) {
+            std::mutex_lock_guard oLock(m_oMutex);
+            return m_vnLoadCounts[nPacketIdx];
+        }
+        std::mutex m_oMutex;
+        std::vector<size_t> m_vnLoadCounts;
+        cv::Mat m_oLatestPacket;
+    };
+
+    /// reads the large packet sequence once, then fetches packets left behind by the ring with a second reader, and checks which ones the lru cache kept
+    void testLRUEviction() {
+        LargePacketLoader oLoader;
+        lv::DataPrecacher oPrecacher([&](size_t nPacketIdx) -> const cv::Mat& {return oLoader.load(nPacketIdx);});
+        oPrecacher.setRandomAccessPolicy(1,s_oLargePacketSize.area()*2);
+        lvTestCheck(oPrecacher.startAsyncPrecaching(s_nBufferSize));
+        for(size_t nPacketIdx=0; nPacketIdx<s_nLargePacketCount; ++nPacketIdx)
+            lvTestCheck_(isEqual(oPrecacher.getPacket(nPacketIdx),getLargePacket(nPacketIdx)),"packet #%d",(int)nPacketIdx);
+        for(size_t nPacketIdx=0; nPacketIdx<s_nLargePacketCount; ++nPacketIdx)
+            lvTestCheck_(oLoader.getLoadCount(nPacketIdx)==1,"packet #%d loaded %d time(s)",(int)nPacketIdx,(int)oLoader.getLoadCount(nPacketIdx));
+        // requested packet index => expected load count once fetched; the lru cache holds two packets, and hits refresh their rank
+        const std::vector<std::pair<size_t,size_t>> vRequests = {{2,2},{5,2},{2,2},{7,2},{2,2},{5,3},{2,2},{7,3}};
+        for(size_t nRequestIdx=0; nRequestIdx<vRequests.size(); ++nRequestIdx) {
+            const size_t nPacketIdx = vRequests[nRequestIdx].first;
+            lvTestCheck_(isEqual(oPrecacher.getPacket(nPacketIdx,1),getLargePacket(nPacketIdx)),"request #%d, packet #%d",(int)nRequestIdx,(int)nPacketIdx);
+            lvTestCheck_(oLoader.getLoadCount(nPacketIdx)==vRequests[nRequestIdx].second,"request #%d, packet #%d loaded %d time(s)",(int)nRequestIdx,(int)nPacketIdx,(int)oLoader.getLoadCount(nPacketIdx));
+        }
+        oPrecacher.stopAsyncPrecaching();
+    }
+
+    /// pins a packet with a second reader while the first one streams through the whole large packet sequence, and checks that the pinned packet stays intact
+    void testReaderPins() {
+        LargePacketLoader oLoader;
+        lv::DataPrecacher oPrecacher([&](size_t nPacketIdx) -> const cv::Mat& {return oLoader.load(nPacketIdx);});
+        oPrecacher.setRandomAccessPolicy(0,0);
+        lvTestCheck(oPrecacher.startAsyncPrecaching(s_nBufferSize));
+        lvTestCheck(isEqual(oPrecacher.getPacket(0,0),getLargePacket(0)));
+        const cv::Mat& oPinnedPacket = oPrecacher.getPacket(1,1);
+        lvTestCheck(isEqual(oPinnedPacket,getLargePacket(1)));
+        for(size_t nPacketIdx=1; nPacketIdx<s_nLargePacketCount; ++nPacketIdx)
+            lvTestCheck_(isEqual(oPrecacher.getPacket(nPacketIdx,0),getLargePacket(nPacketIdx)),"packet #%d",(int)nPacketIdx);
+        lvTestCheck(isEqual(oPinnedPacket,getLargePacket(1)));
+        lvTestCheck(oLoader.getLoadCount(1)==1);
+        lvTestCheck(isEqual(oPrecacher.getPacket(2,1),getLargePacket(2)));
+        oPrecacher.stopAsyncPrecaching();
+    }
+
+    /// fetches random packets of the large packet sequence with two readers (the first one repeatedly leaving the ring window), and checks them all
+    void testRandomAccess() {
+        LargePacketLoader oLoader;
+        lv::DataPrecacher oPrecacher([&](size_t nPacketIdx) -> const cv::Mat& {return oLoader.load(nPacketIdx);});
+        oPrecacher.setRandomAccessPolicy(4,s_oLargePacketSize.area()*4);
+        lvTestCheck(oPrecacher.startAsyncPrecaching(s_nBufferSize));
+        cv::RNG oRNG(42);
+        for(size_t nRequestIdx=0; nRequestIdx<200; ++nRequestIdx) {
+            const size_t nReaderIdx = (size_t)oRNG.uniform(0,2);
+            const size_t nPacketIdx = (size_t)oRNG.uniform(0,(int)s_nLargePacketCount+2);
+            const cv::Mat& oPacket = oPrecacher.getPacket(nPacketIdx,nReaderIdx);
+            if(nPacketIdx<s_nLargePacketCount)
+                lvTestCheck_(isEqual(oPacket,getLargePacket(nPacketIdx)),"request #%d, reader %d, packet #%d",(int)nRequestIdx,(int)nReaderIdx,(int)nPacketIdx);
+            else
+                lvTestCheck_(oPacket.empty(),"request #%d, reader %d, packet #%d",(int)nRequestIdx,(int)nReaderIdx,(int)nPacketIdx);
+        }
+        oPrecacher.stopAsyncPrecaching();
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("precacher",[]() {
+        lv::test::writeTestDataset(s_sRootDirPath);
+        std::vector<cv::Mat> voPackets(lv::test::g_nTestFrameCount);
+        for(size_t nPacketIdx=0; nPacketIdx<voPackets.size(); ++nPacketIdx) {
+            voPackets[nPacketIdx] = cv::imread(getInputFilePath(nPacketIdx));
+            lvAssert__(!voPackets[nPacketIdx].empty(),"could not read test packet #%d",(int)nPacketIdx);
+        }
+        for(size_t nDecodeThreads : {size_t(1),size_t(2),size_t(4)}) {
+            testStream(voPackets,nDecodeThreads,0,4);
+            testStream(voPackets,nDecodeThreads,nDecodeThreads,4);
+            testStream(voPackets,nDecodeThreads,lv::test::g_nTestFrameCount*2,lv::test::g_nTestFrameCount);
+        }
+        for(size_t nDecodeThreads : {size_t(1),size_t(2)})
+            testInPlaceStream(voPackets,nDecodeThreads);
+        for(bool bForce4ByteAlign : {false,true})
+            for(double dScaleFactor : {1.0,0.5})
+                testBatchInputs(bForce4ByteAlign,dScaleFactor);
+        testLRUEviction();
+        testReaderPins();
+        testRandomAccess();
+        lv::test::removeDirs(s_sRootDirPath);
+    });
+}
@@ -0,0 +1,117 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// note: this header provides a small generated CDnet 2012-like dataset for the tests of this module that need full work batches
+
+#include "litiv/datasets.hpp"
+
+namespace lv {
+
+    namespace test {
+
+        /// dataset specialization matching the generated test dataset
+        using TestDatasetType = lv::Dataset_<lv::DatasetTask_Segm,lv::Dataset_CDnet,lv::NonParallel>;
+        /// frame size of all generated sequences
+        const cv::Size g_oTestFrameSize(64,48);
+        /// number of frames in each generated sequence
+        constexpr size_t g_nTestFrameCount = 12;
+
+        /// recursively removes all files and directories found under the given (slash-terminated) path, and the directory itself
+        inline void removeDirs(const std::string& sDirPath) {
+            std::vector<std::string> vsPaths;
+            lv::GetSubDirsFromDir(sDirPath,vsPaths);
+            for(const std::string& sSubDirPath : vsPaths)
+                removeDirs(lv::AddDirSlashIfMissing(sSubDirPath));
+            lv::GetFilesFromDir(sDirPath,vsPaths);
+            for(const std::string& sFilePath : vsPaths)
+                std::remove(sFilePath.c_str());
+            std::remove(sDirPath.substr(0,sDirPath.size()-1).c_str());
+        }
+
+        /// creates all directories along the given (slash-terminated) path
+        inline void createDirs(const std::string& sDirPath) {
+            for(size_t nSlashPos=sDirPath.find('/'); nSlashPos!=std::string::npos; nSlashPos=sDirPath.find('/',nSlashPos+1))
+                lv::CreateDirIfNotExist(sDirPath.substr(0,nSlashPos));
+        }
+
+        /// writes a CDnet 2012-like dataset (one or more sequences per category, named 'seq', 'seq1', 'seq2', ...) with random inputs, gt masks (incl. shadows/unknowns) and rois, and uses its directory as the datasets root path
+        inline void writeTestDataset(const std::string& sRootDirPath, size_t nSeqCount=1) {
+            removeDirs(sRootDirPath);
+            cv::RNG oRNG(42);
+            const std::array<uchar,5> anGTVals = {DATASETUTILS_NEGATIVE_VAL,DATASETUTILS_POSITIVE_VAL,DATASETUTILS_OUTOFSCOPE_VAL,DATASETUTILS_UNKNOWN_VAL,DATASETUTILS_SHADOW_VAL};
+            for(const std::string& sCategory : {"baseline","cameraJitter","dynamicBackground","intermittentObjectMotion","shadow","thermal"}) {
+                for(size_t nSeqIdx=0; nSeqIdx<nSeqCount; ++nSeqIdx) {
+                    const std::string sSeqPath = sRootDirPath+"CDNet/dataset/"+sCategory+"/seq"+(nSeqIdx?std::to_string(nSeqIdx):std::string())+"/";
+                    createDirs(sSeqPath+"input/");
+                    createDirs(sSeqPath+"groundtruth/");
+                    cv::Mat oROI(g_oTestFrameSize,CV_8UC1,cv::Scalar_<uchar>(255));
+                    oROI(cv::Rect(0,0,g_oTestFrameSize.width/4,g_oTestFrameSize.height)) = 0;
+                    lvAssert_(cv::imwrite(sSeqPath+"ROI.bmp",oROI) && cv::imwrite(sSeqPath+"ROI.jpg",oROI),"could not write test roi");
+                    for(size_t nFrameIdx=0; nFrameIdx<g_nTestFrameCount; ++nFrameIdx) {
+                        std::array<char,32> acBuffer;
+                        cv::Mat oInput(g_oTestFrameSize,CV_8UC3), oGT(g_oTestFrameSize,CV_8UC1);
+                        oRNG.fill(oInput,cv::RNG::UNIFORM,0,256);
+                        for(size_t nPxIter=0; nPxIter<oGT.total(); ++nPxIter)
+                            oGT.data[nPxIter] = anGTVals[oRNG.uniform(0,(int)anGTVals.size())];
+                        snprintf(acBuffer.data(),acBuffer.size(),"in%06d.jpg",(int)nFrameIdx+1);
+                        lvAssert_(cv::imwrite(sSeqPath+"input/"+acBuffer.data(),oInput),"could not write test input");
+                        snprintf(acBuffer.data(),acBuffer.size(),"gt%06d.png",(int)nFrameIdx+1);
+                        lvAssert_(cv::imwrite(sSeqPath+"groundtruth/"+acBuffer.data(),oGT),"could not write test gt");
+                    }
+                }
+            }
+            lv::datasets::setDatasetsRootPath(sRootDirPath);
+        }
+
+        /// creates a new instance of the generated test dataset (results go in a subdirectory of the given name)
+        inline TestDatasetType::Ptr createTestDataset(const std::string& sOutputDirName) {
+            return TestDatasetType::create(sOutputDirName,false,true,false,1.0,false);
+        }
+
+        /// returns a random output mask for the test dataset whose content only depends on the given batch name and packet index
+        inline cv::Mat getTestOutput(const std::string& sBatchName, size_t nPacketIdx) {
+            cv::RNG oRNG((uint64)(std::hash<std::string>()(sBatchName)+nPacketIdx));
+            cv::Mat oOutput(g_oTestFrameSize,CV_8UC1);
+            oRNG.fill(oOutput,cv::RNG::UNIFORM,0,2);
+            return oOutput*UCHAR_MAX;
+        }
+
+        /// returns whether both metric values are equal (or both undefined)
+        inline bool isEqual(double dVal1, double dVal2) {
+            return dVal1==dVal2 || (std::isnan(dVal1) && std::isnan(dVal2));
+        }
+
+        /// returns whether both binary classification metrics are identical
+        inline bool isEqual(const lv::BinClassifMetrics& oMetrics1, const lv::BinClassifMetrics& oMetrics2) {
+            return isEqual(oMetrics1.dRecall,oMetrics2.dRecall) && isEqual(oMetrics1.dSpecificity,oMetrics2.dSpecificity) &&
+                   isEqual(oMetrics1.dFPR,oMetrics2.dFPR) && isEqual(oMetrics1.dFNR,oMetrics2.dFNR) &&
+                   isEqual(oMetrics1.dPBC,oMetrics2.dPBC) && isEqual(oMetrics1.dPrecision,oMetrics2.dPrecision) &&
+                   isEqual(oMetrics1.dFMeasure,oMetrics2.dFMeasure) && isEqual(oMetrics1.dMCC,oMetrics2.dMCC);
+        }
+
+        /// returns the binary classification metrics held by a metrics calculator
+        inline lv::BinClassifMetrics getBinClassifMetrics(const lv::IIMetricsCalculatorPtr& pMetrics) {
+            auto pBinMetrics = std::dynamic_pointer_cast<lv::BinClassifMetricsCalculator>(pMetrics);
+            lvAssert_(pBinMetrics,"unexpected metrics calculator type");
+            return pBinMetrics->m_oMetrics;
+        }
+
+    } // namespace test
+
+} // namespace lv
@@ -0,0 +1,111 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks that the parallel video reader returns the same frames as a sequential decoder, and that it really decodes segments concurrently
+
+#include "litiv_test.hpp"
+#include "litiv/datasets/utils.hpp"
+
+namespace {
+
+    /// path of the video file written by this test (created in the working directory)
+    const std::string s_sVideoFilePath = "litiv_test_videoreader.avi";
+    /// number of frames in the test video (every frame is a keyframe with mjpeg, so segments all have the minimum size)
+    constexpr size_t s_nFrameCount = 512;
+    /// size of the test video frames (large enough for segment decoding to take longer than the workers' wake-up latency)
+    const cv::Size s_oFrameSize(640,480);
+
+    /// returns whether both frames have the same size, type and content
+    bool isEqual(const cv::Mat& oFrame1, const cv::Mat& oFrame2) {
+        return oFrame1.size()==oFrame2.size() && oFrame1.type()==oFrame2.type() && cv::norm(oFrame1,oFrame2,cv::NORM_INF)==0;
+    }
+
+    /// reads the given frame indices with a parallel reader, and checks them against the sequentially decoded frames
+    void testReader(const std::vector<cv::Mat>& voFrames, const std::vector<size_t>& vnKeyFrameIdxs, size_t nDecodeThreads, size_t nMaxBufferedFrames,
+                    size_t nExpectedDecodeThreads, const std::vector<size_t>& vnFrameIdxs) {
+        lv::ParallelVideoReader oReader(s_sVideoFilePath,voFrames.size(),vnKeyFrameIdxs,nDecodeThreads,nMaxBufferedFrames);
+        lvTestCheck_(oReader.getDecodeThreadCount()==nExpectedDecodeThreads,"%d thread(s), %d buffered frame(s): got %d",(int)nDecodeThreads,(int)nMaxBufferedFrames,(int)oReader.getDecodeThreadCount());
+        cv::Mat oFrame;
+        for(size_t nFrameIdx : vnFrameIdxs) {
+            const bool bRead = oReader.read(nFrameIdx,oFrame);
+            lvTestCheck_(bRead==(nFrameIdx<voFrames.size()),"frame #%d",(int)nFrameIdx);
+            if(bRead && nFrameIdx<voFrames.size())
+                lvTestCheck_(isEqual(oFrame,voFrames[nFrameIdx]),"frame #%d",(int)nFrameIdx);
+        }
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("videoreader",[]() {
+        {
+            cv::VideoWriter oWriter(s_sVideoFilePath,cv::VideoWriter::fourcc('M','J','P','G'),30,s_oFrameSize);
+            if(!oWriter.isOpened()) {
+                std::printf("[videoreader] skipped (no mjpeg video writer available)\n");
+                return;
+            }
+            cv::RNG oRNG(0);
+            cv::Mat oFrame(s_oFrameSize,CV_8UC3);
+            for(size_t nFrameIdx=0; nFrameIdx<s_nFrameCount; ++nFrameIdx) {
+                oRNG.fill(oFrame,cv::RNG::UNIFORM,cv::Scalar::all(0),cv::Scalar::all(256));
+                cv::putText(oFrame,std::to_string(nFrameIdx),cv::Point(20,200),cv::FONT_HERSHEY_SIMPLEX,4,cv::Scalar::all(255),8);
+                oWriter.write(oFrame);
+            }
+        }
+        std::vector<size_t> vnKeyFrameIdxs;
+        const size_t nFrameCount = lv::ParallelVideoReader::buildKeyFrameIndex(s_sVideoFilePath,vnKeyFrameIdxs);
+        if(nFrameCount==0) {
+            std::printf("[videoreader] skipped (keyframes cannot be demuxed with the current backend)\n");
+            std::remove(s_sVideoFilePath.c_str());
+            return;
+        }
+        lvTestCheck(nFrameCount==s_nFrameCount);
+        std::vector<cv::Mat> voFrames;
+        {
+            cv::VideoCapture oCapture(s_sVideoFilePath);
+            cv::Mat oFrame;
+            while(oCapture.read(oFrame))
+                voFrames.push_back(oFrame.clone());
+        }
+        lvTestCheck(voFrames.size()==nFrameCount);
+        std::vector<size_t> vnSequentialIdxs(nFrameCount+1);
+        std::iota(vnSequentialIdxs.begin(),vnSequentialIdxs.end(),size_t(0));
+        const std::vector<size_t> vnJumpIdxs = {0,1,2,300,301,100,101,511,512,64,0,450};
+        constexpr size_t nSegmentSize = 64; // matches the reader's minimum segment size
+        {
+            // with a window holding a whole segment per worker, all workers must take part while the consumer stalls
+            lv::ParallelVideoReader oReader(s_sVideoFilePath,nFrameCount,vnKeyFrameIdxs,4,4*nSegmentSize);
+            lvTestCheck(oReader.getSegmentCount()==nFrameCount/nSegmentSize);
+            lvTestCheck(oReader.getDecodeThreadCount()==4);
+            cv::Mat oFrame;
+            lvTestCheck(oReader.read(0,oFrame) && isEqual(oFrame,voFrames[0]));
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            lvTestCheck_(oReader.getActiveDecodeThreadCount()>1,"got %d active decode thread(s)",(int)oReader.getActiveDecodeThreadCount());
+            for(size_t nFrameIdx=1; nFrameIdx<nFrameCount; ++nFrameIdx)
+                lvTestCheck_(oReader.read(nFrameIdx,oFrame) && isEqual(oFrame,voFrames[nFrameIdx]),"frame #%d",(int)nFrameIdx);
+            lvTestCheck(!oReader.read(nFrameCount,oFrame));
+        }
+        // workers are bounded by the window size (in whole segments), by the segment count, and by the requested thread count
+        testReader(voFrames,vnKeyFrameIdxs,4,4*nSegmentSize,4,vnSequentialIdxs);
+        testReader(voFrames,vnKeyFrameIdxs,8,3*nSegmentSize+10,3,vnSequentialIdxs);
+        testReader(voFrames,vnKeyFrameIdxs,4,nSegmentSize/2,1,vnSequentialIdxs);
+        testReader(voFrames,vnKeyFrameIdxs,64,SIZE_MAX/2,nFrameCount/nSegmentSize,vnSequentialIdxs);
+        testReader(voFrames,vnKeyFrameIdxs,4,4*nSegmentSize,4,vnJumpIdxs);
+        testReader(voFrames,vnKeyFrameIdxs,4,nSegmentSize/2,1,vnJumpIdxs);
+        std::remove(s_sVideoFilePath.c_str());
+    });
+}
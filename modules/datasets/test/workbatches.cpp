@@ -0,0 +1,108 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks that work batches parsed in parallel keep the same order whatever the thread budget, and that parsing errors in several batches are all reported together
+
+#include "litiv_test.hpp"
+#include "testdataset.hpp"
+
+namespace {
+
+    /// directory (created in the working directory) used as the datasets root path by this test
+    const std::string s_sRootDirPath = "litiv_test_workbatches/";
+    /// number of sequences written in each category of the test dataset
+    constexpr size_t s_nSeqCount = 5;
+
+    /// appends the relative paths of all children of a work group (depth-first, in their stored order) to the given list
+    void appendBatchPaths(const lv::IDataHandler& oGroup, std::vector<std::string>& vsPaths) {
+        for(const lv::IDataHandlerPtr& pBatch : oGroup.getBatches(true)) {
+            vsPaths.push_back(pBatch->getRelativePath());
+            if(pBatch->isGroup())
+                appendBatchPaths(*pBatch,vsPaths);
+        }
+    }
+
+    /// creates a new instance of the test dataset under the given thread budget (0 = unlimited), and returns the relative paths of its work batches/groups
+    std::vector<std::string> getBatchPaths(const std::string& sOutputDirName, size_t nThreadBudget) {
+        lv::ThreadBudgetGuard oGuard(nThreadBudget);
+        std::vector<std::string> vsPaths;
+        appendBatchPaths(*lv::test::createTestDataset(sOutputDirName),vsPaths);
+        return vsPaths;
+    }
+
+    /// creates a new instance of the test dataset under the given thread budget (0 = unlimited), and returns the message of the exception it throws
+    std::string getParsingError(const std::string& sOutputDirName, size_t nThreadBudget) {
+        lv::ThreadBudgetGuard oGuard(nThreadBudget);
+        try {
+            lv::test::createTestDataset(sOutputDirName);
+        }
+        catch(const std::exception& e) {
+            return e.what();
+        }
+        return std::string();
+    }
+
+    /// returns whether the given string contains the given substring
+    bool contains(const std::string& sStr, const std::string& sSubStr) {
+        return sStr.find(sSubStr)!=std::string::npos;
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("workbatches",[]() {
+        {
+            // the same batches come out in the same order with a single parsing thread as with many, with or without a pre-filled index cache
+            lv::test::writeTestDataset(s_sRootDirPath,s_nSeqCount);
+            const std::vector<std::string> vsRefPaths = getBatchPaths("parallel",0);
+            lvTestCheck_(vsRefPaths.size()==size_t(6*(s_nSeqCount+1)),"%d batches/groups parsed",(int)vsRefPaths.size());
+            lvTestCheck(getBatchPaths("serial",1)==vsRefPaths);
+            for(size_t nRunIdx=0; nRunIdx<3; ++nRunIdx) {
+                lvTestCheck_(getBatchPaths("parallel",0)==vsRefPaths,"run %d",(int)nRunIdx);
+                lvTestCheck_(getBatchPaths("serial",1)==vsRefPaths,"run %d",(int)nRunIdx);
+                lvTestCheck_(getBatchPaths("budget2",2)==vsRefPaths,"run %d",(int)nRunIdx);
+            }
+        }
+        {
+            // a single broken sequence rethrows its own error as-is
+            lv::test::writeTestDataset(s_sRootDirPath);
+            lv::test::createDirs(s_sRootDirPath+"CDNet/dataset/shadow/broken0/");
+            const std::string sParallelError = getParsingError("single_parallel",0);
+            const std::string sSerialError = getParsingError("single_serial",1);
+            lvTestCheck_(contains(sParallelError,"'broken0' did not possess the required"),"error = '%s'",sParallelError.c_str());
+            lvTestCheck_(!contains(sParallelError,"failed to parse"),"error = '%s'",sParallelError.c_str());
+            lvTestCheck_(sSerialError==sParallelError,"error = '%s'",sSerialError.c_str());
+        }
+        {
+            // broken sequences in several categories are all reported (in batch order) in one error, whatever the thread budget
+            lv::test::writeTestDataset(s_sRootDirPath);
+            for(const std::string& sBrokenPath : {"baseline/broken1/","baseline/broken2/","shadow/broken3/"})
+                lv::test::createDirs(s_sRootDirPath+"CDNet/dataset/"+sBrokenPath);
+            const std::string sParallelError = getParsingError("multi_parallel",0);
+            const std::string sSerialError = getParsingError("multi_serial",1);
+            // (the root reports both broken categories, and 'baseline' itself reports both of its broken sequences)
+            const size_t nRootErrorPos = sParallelError.find("failed to parse 2 work batches"), nBaselinePos = sParallelError.find("\n\t'baseline': ");
+            const size_t nBaselineErrorPos = sParallelError.find("failed to parse 2 work batches",nBaselinePos);
+            const size_t nBroken1Pos = sParallelError.find("\n\t'broken1': "), nBroken2Pos = sParallelError.find("\n\t'broken2': ");
+            const size_t nShadowPos = sParallelError.find("\n\t'shadow': "), nBroken3Pos = sParallelError.find("'broken3' did not possess the required");
+            lvTestCheck_(nRootErrorPos<nBaselinePos && nBaselinePos<nBaselineErrorPos && nBaselineErrorPos<nBroken1Pos && nBroken1Pos<nBroken2Pos,"error = '%s'",sParallelError.c_str());
+            lvTestCheck_(nBroken2Pos<nShadowPos && nShadowPos<nBroken3Pos && nBroken3Pos!=std::string::npos,"error = '%s'",sParallelError.c_str());
+            lvTestCheck_(sSerialError==sParallelError,"error = '%s'",sSerialError.c_str());
+        }
+        lv::test::removeDirs(s_sRootDirPath);
+    });
+}
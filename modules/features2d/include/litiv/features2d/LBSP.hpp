@@ -22,102 +22,136 @@
 #include <opencv2/features2d.hpp>
 #include "litiv/utils/distances.hpp"
 
-/*!
-    Local Binary Similarity Pattern (LBSP) feature extractor
+/// list of LBSP sampling patterns available for compile-time specialization (see LBSPPattern_ and LBSP_)
+enum LBSPPatternList {
+    LBSPPattern_8bitsRing, ///< 3x3 ring around the central pixel (radius 1)
+    LBSPPattern_16bitsDbCross, ///< 5x5 double-cross pattern used by the original LBSP impl (radii 1 and 2)
+    LBSPPattern_24bitsDbRing, ///< 5x5 double ring pattern (every pixel of the patch except the center)
+    LBSPPattern_32bitsMultiRadius, ///< 7x7 multi-radius pattern (16-bit double-cross + 16 pixels at radius 3)
+};
 
-    Note 1: both grayscale and RGB/BGR images may be used with this extractor.
-    Note 2: using LBSP::compute2(...) is logically equivalent to using LBSP::compute(...) followed by LBSP::reshapeDesc(...).
+/// LBSP sampling pattern traits interface (offset tables are listed in bit order, and all describe (x,y) offsets w.r.t. the central pixel)
+template<LBSPPatternList ePattern>
+struct LBSPPattern_;
 
-    For more details on the different parameters, see G.-A. Bilodeau et al, "Change Detection in Feature Space Using Local
-    Binary Similarity Patterns", in CRV 2013.
- */
-class LBSP : public cv::Feature2D {
-public:
-    /// constructor 1, threshold = absolute intensity 'similarity' threshold used when computing comparisons
-    LBSP(size_t nThreshold);
-    /// constructor 2, threshold = relative intensity 'similarity' threshold used when computing comparisons
-    LBSP(float fRelThreshold, size_t nThresholdOffset=0);
-    /// default destructor
-    virtual ~LBSP();
-    /// loads extractor params from the specified file node @@@@ not impl
-    virtual void read(const cv::FileNode&);
-    /// writes extractor params to the specified file storage @@@@ not impl
-    virtual void write(cv::FileStorage&) const;
-    /// sets the 'reference' image to be used for inter-frame comparisons (note: if no image is set or if the image is empty, the algorithm will default back to intra-frame comparisons)
-    virtual void setReference(const cv::Mat&);
-    /// returns the current descriptor size, in bytes
-    virtual int descriptorSize() const;
-    /// returns the current descriptor data type
-    virtual int descriptorType() const;
-    /// returns whether this extractor is using a relative threshold or not
-    virtual bool isUsingRelThreshold() const;
-    /// returns the current relative threshold used for comparisons (-1 = invalid/not used)
-    virtual float getRelThreshold() const;
-    /// returns the current absolute threshold used for comparisons (-1 = invalid/not used)
-    virtual size_t getAbsThreshold() const;
+/// LBSP 8 bit ring pattern traits
+template<>
+struct LBSPPattern_<LBSPPattern_8bitsRing> {
+    //  O O O        6  3  5
+    //  O X O   =>   0  X  1
+    //  O O O        4  2  7
+    typedef uchar desc_t;
+    static constexpr size_t PATCH_SIZE = 3;
+    static constexpr size_t DESC_SIZE_BITS = 8;
+    static constexpr int s_anIdxLUT_x[8] = {-1, 1, 0, 0, -1, 1,-1, 1};
+    static constexpr int s_anIdxLUT_y[8] = { 0, 0,-1, 1, -1, 1, 1,-1};
+};
 
-    /// similar to DescriptorExtractor::compute(const cv::Mat& image, ...), but in this case, the descriptors matrix has the same shape as the input matrix
-    void compute2(const cv::Mat& oImage, std::vector<cv::KeyPoint>& voKeypoints, cv::Mat& oDescriptors) const;
-    /// batch version of LBSP::compute2(const cv::Mat& image, ...)
-    void compute2(const std::vector<cv::Mat>& voImageCollection, std::vector<std::vector<cv::KeyPoint> >& vvoPointCollection, std::vector<cv::Mat>& voDescCollection) const;
+/// LBSP 16 bit double-cross pattern traits (identical to the one used in the LBSP class)
+template<>
+struct LBSPPattern_<LBSPPattern_16bitsDbCross> {
+    //  O   O   O        4 ..  3 ..  6
+    //    O O O         .. 15  8 13 ..
+    //  O O X O O   =>   0  9  X 11  1
+    //    O O O         .. 12 10 14 ..
+    //  O   O   O        7 ..  2 ..  5
+    typedef ushort desc_t;
+    static constexpr size_t PATCH_SIZE = 5;
+    static constexpr size_t DESC_SIZE_BITS = 16;
+    static constexpr int s_anIdxLUT_x[16] = {-2, 2, 0, 0,  -2, 2, 2,-2,   0,-1, 0, 1,  -1, 1, 1,-1};
+    static constexpr int s_anIdxLUT_y[16] = { 0, 0,-2, 2,   2,-2, 2,-2,   1, 0,-1, 0,  -1, 1,-1, 1};
+};
 
-    /// utility function, used to reshape a descriptors matrix to its input image size via their keypoint locations
-    static void reshapeDesc(cv::Size oSize, const std::vector<cv::KeyPoint>& voKeypoints, const cv::Mat& oDescriptors, cv::Mat& oOutput);
-    /// utility function, used to illustrate the difference between two descriptor images
-    static void calcDescImgDiff(const cv::Mat& oDesc1, const cv::Mat& oDesc2, cv::Mat& oOutput, bool bForceMergeChannels=false);
-    /// utility function, used to filter out bad keypoints that would trigger out of bounds error because they're too close to the image border
-    static void validateKeyPoints(std::vector<cv::KeyPoint>& voKeypoints, cv::Size oImgSize);
-    /// utility function, used to filter out bad pixels in a ROI that would trigger out of bounds error because they're too close to the image border
-    static void validateROI(cv::Mat& oROI);
-#if HAVE_GLSL
-    /// utility function, returns the glsl source code required to describe an LBSP descriptor based on the image load store
-    static std::string getShaderFunctionSource(size_t nChannels, bool bUseSharedDataPreload, const glm::uvec2& vWorkGroupSize);
-#endif //HAVE_GLSL
+/// LBSP 24 bit double ring pattern traits
+template<>
+struct LBSPPattern_<LBSPPattern_24bitsDbRing> {
+    //  O O O O O       14 18 11 19 13
+    //  O O O O O       17  6  3  5 16
+    //  O O X O O   =>   8  0  X  1  9
+    //  O O O O O       22  4  2  7 23
+    //  O O O O O       12 20 10 21 15
+    typedef uint32_t desc_t;
+    static constexpr size_t PATCH_SIZE = 5;
+    static constexpr size_t DESC_SIZE_BITS = 24;
+    static constexpr int s_anIdxLUT_x[24] = {-1, 1, 0, 0, -1, 1,-1, 1,  -2, 2, 0, 0, -2, 2,-2, 2,   2,-2,-1, 1,-1, 1,-2, 2};
+    static constexpr int s_anIdxLUT_y[24] = { 0, 0,-1, 1, -1, 1, 1,-1,   0, 0,-2, 2, -2, 2, 2,-2,   1, 1, 2, 2,-2,-2,-1,-1};
+};
 
+/// LBSP 32 bit multi-radius pattern traits
+template<>
+struct LBSPPattern_<LBSPPattern_32bitsMultiRadius> {
+    //  O O   O   O O       23 26 .. 19 .. 27 21
+    //  O O   O   O O       25  4 ..  3 ..  6 24
+    //      O O O           .. .. 15  8 13 .. ..
+    //  O O O X O O O   =>  16  0  9  X 11  1 17
+    //      O O O           .. .. 12 10 14 .. ..
+    //  O O   O   O O       31  7 ..  2 ..  5 30
+    //  O O   O   O O       20 28 .. 18 .. 29 22
+    typedef uint32_t desc_t;
+    static constexpr size_t PATCH_SIZE = 7;
+    static constexpr size_t DESC_SIZE_BITS = 32;
+    static constexpr int s_anIdxLUT_x[32] = {-2, 2, 0, 0,  -2, 2, 2,-2,   0,-1, 0, 1,  -1, 1, 1,-1,  -3, 3, 0, 0,  -3, 3, 3,-3,   3,-3,-2, 2,  -2, 2, 3,-3};
+    static constexpr int s_anIdxLUT_y[32] = { 0, 0,-2, 2,   2,-2, 2,-2,   1, 0,-1, 0,  -1, 1,-1, 1,   0, 0,-3, 3,  -3, 3,-3, 3,   2, 2, 3, 3,  -3,-3,-2,-2};
+};
+
+/*!
+    Compile-time specialized LBSP descriptor utilities for a given sampling pattern
+
+    All lookup/threshold loops are fully unrolled based on the pattern's descriptor size, and thresholding uses
+    16-byte (SSE2/SSE4.1) or 32-byte (AVX2) chunks when available; the LBSP class below inherits the 16-bit
+    double-cross specialization, and LBSP-based subtractors pick theirs via IBackgroundSubtractorLBSP_::LBSPDesc.
+ */
+template<LBSPPatternList ePattern>
+struct LBSP_ {
+    /// pattern traits used for this specialization
+    typedef LBSPPattern_<ePattern> Pattern;
     /// utility, specifies the integer type used to store descriptors
-    typedef ushort desc_t;
+    typedef typename Pattern::desc_t desc_t;
     /// utility, specifies the pixel size of the pattern used (width and height)
-    static constexpr size_t PATCH_SIZE = 5;
-    /// utility, specifies the number of bytes per descriptor (should be the same as calling 'descriptorSize()')
-    static constexpr size_t DESC_SIZE = 2;
+    static constexpr size_t PATCH_SIZE = Pattern::PATCH_SIZE;
+    /// utility, specifies the number of bytes per descriptor
+    static constexpr size_t DESC_SIZE = sizeof(desc_t);
     /// utility, specifies the number of bits per descriptor
-    static constexpr size_t DESC_SIZE_BITS = DESC_SIZE*8;
-    /// utility, specifies the maximum gradient magnitude value that can be returned by computeDescriptor_gradient
-    static constexpr size_t MAX_GRAD_MAG = DESC_SIZE_BITS;
+    static constexpr size_t DESC_SIZE_BITS = Pattern::DESC_SIZE_BITS;
+    /// utility, specifies the opencv matrix depth to use when storing descriptors (32-bit descriptors are stored as CV_32S)
+    static constexpr int DESC_DEPTH = (DESC_SIZE==1)?CV_8U:(DESC_SIZE==2)?CV_16U:CV_32S;
+    static_assert(DESC_SIZE_BITS<=sizeof(desc_t)*8,"descriptor type is too small for pattern size");
+    static_assert(DESC_SIZE==1 || DESC_SIZE==2 || DESC_SIZE==4,"descriptor type must be storable in an opencv matrix");
+    static_assert((PATCH_SIZE%2)==1,"pattern patch size must be odd");
 
     /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (single-channel lookup, single-channel array thresholding)
     template<size_t nChannels>
     static inline void computeDescriptor(const cv::Mat& oInputImg, const uchar nRef, const int _x, const int _y, const size_t _c, const uchar nThreshold, desc_t& nDesc) {
-        alignas(16) std::array<uchar,LBSP::DESC_SIZE_BITS> anVals;
-        LBSP::computeDescriptor_lookup<nChannels>(oInputImg,_x,_y,_c,anVals);
-        nDesc = LBSP::computeDescriptor_threshold(anVals.data(),nRef,nThreshold);
+        alignas(32) std::array<uchar,DESC_SIZE_BITS> anVals;
+        computeDescriptor_lookup<nChannels>(oInputImg,_x,_y,_c,anVals);
+        nDesc = computeDescriptor_threshold(anVals.data(),nRef,nThreshold);
     }
 
     /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (multi-channel lookup, multi-channel array thresholding)
     template<size_t nChannels>
     static inline void computeDescriptor(const cv::Mat& oInputImg, const std::array<uchar,nChannels>& anRefs, const int _x, const int _y, const std::array<uchar,nChannels>& anThresholds, std::array<desc_t,nChannels>& anDesc) {
-        LBSP::computeDescriptor<nChannels>(oInputImg,anRefs.data(),_x,_y,anThresholds.data(),anDesc.data());
+        computeDescriptor<nChannels>(oInputImg,anRefs.data(),_x,_y,anThresholds.data(),anDesc.data());
     }
 
     /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (multi-channel lookup, multi-channel array thresholding)
     template<size_t nChannels>
     static inline void computeDescriptor(const cv::Mat& oInputImg, const uchar* const anRefs, const int _x, const int _y, const std::array<uchar,nChannels>& anThresholds, std::array<desc_t,nChannels>& anDesc) {
-        LBSP::computeDescriptor<nChannels>(oInputImg,anRefs,_x,_y,anThresholds.data(),anDesc.data());
+        computeDescriptor<nChannels>(oInputImg,anRefs,_x,_y,anThresholds.data(),anDesc.data());
     }
 
     /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (multi-channel lookup, multi-channel array thresholding)
     template<size_t nChannels>
     static inline void computeDescriptor(const cv::Mat& oInputImg, const uchar* const anRefs, const int _x, const int _y, const std::array<uchar,nChannels>& anThresholds, desc_t* anDesc) {
-        LBSP::computeDescriptor<nChannels>(oInputImg,anRefs,_x,_y,anThresholds.data(),anDesc);
+        computeDescriptor<nChannels>(oInputImg,anRefs,_x,_y,anThresholds.data(),anDesc);
     }
 
     /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (multi-channel lookup, multi-channel array thresholding)
     template<size_t nChannels>
     static inline void computeDescriptor(const cv::Mat& oInputImg, const uchar* const anRefs, const int _x, const int _y, const uchar* const anThresholds, desc_t* anDesc) {
-        alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,nChannels> aanVals;
-        LBSP::computeDescriptor_lookup<nChannels>(oInputImg,_x,_y,aanVals);
+        alignas(32) std::array<std::array<uchar,DESC_SIZE_BITS>,nChannels> aanVals;
+        computeDescriptor_lookup<nChannels>(oInputImg,_x,_y,aanVals);
         lv::unroll<nChannels>([&](int _c) {
-            anDesc[_c] = LBSP::computeDescriptor_threshold(aanVals[_c].data(),anRefs[_c],anThresholds[_c]);
+            anDesc[_c] = computeDescriptor_threshold(aanVals[_c].data(),anRefs[_c],anThresholds[_c]);
         });
     }
 
@@ -125,7 +159,7 @@ public:
     template<size_t nChannels>
     static inline void computeDescriptor_lookup(const cv::Mat& oInputImg, const int _x, const int _y, const size_t _c, std::array<uchar,DESC_SIZE_BITS>& anVals) {
         static_assert(sizeof(std::array<uchar,DESC_SIZE_BITS>)==sizeof(uchar)*DESC_SIZE_BITS,"terrible impl of std::array right here");
-        LBSP::computeDescriptor_lookup<nChannels>(oInputImg,_x,_y,_c,anVals.data());
+        computeDescriptor_lookup<nChannels>(oInputImg,_x,_y,_c,anVals.data());
     }
 
     /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (multi-channel lookup only)
@@ -133,7 +167,7 @@ public:
     static inline void computeDescriptor_lookup(const cv::Mat& oInputImg, const int _x, const int _y, std::array<std::array<uchar,DESC_SIZE_BITS>,nChannels>& aanVals) {
         static_assert(sizeof(std::array<std::array<uchar,DESC_SIZE_BITS>,nChannels>)==sizeof(uchar)*DESC_SIZE_BITS*nChannels,"terrible impl of std::array right here");
         lvDbgAssert_((void*)aanVals.data()==(void*)aanVals[0].data(),"bad indexing in array-of-array impl");
-        LBSP::computeDescriptor_lookup<nChannels>(oInputImg,_x,_y,aanVals[0].data());
+        computeDescriptor_lookup<nChannels>(oInputImg,_x,_y,aanVals[0].data());
     }
 
     /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (single-channel lookup only)
@@ -142,69 +176,156 @@ public:
         static_assert(nChannels>0,"need at least one image channel");
         lvDbgAssert_(anVals,"need to provide a valid pixel pointer");
         lvDbgAssert__(!oInputImg.empty() && oInputImg.type()==CV_8UC(nChannels) && _c<nChannels,"need to provide a non-empty matrix of %d channels, with _c<%d",(int)nChannels,(int)nChannels);
-        lvDbgAssert__(_x>=(int)LBSP::PATCH_SIZE/2 && _y>=(int)LBSP::PATCH_SIZE/2,"descriptor center needs to be at least %d pixels from image borders",(int)LBSP::PATCH_SIZE/2);
-        lvDbgAssert__(_x<oInputImg.cols-(int)LBSP::PATCH_SIZE/2 && _y<oInputImg.rows-(int)LBSP::PATCH_SIZE/2,"descriptor center needs to be at least %d pixels from image borders",(int)LBSP::PATCH_SIZE/2);
+        lvDbgAssert__(_x>=(int)PATCH_SIZE/2 && _y>=(int)PATCH_SIZE/2,"descriptor center needs to be at least %d pixels from image borders",(int)PATCH_SIZE/2);
+        lvDbgAssert__(_x<oInputImg.cols-(int)PATCH_SIZE/2 && _y<oInputImg.rows-(int)PATCH_SIZE/2,"descriptor center needs to be at least %d pixels from image borders",(int)PATCH_SIZE/2);
         const size_t nRowStep = oInputImg.step.p[0];
         const size_t nColStep = oInputImg.step.p[1];
-        const uchar* const anData = oInputImg.data+_y*nRowStep+_x*nColStep+_c;
-        LBSP::lookup_16bits_dbcross<nChannels>(anData,nRowStep,nColStep,anVals);
+        lookup(oInputImg.data+_y*nRowStep+_x*nColStep+_c,nRowStep,nColStep,anVals);
     }
 
-    /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (multi-channel lookup only)
+    /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (multi-channel lookup only, output is [nChannels][DESC_SIZE_BITS])
     template<size_t nChannels>
     static inline void computeDescriptor_lookup(const cv::Mat& oInputImg, const int _x, const int _y, uchar* aanVals) {
         static_assert(nChannels>0,"need at least one image channel");
         lvDbgAssert_(aanVals,"need to provide a valid pixel pointer");
         lvDbgAssert__(!oInputImg.empty() && oInputImg.type()==CV_8UC(nChannels),"need to provide a non-empty matrix of %d channels",(int)nChannels);
-        lvDbgAssert__(_x>=(int)LBSP::PATCH_SIZE/2 && _y>=(int)LBSP::PATCH_SIZE/2,"descriptor center needs to be at least %d pixels from image borders",(int)LBSP::PATCH_SIZE/2);
-        lvDbgAssert__(_x<oInputImg.cols-(int)LBSP::PATCH_SIZE/2 && _y<oInputImg.rows-(int)LBSP::PATCH_SIZE/2,"descriptor center needs to be at least %d pixels from image borders",(int)LBSP::PATCH_SIZE/2);
+        lvDbgAssert__(_x>=(int)PATCH_SIZE/2 && _y>=(int)PATCH_SIZE/2,"descriptor center needs to be at least %d pixels from image borders",(int)PATCH_SIZE/2);
+        lvDbgAssert__(_x<oInputImg.cols-(int)PATCH_SIZE/2 && _y<oInputImg.rows-(int)PATCH_SIZE/2,"descriptor center needs to be at least %d pixels from image borders",(int)PATCH_SIZE/2);
         const size_t nRowStep = oInputImg.step.p[0];
         const size_t nColStep = oInputImg.step.p[1];
         lv::unroll<nChannels>([&](int _c) {
-            const uchar* const anData = oInputImg.data+_y*nRowStep+_x*nColStep+_c;
-            LBSP::lookup_16bits_dbcross<nChannels>(anData,nRowStep,nColStep,aanVals+_c*LBSP::DESC_SIZE_BITS);
+            lookup(oInputImg.data+_y*nRowStep+_x*nColStep+_c,nRowStep,nColStep,aanVals+_c*DESC_SIZE_BITS);
         });
     }
 
     /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (array thresholding only)
-    static inline desc_t computeDescriptor_threshold(const std::array<uchar,LBSP::DESC_SIZE_BITS>& anVals, const uchar nRef, const uchar nThreshold) {
-        static_assert(sizeof(std::array<uchar,LBSP::DESC_SIZE_BITS>)==sizeof(uchar)*LBSP::DESC_SIZE_BITS,"terrible impl of std::array right here");
-        return LBSP::computeDescriptor_threshold(anVals.data(),nRef,nThreshold);
+    static inline desc_t computeDescriptor_threshold(const std::array<uchar,DESC_SIZE_BITS>& anVals, const uchar nRef, const uchar nThreshold) {
+        static_assert(sizeof(std::array<uchar,DESC_SIZE_BITS>)==sizeof(uchar)*DESC_SIZE_BITS,"terrible impl of std::array right here");
+        return computeDescriptor_threshold(anVals.data(),nRef,nThreshold);
     }
 
-    /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (array thresholding only)
+    /// utility function, shortcut/lightweight/direct single-point LBSP computation function for extra flexibility (array thresholding only, no alignment requirement)
     static inline desc_t computeDescriptor_threshold(const uchar* const anVals, const uchar nRef, const uchar nThreshold) {
-        // note: this function is used to threshold an LBSP pattern based on a predefined lookup array (see LBSP_16bits_dbcross_lookup for more information)
-        // @@@ todo: use array template to unroll loops & allow any descriptor size here
         lvDbgAssert_(anVals,"need to provide a valid pixel pointer");
-#if (!HAVE_SSE4_1 && !HAVE_SSE2)
-        desc_t nDesc = 0;
-        lv::unroll<LBSP::DESC_SIZE_BITS>([&](int n) {
-            nDesc |= (lv::L1dist(anVals[n],nRef) > nThreshold) << n;
+        uint32_t nDesc = 0;
+        size_t nOffset = 0;
+#if HAVE_AVX2
+        lv::unroll<DESC_SIZE_BITS/32>([&](int n) {
+            const __m256i _anDistVals = absdiff_32ub(_mm256_loadu_si256((__m256i*)(anVals+n*32)),_mm256_set1_epi8((char)nRef));
+            nDesc |= (uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_xor_si256(_anDistVals,_mm256_set1_epi8(char(0x80))),_mm256_set1_epi8(char(nThreshold^0x80))));
         });
-        return nDesc;
-#else //(HAVE_SSE4_1 || HAVE_SSE2)
-        static_assert(LBSP::DESC_SIZE_BITS==16,"current sse impl can only manage 16-byte chunks");
-        // @@@@ send <16byte back to non-sse, and >16 to loop via template enableif?
-        lvDbgAssert_(((uintptr_t)(&anVals[0])&15)==0,"pixel pointer must be 16-byte aligned");
-        __m128i _anInputVals = _mm_load_si128((__m128i*)&anVals[0]); // @@@@@ load? or just cast?
-        __m128i _anRefVals = _mm_set1_epi8(nRef);
+        nOffset = (DESC_SIZE_BITS/32)*32;
+#endif //HAVE_AVX2
+#if HAVE_SSE2
+        for(; nOffset+16<=DESC_SIZE_BITS; nOffset+=16)
+            nDesc |= (uint32_t)threshold_16ub(_mm_loadu_si128((__m128i*)(anVals+nOffset)),nRef,nThreshold)<<nOffset;
+        if(nOffset+8<=DESC_SIZE_BITS) {
+            nDesc |= (uint32_t)(threshold_16ub(_mm_loadl_epi64((__m128i*)(anVals+nOffset)),nRef,nThreshold)&0xFF)<<nOffset;
+            nOffset += 8;
+        }
+#endif //HAVE_SSE2
+        for(; nOffset<DESC_SIZE_BITS; ++nOffset)
+            nDesc |= uint32_t(lv::L1dist(anVals[nOffset],nRef)>nThreshold)<<nOffset;
+        return (desc_t)nDesc;
+    }
+
+    /// fetches all pattern values around the pixel pointed to by anData (strides are given in elements of Tv)
+    template<typename Tv>
+    static inline void lookup(const Tv* const anData, const size_t nRowStep, const size_t nColStep, Tv* const anVals) {
+        lv::unroll<DESC_SIZE_BITS>([&](int n) {
+            anVals[n] = anData[nRowStep*Pattern::s_anIdxLUT_y[n]+nColStep*Pattern::s_anIdxLUT_x[n]];
+        });
+    }
+
+protected:
+#if HAVE_SSE2
+    /// returns the 16-bit comparison mask of |anVals-nRef|>nThreshold for 16 packed unsigned bytes
+    static inline int threshold_16ub(const __m128i& _anInputVals, const uchar nRef, const uchar nThreshold) {
+        __m128i _anRefVals = _mm_set1_epi8((char)nRef);
 #if HAVE_SSE4_1
-        __m128i _anDistVals = _mm_sub_epi8(_mm_max_epu8(_anInputVals,_anRefVals),_mm_min_epu8(_anInputVals,_anRefVals));
-        __m128i _abCmpRes = _mm_cmpgt_epi8(_mm_xor_si128(_anDistVals,_mm_set1_epi8(uchar(0x80))),_mm_set1_epi8(uchar(nThreshold^0x80)));
+        const __m128i _anDistVals = _mm_sub_epi8(_mm_max_epu8(_anInputVals,_anRefVals),_mm_min_epu8(_anInputVals,_anRefVals));
 #else //HAVE_SSE2
-        __m128i _anBitFlipper = _mm_set1_epi8(uchar(0x80));
-        __m128i _anDistVals = _mm_xor_si128(_anInputVals,_anBitFlipper);
-        _anRefVals = _mm_xor_si128(_anRefVals,_anBitFlipper);
-        __m128i _abCmpRes = _mm_cmpgt_epi8(_anDistVals,_anRefVals);
-        __m128i _anDistVals1 = _mm_sub_epi8(_anDistVals,_anRefVals);
-        __m128i _anDistVals2 = _mm_sub_epi8(_anRefVals,_anDistVals);
-        _anDistVals = _mm_or_si128(_mm_and_si128(_abCmpRes,_anDistVals1),_mm_andnot_si128(_abCmpRes,_anDistVals2));
-        _abCmpRes = _mm_cmpgt_epi8(_mm_xor_si128(_anDistVals,_anBitFlipper),_mm_set1_epi8(uchar(nThreshold^0x80)));
+        const __m128i _anDistVals = _mm_or_si128(_mm_subs_epu8(_anInputVals,_anRefVals),_mm_subs_epu8(_anRefVals,_anInputVals));
+#endif //HAVE_SSE2
+        return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_xor_si128(_anDistVals,_mm_set1_epi8(char(0x80))),_mm_set1_epi8(char(nThreshold^0x80))));
+    }
 #endif //HAVE_SSE2
-        return (desc_t)_mm_movemask_epi8(_abCmpRes);
-#endif //(HAVE_SSE4_1 || HAVE_SSE2)
+#if HAVE_AVX2
+    /// returns the absolute difference of 32 packed unsigned bytes
+    static inline __m256i absdiff_32ub(const __m256i& _anVals1, const __m256i& _anVals2) {
+        return _mm256_sub_epi8(_mm256_max_epu8(_anVals1,_anVals2),_mm256_min_epu8(_anVals1,_anVals2));
     }
+#endif //HAVE_AVX2
+};
+
+/*!
+    Local Binary Similarity Pattern (LBSP) feature extractor
+
+    Note 1: both grayscale and RGB/BGR images may be used with this extractor.
+    Note 2: using LBSP::compute2(...) is logically equivalent to using LBSP::compute(...) followed by LBSP::reshapeDesc(...).
+    Note 3: the sampling pattern given at construction only affects the descriptors computed by this extractor (their
+    depth follows LBSP_<ePattern>::DESC_DEPTH); the static utilities inherited from LBSP_ always use the 16-bit double-cross pattern.
+
+    For more details on the different parameters, see G.-A. Bilodeau et al, "Change Detection in Feature Space Using Local
+    Binary Similarity Patterns", in CRV 2013.
+ */
+class LBSP : public cv::Feature2D, public LBSP_<LBSPPattern_16bitsDbCross> {
+public:
+    /// constructor 1, threshold = absolute intensity 'similarity' threshold used when computing comparisons
+    LBSP(size_t nThreshold, LBSPPatternList ePattern=LBSPPattern_16bitsDbCross);
+    /// constructor 2, threshold = relative intensity 'similarity' threshold used when computing comparisons
+    LBSP(float fRelThreshold, size_t nThresholdOffset=0, LBSPPatternList ePattern=LBSPPattern_16bitsDbCross);
+    /// default destructor
+    virtual ~LBSP();
+    /// loads extractor params from the specified file node @@@@ not impl
+    virtual void read(const cv::FileNode&);
+    /// writes extractor params to the specified file storage @@@@ not impl
+    virtual void write(cv::FileStorage&) const;
+    /// sets the 'reference' image to be used for inter-frame comparisons (note: if no image is set or if the image is empty, the algorithm will default back to intra-frame comparisons)
+    virtual void setReference(const cv::Mat&);
+    /// returns the current descriptor size, in bytes
+    virtual int descriptorSize() const;
+    /// returns the current descriptor data type (i.e. the opencv depth of the sampling pattern's descriptors)
+    virtual int descriptorType() const;
+    /// returns the sampling pattern used by this extractor
+    LBSPPatternList getPattern() const;
+    /// returns the pixel size of the sampling pattern used by this extractor (width and height)
+    size_t getPatchSize() const;
+    /// returns the pixel size of the given sampling pattern (width and height)
+    static size_t getPatchSize(LBSPPatternList ePattern);
+    /// returns whether this extractor is using a relative threshold or not
+    virtual bool isUsingRelThreshold() const;
+    /// returns the current relative threshold used for comparisons (-1 = invalid/not used)
+    virtual float getRelThreshold() const;
+    /// returns the current absolute threshold used for comparisons (-1 = invalid/not used)
+    virtual size_t getAbsThreshold() const;
+
+    /// similar to DescriptorExtractor::compute(const cv::Mat& image, ...), but in this case, the descriptors matrix has the same shape as the input matrix
+    void compute2(const cv::Mat& oImage, std::vector<cv::KeyPoint>& voKeypoints, cv::Mat& oDescriptors) const;
+    /// batch version of LBSP::compute2(const cv::Mat& image, ...); images are processed serially by default, or split across up to nThreads threads if requested (0 = hardware concurrency)
+    void compute2(const std::vector<cv::Mat>& voImageCollection, std::vector<std::vector<cv::KeyPoint> >& vvoPointCollection, std::vector<cv::Mat>& voDescCollection, size_t nThreads=1) const;
+    /// computes descriptors on a dense grid without keypoints; descriptor (i,j) is located at image pixel (getPatchSize()/2+j*nStride,getPatchSize()/2+i*nStride)
+    void computeDense(const cv::Mat& oImage, cv::Mat& oDescriptors, size_t nStride=1, size_t nThreads=1) const;
+    /// batch version of LBSP::computeDense(const cv::Mat& image, ...); output mats are (re)allocated up-front, and row blocks of all images are processed serially by default, or split across up to nThreads threads if requested (0 = hardware concurrency)
+    void computeDense(const std::vector<cv::Mat>& voImageCollection, std::vector<cv::Mat>& voDescCollection, size_t nStride=1, size_t nThreads=1) const;
+    /// returns the size of the descriptor grid that would be computed by LBSP::computeDense for a given image size, stride and sampling pattern
+    static cv::Size getDenseGridSize(cv::Size oImgSize, size_t nStride=1, LBSPPatternList ePattern=LBSPPattern_16bitsDbCross);
+
+    /// utility function, used to reshape a descriptors matrix to its input image size via their keypoint locations
+    static void reshapeDesc(cv::Size oSize, const std::vector<cv::KeyPoint>& voKeypoints, const cv::Mat& oDescriptors, cv::Mat& oOutput);
+    /// utility function, used to illustrate the difference between two descriptor images (distances are scaled by the bit count of the descriptor depth)
+    static void calcDescImgDiff(const cv::Mat& oDesc1, const cv::Mat& oDesc2, cv::Mat& oOutput, bool bForceMergeChannels=false);
+    /// utility function, used to filter out bad keypoints that would trigger out of bounds error because they're too close to the image border
+    static void validateKeyPoints(std::vector<cv::KeyPoint>& voKeypoints, cv::Size oImgSize, LBSPPatternList ePattern=LBSPPattern_16bitsDbCross);
+    /// utility function, used to filter out bad pixels in a ROI that would trigger out of bounds error because they're too close to the image border
+    static void validateROI(cv::Mat& oROI, LBSPPatternList ePattern=LBSPPattern_16bitsDbCross);
+#if HAVE_GLSL
+    /// utility function, returns the glsl source code required to describe an LBSP descriptor based on the image load store
+    static std::string getShaderFunctionSource(size_t nChannels, bool bUseSharedDataPreload, const glm::uvec2& vWorkGroupSize);
+#endif //HAVE_GLSL
+
+    /// utility, specifies the maximum gradient magnitude value that can be returned by computeDescriptor_gradient
+    static constexpr size_t MAX_GRAD_MAG = DESC_SIZE_BITS;
 
     /// utility function, shortcut/lightweight/direct single-point LBSP gradient computation function (mixes rel+abs, returns max-channel only)
     template<size_t nChannels, size_t nAbsOffset=20, size_t nRelShift=2, typename Tr1=int, typename Tr2=uint>
@@ -217,16 +338,16 @@ public:
     /// utility function, shortcut/lightweight/direct single-point LBSP gradient estimation function (mixes rel+abs, returns max-channel only)
     template<size_t nChannels, size_t nAbsOffset=20, size_t nRelShift=2, typename Tr1=char, typename Tr2=uchar>
     static inline void computeDescriptor_gradient(const uchar* const aanVals, const uchar* const anRefs, Tr1& nGradX, Tr1& nGradY, Tr2& nGradMag) {
-        // note: this function is used to threshold a multi-channel LBSP pattern based on a predefined lookup array (see LBSP_16bits_dbcross_lookup for more information)
-        // @@@ todo: use array template to unroll loops & allow any descriptor size here
-        static_assert(std::numeric_limits<Tr1>::max()>=4*LBSP::DESC_SIZE_BITS,"output size is too small for descriptor config");
+        // note: this function is used to threshold a multi-channel LBSP pattern based on a predefined lookup array (see LBSP_::computeDescriptor_lookup for more information)
+        static_assert(std::is_same<Pattern,LBSPPattern_<LBSPPattern_16bitsDbCross>>::value,"gradient sign masks below are only defined for the 16-bit double-cross pattern");
+        static_assert(std::numeric_limits<Tr1>::max()>=4*DESC_SIZE_BITS,"output size is too small for descriptor config");
         static_assert(nChannels>0,"need at least one image channel");
         lvDbgAssert_(aanVals,"need to provide a valid pixel pointer");
         lvDbgAssert_(anRefs,"need to provide a valid ref pixel pointer");
-        desc_t nTempDesc = computeDescriptor_threshold(aanVals+(nChannels-1)*LBSP::DESC_SIZE_BITS,anRefs[nChannels-1],((anRefs[nChannels-1]>>nRelShift)+nAbsOffset)/2);
+        desc_t nTempDesc = computeDescriptor_threshold(aanVals+(nChannels-1)*DESC_SIZE_BITS,anRefs[nChannels-1],((anRefs[nChannels-1]>>nRelShift)+nAbsOffset)/2);
         nGradMag = (Tr2)lv::popcount(nTempDesc);
         lv::unroll<nChannels-1>([&](int cn) {
-            desc_t nNewTempDesc = computeDescriptor_threshold(aanVals+cn*LBSP::DESC_SIZE_BITS,anRefs[cn],((anRefs[cn]>>nRelShift)+nAbsOffset)/2);
+            desc_t nNewTempDesc = computeDescriptor_threshold(aanVals+cn*DESC_SIZE_BITS,anRefs[cn],((anRefs[cn]>>nRelShift)+nAbsOffset)/2);
             const Tr2 nNewGradMag = (Tr2)lv::popcount(nNewTempDesc);
             if(nGradMag<nNewGradMag) {
                 nGradMag = nNewGradMag;
@@ -244,54 +365,12 @@ protected:
     const bool m_bOnlyUsingAbsThreshold;
     const float m_fRelThreshold;
     const size_t m_nThreshold;
+    const LBSPPatternList m_ePattern;
     cv::Mat m_oRefImage;
 
-    // arrays below do not rely on std::array to avoid multi-dim init problems w/ static constexpr in header files
-
-    /// LBSP 16 bit double-cross indiv RGB/RGBA pattern as used in the original article by G.-A. Bilodeau et al.
-    static constexpr int s_anIdxLUT_16bitdbcross[16][2] = {
-            //  O   O   O        4 ..  3 ..  6
-            //    O O O         .. 15  8 13 ..
-            //  O O X O O   =>   0  9  X 11  1
-            //    O O O         .. 12 10 14 ..
-            //  O   O   O        7 ..  2 ..  5
-            {-2, 0}, { 2, 0}, { 0,-2}, { 0, 2},
-            {-2, 2}, { 2,-2}, { 2, 2}, {-2,-2},
-            { 0, 1}, {-1, 0}, { 0,-1}, { 1, 0},
-            {-1,-1}, { 1, 1}, { 1,-1}, {-1, 1},
-    };//                                                   # { 0  1  2  3  4  5  6  7  8  9 10 11 12 13 14 15};
-    static constexpr int s_anIdxLUT_16bitdbcross_GradX[16] = { 1,-1, 0, 0, 1,-1,-1, 1, 0, 1, 0,-1, 1,-1,-1, 1};
-    static constexpr int s_anIdxLUT_16bitdbcross_GradY[16] = { 0, 0,-1, 1, 1,-1, 1,-1, 1, 0,-1, 0,-1, 1,-1, 1};
+    /// gradient sign masks for the 16-bit double-cross pattern (see LBSPPattern_<LBSPPattern_16bitsDbCross> for bit indices)
     static constexpr desc_t s_nDesc_16bitdbcross_GradX_Pos = ((1<<0)+(1<<4)+(1<<7)+(1<<9)+(1<<12)+(1<<15));
     static constexpr desc_t s_nDesc_16bitdbcross_GradX_Neg = ((1<<1)+(1<<5)+(1<<6)+(1<<11)+(1<<13)+(1<<14));
     static constexpr desc_t s_nDesc_16bitdbcross_GradY_Pos = ((1<<3)+(1<<4)+(1<<6)+(1<<8)+(1<<13)+(1<<15));
     static constexpr desc_t s_nDesc_16bitdbcross_GradY_Neg = ((1<<2)+(1<<5)+(1<<7)+(1<<10)+(1<<12)+(1<<14));
-#if HAVE_SSE2
-    static constexpr union IdxLUTOffsetArray {int anOffsets[16]; __m128i vnOffsets[4];}
-#else //(!HAVE_SSE2)
-    static constexpr union IdxLUTOffsetArray {int anOffsets[16];}
-#endif //(!HAVE_SSE2)
-            s_oIdxLUT_16bitdbcross_x = {{-2, 2, 0, 0,  -2, 2, 2,-2,   0,-1, 0, 1,  -1, 1, 1,-1}},
-            s_oIdxLUT_16bitdbcross_y = {{ 0, 0,-2, 2,   2,-2, 2,-2,   1, 0,-1, 0,  -1, 1,-1, 1}};
-
-    template<size_t nChannels, typename Tv>
-    static inline void lookup_16bits_dbcross(const Tv* const anData, const size_t nRowStep, const size_t nColStep, Tv* const anVals) {
-/*#if !HAVE_SSE2
-        // SSE2 version is not faster than fully optimized version
-        lvDbgAssert(nRowStep*2+nColStep*2<INT32_MAX); // map index offsets will be stored in signed 32-bit integers
-        const __m128i vnColStep = _mm_set1_epi32((int)nColStep);
-        const __m128i vnRowStep = _mm_set1_epi32((int)nRowStep);
-        lv::unroll<4>([&](int n) {
-            __m128i vnMapOffsets = _mm_add_epi32(lv::mult_32si(vnColStep,s_oIdxLUT_16bitdbcross_x.vnOffsets[n]),lv::mult_32si(vnRowStep,s_oIdxLUT_16bitdbcross_y.vnOffsets[n]));
-            anVals[n*4+3] = anData[lv::extract_32si<3>(vnMapOffsets)];
-            anVals[n*4+2] = anData[lv::extract_32si<2>(vnMapOffsets)];
-            anVals[n*4+1] = anData[lv::extract_32si<1>(vnMapOffsets)];
-            anVals[n*4+0] = anData[lv::extract_32si<0>(vnMapOffsets)];
-        });
-#else //(!HAVE_SSE2)*/
-        lv::unroll<16>([&](int n) {
-            anVals[n] = anData[nRowStep*s_oIdxLUT_16bitdbcross_y.anOffsets[n]+nColStep*s_oIdxLUT_16bitdbcross_x.anOffsets[n]];
-        });
-//#endif //(!HAVE_SSE2)
-    }
 };
@@ -18,24 +18,48 @@
 #include "litiv/features2d/LBSP.hpp"
 
 // make sure static constexpr array addresses exist
-constexpr int LBSP::s_anIdxLUT_16bitdbcross[16][2];
-constexpr int LBSP::s_anIdxLUT_16bitdbcross_GradX[16];
-constexpr int LBSP::s_anIdxLUT_16bitdbcross_GradY[16];
-constexpr LBSP::IdxLUTOffsetArray LBSP::s_oIdxLUT_16bitdbcross_x;
-constexpr LBSP::IdxLUTOffsetArray LBSP::s_oIdxLUT_16bitdbcross_y;
+constexpr int LBSPPattern_<LBSPPattern_8bitsRing>::s_anIdxLUT_x[8];
+constexpr int LBSPPattern_<LBSPPattern_8bitsRing>::s_anIdxLUT_y[8];
+constexpr int LBSPPattern_<LBSPPattern_16bitsDbCross>::s_anIdxLUT_x[16];
+constexpr int LBSPPattern_<LBSPPattern_16bitsDbCross>::s_anIdxLUT_y[16];
+constexpr int LBSPPattern_<LBSPPattern_24bitsDbRing>::s_anIdxLUT_x[24];
+constexpr int LBSPPattern_<LBSPPattern_24bitsDbRing>::s_anIdxLUT_y[24];
+constexpr int LBSPPattern_<LBSPPattern_32bitsMultiRadius>::s_anIdxLUT_x[32];
+constexpr int LBSPPattern_<LBSPPattern_32bitsMultiRadius>::s_anIdxLUT_y[32];
 
-LBSP::LBSP(size_t nThreshold) :
+namespace {
+
+/// calls lFunc with a (stateless) LBSP_ specialization instance matching the given runtime sampling pattern
+template<typename TFunc>
+void lbsp_dispatch(LBSPPatternList ePattern, TFunc&& lFunc) {
+    switch(ePattern) {
+        case LBSPPattern_8bitsRing: lFunc(LBSP_<LBSPPattern_8bitsRing>()); break;
+        case LBSPPattern_16bitsDbCross: lFunc(LBSP_<LBSPPattern_16bitsDbCross>()); break;
+        case LBSPPattern_24bitsDbRing: lFunc(LBSP_<LBSPPattern_24bitsDbRing>()); break;
+        case LBSPPattern_32bitsMultiRadius: lFunc(LBSP_<LBSPPattern_32bitsMultiRadius>()); break;
+        default: lvError("unknown LBSP sampling pattern");
+    }
+}
+
+} // namespace
+
+LBSP::LBSP(size_t nThreshold, LBSPPatternList ePattern) :
         m_bOnlyUsingAbsThreshold(true),
         m_fRelThreshold(0), // unused
         m_nThreshold(nThreshold),
-        m_oRefImage() {}
+        m_ePattern(ePattern),
+        m_oRefImage() {
+    lvAssert_(getPatchSize(m_ePattern)>0,"unknown LBSP sampling pattern");
+}
 
-LBSP::LBSP(float fRelThreshold, size_t nThresholdOffset) :
+LBSP::LBSP(float fRelThreshold, size_t nThresholdOffset, LBSPPatternList ePattern) :
         m_bOnlyUsingAbsThreshold(false),
         m_fRelThreshold(fRelThreshold),
         m_nThreshold(nThresholdOffset),
+        m_ePattern(ePattern),
         m_oRefImage() {
     lvAssert_(m_fRelThreshold>=0,"relative LBSP threshold must be non-negative");
+    lvAssert_(getPatchSize(m_ePattern)>0,"unknown LBSP sampling pattern");
 }
 
 LBSP::~LBSP() {}
@@ -54,11 +78,35 @@ void LBSP::setReference(const cv::Mat& img) {
 }
 
 int LBSP::descriptorSize() const {
-    return LBSP::DESC_SIZE;
+    int nDescSize = 0;
+    lbsp_dispatch(m_ePattern,[&](auto oLBSP) {
+        nDescSize = (int)decltype(oLBSP)::DESC_SIZE;
+    });
+    return nDescSize;
 }
 
 int LBSP::descriptorType() const {
-    return CV_16U;
+    int nDescDepth = -1;
+    lbsp_dispatch(m_ePattern,[&](auto oLBSP) {
+        nDescDepth = decltype(oLBSP)::DESC_DEPTH;
+    });
+    return nDescDepth;
+}
+
+LBSPPatternList LBSP::getPattern() const {
+    return m_ePattern;
+}
+
+size_t LBSP::getPatchSize() const {
+    return getPatchSize(m_ePattern);
+}
+
+size_t LBSP::getPatchSize(LBSPPatternList ePattern) {
+    size_t nPatchSize = 0;
+    lbsp_dispatch(ePattern,[&](auto oLBSP) {
+        nPatchSize = decltype(oLBSP)::PATCH_SIZE;
+    });
+    return nPatchSize;
 }
 
 bool LBSP::isUsingRelThreshold() const {
@@ -75,197 +123,241 @@ size_t LBSP::getAbsThreshold() const {
 
 namespace {
 
-void lbsp_computeImpl(const cv::Mat& oInputImg, const cv::Mat& oRefImg, const std::vector<cv::KeyPoint>& voKeyPoints, cv::Mat& oDesc, bool bSingleColumnDesc, size_t nThreshold) {
-    static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
-    lvAssert_(!oInputImg.empty() && oInputImg.isContinuous() && (oInputImg.type()==CV_8UC1 || oInputImg.type()==CV_8UC3),"input image must be non-empty, continuous, and of type 8UC1/8UC3");
-    lvAssert_(oRefImg.empty() || (oRefImg.size==oInputImg.size && oRefImg.type()==oInputImg.type()),"ref image must be empty, or of the same size/type as the input image");
-    const size_t nChannels = (size_t)oInputImg.channels();
+template<typename TLBSP, size_t nChannels>
+void lbsp_computeImpl(const cv::Mat& oInputImg, const cv::Mat& oRefImg, const std::vector<cv::KeyPoint>& voKeyPoints, cv::Mat& oDesc, bool bSingleColumnDesc, bool bOnlyUsingAbsThreshold, float fThreshold, size_t nThresholdOffset) {
+    typedef typename TLBSP::desc_t desc_t;
+    lvDbgAssert(oInputImg.type()==CV_8UC(nChannels));
     const cv::Mat& oRefMat = oRefImg.empty()?oInputImg:oRefImg;
     const size_t nKeyPoints = voKeyPoints.size();
-    const uchar t = cv::saturate_cast<uchar>(nThreshold);
-    if(nChannels==1) {
-        if(bSingleColumnDesc)
-            oDesc.create((int)nKeyPoints,1,CV_16UC1);
-        else
-            oDesc.create(oInputImg.size(),CV_16UC1);
-        for(size_t k=0; k<nKeyPoints; ++k) {
-            const int x = (int)voKeyPoints[k].pt.x;
-            const int y = (int)voKeyPoints[k].pt.y;
-            LBSP::computeDescriptor<1>(oInputImg,oRefMat.at<uchar>(y,x),x,y,0,t,oDesc.at<ushort>((int)k));
-        }
-        return;
-    }
-    else { //nChannels==3
-        if(bSingleColumnDesc)
-            oDesc.create((int)nKeyPoints,1,CV_16UC3);
-        else
-            oDesc.create(oInputImg.size(),CV_16UC3);
-        alignas(16) const std::array<uchar,3> anThreshold = {t,t,t};
-        for(size_t k=0; k<nKeyPoints; ++k) {
-            const int x = (int)voKeyPoints[k].pt.x;
-            const int y = (int)voKeyPoints[k].pt.y;
-            const uchar* acRef = oRefMat.data+oInputImg.step.p[0]*y+oInputImg.step.p[1]*x;
-            LBSP::computeDescriptor(oInputImg,acRef,x,y,anThreshold,((ushort*)(oDesc.data+oDesc.step.p[0]*k)));
-        }
+    if(bSingleColumnDesc)
+        oDesc.create((int)nKeyPoints,1,CV_MAKETYPE(TLBSP::DESC_DEPTH,(int)nChannels));
+    else
+        oDesc.create(oInputImg.size(),CV_MAKETYPE(TLBSP::DESC_DEPTH,(int)nChannels));
+    alignas(16) std::array<uchar,nChannels> anThresholds;
+    anThresholds.fill(cv::saturate_cast<uchar>(nThresholdOffset));
+    for(size_t k=0; k<nKeyPoints; ++k) {
+        const int x = (int)voKeyPoints[k].pt.x;
+        const int y = (int)voKeyPoints[k].pt.y;
+        const uchar* const acRef = oRefMat.data+oRefMat.step.p[0]*y+oRefMat.step.p[1]*x;
+        if(!bOnlyUsingAbsThreshold)
+            lv::unroll<nChannels>([&](int c) {
+                anThresholds[c] = cv::saturate_cast<uchar>(acRef[c]*fThreshold+nThresholdOffset);
+            });
+        desc_t* const anDesc = (desc_t*)(bSingleColumnDesc?oDesc.ptr((int)k):oDesc.ptr(y,x));
+        TLBSP::template computeDescriptor<nChannels>(oInputImg,acRef,x,y,anThresholds,anDesc);
     }
 }
 
-void lbsp_computeImpl(const cv::Mat& oInputImg, const cv::Mat& oRefImg, const std::vector<cv::KeyPoint>& voKeyPoints, cv::Mat& oDesc, bool bSingleColumnDesc, float fThreshold, size_t nThresholdOffset) {
-    static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
+void lbsp_computeImpl(LBSPPatternList ePattern, const cv::Mat& oInputImg, const cv::Mat& oRefImg, const std::vector<cv::KeyPoint>& voKeyPoints, cv::Mat& oDesc, bool bSingleColumnDesc, bool bOnlyUsingAbsThreshold, float fThreshold, size_t nThresholdOffset) {
+    // note: in absolute threshold mode, nThresholdOffset is the absolute threshold itself
     lvAssert_(!oInputImg.empty() && oInputImg.isContinuous() && (oInputImg.type()==CV_8UC1 || oInputImg.type()==CV_8UC3),"input image must be non-empty, continuous, and of type 8UC1/8UC3");
     lvAssert_(oRefImg.empty() || (oRefImg.size==oInputImg.size && oRefImg.type()==oInputImg.type()),"ref image must be empty, or of the same size/type as the input image");
     lvAssert_(fThreshold>=0,"lbsp internal relative threshold must be non-negative");
-    const size_t nChannels = (size_t)oInputImg.channels();
+    lbsp_dispatch(ePattern,[&](auto oLBSP) {
+        if(oInputImg.channels()==1)
+            lbsp_computeImpl<decltype(oLBSP),1>(oInputImg,oRefImg,voKeyPoints,oDesc,bSingleColumnDesc,bOnlyUsingAbsThreshold,fThreshold,nThresholdOffset);
+        else //nChannels==3
+            lbsp_computeImpl<decltype(oLBSP),3>(oInputImg,oRefImg,voKeyPoints,oDesc,bSingleColumnDesc,bOnlyUsingAbsThreshold,fThreshold,nThresholdOffset);
+    });
+}
+
+template<typename TLBSP, size_t nChannels>
+void lbsp_computeDenseImpl(const cv::Mat& oInputImg, const cv::Mat& oRefImg, cv::Mat& oDesc, size_t nStride, int nGridRowBegin, int nGridRowEnd, bool bOnlyUsingAbsThreshold, float fThreshold, size_t nThresholdOffset) {
+    // note: oDesc must already be allocated with the proper grid size (see LBSP::getDenseGridSize); only rows in [nGridRowBegin,nGridRowEnd) are filled
+    typedef typename TLBSP::desc_t desc_t;
+    lvDbgAssert(oInputImg.type()==CV_8UC(nChannels) && oDesc.type()==CV_MAKETYPE(TLBSP::DESC_DEPTH,(int)nChannels));
+    lvDbgAssert(nGridRowBegin>=0 && nGridRowEnd<=oDesc.rows);
     const cv::Mat& oRefMat = oRefImg.empty()?oInputImg:oRefImg;
-    const size_t nKeyPoints = voKeyPoints.size();
+    const int nBorderSize = (int)TLBSP::PATCH_SIZE/2;
+    const uchar nAbsThreshold = cv::saturate_cast<uchar>(nThresholdOffset);
+    alignas(16) std::array<uchar,nChannels> anThresholds;
+    anThresholds.fill(nAbsThreshold);
+    for(int nGridRowIdx=nGridRowBegin; nGridRowIdx<nGridRowEnd; ++nGridRowIdx) {
+        const int y = nBorderSize+nGridRowIdx*(int)nStride;
+        const uchar* const acRefRow = oRefMat.ptr<uchar>(y);
+        desc_t* const anDescRow = oDesc.ptr<desc_t>(nGridRowIdx);
+        for(int nGridColIdx=0; nGridColIdx<oDesc.cols; ++nGridColIdx) {
+            const int x = nBorderSize+nGridColIdx*(int)nStride;
+            const uchar* const acRef = acRefRow+x*nChannels;
+            if(!bOnlyUsingAbsThreshold)
+                lv::unroll<nChannels>([&](int c) {
+                    anThresholds[c] = cv::saturate_cast<uchar>(acRef[c]*fThreshold+nThresholdOffset);
+                });
+            TLBSP::template computeDescriptor<nChannels>(oInputImg,acRef,x,y,anThresholds,anDescRow+nGridColIdx*nChannels);
+        }
+    }
+}
+
+void lbsp_computeDenseImpl(LBSPPatternList ePattern, const cv::Mat& oInputImg, const cv::Mat& oRefImg, cv::Mat& oDesc, size_t nStride, int nGridRowBegin, int nGridRowEnd, bool bOnlyUsingAbsThreshold, float fThreshold, size_t nThresholdOffset) {
+    lbsp_dispatch(ePattern,[&](auto oLBSP) {
+        if(oInputImg.channels()==1)
+            lbsp_computeDenseImpl<decltype(oLBSP),1>(oInputImg,oRefImg,oDesc,nStride,nGridRowBegin,nGridRowEnd,bOnlyUsingAbsThreshold,fThreshold,nThresholdOffset);
+        else //nChannels==3
+            lbsp_computeDenseImpl<decltype(oLBSP),3>(oInputImg,oRefImg,oDesc,nStride,nGridRowBegin,nGridRowEnd,bOnlyUsingAbsThreshold,fThreshold,nThresholdOffset);
+    });
+}
+
+template<typename TDesc>
+void lbsp_calcDescImgDiff(const cv::Mat& oDesc1, const cv::Mat& oDesc2, cv::Mat& oOutput, bool bForceMergeChannels) {
+    static_assert(sizeof(TDesc)*8<=UCHAR_MAX,"bad assumptions in impl below");
+    const float fScaleFactor = (float)UCHAR_MAX/(sizeof(TDesc)*8);
+    const size_t nChannels = CV_MAT_CN(oDesc1.type());
+    const size_t _step_row = oDesc1.step.p[0];
     if(nChannels==1) {
-        if(bSingleColumnDesc)
-            oDesc.create((int)nKeyPoints,1,CV_16UC1);
-        else
-            oDesc.create(oInputImg.size(),CV_16UC1);
-        for(size_t k=0; k<nKeyPoints; ++k) {
-            const int x = (int)voKeyPoints[k].pt.x;
-            const int y = (int)voKeyPoints[k].pt.y;
-            const uchar nThreshold = cv::saturate_cast<uchar>(oRefMat.at<uchar>(y,x)*fThreshold+nThresholdOffset);
-            ushort& nResult = bSingleColumnDesc?oDesc.at<ushort>((int)k):oDesc.at<ushort>(y,x);
-            LBSP::computeDescriptor<1>(oInputImg,oRefMat.at<uchar>(y,x),x,y,0,nThreshold,nResult);
+        oOutput.create(oDesc1.size(),CV_8UC1);
+        oOutput = cv::Scalar(0);
+        for(int i=0; i<oDesc1.rows; ++i) {
+            const size_t idx = _step_row*i;
+            const TDesc* const desc1_ptr = (TDesc*)(oDesc1.data+idx);
+            const TDesc* const desc2_ptr = (TDesc*)(oDesc2.data+idx);
+            for(int j=0; j<oDesc1.cols; ++j)
+                oOutput.at<uchar>(i,j) = (uchar)(fScaleFactor*lv::hdist(desc1_ptr[j],desc2_ptr[j]));
         }
     }
     else { //nChannels==3
-        if(bSingleColumnDesc)
-            oDesc.create((int)nKeyPoints,1,CV_16UC3);
+        if(bForceMergeChannels)
+            oOutput.create(oDesc1.size(),CV_8UC1);
         else
-            oDesc.create(oInputImg.size(),CV_16UC3);
-        for(size_t k=0; k<nKeyPoints; ++k) {
-            const int x = (int)voKeyPoints[k].pt.x;
-            const int y = (int)voKeyPoints[k].pt.y;
-            const uchar* acRef = oRefMat.data+oInputImg.step.p[0]*y+oInputImg.step.p[1]*x;
-            alignas(16) const std::array<uchar,3> anThreshold = {cv::saturate_cast<uchar>(acRef[0]*fThreshold+nThresholdOffset),
-                                                                 cv::saturate_cast<uchar>(acRef[1]*fThreshold+nThresholdOffset),
-                                                                 cv::saturate_cast<uchar>(acRef[2]*fThreshold+nThresholdOffset)};
-            ushort* anResult = (ushort*)(bSingleColumnDesc?(oDesc.data+oDesc.step.p[0]*k):(oDesc.data+oDesc.step.p[0]*y+oDesc.step.p[1]*x));
-            LBSP::computeDescriptor(oInputImg,acRef,x,y,anThreshold,anResult);
+            oOutput.create(oDesc1.size(),CV_8UC3);
+        oOutput = cv::Scalar::all(0);
+        for(int i=0; i<oDesc1.rows; ++i) {
+            const size_t idx =  _step_row*i;
+            const TDesc* const desc1_ptr = (TDesc*)(oDesc1.data+idx);
+            const TDesc* const desc2_ptr = (TDesc*)(oDesc2.data+idx);
+            uchar* output_ptr = oOutput.data + oOutput.step.p[0]*i;
+            for(int j=0; j<oDesc1.cols; ++j) {
+                for(size_t n=0;n<3; ++n) {
+                    const size_t idx2 = 3*j+n;
+                    if(bForceMergeChannels)
+                        output_ptr[j] += (uchar)((fScaleFactor*lv::hdist(desc1_ptr[idx2],desc2_ptr[idx2]))/3);
+                    else
+                        output_ptr[idx2] = (uchar)(fScaleFactor*lv::hdist(desc1_ptr[idx2],desc2_ptr[idx2]));
+                }
+            }
         }
     }
 }
 
+/// number of descriptor grid rows processed by a single job in batched dense computations
+constexpr int s_nDenseGridRowsPerJob = 32;
+
 } // namespace
 
 void LBSP::compute2(const cv::Mat& oImage, std::vector<cv::KeyPoint>& voKeypoints, cv::Mat& oDescriptors) const {
     lvAssert_(!oImage.empty(),"input image must be non-empty");
-    cv::KeyPointsFilter::runByImageBorder(voKeypoints,oImage.size(),PATCH_SIZE/2);
+    cv::KeyPointsFilter::runByImageBorder(voKeypoints,oImage.size(),(int)getPatchSize()/2);
     cv::KeyPointsFilter::runByKeypointSize(voKeypoints,std::numeric_limits<float>::epsilon());
     if(voKeypoints.empty()) {
         oDescriptors.release();
         return;
     }
-    if(m_bOnlyUsingAbsThreshold)
-        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,oDescriptors,false,m_nThreshold);
-    else
-        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,oDescriptors,false,m_fRelThreshold,m_nThreshold);
+    lbsp_computeImpl(m_ePattern,oImage,m_oRefImage,voKeypoints,oDescriptors,false,m_bOnlyUsingAbsThreshold,m_fRelThreshold,m_nThreshold);
 }
 
-void LBSP::compute2(const std::vector<cv::Mat>& voImageCollection, std::vector<std::vector<cv::KeyPoint> >& vvoPointCollection, std::vector<cv::Mat>& voDescCollection) const {
+void LBSP::compute2(const std::vector<cv::Mat>& voImageCollection, std::vector<std::vector<cv::KeyPoint> >& vvoPointCollection, std::vector<cv::Mat>& voDescCollection, size_t nThreads) const {
     lvAssert_(voImageCollection.size()==vvoPointCollection.size(),"number of images must match number of keypoint lists");
     voDescCollection.resize(voImageCollection.size());
-    for(size_t i=0; i<voImageCollection.size(); i++)
-        compute2(voImageCollection[i], vvoPointCollection[i], voDescCollection[i]);
+    lv::parallel_for(voImageCollection.size(),nThreads,[&](size_t i) {
+        compute2(voImageCollection[i],vvoPointCollection[i],voDescCollection[i]);
+    });
+}
+
+cv::Size LBSP::getDenseGridSize(cv::Size oImgSize, size_t nStride, LBSPPatternList ePattern) {
+    lvAssert_(nStride>0,"dense grid stride must be positive");
+    const int nBorderSize = (int)getPatchSize(ePattern)/2;
+    if(oImgSize.width<=nBorderSize*2 || oImgSize.height<=nBorderSize*2)
+        return cv::Size();
+    return cv::Size((oImgSize.width-nBorderSize*2-1)/(int)nStride+1,(oImgSize.height-nBorderSize*2-1)/(int)nStride+1);
+}
+
+void LBSP::computeDense(const cv::Mat& oImage, cv::Mat& oDescriptors, size_t nStride, size_t nThreads) const {
+    lvAssert_(!oImage.empty() && (oImage.type()==CV_8UC1 || oImage.type()==CV_8UC3),"input image must be non-empty, and of type 8UC1/8UC3");
+    lvAssert_(m_oRefImage.empty() || (m_oRefImage.size==oImage.size && m_oRefImage.type()==oImage.type()),"ref image must be empty, or of the same size/type as the input image");
+    const cv::Size oGridSize = getDenseGridSize(oImage.size(),nStride,m_ePattern);
+    if(oGridSize.area()==0) {
+        oDescriptors.release();
+        return;
+    }
+    oDescriptors.create(oGridSize,CV_MAKETYPE(descriptorType(),oImage.channels()));
+    const int nJobs = (oGridSize.height+s_nDenseGridRowsPerJob-1)/s_nDenseGridRowsPerJob;
+    lv::parallel_for((size_t)nJobs,nThreads,[&](size_t nJobIdx) {
+        const int nGridRowBegin = (int)nJobIdx*s_nDenseGridRowsPerJob;
+        const int nGridRowEnd = std::min(nGridRowBegin+s_nDenseGridRowsPerJob,oGridSize.height);
+        lbsp_computeDenseImpl(m_ePattern,oImage,m_oRefImage,oDescriptors,nStride,nGridRowBegin,nGridRowEnd,m_bOnlyUsingAbsThreshold,m_fRelThreshold,m_nThreshold);
+    });
+}
+
+void LBSP::computeDense(const std::vector<cv::Mat>& voImageCollection, std::vector<cv::Mat>& voDescCollection, size_t nStride, size_t nThreads) const {
+    voDescCollection.resize(voImageCollection.size());
+    // all output buffers are allocated up-front (and reused if possible), so that workers only ever fill preallocated rows
+    std::vector<std::pair<size_t,int>> vJobs; // (image index, first grid row)
+    for(size_t i=0; i<voImageCollection.size(); ++i) {
+        const cv::Mat& oImage = voImageCollection[i];
+        lvAssert_(!oImage.empty() && (oImage.type()==CV_8UC1 || oImage.type()==CV_8UC3),"input images must be non-empty, and of type 8UC1/8UC3");
+        lvAssert_(m_oRefImage.empty() || (m_oRefImage.size==oImage.size && m_oRefImage.type()==oImage.type()),"ref image must be empty, or of the same size/type as all input images");
+        const cv::Size oGridSize = getDenseGridSize(oImage.size(),nStride,m_ePattern);
+        if(oGridSize.area()==0) {
+            voDescCollection[i].release();
+            continue;
+        }
+        voDescCollection[i].create(oGridSize,CV_MAKETYPE(descriptorType(),oImage.channels()));
+        for(int nGridRowBegin=0; nGridRowBegin<oGridSize.height; nGridRowBegin+=s_nDenseGridRowsPerJob)
+            vJobs.emplace_back(i,nGridRowBegin);
+    }
+    lv::parallel_for(vJobs.size(),nThreads,[&](size_t nJobIdx) {
+        const size_t i = vJobs[nJobIdx].first;
+        const int nGridRowBegin = vJobs[nJobIdx].second;
+        const int nGridRowEnd = std::min(nGridRowBegin+s_nDenseGridRowsPerJob,voDescCollection[i].rows);
+        lbsp_computeDenseImpl(m_ePattern,voImageCollection[i],m_oRefImage,voDescCollection[i],nStride,nGridRowBegin,nGridRowEnd,m_bOnlyUsingAbsThreshold,m_fRelThreshold,m_nThreshold);
+    });
 }
 
 void LBSP::computeImpl(const cv::Mat& oImage, std::vector<cv::KeyPoint>& voKeypoints, cv::Mat& oDescriptors) const {
     lvAssert_(!oImage.empty(),"input image must be non-empty");
-    cv::KeyPointsFilter::runByImageBorder(voKeypoints,oImage.size(),PATCH_SIZE/2);
+    cv::KeyPointsFilter::runByImageBorder(voKeypoints,oImage.size(),(int)getPatchSize()/2);
     cv::KeyPointsFilter::runByKeypointSize(voKeypoints,std::numeric_limits<float>::epsilon());
     if(voKeypoints.empty()) {
         oDescriptors.release();
         return;
     }
-    if(m_bOnlyUsingAbsThreshold)
-        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,oDescriptors,true,m_nThreshold);
-    else
-        lbsp_computeImpl(oImage,m_oRefImage,voKeypoints,oDescriptors,true,m_fRelThreshold,m_nThreshold);
+    lbsp_computeImpl(m_ePattern,oImage,m_oRefImage,voKeypoints,oDescriptors,true,m_bOnlyUsingAbsThreshold,m_fRelThreshold,m_nThreshold);
 }
 
 void LBSP::reshapeDesc(cv::Size oSize, const std::vector<cv::KeyPoint>& voKeypoints, const cv::Mat& oDescriptors, cv::Mat& oOutput) {
-    static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
     lvAssert_(!voKeypoints.empty(),"keypoint array must be non-empty");
     lvAssert_(!oDescriptors.empty() && oDescriptors.isContinuous() && oDescriptors.cols==1,"descriptor mat must be non-empty, continuous, and have only one column");
     lvAssert_(oSize.width>0 && oSize.height>0,"expected output desc image size must not contain null dimensions");
-    lvAssert_(oDescriptors.type()==CV_16UC1 || oDescriptors.type()==CV_16UC3,"descriptor mat type must be 16UC1/16UC3");
-    const size_t nChannels = (size_t)oDescriptors.channels();
+    lvAssert_((oDescriptors.depth()==CV_8U || oDescriptors.depth()==CV_16U || oDescriptors.depth()==CV_32S) && (oDescriptors.channels()==1 || oDescriptors.channels()==3),"descriptor mat type must be 8U/16U/32S, with 1 or 3 channels");
+    lvAssert_((size_t)oDescriptors.rows==voKeypoints.size(),"descriptor mat must have one row per keypoint");
+    const size_t nDescElemSize = oDescriptors.elemSize();
     const size_t nKeyPoints = voKeypoints.size();
-    if(nChannels==1) {
-        oOutput.create(oSize,CV_16UC1);
-        oOutput = cv::Scalar_<ushort>(0);
-        for(size_t k=0; k<nKeyPoints; ++k)
-            oOutput.at<ushort>(voKeypoints[k].pt) = oDescriptors.at<ushort>((int)k);
-    }
-    else { //nChannels==3
-        oOutput.create(oSize,CV_16UC3);
-        oOutput = cv::Scalar_<ushort>(0,0,0);
-        for(size_t k=0; k<nKeyPoints; ++k) {
-            ushort* output_ptr = (ushort*)(oOutput.data + oOutput.step.p[0]*(int)voKeypoints[k].pt.y);
-            const ushort* const desc_ptr = (ushort*)(oDescriptors.data + oDescriptors.step.p[0]*k);
-            const size_t idx = 3*(int)voKeypoints[k].pt.x;
-            for(size_t n=0; n<3; ++n)
-                output_ptr[idx+n] = desc_ptr[n];
-        }
-    }
+    oOutput.create(oSize,oDescriptors.type());
+    oOutput = cv::Scalar::all(0);
+    for(size_t k=0; k<nKeyPoints; ++k)
+        std::copy_n(oDescriptors.ptr((int)k),nDescElemSize,oOutput.ptr((int)voKeypoints[k].pt.y,(int)voKeypoints[k].pt.x));
 }
 
 void LBSP::calcDescImgDiff(const cv::Mat& oDesc1, const cv::Mat& oDesc2, cv::Mat& oOutput, bool bForceMergeChannels) {
-    static_assert(LBSP::DESC_SIZE_BITS<=UCHAR_MAX,"bad assumptions in impl below");
-    static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
-    lvAssert_(oDesc1.isContinuous() && (oDesc1.type()==CV_16UC1 || oDesc1.type()==CV_16UC3),"desc1 mat must be continuous, and of type 16UC1/16UC3");
-    lvAssert_(oDesc2.isContinuous() && (oDesc2.type()==CV_16UC1 || oDesc2.type()==CV_16UC3),"desc2 mat must be continuous, and of type 16UC1/16UC3");
+    lvAssert_(oDesc1.isContinuous() && (oDesc1.depth()==CV_8U || oDesc1.depth()==CV_16U || oDesc1.depth()==CV_32S) && (oDesc1.channels()==1 || oDesc1.channels()==3),"desc1 mat must be continuous, of depth 8U/16U/32S, and have 1 or 3 channels");
+    lvAssert_(oDesc2.isContinuous(),"desc2 mat must be continuous");
     lvAssert_(oDesc1.size()==oDesc2.size() && oDesc1.type()==oDesc2.type(),"size/type of descriptor mats must match");
     lvDbgAssert(oDesc1.step.p[0]==oDesc2.step.p[0] && oDesc1.step.p[1]==oDesc2.step.p[1]);
-    const float fScaleFactor = (float)UCHAR_MAX/(LBSP::DESC_SIZE_BITS);
-    const size_t nChannels = CV_MAT_CN(oDesc1.type());
-    const size_t _step_row = oDesc1.step.p[0];
-    if(nChannels==1) {
-        oOutput.create(oDesc1.size(),CV_8UC1);
-        oOutput = cv::Scalar(0);
-        for(int i=0; i<oDesc1.rows; ++i) {
-            const size_t idx = _step_row*i;
-            const ushort* const desc1_ptr = (ushort*)(oDesc1.data+idx);
-            const ushort* const desc2_ptr = (ushort*)(oDesc2.data+idx);
-            for(int j=0; j<oDesc1.cols; ++j)
-                oOutput.at<uchar>(i,j) = (uchar)(fScaleFactor*lv::hdist(desc1_ptr[j],desc2_ptr[j]));
-        }
-    }
-    else { //nChannels==3
-        if(bForceMergeChannels)
-            oOutput.create(oDesc1.size(),CV_8UC1);
-        else
-            oOutput.create(oDesc1.size(),CV_8UC3);
-        oOutput = cv::Scalar::all(0);
-        for(int i=0; i<oDesc1.rows; ++i) {
-            const size_t idx =  _step_row*i;
-            const ushort* const desc1_ptr = (ushort*)(oDesc1.data+idx);
-            const ushort* const desc2_ptr = (ushort*)(oDesc2.data+idx);
-            uchar* output_ptr = oOutput.data + oOutput.step.p[0]*i;
-            for(int j=0; j<oDesc1.cols; ++j) {
-                for(size_t n=0;n<3; ++n) {
-                    const size_t idx2 = 3*j+n;
-                    if(bForceMergeChannels)
-                        output_ptr[j] += (uchar)((fScaleFactor*lv::hdist(desc1_ptr[idx2],desc2_ptr[idx2]))/3);
-                    else
-                        output_ptr[idx2] = (uchar)(fScaleFactor*lv::hdist(desc1_ptr[idx2],desc2_ptr[idx2]));
-                }
-            }
-        }
-    }
+    if(oDesc1.depth()==CV_8U)
+        lbsp_calcDescImgDiff<uchar>(oDesc1,oDesc2,oOutput,bForceMergeChannels);
+    else if(oDesc1.depth()==CV_16U)
+        lbsp_calcDescImgDiff<ushort>(oDesc1,oDesc2,oOutput,bForceMergeChannels);
+    else //oDesc1.depth()==CV_32S
+        lbsp_calcDescImgDiff<uint32_t>(oDesc1,oDesc2,oOutput,bForceMergeChannels);
 }
 
-void LBSP::validateKeyPoints(std::vector<cv::KeyPoint>& voKeypoints, cv::Size oImgSize) {
-    cv::KeyPointsFilter::runByImageBorder(voKeypoints,oImgSize,PATCH_SIZE/2);
+void LBSP::validateKeyPoints(std::vector<cv::KeyPoint>& voKeypoints, cv::Size oImgSize, LBSPPatternList ePattern) {
+    cv::KeyPointsFilter::runByImageBorder(voKeypoints,oImgSize,(int)getPatchSize(ePattern)/2);
 }
 
-void LBSP::validateROI(cv::Mat& oROI) {
+void LBSP::validateROI(cv::Mat& oROI, LBSPPatternList ePattern) {
     lvAssert_(!oROI.empty() && oROI.type()==CV_8UC1,"input ROI must be non-empty and of type 8UC1");
     cv::Mat oROI_new(oROI.size(),CV_8UC1,cv::Scalar_<uchar>(0));
-    const size_t nBorderSize = PATCH_SIZE/2;
+    const size_t nBorderSize = getPatchSize(ePattern)/2;
     const cv::Rect nROI_inner(nBorderSize,nBorderSize,oROI.cols-nBorderSize*2,oROI.rows-nBorderSize*2);
     cv::Mat(oROI,nROI_inner).copyTo(cv::Mat(oROI_new,nROI_inner));
     oROI = oROI_new;
@@ -0,0 +1,219 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks the LBSP pattern utilities against scalar references, and the extractor's keypoint, batch & dense computations against single-point descriptors
+
+#include "litiv_test.hpp"
+#include "litiv/features2d/LBSP.hpp"
+
+namespace {
+
+    /// returns a random 8-bit image with the given number of channels
+    cv::Mat getRandomImage(cv::RNG& oRNG, const cv::Size& oSize, int nChannels) {
+        cv::Mat oImage(oSize,CV_8UC(nChannels));
+        oRNG.fill(oImage,cv::RNG::UNIFORM,0,256);
+        return oImage;
+    }
+
+    /// returns random keypoints over the whole image (including some too close to its borders, which the extractor must filter out)
+    std::vector<cv::KeyPoint> getRandomKeyPoints(cv::RNG& oRNG, const cv::Size& oSize, size_t nKeyPoints) {
+        std::vector<cv::KeyPoint> voKeyPoints;
+        for(size_t nKeyPointIdx=0; nKeyPointIdx<nKeyPoints; ++nKeyPointIdx)
+            voKeyPoints.emplace_back(cv::Point2f((float)oRNG.uniform(0,oSize.width),(float)oRNG.uniform(0,oSize.height)),1.0f);
+        return voKeyPoints;
+    }
+
+    /// plain scalar thresholding of a pattern's lookup values (reference for the SIMD impl of LBSP_::computeDescriptor_threshold)
+    template<LBSPPatternList ePattern>
+    typename LBSP_<ePattern>::desc_t getScalarThresholdDescriptor(const uchar* anVals, uchar nRef, uchar nThreshold) {
+        uint32_t nDesc = 0;
+        for(size_t nBitIdx=0; nBitIdx<LBSP_<ePattern>::DESC_SIZE_BITS; ++nBitIdx)
+            nDesc |= uint32_t(std::abs(int(anVals[nBitIdx])-int(nRef))>int(nThreshold))<<nBitIdx;
+        return (typename LBSP_<ePattern>::desc_t)nDesc;
+    }
+
+    /// checks a pattern's (possibly SIMD) thresholding for all reference/threshold pairs, and its single-point computation against a scalar offset table scan
+    template<LBSPPatternList ePattern>
+    void testPattern(cv::RNG& oRNG) {
+        typedef LBSP_<ePattern> LBSPDesc;
+        typedef typename LBSPDesc::desc_t desc_t;
+        constexpr size_t nBits = LBSPDesc::DESC_SIZE_BITS;
+        lvTestCheck_(LBSPDesc::DESC_DEPTH==(nBits<=8?CV_8U:nBits<=16?CV_16U:CV_32S),"%d bits",(int)nBits);
+        // lookup values are read from an unaligned buffer, and include values on both sides of each threshold boundary
+        std::array<uchar,nBits+1> anBuffer;
+        uchar* const anVals = anBuffer.data()+1;
+        size_t nMismatches = 0;
+        for(int nRef=0; nRef<=UCHAR_MAX; ++nRef) {
+            for(int nThreshold=0; nThreshold<=UCHAR_MAX; ++nThreshold) {
+                for(size_t nBitIdx=0; nBitIdx<nBits; ++nBitIdx) {
+                    const int nOffset = nThreshold+oRNG.uniform(-1,2);
+                    switch(oRNG.uniform(0,4)) {
+                        case 0: anVals[nBitIdx] = cv::saturate_cast<uchar>(nRef+nOffset); break;
+                        case 1: anVals[nBitIdx] = cv::saturate_cast<uchar>(nRef-nOffset); break;
+                        case 2: anVals[nBitIdx] = (uchar)(oRNG.uniform(0,2)*UCHAR_MAX); break;
+                        default: anVals[nBitIdx] = (uchar)oRNG.uniform(0,UCHAR_MAX+1); break;
+                    }
+                }
+                const desc_t nDesc = LBSPDesc::computeDescriptor_threshold(anVals,(uchar)nRef,(uchar)nThreshold);
+                nMismatches += size_t(nDesc!=getScalarThresholdDescriptor<ePattern>(anVals,(uchar)nRef,(uchar)nThreshold));
+            }
+        }
+        lvTestCheck_(nMismatches==0,"%d bits, %d threshold mismatches",(int)nBits,(int)nMismatches);
+        // single-point computations (lookup + threshold) must match a scalar scan of the pattern's offset tables
+        const cv::Mat oImage = getRandomImage(oRNG,cv::Size(31,23),3);
+        const int nBorderSize = (int)LBSPDesc::PATCH_SIZE/2;
+        nMismatches = 0;
+        for(int y=nBorderSize; y<oImage.rows-nBorderSize; ++y) {
+            for(int x=nBorderSize; x<oImage.cols-nBorderSize; ++x) {
+                for(size_t c=0; c<3; ++c) {
+                    std::array<uchar,nBits> anScanVals;
+                    for(size_t nBitIdx=0; nBitIdx<nBits; ++nBitIdx)
+                        anScanVals[nBitIdx] = oImage.at<cv::Vec3b>(y+LBSPDesc::Pattern::s_anIdxLUT_y[nBitIdx],x+LBSPDesc::Pattern::s_anIdxLUT_x[nBitIdx])[(int)c];
+                    const uchar nRef = oImage.at<cv::Vec3b>(y,x)[(int)c];
+                    const uchar nThreshold = (uchar)oRNG.uniform(0,64);
+                    desc_t nDesc;
+                    LBSPDesc::template computeDescriptor<3>(oImage,nRef,x,y,c,nThreshold,nDesc);
+                    nMismatches += size_t(nDesc!=getScalarThresholdDescriptor<ePattern>(anScanVals.data(),nRef,nThreshold));
+                }
+            }
+        }
+        lvTestCheck_(nMismatches==0,"%d bits, %d lookup mismatches",(int)nBits,(int)nMismatches);
+    }
+
+    /// computes a reference descriptor at (x,y) with the single-point utilities, using the same thresholds as the extractor
+    template<LBSPPatternList ePattern, size_t nChannels>
+    std::array<typename LBSP_<ePattern>::desc_t,nChannels> getRefDescriptor(const cv::Mat& oImage, const cv::Mat& oRefImage, int x, int y, bool bRelThreshold, float fRelThreshold, size_t nThreshold) {
+        const cv::Mat& oRefMat = oRefImage.empty()?oImage:oRefImage;
+        std::array<uchar,nChannels> anRefs, anThresholds;
+        std::array<typename LBSP_<ePattern>::desc_t,nChannels> anDesc;
+        for(size_t c=0; c<nChannels; ++c) {
+            anRefs[c] = oRefMat.ptr<uchar>(y)[x*(int)nChannels+(int)c];
+            anThresholds[c] = bRelThreshold?cv::saturate_cast<uchar>(anRefs[c]*fRelThreshold+nThreshold):cv::saturate_cast<uchar>(nThreshold);
+            LBSP_<ePattern>::template computeDescriptor<nChannels>(oImage,anRefs[c],x,y,c,anThresholds[c],anDesc[c]);
+        }
+        return anDesc;
+    }
+
+    /// returns whether the descriptor stored at the given location matches the reference one
+    template<typename TDesc, size_t nChannels>
+    bool isRefDescriptor(const cv::Mat& oDescriptors, int nRow, int nCol, const std::array<TDesc,nChannels>& anRefDesc) {
+        const TDesc* anDesc = oDescriptors.ptr<TDesc>(nRow)+nCol*(int)nChannels;
+        return std::equal(anRefDesc.begin(),anRefDesc.end(),anDesc);
+    }
+
+    /// checks an extractor's batch keypoint & dense computations on random images (with or without a reference image) against single-point descriptors
+    template<LBSPPatternList ePattern, size_t nChannels>
+    void testExtractor(cv::RNG& oRNG, LBSP& oExtractor, bool bRelThreshold, float fRelThreshold, size_t nThreshold, bool bUseRefImage) {
+        typedef typename LBSP_<ePattern>::desc_t desc_t;
+        const int nBorderSize = (int)LBSP_<ePattern>::PATCH_SIZE/2;
+        lvTestCheck(oExtractor.getPattern()==ePattern && oExtractor.getPatchSize()==LBSP_<ePattern>::PATCH_SIZE);
+        lvTestCheck(oExtractor.descriptorSize()==(int)sizeof(desc_t) && oExtractor.descriptorType()==LBSP_<ePattern>::DESC_DEPTH);
+        const cv::Size oSize(oRNG.uniform(1,80),oRNG.uniform(1,80));
+        const cv::Mat oRefImage = bUseRefImage?getRandomImage(oRNG,oSize,(int)nChannels):cv::Mat();
+        oExtractor.setReference(oRefImage);
+        std::vector<cv::Mat> voImages;
+        std::vector<std::vector<cv::KeyPoint>> vvoKeyPoints;
+        for(size_t nImageIdx=0; nImageIdx<5; ++nImageIdx) {
+            voImages.push_back(getRandomImage(oRNG,oSize,(int)nChannels));
+            vvoKeyPoints.push_back(getRandomKeyPoints(oRNG,oSize,200));
+        }
+        // batch keypoint computations must give the same results serially (default), with two threads & with all threads
+        for(size_t nThreads : {size_t(1),size_t(2),size_t(0)}) {
+            std::vector<std::vector<cv::KeyPoint>> vvoBatchKeyPoints = vvoKeyPoints;
+            std::vector<cv::Mat> voBatchDescs;
+            if(nThreads==1)
+                oExtractor.compute2(voImages,vvoBatchKeyPoints,voBatchDescs);
+            else
+                oExtractor.compute2(voImages,vvoBatchKeyPoints,voBatchDescs,nThreads);
+            lvTestCheck_(voBatchDescs.size()==voImages.size(),"%d thread(s)",(int)nThreads);
+            for(size_t nImageIdx=0; nImageIdx<std::min(voBatchDescs.size(),voImages.size()); ++nImageIdx) {
+                std::vector<cv::KeyPoint> voKeyPoints = vvoKeyPoints[nImageIdx];
+                cv::Mat oDescs;
+                oExtractor.compute2(voImages[nImageIdx],voKeyPoints,oDescs);
+                lvTestCheck_(voKeyPoints.size()==vvoBatchKeyPoints[nImageIdx].size(),"%d thread(s)",(int)nThreads);
+                lvTestCheck_(oDescs.empty()==voBatchDescs[nImageIdx].empty(),"%d thread(s)",(int)nThreads);
+                lvTestCheck_(oDescs.empty() || oDescs.type()==CV_MAKETYPE(LBSP_<ePattern>::DESC_DEPTH,(int)nChannels),"%d thread(s)",(int)nThreads);
+                size_t nMismatches = 0;
+                for(const cv::KeyPoint& oKeyPoint : vvoBatchKeyPoints[nImageIdx]) {
+                    const int x = (int)oKeyPoint.pt.x, y = (int)oKeyPoint.pt.y;
+                    if(x<nBorderSize || y<nBorderSize || x>=oSize.width-nBorderSize || y>=oSize.height-nBorderSize) {
+                        ++nMismatches; // border keypoints should have been filtered out
+                        continue;
+                    }
+                    const std::array<desc_t,nChannels> anRefDesc = getRefDescriptor<ePattern,nChannels>(voImages[nImageIdx],oRefImage,x,y,bRelThreshold,fRelThreshold,nThreshold);
+                    nMismatches += size_t(!isRefDescriptor(voBatchDescs[nImageIdx],y,x,anRefDesc));
+                    nMismatches += size_t(!isRefDescriptor(oDescs,y,x,anRefDesc));
+                }
+                lvTestCheck_(nMismatches==0,"%dx%d image, %d channel(s), %d thread(s)",oSize.width,oSize.height,(int)nChannels,(int)nThreads);
+            }
+        }
+        // dense computations must match the reference descriptors on the whole grid, serially or not, and one image at a time or batched
+        for(size_t nStride : {size_t(1),size_t(3)}) {
+            const cv::Size oGridSize = LBSP::getDenseGridSize(oSize,nStride,ePattern);
+            for(size_t nThreads : {size_t(1),size_t(0)}) {
+                std::vector<cv::Mat> voBatchDescs;
+                oExtractor.computeDense(voImages,voBatchDescs,nStride,nThreads);
+                lvTestCheck_(voBatchDescs.size()==voImages.size(),"stride %d, %d thread(s)",(int)nStride,(int)nThreads);
+                for(size_t nImageIdx=0; nImageIdx<std::min(voBatchDescs.size(),voImages.size()); ++nImageIdx) {
+                    cv::Mat oDescs;
+                    oExtractor.computeDense(voImages[nImageIdx],oDescs,nStride,nThreads);
+                    lvTestCheck_(oDescs.size()==oGridSize && voBatchDescs[nImageIdx].size()==oGridSize,"stride %d, %d thread(s)",(int)nStride,(int)nThreads);
+                    if(oGridSize.area()==0 || oDescs.size()!=oGridSize || voBatchDescs[nImageIdx].size()!=oGridSize)
+                        continue;
+                    lvTestCheck_(oDescs.type()==CV_MAKETYPE(LBSP_<ePattern>::DESC_DEPTH,(int)nChannels),"stride %d, %d thread(s)",(int)nStride,(int)nThreads);
+                    size_t nMismatches = 0;
+                    for(int nGridRowIdx=0; nGridRowIdx<oGridSize.height; ++nGridRowIdx) {
+                        for(int nGridColIdx=0; nGridColIdx<oGridSize.width; ++nGridColIdx) {
+                            const int x = nBorderSize+nGridColIdx*(int)nStride, y = nBorderSize+nGridRowIdx*(int)nStride;
+                            const std::array<desc_t,nChannels> anRefDesc = getRefDescriptor<ePattern,nChannels>(voImages[nImageIdx],oRefImage,x,y,bRelThreshold,fRelThreshold,nThreshold);
+                            nMismatches += size_t(!isRefDescriptor(oDescs,nGridRowIdx,nGridColIdx,anRefDesc));
+                            nMismatches += size_t(!isRefDescriptor(voBatchDescs[nImageIdx],nGridRowIdx,nGridColIdx,anRefDesc));
+                        }
+                    }
+                    lvTestCheck_(nMismatches==0,"%dx%d image, %d channel(s), stride %d, %d thread(s)",oSize.width,oSize.height,(int)nChannels,(int)nStride,(int)nThreads);
+                }
+            }
+        }
+    }
+
+    /// runs all pattern & extractor checks for a given sampling pattern
+    template<LBSPPatternList ePattern>
+    void testAll(cv::RNG& oRNG) {
+        testPattern<ePattern>(oRNG);
+        LBSP oAbsExtractor(size_t(30),ePattern);
+        LBSP oRelExtractor(0.35f,size_t(5),ePattern);
+        for(size_t nTestIdx=0; nTestIdx<10; ++nTestIdx) {
+            for(bool bUseRefImage : {false,true}) {
+                testExtractor<ePattern,1>(oRNG,oAbsExtractor,false,-1.0f,30,bUseRefImage);
+                testExtractor<ePattern,3>(oRNG,oAbsExtractor,false,-1.0f,30,bUseRefImage);
+                testExtractor<ePattern,1>(oRNG,oRelExtractor,true,0.35f,5,bUseRefImage);
+                testExtractor<ePattern,3>(oRNG,oRelExtractor,true,0.35f,5,bUseRefImage);
+            }
+        }
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("lbsp",[]() {
+        cv::RNG oRNG(42);
+        testAll<LBSPPattern_8bitsRing>(oRNG);
+        testAll<LBSPPattern_16bitsDbCross>(oRNG);
+        testAll<LBSPPattern_24bitsDbRing>(oRNG);
+        testAll<LBSPPattern_32bitsMultiRadius>(oRNG);
+    });
+}
@@ -76,17 +76,23 @@ void EdgeDetectorLBSP::apply_internal_lookup(const cv::Mat& oInputImg) {
             uchar* aanCurrLUT = m_vvuLBSPLookupMaps[nLevelIter].data()+nCurrColLUTIdx;
             const uchar* aanCurrImg = oCurrPyrInputMap.data+nCurrColLUTIdx/LBSP::DESC_SIZE_BITS;
             lvDbgAssert(nCurrColLUTIdx<m_vvuLBSPLookupMaps[nLevelIter].size() && (nCurrColLUTIdx%LBSP::DESC_SIZE_BITS)==0);
-#if HAVE_SSE2
+#if LV_SIMD_SSE4
             // no slower than fill_n if fill_n is implemented with SSE
+            static_assert(LBSP::DESC_SIZE_BITS==lv::SIMDVec_u8x16::s_nLanes,"all channels should already be 16-byte-aligned");
+            lv::unroll<nChannels>([&](size_t nChIter){
+                lv::SIMDVec_u8x16::set1(*(aanCurrImg+nChIter)).store(aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS);
+            });
+#elif HAVE_SSE2 //(!LV_SIMD_SSE4)
+            // SSE2-only builds still get a single aligned store per channel (lookup maps are 32-byte-aligned)
             static_assert(LBSP::DESC_SIZE_BITS==16,"all channels should already be 16-byte-aligned");
             lv::unroll<nChannels>([&](size_t nChIter){
-                lv::copy_16ub((__m128i*)(aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS),*(aanCurrImg+nChIter));
+                _mm_store_si128((__m128i*)(aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS),_mm_set1_epi8((char)*(aanCurrImg+nChIter)));
             });
-#else //(!HAVE_SSE2)
+#else //(!LV_SIMD_SSE4 && !HAVE_SSE2)
             lv::unroll<nChannels>([&](size_t nChIter){
                 std::fill_n(aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS,LBSP::DESC_SIZE_BITS,*(aanCurrImg+nChIter));
             });
-#endif //(!HAVE_SSE2)
+#endif //(!LV_SIMD_SSE4 && !HAVE_SSE2)
             if(nNextScaleMapSize && !(nRowIter%2) && !(nColIter%2)) {
                 const size_t nNextColLUTIdx = (nRowIter/2)*nNextRowLUTStep + (nColIter/2)*nColLUTStep;
                 for(size_t nChIter = 0; nChIter<nChannels; ++nChIter) {
@@ -117,17 +123,20 @@ void EdgeDetectorLBSP::apply_internal_lookup(const cv::Mat& oInputImg) {
                 if(nNextScaleMapSize && !(nRowIter%2) && !(nColIter%2)) {
                     const size_t nNextColLUTIdx = (nRowIter/2)*nNextRowLUTStep + (nColIter/2)*nColLUTStep;
                     for(size_t nChIter = 0; nChIter<nChannels; ++nChIter) {
-#if HAVE_SSE2
+#if LV_SIMD_SSE4
+                        static_assert(LBSP::DESC_SIZE_BITS==lv::SIMDVec_u8x16::s_nLanes,"all channels should already be 16-byte-aligned");
+                        const size_t nLUTSum = (size_t)lv::SIMDVec_u8x16::load(aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS).hsum();
+#elif HAVE_SSE2 //(!LV_SIMD_SSE4)
                         static_assert(LBSP::DESC_SIZE_BITS==16,"all channels should already be 16-byte-aligned");
-                        __m128i _anInputVals = _mm_load_si128((__m128i*)(aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS));
-                        size_t nLUTSum = (size_t)lv::hsum_16ub(_anInputVals);
-#else //(!HAVE_SSE2)
+                        const __m128i _anHalfSums = _mm_sad_epu8(_mm_load_si128((__m128i*)(aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS)),_mm_setzero_si128());
+                        const size_t nLUTSum = (size_t)_mm_cvtsi128_si32(_mm_add_epi32(_anHalfSums,_mm_srli_si128(_anHalfSums,8)));
+#else //(!LV_SIMD_SSE4 && !HAVE_SSE2)
                         uchar* anCurrChLUT = aanCurrLUT+nChIter*LBSP::DESC_SIZE_BITS;
                         size_t nLUTSum = 0;
                         lv::unroll<LBSP::DESC_SIZE_BITS>([&](size_t nLUTIter){
                             nLUTSum += anCurrChLUT[nLUTIter];
                         });
-#endif //(!HAVE_SSE2)
+#endif //(!LV_SIMD_SSE4 && !HAVE_SSE2)
                         const size_t nNextPyrImgIdx = nNextColLUTIdx/LBSP::DESC_SIZE_BITS + nChIter;
                         lvDbgAssert(nNextPyrImgIdx<size_t(oNextPyrInputMap.dataend-oNextPyrInputMap.datastart));
                         *(oNextPyrInputMap.data+nNextPyrImgIdx) = uchar(nLUTSum/LBSP::DESC_SIZE_BITS);
@@ -26,6 +26,7 @@
 #include <array>
 #include <queue>
 #include <deque>
+#include <list>
 #include <stack>
 #include <string>
 #include <vector>
@@ -282,6 +283,58 @@ namespace lv {
         return vfResult;
     }
 
+    /// returns whether the calling thread already runs inside a parallel region (i.e. a 'parallel_for' worker, or a thread holding a 'ParallelRegionGuard')
+    bool isInParallelRegion();
+
+    /// returns the maximum number of threads 'parallel_for' may use from the calling thread (0 = unbounded)
+    size_t getThreadBudget();
+
+    /// bounds the number of threads 'parallel_for' may use from the calling thread for the guard's lifetime (nested guards can only lower it)
+    struct ThreadBudgetGuard {
+        ThreadBudgetGuard(size_t nMaxThreads);
+        ~ThreadBudgetGuard();
+    private:
+        const size_t m_nPrevThreadBudget;
+        ThreadBudgetGuard(const ThreadBudgetGuard&) = delete;
+        ThreadBudgetGuard& operator=(const ThreadBudgetGuard&) = delete;
+    };
+
+    /// bounds the number of threads 'parallel_for' may use from the calling thread by a budget that other threads may update (e.g. a scheduler rebalancing its workers) for the guard's lifetime
+    struct SharedThreadBudgetGuard {
+        SharedThreadBudgetGuard(const std::atomic_size_t& nMaxThreads);
+        ~SharedThreadBudgetGuard();
+    private:
+        const std::atomic_size_t* const m_pPrevSharedThreadBudget;
+        SharedThreadBudgetGuard(const SharedThreadBudgetGuard&) = delete;
+        SharedThreadBudgetGuard& operator=(const SharedThreadBudgetGuard&) = delete;
+    };
+
+    /// flags the calling thread as part of a parallel region for the guard's lifetime, so that nested 'parallel_for' calls run serially
+    struct ParallelRegionGuard : ThreadBudgetGuard {
+        ParallelRegionGuard() : ThreadBudgetGuard(1) {}
+    };
+
+    /// dispatches 'nJobs' jobs to the caller's thread + up to 'nThreads-1' workers of the persistent pool shared by all 'parallel_for' calls
+    void parallel_for_pooled(size_t nJobs, size_t nThreads, const std::function<void(size_t)>& lJob);
+
+    template<typename Tfunc>
+    inline void parallel_for(size_t nJobs, size_t nMaxThreads, const Tfunc& lJob) {
+        // calls lJob(nJobIdx) for all indices in [0,nJobs) using up to nMaxThreads threads (0 = use hardware concurrency)
+        // note: jobs are fetched dynamically by the pool workers (and by the caller's thread), and the first exception thrown is rethrown here
+        // note: calls nested inside a parallel region run serially on the calling thread, so that nested loops never oversubscribe the cpu
+        // note: the calling thread's budget (see 'ThreadBudgetGuard') further bounds the number of threads used
+        if(nMaxThreads==0)
+            nMaxThreads = std::max(std::thread::hardware_concurrency(),1u);
+        const size_t nThreadBudget = getThreadBudget();
+        const size_t nThreads = std::min(std::min(nMaxThreads,nJobs),nThreadBudget?nThreadBudget:SIZE_MAX);
+        if(nThreads<=1) {
+            for(size_t nJobIdx=0; nJobIdx<nJobs; ++nJobIdx)
+                lJob(nJobIdx);
+            return;
+        }
+        parallel_for_pooled(nJobs,nThreads,std::function<void(size_t)>(std::cref(lJob)));
+    }
+
     template<size_t nWorkers>
     struct WorkerPool {
         static_assert(nWorkers>0,"Worker pool must have at least one work thread");
@@ -498,10 +498,10 @@ namespace lv {
     template<size_t nChannels, typename T>
     inline size_t hdist(const T* const a, const T* const b) {
         static_assert(nChannels>0,"vectors should have at least one channel");
-        T xor_array[nChannels];
+        size_t nResult = 0;
         for(size_t c=0; c<nChannels; ++c)
-            xor_array[c] = a[c]^b[c];
-        return popcount<nChannels>(xor_array);
+            nResult += popcount<T>(T(a[c]^b[c]));
+        return nResult;
     }
 
     /// computes the hamming distance between two (nChannels*N)-byte vectors
@@ -546,6 +546,42 @@ namespace lv {
         return gdist<nChannels>(a,b.data());
     }
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////
+
+    /// computes the hamming distance between two byte arrays of arbitrary length (uses the widest popcount instructions available)
+    size_t hdist(const uchar* const a, const uchar* const b, size_t nBytes);
+
+    /// computes the hamming distances between a query descriptor and N contiguous sample descriptors of nDescBytes bytes each
+    void hdist_batch(const uchar* const aQuery, const uchar* const aSamples, size_t nDescBytes, size_t nSamples, size_t* anDists);
+
+    /// computes the hamming distances between M contiguous query descriptors and N contiguous sample descriptors (output is a row-major MxN matrix)
+    void hdist_batch(const uchar* const aQueries, size_t nQueries, const uchar* const aSamples, size_t nDescBytes, size_t nSamples, size_t* anDists);
+
+    /// returns how many of the N contiguous sample descriptors are within nMaxDist (inclusive) of the query in hamming space (stops early once nMaxCount is reached)
+    size_t hdist_count(const uchar* const aQuery, const uchar* const aSamples, size_t nDescBytes, size_t nSamples, size_t nMaxDist, size_t nMaxCount=SIZE_MAX);
+
+    /// computes the L1 distances between a query vector and N contiguous sample vectors of nChannels bytes each
+    void L1dist_batch(const uchar* const aQuery, const uchar* const aSamples, size_t nChannels, size_t nSamples, size_t* anDists);
+
+    /// returns how many of the N contiguous sample vectors are within nMaxDist (inclusive) of the query in L1 space (stops early once nMaxCount is reached)
+    size_t L1dist_count(const uchar* const aQuery, const uchar* const aSamples, size_t nChannels, size_t nSamples, size_t nMaxDist, size_t nMaxCount=SIZE_MAX);
+
+    /// computes the hamming distances between a query descriptor and N contiguous sample descriptors of nChannels integer values each
+    template<size_t nChannels, typename T>
+    inline void hdist_batch(const T* const aQuery, const T* const aSamples, size_t nSamples, size_t* anDists) {
+        static_assert(std::is_integral<T>::value,"type must be integral");
+        static_assert(nChannels>0,"vectors should have at least one channel");
+        hdist_batch((const uchar*)aQuery,(const uchar*)aSamples,sizeof(T)*nChannels,nSamples,anDists);
+    }
+
+    /// returns how many of the N contiguous sample descriptors of nChannels integer values each are within nMaxDist (inclusive) of the query in hamming space
+    template<size_t nChannels, typename T>
+    inline size_t hdist_count(const T* const aQuery, const T* const aSamples, size_t nSamples, size_t nMaxDist, size_t nMaxCount=SIZE_MAX) {
+        static_assert(std::is_integral<T>::value,"type must be integral");
+        static_assert(nChannels>0,"vectors should have at least one channel");
+        return hdist_count((const uchar*)aQuery,(const uchar*)aSamples,sizeof(T)*nChannels,nSamples,nMaxDist,nMaxCount);
+    }
+
 #if HAVE_GLSL
 
     inline std::string getShaderFunctionSource_absdiff(bool bUseBuiltinDistance) {
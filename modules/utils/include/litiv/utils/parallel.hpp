@@ -19,6 +19,7 @@
 
 #include "litiv/utils/opencv.hpp"
 #include "litiv/utils/platform.hpp"
+#include "litiv/utils/simd.hpp"
 #include <type_traits>
 
 #if HAVE_GLSL
@@ -108,56 +109,29 @@ namespace lv {
     };
     using NonParallelAlgo = IParallelAlgo_<NonParallel>;
 
-#if HAVE_MMX
-    /// returns the (horizontal) sum of the provided 8-unsigned-byte array
-    inline uint hsum_8ub(const __m64& anBuffer) {
-        __m64 _anRes = _mm_sad_pu8(anBuffer,_mm_set1_pi8(char(0)));
-        return uint(_mm_cvtsi64_si32(_anRes));
-    }
-#endif //HAVE_MMX
-
-#if HAVE_SSE2
-    /// returns the (horizontal) sum of the provided 16-unsigned-byte array
-    inline uint hsum_16ub(const __m128i& anBuffer) {
-        __m128i _anRes = _mm_sad_epu8(anBuffer,_mm_set1_epi8(char(0)));
-        return uint(_mm_cvtsi128_si32(_mm_add_epi64(_mm_srli_si128(_anRes,8),_anRes)));
-    }
-
-    /// fills the provided 16-byte array with a constant
-    inline void copy_16ub(__m128i* anBuffer, uchar nVal) {
-        _mm_store_si128(anBuffer,_mm_set1_epi8((char)nVal));
-    }
+    /// instruction set levels used for runtime kernel dispatch (each level implies all the previous ones)
+    enum ISALevelList {
+        ISALevel_Generic, ///< baseline instruction set (i.e. whatever the build itself targets)
+        ISALevel_SSE4, ///< SSSE3 + SSE4.1 + POPCNT
+        ISALevel_AVX2, ///< AVX2 (+ all of the above)
+        ISALevel_AVX512, ///< AVX-512 F/BW + VPOPCNTDQ (+ all of the above)
+        ISALevelCount
+    };
 
-    inline __m128i mult_32si(const __m128i& a, const __m128i& b) {
-#if HAVE_SSE4_1
-        return _mm_mullo_epi32(a, b);
-#else //(!HAVE_SSE4_1)
-        return _mm_unpacklo_epi32(_mm_shuffle_epi32(_mm_mul_epu32(a,b),_MM_SHUFFLE(0,0,2,0)),_mm_shuffle_epi32(_mm_mul_epu32(_mm_srli_si128(a,4),_mm_srli_si128(b,4)),_MM_SHUFFLE(0,0,2,0)));
-#endif //(!HAVE_SSE4_1)
-    }
+    /// returns the highest instruction set level supported by the current CPU & OS (detected once; can be capped via the 'LITIV_MAX_ISA_LEVEL' env variable)
+    ISALevelList getISALevel();
 
-    template<int nPos>
-    inline int extract_32si(const __m128i& anBuffer) {
-        static_assert(nPos>=0 && nPos<4,"Integer position out of bounds");
-#if HAVE_SSE4_1
-        return _mm_extract_epi32(anBuffer,nPos);
-#else //(!HAVE_SSE4_1)
-        return _mm_extract_epi16(anBuffer,nPos*2)+_mm_extract_epi16(anBuffer,nPos*2+1)<<16;
-#endif //(!HAVE_SSE4_1)
-    }
-#endif //HAVE_SSE2
-
-#if HAVE_SSE4_1
-    /// returns the maximum value of the provided 16-unsigned-byte array
-    inline uchar hmax_16ub(const __m128i& anBuffer) {
-        __m128i _anTmp = _mm_sub_epi8(_mm_set1_epi8(char(CHAR_MAX)),anBuffer);
-        return uchar(char(CHAR_MAX)-_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_min_epu8(_anTmp,_mm_srli_epi16(_anTmp,8)))));
-    }
+    /// returns the printable name of the given instruction set level
+    const char* getISALevelName(ISALevelList eLevel);
 
-    /// returns the minimum value of the provided 16-unsigned-byte array
-    inline uchar hmin_16ub(const __m128i& anBuffer) {
-        return uchar(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_min_epu8(anBuffer,_mm_srli_epi16(anBuffer,8)))));
+    /// returns the best kernel of a table indexed by instruction set level for the current CPU (null entries are skipped; the generic one is mandatory)
+    template<typename TKernel>
+    inline const TKernel& selectKernel(const std::array<const TKernel*,ISALevelCount>& apKernels) {
+        for(int nLevel=(int)getISALevel(); nLevel>(int)ISALevel_Generic; --nLevel)
+            if(apKernels[nLevel])
+                return *apKernels[nLevel];
+        lvAssert_(apKernels[ISALevel_Generic],"kernel table must at least provide a generic implementation");
+        return *apKernels[ISALevel_Generic];
     }
-#endif //HAVE_SSE4_1
 
 } // namespace lv
@@ -25,6 +25,8 @@
 #include <stdint.h>
 #include <direct.h>
 #include <psapi.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 template<class T>
 void SafeRelease(T **ppT) {if(*ppT) {(*ppT)->Release();*ppT = nullptr;}}
 #if !USE_KINECTSDK_STANDALONE
@@ -36,6 +38,8 @@ void SafeRelease(T **ppT) {if(*ppT) {(*ppT)->Release();*ppT = nullptr;}}
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/resource.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <stdio.h>
 #endif //(!defined(_MSC_VER))
 #include "litiv/utils/cxx.hpp"
@@ -48,10 +52,34 @@ namespace lv {
     void GetSubDirsFromDir(const std::string& sDirPath, std::vector<std::string>& vsSubDirPaths);
     void FilterFilePaths(std::vector<std::string>& vsFilePaths, const std::vector<std::string>& vsRemoveTokens, const std::vector<std::string>& vsKeepTokens);
     bool CreateDirIfNotExist(const std::string& sDirPath);
+    /// fetches the size (in bytes) and last modification time (in nanoseconds, or in seconds where unavailable) of a file or directory; returns false if it does not exist
+    bool GetPathStats(const std::string& sPath, uint64_t& nSizeBytes, int64_t& nLastModifTime);
     std::fstream CreateBinFileWithPrealloc(const std::string& sFilePath, size_t nPreallocBytes, bool bZeroInit=false);
     void RegisterAllConsoleSignals(void(*lHandler)(int));
     size_t GetCurrentPhysMemBytesUsed();
 
+    /// memory-mapped file wrapper; the file is mapped privately, so writes to the mapping are copy-on-write and never reach the disk
+    struct MemoryMappedFile {
+        /// maps the entire file located at the given path (throws if it cannot be opened or mapped)
+        MemoryMappedFile(const std::string& sFilePath);
+        /// unmaps the file and closes all associated handles
+        ~MemoryMappedFile();
+        /// returns a pointer to the first byte of the mapping (page-aligned)
+        inline void* data() const {return m_pData;}
+        /// returns the size of the mapping (i.e. of the file) in bytes
+        inline size_t size() const {return m_nSize;}
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+    private:
+        void* m_pData;
+        size_t m_nSize;
+#if defined(_MSC_VER)
+        HANDLE m_hFile,m_hMapping;
+#else //(!defined(_MSC_VER))
+        int m_nFileDesc;
+#endif //(!defined(_MSC_VER))
+    };
+
     template<typename T, std::size_t nByteAlign>
     class AlignedMemAllocator {
     public:
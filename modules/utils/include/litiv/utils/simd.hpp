@@ -0,0 +1,460 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// note: this header is meant to be usable in translation units compiled with extra ISA flags for runtime dispatch (see
+// lv::selectKernel); it therefore only includes intrinsics & plain C headers, and declares all of its inline functions
+// in an inline namespace named after the enabled instruction set, so that no function compiled with a higher ISA level
+// can be merged by the linker into code that runs on a lower one (kernel tables should only rely on this header)
+
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else //(!defined(_MSC_VER))
+#include <x86intrin.h>
+#endif //(!defined(_MSC_VER))
+
+// same lane type names as OpenCV's (redeclaring an identical typedef is harmless, and avoids pulling in its headers)
+typedef unsigned char uchar;
+typedef unsigned short ushort;
+typedef unsigned int uint;
+
+// note: the SIMD vector wrappers below rely on compiler-defined ISA macros (instead of the HAVE_* config flags); since
+// msvc has no /arch level for SSE4.1, its translation units can opt in via the 'LV_SIMD_ENABLE_SSE4' define instead
+#if (defined(__AVX512F__) && defined(__AVX512BW__))
+#define LV_SIMD_AVX512 1
+#else //!(defined(__AVX512F__) && defined(__AVX512BW__))
+#define LV_SIMD_AVX512 0
+#endif //!(defined(__AVX512F__) && defined(__AVX512BW__))
+#if (LV_SIMD_AVX512 && defined(__AVX512VPOPCNTDQ__))
+#define LV_SIMD_AVX512_VPOPCNT 1
+#else //!(LV_SIMD_AVX512 && defined(__AVX512VPOPCNTDQ__))
+#define LV_SIMD_AVX512_VPOPCNT 0
+#endif //!(LV_SIMD_AVX512 && defined(__AVX512VPOPCNTDQ__))
+#if defined(__AVX2__)
+#define LV_SIMD_AVX2 1
+#else //!defined(__AVX2__)
+#define LV_SIMD_AVX2 0
+#endif //!defined(__AVX2__)
+#if (defined(__SSE4_1__) || defined(__AVX__) || defined(LV_SIMD_ENABLE_SSE4))
+#define LV_SIMD_SSE4 1
+#else //!(defined(__SSE4_1__) || defined(__AVX__) || defined(LV_SIMD_ENABLE_SSE4))
+#define LV_SIMD_SSE4 0
+#endif //!(defined(__SSE4_1__) || defined(__AVX__) || defined(LV_SIMD_ENABLE_SSE4))
+#if ((defined(__POPCNT__) || (defined(_MSC_VER) && LV_SIMD_SSE4)) && (defined(__x86_64__) || defined(_M_X64)))
+#define LV_SIMD_POPCNT64 1
+#else //!((defined(__POPCNT__) || (defined(_MSC_VER) && LV_SIMD_SSE4)) && (defined(__x86_64__) || defined(_M_X64)))
+#define LV_SIMD_POPCNT64 0
+#endif //!((defined(__POPCNT__) || (defined(_MSC_VER) && LV_SIMD_SSE4)) && (defined(__x86_64__) || defined(_M_X64)))
+#if LV_SIMD_AVX512_VPOPCNT
+#define LV_SIMD_NAMESPACE simd_avx512vp
+#elif LV_SIMD_AVX512
+#define LV_SIMD_NAMESPACE simd_avx512
+#elif LV_SIMD_AVX2
+#define LV_SIMD_NAMESPACE simd_avx2
+#elif LV_SIMD_SSE4
+#define LV_SIMD_NAMESPACE simd_sse4
+#else //!LV_SIMD_SSE4
+#define LV_SIMD_NAMESPACE simd_none
+#endif //!LV_SIMD_SSE4
+
+namespace lv {
+
+    inline namespace LV_SIMD_NAMESPACE {
+
+        /// empty tag type used to dispatch SIMD vector ops based on lane type and register width
+        template<typename TLane, size_t nBits>
+        struct SIMDTag_ {};
+
+        /// maps a lane type (uchar, ushort, uint or float) and a register width (128, 256 or 512) to its native register type
+        template<typename TLane, size_t nBits>
+        struct SIMDReg_;
+
+#if LV_SIMD_SSE4
+        template<> struct SIMDReg_<uchar,128> {using type = __m128i; using sum_t = uint64_t;};
+        template<> struct SIMDReg_<ushort,128> {using type = __m128i; using sum_t = uint64_t;};
+        template<> struct SIMDReg_<uint,128> {using type = __m128i; using sum_t = uint64_t;};
+        template<> struct SIMDReg_<float,128> {using type = __m128; using sum_t = float;};
+#endif //LV_SIMD_SSE4
+#if LV_SIMD_AVX2
+        template<> struct SIMDReg_<uchar,256> {using type = __m256i; using sum_t = uint64_t;};
+        template<> struct SIMDReg_<ushort,256> {using type = __m256i; using sum_t = uint64_t;};
+        template<> struct SIMDReg_<uint,256> {using type = __m256i; using sum_t = uint64_t;};
+        template<> struct SIMDReg_<float,256> {using type = __m256; using sum_t = float;};
+#endif //LV_SIMD_AVX2
+#if LV_SIMD_AVX512
+        template<> struct SIMDReg_<uchar,512> {using type = __m512i; using sum_t = uint64_t;};
+        template<> struct SIMDReg_<ushort,512> {using type = __m512i; using sum_t = uint64_t;};
+        template<> struct SIMDReg_<uint,512> {using type = __m512i; using sum_t = uint64_t;};
+        template<> struct SIMDReg_<float,512> {using type = __m512; using sum_t = float;};
+#endif //LV_SIMD_AVX512
+
+#if LV_SIMD_SSE4
+
+        namespace simd_impl {
+
+#define LV_SIMD_DEFINE_INT_OPS(TLane,TSigned,B,nBits,W,P,S) \
+            inline W zero(SIMDTag_<TLane,nBits>) {return P##_setzero_##S();} \
+            inline W set1(SIMDTag_<TLane,nBits>, TLane n) {return P##_set1_epi##B((TSigned)n);} \
+            inline W load(SIMDTag_<TLane,nBits>, const TLane* p) {return P##_load_##S((const W*)p);} \
+            inline W loadu(SIMDTag_<TLane,nBits>, const TLane* p) {return P##_loadu_##S((const W*)p);} \
+            inline void store(SIMDTag_<TLane,nBits>, const W& a, TLane* p) {P##_store_##S((W*)p,a);} \
+            inline void storeu(SIMDTag_<TLane,nBits>, const W& a, TLane* p) {P##_storeu_##S((W*)p,a);} \
+            inline W bit_and(SIMDTag_<TLane,nBits>, const W& a, const W& b) {return P##_and_##S(a,b);} \
+            inline W bit_or(SIMDTag_<TLane,nBits>, const W& a, const W& b) {return P##_or_##S(a,b);} \
+            inline W bit_xor(SIMDTag_<TLane,nBits>, const W& a, const W& b) {return P##_xor_##S(a,b);} \
+            inline W bit_andnot(SIMDTag_<TLane,nBits>, const W& a, const W& b) {return P##_andnot_##S(b,a);} \
+            inline W add(SIMDTag_<TLane,nBits>, const W& a, const W& b) {return P##_add_epi##B(a,b);} \
+            inline W sub(SIMDTag_<TLane,nBits>, const W& a, const W& b) {return P##_sub_epi##B(a,b);} \
+            inline W min(SIMDTag_<TLane,nBits>, const W& a, const W& b) {return P##_min_epu##B(a,b);} \
+            inline W max(SIMDTag_<TLane,nBits>, const W& a, const W& b) {return P##_max_epu##B(a,b);} \
+            inline W cmpeq(SIMDTag_<TLane,nBits>, const W& a, const W& b) {return P##_cmpeq_epi##B(a,b);} \
+            inline W cmpgt(SIMDTag_<TLane,nBits>, const W& a, const W& b) {return P##_xor_##S(P##_cmpeq_epi##B(P##_max_epu##B(a,b),b),P##_set1_epi32(-1));} \
+            inline W select(SIMDTag_<TLane,nBits>, const W& m, const W& a, const W& b) {return P##_blendv_epi8(b,a,m);} \
+            inline bool any(SIMDTag_<TLane,nBits>, const W& a) {return !P##_testz_##S(a,a);}
+
+#define LV_SIMD_DEFINE_INT_OPS_512(TLane,TSigned,B) \
+            inline __m512i zero(SIMDTag_<TLane,512>) {return _mm512_setzero_si512();} \
+            inline __m512i set1(SIMDTag_<TLane,512>, TLane n) {return _mm512_set1_epi##B((TSigned)n);} \
+            inline __m512i load(SIMDTag_<TLane,512>, const TLane* p) {return _mm512_load_si512(p);} \
+            inline __m512i loadu(SIMDTag_<TLane,512>, const TLane* p) {return _mm512_loadu_si512(p);} \
+            inline void store(SIMDTag_<TLane,512>, const __m512i& a, TLane* p) {_mm512_store_si512(p,a);} \
+            inline void storeu(SIMDTag_<TLane,512>, const __m512i& a, TLane* p) {_mm512_storeu_si512(p,a);} \
+            inline __m512i bit_and(SIMDTag_<TLane,512>, const __m512i& a, const __m512i& b) {return _mm512_and_si512(a,b);} \
+            inline __m512i bit_or(SIMDTag_<TLane,512>, const __m512i& a, const __m512i& b) {return _mm512_or_si512(a,b);} \
+            inline __m512i bit_xor(SIMDTag_<TLane,512>, const __m512i& a, const __m512i& b) {return _mm512_xor_si512(a,b);} \
+            inline __m512i bit_andnot(SIMDTag_<TLane,512>, const __m512i& a, const __m512i& b) {return _mm512_andnot_si512(b,a);} \
+            inline __m512i add(SIMDTag_<TLane,512>, const __m512i& a, const __m512i& b) {return _mm512_add_epi##B(a,b);} \
+            inline __m512i sub(SIMDTag_<TLane,512>, const __m512i& a, const __m512i& b) {return _mm512_sub_epi##B(a,b);} \
+            inline __m512i min(SIMDTag_<TLane,512>, const __m512i& a, const __m512i& b) {return _mm512_min_epu##B(a,b);} \
+            inline __m512i max(SIMDTag_<TLane,512>, const __m512i& a, const __m512i& b) {return _mm512_max_epu##B(a,b);} \
+            inline __m512i cmpeq(SIMDTag_<TLane,512>, const __m512i& a, const __m512i& b) {return _mm512_maskz_mov_epi##B(_mm512_cmpeq_epi##B##_mask(a,b),_mm512_set1_epi32(-1));} \
+            inline __m512i cmpgt(SIMDTag_<TLane,512>, const __m512i& a, const __m512i& b) {return _mm512_maskz_mov_epi##B(_mm512_cmpgt_epu##B##_mask(a,b),_mm512_set1_epi32(-1));} \
+            inline __m512i select(SIMDTag_<TLane,512>, const __m512i& m, const __m512i& a, const __m512i& b) {return _mm512_mask_blend_epi##B(_mm512_test_epi##B##_mask(m,m),b,a);} \
+            inline bool any(SIMDTag_<TLane,512>, const __m512i& a) {return _mm512_test_epi64_mask(a,a)!=0;}
+
+            LV_SIMD_DEFINE_INT_OPS(uchar,char,8,128,__m128i,_mm,si128)
+            LV_SIMD_DEFINE_INT_OPS(ushort,short,16,128,__m128i,_mm,si128)
+            LV_SIMD_DEFINE_INT_OPS(uint,int,32,128,__m128i,_mm,si128)
+            inline __m128i mul(SIMDTag_<ushort,128>, const __m128i& a, const __m128i& b) {return _mm_mullo_epi16(a,b);}
+            inline __m128i mul(SIMDTag_<uint,128>, const __m128i& a, const __m128i& b) {return _mm_mullo_epi32(a,b);}
+            inline __m128i popcount(SIMDTag_<uchar,128>, const __m128i& a) {
+                const __m128i _anNibbleLUT = _mm_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+                const __m128i _anLowMask = _mm_set1_epi8(0x0F);
+                return _mm_add_epi8(_mm_shuffle_epi8(_anNibbleLUT,_mm_and_si128(a,_anLowMask)),_mm_shuffle_epi8(_anNibbleLUT,_mm_and_si128(_mm_srli_epi16(a,4),_anLowMask)));
+            }
+            inline __m128i popcount(SIMDTag_<ushort,128>, const __m128i& a) {return _mm_maddubs_epi16(popcount(SIMDTag_<uchar,128>(),a),_mm_set1_epi8(1));}
+            inline __m128i popcount(SIMDTag_<uint,128>, const __m128i& a) {return _mm_madd_epi16(popcount(SIMDTag_<ushort,128>(),a),_mm_set1_epi16(1));}
+            inline uint64_t hsum_64(const __m128i& a) {
+                alignas(16) uint64_t anSums[2];
+                _mm_store_si128((__m128i*)anSums,a);
+                return anSums[0]+anSums[1];
+            }
+            inline uint64_t hsum(SIMDTag_<uchar,128>, const __m128i& a) {return hsum_64(_mm_sad_epu8(a,_mm_setzero_si128()));}
+            inline uint64_t hsum(SIMDTag_<ushort,128>, const __m128i& a) {return hsum_64(_mm_sad_epu8(_mm_and_si128(a,_mm_set1_epi16(0x00FF)),_mm_setzero_si128()))+(hsum_64(_mm_sad_epu8(_mm_srli_epi16(a,8),_mm_setzero_si128()))<<8);}
+            inline uint64_t hsum(SIMDTag_<uint,128>, const __m128i& a) {return hsum_64(_mm_add_epi64(_mm_and_si128(a,_mm_set1_epi64x(0xFFFFFFFF)),_mm_srli_epi64(a,32)));}
+            inline uchar hmin(SIMDTag_<uchar,128>, const __m128i& a) {return uchar(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_min_epu8(a,_mm_srli_epi16(a,8)))));}
+            inline uchar hmax(SIMDTag_<uchar,128>, const __m128i& a) {return uchar(~hmin(SIMDTag_<uchar,128>(),_mm_xor_si128(a,_mm_set1_epi32(-1))));}
+            inline ushort hmin(SIMDTag_<ushort,128>, const __m128i& a) {return ushort(_mm_cvtsi128_si32(_mm_minpos_epu16(a)));}
+            inline ushort hmax(SIMDTag_<ushort,128>, const __m128i& a) {return ushort(~hmin(SIMDTag_<ushort,128>(),_mm_xor_si128(a,_mm_set1_epi32(-1))));}
+            inline uint hmin(SIMDTag_<uint,128>, const __m128i& a) {
+                const __m128i _anTmp = _mm_min_epu32(a,_mm_shuffle_epi32(a,_MM_SHUFFLE(1,0,3,2)));
+                return uint(_mm_cvtsi128_si32(_mm_min_epu32(_anTmp,_mm_shuffle_epi32(_anTmp,_MM_SHUFFLE(2,3,0,1)))));
+            }
+            inline uint hmax(SIMDTag_<uint,128>, const __m128i& a) {
+                const __m128i _anTmp = _mm_max_epu32(a,_mm_shuffle_epi32(a,_MM_SHUFFLE(1,0,3,2)));
+                return uint(_mm_cvtsi128_si32(_mm_max_epu32(_anTmp,_mm_shuffle_epi32(_anTmp,_MM_SHUFFLE(2,3,0,1)))));
+            }
+            inline __m128 zero(SIMDTag_<float,128>) {return _mm_setzero_ps();}
+            inline __m128 set1(SIMDTag_<float,128>, float f) {return _mm_set1_ps(f);}
+            inline __m128 load(SIMDTag_<float,128>, const float* p) {return _mm_load_ps(p);}
+            inline __m128 loadu(SIMDTag_<float,128>, const float* p) {return _mm_loadu_ps(p);}
+            inline void store(SIMDTag_<float,128>, const __m128& a, float* p) {_mm_store_ps(p,a);}
+            inline void storeu(SIMDTag_<float,128>, const __m128& a, float* p) {_mm_storeu_ps(p,a);}
+            inline __m128 bit_and(SIMDTag_<float,128>, const __m128& a, const __m128& b) {return _mm_and_ps(a,b);}
+            inline __m128 bit_or(SIMDTag_<float,128>, const __m128& a, const __m128& b) {return _mm_or_ps(a,b);}
+            inline __m128 bit_xor(SIMDTag_<float,128>, const __m128& a, const __m128& b) {return _mm_xor_ps(a,b);}
+            inline __m128 bit_andnot(SIMDTag_<float,128>, const __m128& a, const __m128& b) {return _mm_andnot_ps(b,a);}
+            inline __m128 add(SIMDTag_<float,128>, const __m128& a, const __m128& b) {return _mm_add_ps(a,b);}
+            inline __m128 sub(SIMDTag_<float,128>, const __m128& a, const __m128& b) {return _mm_sub_ps(a,b);}
+            inline __m128 mul(SIMDTag_<float,128>, const __m128& a, const __m128& b) {return _mm_mul_ps(a,b);}
+            inline __m128 min(SIMDTag_<float,128>, const __m128& a, const __m128& b) {return _mm_min_ps(a,b);}
+            inline __m128 max(SIMDTag_<float,128>, const __m128& a, const __m128& b) {return _mm_max_ps(a,b);}
+            inline __m128 cmpeq(SIMDTag_<float,128>, const __m128& a, const __m128& b) {return _mm_cmpeq_ps(a,b);}
+            inline __m128 cmpgt(SIMDTag_<float,128>, const __m128& a, const __m128& b) {return _mm_cmpgt_ps(a,b);}
+            inline __m128 select(SIMDTag_<float,128>, const __m128& m, const __m128& a, const __m128& b) {return _mm_blendv_ps(b,a,m);}
+            inline bool any(SIMDTag_<float,128>, const __m128& a) {return !_mm_testz_si128(_mm_castps_si128(a),_mm_castps_si128(a));}
+            inline float hsum(SIMDTag_<float,128>, const __m128& a) {
+                const __m128 _afTmp = _mm_add_ps(a,_mm_movehl_ps(a,a));
+                return _mm_cvtss_f32(_mm_add_ss(_afTmp,_mm_shuffle_ps(_afTmp,_afTmp,1)));
+            }
+            inline float hmin(SIMDTag_<float,128>, const __m128& a) {
+                const __m128 _afTmp = _mm_min_ps(a,_mm_movehl_ps(a,a));
+                return _mm_cvtss_f32(_mm_min_ss(_afTmp,_mm_shuffle_ps(_afTmp,_afTmp,1)));
+            }
+            inline float hmax(SIMDTag_<float,128>, const __m128& a) {
+                const __m128 _afTmp = _mm_max_ps(a,_mm_movehl_ps(a,a));
+                return _mm_cvtss_f32(_mm_max_ss(_afTmp,_mm_shuffle_ps(_afTmp,_afTmp,1)));
+            }
+
+#if LV_SIMD_AVX2
+            LV_SIMD_DEFINE_INT_OPS(uchar,char,8,256,__m256i,_mm256,si256)
+            LV_SIMD_DEFINE_INT_OPS(ushort,short,16,256,__m256i,_mm256,si256)
+            LV_SIMD_DEFINE_INT_OPS(uint,int,32,256,__m256i,_mm256,si256)
+            inline __m256i mul(SIMDTag_<ushort,256>, const __m256i& a, const __m256i& b) {return _mm256_mullo_epi16(a,b);}
+            inline __m256i mul(SIMDTag_<uint,256>, const __m256i& a, const __m256i& b) {return _mm256_mullo_epi32(a,b);}
+            inline __m256i popcount(SIMDTag_<uchar,256>, const __m256i& a) {
+                const __m256i _anNibbleLUT = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+                const __m256i _anLowMask = _mm256_set1_epi8(0x0F);
+                return _mm256_add_epi8(_mm256_shuffle_epi8(_anNibbleLUT,_mm256_and_si256(a,_anLowMask)),_mm256_shuffle_epi8(_anNibbleLUT,_mm256_and_si256(_mm256_srli_epi16(a,4),_anLowMask)));
+            }
+            inline __m256i popcount(SIMDTag_<ushort,256>, const __m256i& a) {return _mm256_maddubs_epi16(popcount(SIMDTag_<uchar,256>(),a),_mm256_set1_epi8(1));}
+            inline __m256i popcount(SIMDTag_<uint,256>, const __m256i& a) {return _mm256_madd_epi16(popcount(SIMDTag_<ushort,256>(),a),_mm256_set1_epi16(1));}
+            inline __m256i gather(SIMDTag_<uint,256>, const uint* pBase, const int* anIdxs) {return _mm256_i32gather_epi32((const int*)pBase,_mm256_loadu_si256((const __m256i*)anIdxs),4);}
+            inline __m128i gather(SIMDTag_<uint,128>, const uint* pBase, const int* anIdxs) {return _mm_i32gather_epi32((const int*)pBase,_mm_loadu_si128((const __m128i*)anIdxs),4);}
+            inline __m256 gather(SIMDTag_<float,256>, const float* pBase, const int* anIdxs) {return _mm256_i32gather_ps(pBase,_mm256_loadu_si256((const __m256i*)anIdxs),4);}
+            inline __m128 gather(SIMDTag_<float,128>, const float* pBase, const int* anIdxs) {return _mm_i32gather_ps(pBase,_mm_loadu_si128((const __m128i*)anIdxs),4);}
+            template<typename TLane>
+            inline uint64_t hsum(SIMDTag_<TLane,256>, const __m256i& a) {return hsum(SIMDTag_<TLane,128>(),_mm256_castsi256_si128(a))+hsum(SIMDTag_<TLane,128>(),_mm256_extracti128_si256(a,1));}
+            template<typename TLane>
+            inline TLane hmin(SIMDTag_<TLane,256>, const __m256i& a) {return hmin(SIMDTag_<TLane,128>(),min(SIMDTag_<TLane,128>(),_mm256_castsi256_si128(a),_mm256_extracti128_si256(a,1)));}
+            template<typename TLane>
+            inline TLane hmax(SIMDTag_<TLane,256>, const __m256i& a) {return hmax(SIMDTag_<TLane,128>(),max(SIMDTag_<TLane,128>(),_mm256_castsi256_si128(a),_mm256_extracti128_si256(a,1)));}
+            inline __m256 zero(SIMDTag_<float,256>) {return _mm256_setzero_ps();}
+            inline __m256 set1(SIMDTag_<float,256>, float f) {return _mm256_set1_ps(f);}
+            inline __m256 load(SIMDTag_<float,256>, const float* p) {return _mm256_load_ps(p);}
+            inline __m256 loadu(SIMDTag_<float,256>, const float* p) {return _mm256_loadu_ps(p);}
+            inline void store(SIMDTag_<float,256>, const __m256& a, float* p) {_mm256_store_ps(p,a);}
+            inline void storeu(SIMDTag_<float,256>, const __m256& a, float* p) {_mm256_storeu_ps(p,a);}
+            inline __m256 bit_and(SIMDTag_<float,256>, const __m256& a, const __m256& b) {return _mm256_and_ps(a,b);}
+            inline __m256 bit_or(SIMDTag_<float,256>, const __m256& a, const __m256& b) {return _mm256_or_ps(a,b);}
+            inline __m256 bit_xor(SIMDTag_<float,256>, const __m256& a, const __m256& b) {return _mm256_xor_ps(a,b);}
+            inline __m256 bit_andnot(SIMDTag_<float,256>, const __m256& a, const __m256& b) {return _mm256_andnot_ps(b,a);}
+            inline __m256 add(SIMDTag_<float,256>, const __m256& a, const __m256& b) {return _mm256_add_ps(a,b);}
+            inline __m256 sub(SIMDTag_<float,256>, const __m256& a, const __m256& b) {return _mm256_sub_ps(a,b);}
+            inline __m256 mul(SIMDTag_<float,256>, const __m256& a, const __m256& b) {return _mm256_mul_ps(a,b);}
+            inline __m256 min(SIMDTag_<float,256>, const __m256& a, const __m256& b) {return _mm256_min_ps(a,b);}
+            inline __m256 max(SIMDTag_<float,256>, const __m256& a, const __m256& b) {return _mm256_max_ps(a,b);}
+            inline __m256 cmpeq(SIMDTag_<float,256>, const __m256& a, const __m256& b) {return _mm256_cmp_ps(a,b,_CMP_EQ_OQ);}
+            inline __m256 cmpgt(SIMDTag_<float,256>, const __m256& a, const __m256& b) {return _mm256_cmp_ps(a,b,_CMP_GT_OQ);}
+            inline __m256 select(SIMDTag_<float,256>, const __m256& m, const __m256& a, const __m256& b) {return _mm256_blendv_ps(b,a,m);}
+            inline bool any(SIMDTag_<float,256>, const __m256& a) {return !_mm256_testz_si256(_mm256_castps_si256(a),_mm256_castps_si256(a));}
+            inline float hsum(SIMDTag_<float,256>, const __m256& a) {return hsum(SIMDTag_<float,128>(),_mm_add_ps(_mm256_castps256_ps128(a),_mm256_extractf128_ps(a,1)));}
+            inline float hmin(SIMDTag_<float,256>, const __m256& a) {return hmin(SIMDTag_<float,128>(),_mm_min_ps(_mm256_castps256_ps128(a),_mm256_extractf128_ps(a,1)));}
+            inline float hmax(SIMDTag_<float,256>, const __m256& a) {return hmax(SIMDTag_<float,128>(),_mm_max_ps(_mm256_castps256_ps128(a),_mm256_extractf128_ps(a,1)));}
+#endif //LV_SIMD_AVX2
+
+#if LV_SIMD_AVX512
+#if (defined(__GNUC__) && !defined(__clang__))
+// gcc's avx512 intrinsics use self-initialized 'undefined' registers which trigger false uninitialized warnings when inlined
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif //(defined(__GNUC__) && !defined(__clang__))
+            LV_SIMD_DEFINE_INT_OPS_512(uchar,char,8)
+            LV_SIMD_DEFINE_INT_OPS_512(ushort,short,16)
+            LV_SIMD_DEFINE_INT_OPS_512(uint,int,32)
+            inline __m512i mul(SIMDTag_<ushort,512>, const __m512i& a, const __m512i& b) {return _mm512_mullo_epi16(a,b);}
+            inline __m512i mul(SIMDTag_<uint,512>, const __m512i& a, const __m512i& b) {return _mm512_mullo_epi32(a,b);}
+            inline __m512i popcount(SIMDTag_<uchar,512>, const __m512i& a) {
+                const __m512i _anNibbleLUT = _mm512_broadcast_i32x4(_mm_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4));
+                const __m512i _anLowMask = _mm512_set1_epi8(0x0F);
+                return _mm512_add_epi8(_mm512_shuffle_epi8(_anNibbleLUT,_mm512_and_si512(a,_anLowMask)),_mm512_shuffle_epi8(_anNibbleLUT,_mm512_and_si512(_mm512_srli_epi16(a,4),_anLowMask)));
+            }
+            inline __m512i popcount(SIMDTag_<ushort,512>, const __m512i& a) {return _mm512_maddubs_epi16(popcount(SIMDTag_<uchar,512>(),a),_mm512_set1_epi8(1));}
+#if LV_SIMD_AVX512_VPOPCNT
+            inline __m512i popcount(SIMDTag_<uint,512>, const __m512i& a) {return _mm512_popcnt_epi32(a);}
+#else //!LV_SIMD_AVX512_VPOPCNT
+            inline __m512i popcount(SIMDTag_<uint,512>, const __m512i& a) {return _mm512_madd_epi16(popcount(SIMDTag_<ushort,512>(),a),_mm512_set1_epi16(1));}
+#endif //!LV_SIMD_AVX512_VPOPCNT
+            inline __m512i gather(SIMDTag_<uint,512>, const uint* pBase, const int* anIdxs) {return _mm512_i32gather_epi32(_mm512_loadu_si512(anIdxs),pBase,4);}
+            inline __m512 gather(SIMDTag_<float,512>, const float* pBase, const int* anIdxs) {return _mm512_i32gather_ps(_mm512_loadu_si512(anIdxs),pBase,4);}
+            inline __m256 high_256(const __m512& a) {return _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(a),1));}
+            template<typename TLane>
+            inline uint64_t hsum(SIMDTag_<TLane,512>, const __m512i& a) {return hsum(SIMDTag_<TLane,256>(),_mm512_castsi512_si256(a))+hsum(SIMDTag_<TLane,256>(),_mm512_extracti64x4_epi64(a,1));}
+            template<typename TLane>
+            inline TLane hmin(SIMDTag_<TLane,512>, const __m512i& a) {return hmin(SIMDTag_<TLane,256>(),min(SIMDTag_<TLane,256>(),_mm512_castsi512_si256(a),_mm512_extracti64x4_epi64(a,1)));}
+            template<typename TLane>
+            inline TLane hmax(SIMDTag_<TLane,512>, const __m512i& a) {return hmax(SIMDTag_<TLane,256>(),max(SIMDTag_<TLane,256>(),_mm512_castsi512_si256(a),_mm512_extracti64x4_epi64(a,1)));}
+            inline __m512 zero(SIMDTag_<float,512>) {return _mm512_setzero_ps();}
+            inline __m512 set1(SIMDTag_<float,512>, float f) {return _mm512_set1_ps(f);}
+            inline __m512 load(SIMDTag_<float,512>, const float* p) {return _mm512_load_ps(p);}
+            inline __m512 loadu(SIMDTag_<float,512>, const float* p) {return _mm512_loadu_ps(p);}
+            inline void store(SIMDTag_<float,512>, const __m512& a, float* p) {_mm512_store_ps(p,a);}
+            inline void storeu(SIMDTag_<float,512>, const __m512& a, float* p) {_mm512_storeu_ps(p,a);}
+            inline __m512 bit_and(SIMDTag_<float,512>, const __m512& a, const __m512& b) {return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a),_mm512_castps_si512(b)));}
+            inline __m512 bit_or(SIMDTag_<float,512>, const __m512& a, const __m512& b) {return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(a),_mm512_castps_si512(b)));}
+            inline __m512 bit_xor(SIMDTag_<float,512>, const __m512& a, const __m512& b) {return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a),_mm512_castps_si512(b)));}
+            inline __m512 bit_andnot(SIMDTag_<float,512>, const __m512& a, const __m512& b) {return _mm512_castsi512_ps(_mm512_andnot_si512(_mm512_castps_si512(b),_mm512_castps_si512(a)));}
+            inline __m512 add(SIMDTag_<float,512>, const __m512& a, const __m512& b) {return _mm512_add_ps(a,b);}
+            inline __m512 sub(SIMDTag_<float,512>, const __m512& a, const __m512& b) {return _mm512_sub_ps(a,b);}
+            inline __m512 mul(SIMDTag_<float,512>, const __m512& a, const __m512& b) {return _mm512_mul_ps(a,b);}
+            inline __m512 min(SIMDTag_<float,512>, const __m512& a, const __m512& b) {return _mm512_min_ps(a,b);}
+            inline __m512 max(SIMDTag_<float,512>, const __m512& a, const __m512& b) {return _mm512_max_ps(a,b);}
+            inline __m512 cmpeq(SIMDTag_<float,512>, const __m512& a, const __m512& b) {return _mm512_castsi512_ps(_mm512_maskz_mov_epi32(_mm512_cmp_ps_mask(a,b,_CMP_EQ_OQ),_mm512_set1_epi32(-1)));}
+            inline __m512 cmpgt(SIMDTag_<float,512>, const __m512& a, const __m512& b) {return _mm512_castsi512_ps(_mm512_maskz_mov_epi32(_mm512_cmp_ps_mask(a,b,_CMP_GT_OQ),_mm512_set1_epi32(-1)));}
+            inline __m512 select(SIMDTag_<float,512>, const __m512& m, const __m512& a, const __m512& b) {return _mm512_mask_blend_ps(_mm512_test_epi32_mask(_mm512_castps_si512(m),_mm512_castps_si512(m)),b,a);}
+            inline bool any(SIMDTag_<float,512>, const __m512& a) {return _mm512_test_epi32_mask(_mm512_castps_si512(a),_mm512_castps_si512(a))!=0;}
+            inline float hsum(SIMDTag_<float,512>, const __m512& a) {return hsum(SIMDTag_<float,256>(),_mm256_add_ps(_mm512_castps512_ps256(a),high_256(a)));}
+            inline float hmin(SIMDTag_<float,512>, const __m512& a) {return hmin(SIMDTag_<float,256>(),_mm256_min_ps(_mm512_castps512_ps256(a),high_256(a)));}
+            inline float hmax(SIMDTag_<float,512>, const __m512& a) {return hmax(SIMDTag_<float,256>(),_mm256_max_ps(_mm512_castps512_ps256(a),high_256(a)));}
+#if (defined(__GNUC__) && !defined(__clang__))
+#pragma GCC diagnostic pop
+#endif //(defined(__GNUC__) && !defined(__clang__))
+#endif //LV_SIMD_AVX512
+
+            /// gathers lanes one at a time (fallback for lane types or widths without native gather support)
+            template<typename TLane, size_t nBits>
+            inline typename SIMDReg_<TLane,nBits>::type gather(SIMDTag_<TLane,nBits> oTag, const TLane* pBase, const int* anIdxs) {
+                alignas(nBits/8) TLane anVals[nBits/(8*sizeof(TLane))];
+                for(size_t n=0; n<nBits/(8*sizeof(TLane)); ++n)
+                    anVals[n] = pBase[anIdxs[n]];
+                return load(oTag,anVals);
+            }
+
+#undef LV_SIMD_DEFINE_INT_OPS
+#undef LV_SIMD_DEFINE_INT_OPS_512
+
+        } // namespace simd_impl
+
+        /// width-generic SIMD vector wrapper; kernels written with it can be instantiated once per register width/ISA level
+        template<typename TLane, size_t nBits>
+        struct SIMDVec_ {
+            /// lane (element) type of the vector
+            using lane_t = TLane;
+            /// native register type wrapped by the vector
+            using reg_t = typename SIMDReg_<TLane,nBits>::type;
+            /// type returned by horizontal sums (64-bit for integer lanes to avoid overflows)
+            using sum_t = typename SIMDReg_<TLane,nBits>::sum_t;
+            /// tag type used to dispatch ops to the right intrinsics
+            using tag_t = SIMDTag_<TLane,nBits>;
+            /// number of lanes (elements) in the vector
+            static constexpr size_t s_nLanes = nBits/(8*sizeof(TLane));
+            /// default constructor (leaves the register uninitialized)
+            SIMDVec_() = default;
+            /// implicit conversion from the native register type, for interop with raw intrinsics
+            SIMDVec_(const reg_t& v) : m_v(v) {}
+            /// implicit conversion to the native register type, for interop with raw intrinsics
+            operator const reg_t&() const {return m_v;}
+            /// returns a vector with all lanes set to zero
+            static SIMDVec_ zero() {return simd_impl::zero(tag_t());}
+            /// returns a vector with all lanes set to the given value
+            static SIMDVec_ set1(TLane n) {return simd_impl::set1(tag_t(),n);}
+            /// loads a vector from memory aligned on the register size
+            static SIMDVec_ load(const TLane* p) {return simd_impl::load(tag_t(),p);}
+            /// loads a vector from unaligned memory
+            static SIMDVec_ loadu(const TLane* p) {return simd_impl::loadu(tag_t(),p);}
+            /// loads a vector from the given base pointer using one (lane-sized) offset per lane
+            static SIMDVec_ gather(const TLane* pBase, const int* anIdxs) {return simd_impl::gather(tag_t(),pBase,anIdxs);}
+            /// stores the vector to memory aligned on the register size
+            void store(TLane* p) const {simd_impl::store(tag_t(),m_v,p);}
+            /// stores the vector to unaligned memory
+            void storeu(TLane* p) const {simd_impl::storeu(tag_t(),m_v,p);}
+            SIMDVec_ operator+(const SIMDVec_& o) const {return simd_impl::add(tag_t(),m_v,o.m_v);}
+            SIMDVec_ operator-(const SIMDVec_& o) const {return simd_impl::sub(tag_t(),m_v,o.m_v);}
+            SIMDVec_ operator*(const SIMDVec_& o) const {return simd_impl::mul(tag_t(),m_v,o.m_v);}
+            SIMDVec_ operator&(const SIMDVec_& o) const {return simd_impl::bit_and(tag_t(),m_v,o.m_v);}
+            SIMDVec_ operator|(const SIMDVec_& o) const {return simd_impl::bit_or(tag_t(),m_v,o.m_v);}
+            SIMDVec_ operator^(const SIMDVec_& o) const {return simd_impl::bit_xor(tag_t(),m_v,o.m_v);}
+            SIMDVec_& operator+=(const SIMDVec_& o) {return (*this = *this+o);}
+            SIMDVec_& operator-=(const SIMDVec_& o) {return (*this = *this-o);}
+            SIMDVec_& operator&=(const SIMDVec_& o) {return (*this = *this&o);}
+            SIMDVec_& operator|=(const SIMDVec_& o) {return (*this = *this|o);}
+            SIMDVec_& operator^=(const SIMDVec_& o) {return (*this = *this^o);}
+            /// returns the per-lane bit count of the vector (integer lanes only)
+            SIMDVec_ popcount() const {return simd_impl::popcount(tag_t(),m_v);}
+            /// returns the sum of all lanes
+            sum_t hsum() const {return simd_impl::hsum(tag_t(),m_v);}
+            /// returns the minimum value of all lanes
+            TLane hmin() const {return simd_impl::hmin(tag_t(),m_v);}
+            /// returns the maximum value of all lanes
+            TLane hmax() const {return simd_impl::hmax(tag_t(),m_v);}
+            /// returns whether any bit of the vector is set (e.g. whether any lane of a comparison mask is true)
+            bool any() const {return simd_impl::any(tag_t(),m_v);}
+            /// wrapped native register
+            reg_t m_v;
+        };
+
+        /// returns the per-lane minimum of two vectors (unsigned for integer lanes)
+        template<typename TLane, size_t nBits>
+        inline SIMDVec_<TLane,nBits> min(const SIMDVec_<TLane,nBits>& a, const SIMDVec_<TLane,nBits>& b) {
+            return simd_impl::min(SIMDTag_<TLane,nBits>(),a.m_v,b.m_v);
+        }
+
+        /// returns the per-lane maximum of two vectors (unsigned for integer lanes)
+        template<typename TLane, size_t nBits>
+        inline SIMDVec_<TLane,nBits> max(const SIMDVec_<TLane,nBits>& a, const SIMDVec_<TLane,nBits>& b) {
+            return simd_impl::max(SIMDTag_<TLane,nBits>(),a.m_v,b.m_v);
+        }
+
+        /// returns the per-lane absolute difference of two vectors
+        template<typename TLane, size_t nBits>
+        inline SIMDVec_<TLane,nBits> absdiff(const SIMDVec_<TLane,nBits>& a, const SIMDVec_<TLane,nBits>& b) {
+            return max(a,b)-min(a,b);
+        }
+
+        /// returns a & ~b
+        template<typename TLane, size_t nBits>
+        inline SIMDVec_<TLane,nBits> andnot(const SIMDVec_<TLane,nBits>& a, const SIMDVec_<TLane,nBits>& b) {
+            return simd_impl::bit_andnot(SIMDTag_<TLane,nBits>(),a.m_v,b.m_v);
+        }
+
+        /// returns a lane mask (all bits set where true) of a==b
+        template<typename TLane, size_t nBits>
+        inline SIMDVec_<TLane,nBits> cmpeq(const SIMDVec_<TLane,nBits>& a, const SIMDVec_<TLane,nBits>& b) {
+            return simd_impl::cmpeq(SIMDTag_<TLane,nBits>(),a.m_v,b.m_v);
+        }
+
+        /// returns a lane mask (all bits set where true) of a>b (unsigned for integer lanes)
+        template<typename TLane, size_t nBits>
+        inline SIMDVec_<TLane,nBits> cmpgt(const SIMDVec_<TLane,nBits>& a, const SIMDVec_<TLane,nBits>& b) {
+            return simd_impl::cmpgt(SIMDTag_<TLane,nBits>(),a.m_v,b.m_v);
+        }
+
+        /// returns the lanes of 'a' where the lane mask is set, and those of 'b' elsewhere
+        template<typename TLane, size_t nBits>
+        inline SIMDVec_<TLane,nBits> select(const SIMDVec_<TLane,nBits>& oMask, const SIMDVec_<TLane,nBits>& a, const SIMDVec_<TLane,nBits>& b) {
+            return simd_impl::select(SIMDTag_<TLane,nBits>(),oMask.m_v,a.m_v,b.m_v);
+        }
+
+        template<typename TLane, size_t nBits>
+        constexpr size_t SIMDVec_<TLane,nBits>::s_nLanes;
+
+        using SIMDVec_u8x16 = SIMDVec_<uchar,128>;
+        using SIMDVec_u16x8 = SIMDVec_<ushort,128>;
+        using SIMDVec_u32x4 = SIMDVec_<uint,128>;
+        using SIMDVec_f32x4 = SIMDVec_<float,128>;
+#if LV_SIMD_AVX2
+        using SIMDVec_u8x32 = SIMDVec_<uchar,256>;
+        using SIMDVec_u16x16 = SIMDVec_<ushort,256>;
+        using SIMDVec_u32x8 = SIMDVec_<uint,256>;
+        using SIMDVec_f32x8 = SIMDVec_<float,256>;
+#endif //LV_SIMD_AVX2
+#if LV_SIMD_AVX512
+        using SIMDVec_u8x64 = SIMDVec_<uchar,512>;
+        using SIMDVec_u16x32 = SIMDVec_<ushort,512>;
+        using SIMDVec_u32x16 = SIMDVec_<uint,512>;
+        using SIMDVec_f32x16 = SIMDVec_<float,512>;
+#endif //LV_SIMD_AVX512
+
+#endif //LV_SIMD_SSE4
+
+    } // inline namespace LV_SIMD_NAMESPACE
+
+} // namespace lv
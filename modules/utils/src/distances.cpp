@@ -0,0 +1,87 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/utils/distances.hpp"
+// note: the generic kernel table is compiled here with the baseline flags of the project, while the other tables are
+// compiled in their own translation units with extra ISA flags (see distances_kernels.hpp and the module's CMakeLists)
+#define LV_DISTANCE_KERNELS_TABLE g_oDistanceKernels_generic
+#include "distances_kernels.hpp"
+#undef LV_DISTANCE_KERNELS_TABLE
+
+namespace {
+
+    /// number of distances computed on the stack at once by the count functions
+    constexpr size_t s_nDistBlockSize = 64;
+
+    /// returns the distance kernel table best suited for the current CPU (selected once, on first call)
+    const lv::DistanceKernels& getDistanceKernels() {
+        static const lv::DistanceKernels& s_oKernels = lv::selectKernel<lv::DistanceKernels>({{
+            &lv::g_oDistanceKernels_generic,
+            &lv::g_oDistanceKernels_sse4,
+            &lv::g_oDistanceKernels_avx2,
+            &lv::g_oDistanceKernels_avx512,
+        }});
+        return s_oKernels;
+    }
+
+} // namespace
+
+size_t lv::hdist(const uchar* const a, const uchar* const b, size_t nBytes) {
+    lvDbgAssert((a && b) || nBytes==0);
+    return getDistanceKernels().hdist(a,b,nBytes);
+}
+
+void lv::hdist_batch(const uchar* const aQuery, const uchar* const aSamples, size_t nDescBytes, size_t nSamples, size_t* anDists) {
+    lvDbgAssert_(aQuery && (aSamples || nSamples==0) && (anDists || nSamples==0),"invalid input/output pointers");
+    lvDbgAssert_(nDescBytes>0,"descriptor size must be non-null");
+    getDistanceKernels().hdist_batch(aQuery,aSamples,nDescBytes,nSamples,anDists);
+}
+
+void lv::hdist_batch(const uchar* const aQueries, size_t nQueries, const uchar* const aSamples, size_t nDescBytes, size_t nSamples, size_t* anDists) {
+    lvDbgAssert_(aQueries || nQueries==0,"invalid query pointer");
+    for(size_t nQueryIdx=0; nQueryIdx<nQueries; ++nQueryIdx)
+        lv::hdist_batch(aQueries+nQueryIdx*nDescBytes,aSamples,nDescBytes,nSamples,anDists+nQueryIdx*nSamples);
+}
+
+size_t lv::hdist_count(const uchar* const aQuery, const uchar* const aSamples, size_t nDescBytes, size_t nSamples, size_t nMaxDist, size_t nMaxCount) {
+    std::array<size_t,s_nDistBlockSize> anDists;
+    size_t nCount = 0;
+    for(size_t nBlockIdx=0; nBlockIdx<nSamples && nCount<nMaxCount; nBlockIdx+=s_nDistBlockSize) {
+        const size_t nBlockSize = std::min(s_nDistBlockSize,nSamples-nBlockIdx);
+        lv::hdist_batch(aQuery,aSamples+nBlockIdx*nDescBytes,nDescBytes,nBlockSize,anDists.data());
+        for(size_t n=0; n<nBlockSize; ++n)
+            nCount += size_t(anDists[n]<=nMaxDist);
+    }
+    return std::min(nCount,nMaxCount);
+}
+
+void lv::L1dist_batch(const uchar* const aQuery, const uchar* const aSamples, size_t nChannels, size_t nSamples, size_t* anDists) {
+    lvDbgAssert_(aQuery && (aSamples || nSamples==0) && (anDists || nSamples==0),"invalid input/output pointers");
+    lvDbgAssert_(nChannels>0,"vectors should have at least one channel");
+    getDistanceKernels().L1dist_batch(aQuery,aSamples,nChannels,nSamples,anDists);
+}
+
+size_t lv::L1dist_count(const uchar* const aQuery, const uchar* const aSamples, size_t nChannels, size_t nSamples, size_t nMaxDist, size_t nMaxCount) {
+    std::array<size_t,s_nDistBlockSize> anDists;
+    size_t nCount = 0;
+    for(size_t nBlockIdx=0; nBlockIdx<nSamples && nCount<nMaxCount; nBlockIdx+=s_nDistBlockSize) {
+        const size_t nBlockSize = std::min(s_nDistBlockSize,nSamples-nBlockIdx);
+        lv::L1dist_batch(aQuery,aSamples+nBlockIdx*nChannels,nChannels,nBlockSize,anDists.data());
+        for(size_t n=0; n<nBlockSize; ++n)
+            nCount += size_t(anDists[n]<=nMaxDist);
+    }
+    return std::min(nCount,nMaxCount);
+}
@@ -0,0 +1,234 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// note: this private header is included by several translation units, each compiled for a different instruction set
+// level (see the utils module's CMakeLists.txt); it must therefore only include intrinsics, plain C headers and the
+// ISA-namespaced lv::SIMDVec_ wrappers, and keep all of its own helpers in an anonymous namespace (any other inline
+// function shared across these translation units could be merged by the linker into a version the CPU cannot run)
+
+#include "litiv/utils/simd.hpp"
+#include <climits>
+#include <cstring>
+
+namespace lv {
+
+    /// table of batched distance kernels compiled for a given instruction set level
+    struct DistanceKernels {
+        /// computes the hamming distance between two byte arrays of arbitrary length
+        size_t (*hdist)(const uchar* a, const uchar* b, size_t nBytes);
+        /// computes the hamming distances between a query descriptor and N contiguous sample descriptors
+        void (*hdist_batch)(const uchar* aQuery, const uchar* aSamples, size_t nDescBytes, size_t nSamples, size_t* anDists);
+        /// computes the L1 distances between a query vector and N contiguous sample vectors
+        void (*L1dist_batch)(const uchar* aQuery, const uchar* aSamples, size_t nChannels, size_t nSamples, size_t* anDists);
+    };
+
+    extern const DistanceKernels g_oDistanceKernels_generic;
+    extern const DistanceKernels g_oDistanceKernels_sse4;
+    extern const DistanceKernels g_oDistanceKernels_avx2;
+    extern const DistanceKernels g_oDistanceKernels_avx512;
+
+} // namespace lv
+
+#ifdef LV_DISTANCE_KERNELS_TABLE
+
+#if defined(__AVX2__)
+#define LV_KERNELS_USE_AVX2 1
+#else //!defined(__AVX2__)
+#define LV_KERNELS_USE_AVX2 0
+#endif //!defined(__AVX2__)
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2))
+#define LV_KERNELS_USE_SSE2 1
+#else //!(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2))
+#define LV_KERNELS_USE_SSE2 0
+#endif //!(defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2))
+namespace {
+
+#if LV_SIMD_SSE4
+    /// accumulates the hamming distance of all full vectors of two byte arrays, starting at (and updating) the given offset
+    template<typename TVec>
+    size_t hdist_vec(const uchar* a, const uchar* b, size_t nBytes, size_t& nOffset) {
+        using TLane = typename TVec::lane_t;
+        constexpr size_t nVecBytes = TVec::s_nLanes*sizeof(TLane);
+        // per-lane counts are reduced before they can overflow (i.e. every 31 vectors for 8-bit lanes)
+        constexpr size_t nMaxIters = size_t(TLane(~TLane(0)))/(sizeof(TLane)*8);
+        size_t nResult = 0;
+        while(nOffset+nVecBytes<=nBytes) {
+            TVec vSums = TVec::zero();
+            for(size_t nIter=0; nIter<nMaxIters && nOffset+nVecBytes<=nBytes; ++nIter, nOffset+=nVecBytes)
+                vSums += (TVec::loadu((const TLane*)(a+nOffset))^TVec::loadu((const TLane*)(b+nOffset))).popcount();
+            nResult += (size_t)vSums.hsum();
+        }
+        return nResult;
+    }
+
+    /// computes the hamming distances between a query and samples packed in vector lanes, starting at (and returning) the given sample index
+    template<typename TVec>
+    size_t hdist_batch_vec(const uchar* aQuery, const uchar* aSamples, size_t nSamples, size_t* anDists, size_t nSampleIdx) {
+        using TLane = typename TVec::lane_t;
+        TLane nQuery;
+        memcpy(&nQuery,aQuery,sizeof(TLane));
+        const TVec vQuery = TVec::set1(nQuery);
+        alignas(64) TLane anTempDists[TVec::s_nLanes];
+        for(; nSampleIdx+TVec::s_nLanes<=nSamples; nSampleIdx+=TVec::s_nLanes) {
+            (TVec::loadu((const TLane*)(aSamples+nSampleIdx*sizeof(TLane)))^vQuery).popcount().store(anTempDists);
+            for(size_t n=0; n<TVec::s_nLanes; ++n)
+                anDists[nSampleIdx+n] = anTempDists[n];
+        }
+        return nSampleIdx;
+    }
+#endif //LV_SIMD_SSE4
+
+    /// returns the popcount of an 8-bit integer (bit-twiddling version, to avoid sharing a LUT with non-kernel code)
+    inline size_t popcount_8(const uchar nVal) {
+        const uint nPairs = uint(nVal)-((uint(nVal)>>1)&0x55u);
+        const uint nNibbles = (nPairs&0x33u)+((nPairs>>2)&0x33u);
+        return size_t((nNibbles+(nNibbles>>4))&0x0Fu);
+    }
+
+    /// returns the popcount of a 64-bit integer (popcnt instruction if available, bit-twiddling version otherwise)
+    inline size_t popcount_64(const uint64_t nVal) {
+#if LV_SIMD_POPCNT64
+        return (size_t)_mm_popcnt_u64(nVal);
+#else //!LV_SIMD_POPCNT64
+        uint64_t nPairs = nVal-((nVal>>1)&0x5555555555555555ull);
+        nPairs = (nPairs&0x3333333333333333ull)+((nPairs>>2)&0x3333333333333333ull);
+        return size_t((((nPairs+(nPairs>>4))&0x0F0F0F0F0F0F0F0Full)*0x0101010101010101ull)>>56);
+#endif //!LV_SIMD_POPCNT64
+    }
+
+    /// returns the absolute difference between two bytes
+    inline size_t absdiff_8(const uchar a, const uchar b) {
+        return size_t(a>b?a-b:b-a);
+    }
+
+    /// computes the hamming distance between two byte arrays of arbitrary length
+    size_t hdist_impl(const uchar* a, const uchar* b, size_t nBytes) {
+        size_t nResult = 0, nOffset = 0;
+#if LV_SIMD_AVX512_VPOPCNT
+        nResult += hdist_vec<lv::SIMDVec_<uint,512>>(a,b,nBytes,nOffset);
+#elif LV_SIMD_AVX512
+        nResult += hdist_vec<lv::SIMDVec_<uchar,512>>(a,b,nBytes,nOffset);
+#endif //LV_SIMD_AVX512
+#if LV_SIMD_AVX2
+        nResult += hdist_vec<lv::SIMDVec_<uchar,256>>(a,b,nBytes,nOffset);
+#endif //LV_SIMD_AVX2
+#if LV_SIMD_SSE4
+        nResult += hdist_vec<lv::SIMDVec_<uchar,128>>(a,b,nBytes,nOffset);
+#endif //LV_SIMD_SSE4
+        for(; nOffset+8<=nBytes; nOffset+=8) {
+            uint64_t nA, nB;
+            memcpy(&nA,a+nOffset,8);
+            memcpy(&nB,b+nOffset,8);
+            nResult += popcount_64(nA^nB);
+        }
+        for(; nOffset<nBytes; ++nOffset)
+            nResult += popcount_8(uchar(a[nOffset]^b[nOffset]));
+        return nResult;
+    }
+
+    /// computes the hamming distances between a query and samples of 2 or 4 bytes by replicating the query across vector lanes
+    template<typename TLane>
+    size_t hdist_batch_small(const uchar* aQuery, const uchar* aSamples, size_t nSamples, size_t* anDists) {
+        static_assert(sizeof(TLane)==2 || sizeof(TLane)==4,"small batch impl only handles 16-bit and 32-bit descriptors");
+        (void)aQuery; (void)aSamples; (void)nSamples; (void)anDists; // all used only if simd impls are available
+        size_t nSampleIdx = 0;
+#if LV_SIMD_AVX512
+        nSampleIdx = hdist_batch_vec<lv::SIMDVec_<TLane,512>>(aQuery,aSamples,nSamples,anDists,nSampleIdx);
+#endif //LV_SIMD_AVX512
+#if LV_SIMD_AVX2
+        nSampleIdx = hdist_batch_vec<lv::SIMDVec_<TLane,256>>(aQuery,aSamples,nSamples,anDists,nSampleIdx);
+#endif //LV_SIMD_AVX2
+#if LV_SIMD_SSE4
+        nSampleIdx = hdist_batch_vec<lv::SIMDVec_<TLane,128>>(aQuery,aSamples,nSamples,anDists,nSampleIdx);
+#endif //LV_SIMD_SSE4
+        return nSampleIdx; // remaining samples are left to the caller
+    }
+
+    /// computes the hamming distances between a query descriptor and N contiguous sample descriptors
+    void hdist_batch_impl(const uchar* aQuery, const uchar* aSamples, size_t nDescBytes, size_t nSamples, size_t* anDists) {
+        size_t nSampleIdx = 0;
+        if(nDescBytes==1) {
+            for(; nSampleIdx<nSamples; ++nSampleIdx)
+                anDists[nSampleIdx] = popcount_8(uchar(aQuery[0]^aSamples[nSampleIdx]));
+            return;
+        }
+        else if(nDescBytes==2)
+            nSampleIdx = hdist_batch_small<ushort>(aQuery,aSamples,nSamples,anDists);
+        else if(nDescBytes==4)
+            nSampleIdx = hdist_batch_small<uint>(aQuery,aSamples,nSamples,anDists);
+        for(; nSampleIdx<nSamples; ++nSampleIdx)
+            anDists[nSampleIdx] = hdist_impl(aQuery,aSamples+nSampleIdx*nDescBytes,nDescBytes);
+    }
+
+    /// computes the L1 distance between two byte arrays of arbitrary length
+    inline size_t L1dist_bytes(const uchar* a, const uchar* b, size_t nBytes) {
+        size_t nResult = 0, nOffset = 0;
+#if LV_KERNELS_USE_AVX2
+        if(nBytes>=32) {
+            __m256i _anSums = _mm256_setzero_si256();
+            for(; nOffset+32<=nBytes; nOffset+=32)
+                _anSums = _mm256_add_epi64(_anSums,_mm256_sad_epu8(_mm256_loadu_si256((const __m256i*)(a+nOffset)),_mm256_loadu_si256((const __m256i*)(b+nOffset))));
+            alignas(32) uint64_t anSums[4];
+            _mm256_store_si256((__m256i*)anSums,_anSums);
+            nResult += size_t(anSums[0]+anSums[1]+anSums[2]+anSums[3]);
+        }
+#endif //LV_KERNELS_USE_AVX2
+#if LV_KERNELS_USE_SSE2
+        if(nBytes-nOffset>=16) {
+            __m128i _anSums = _mm_setzero_si128();
+            for(; nOffset+16<=nBytes; nOffset+=16)
+                _anSums = _mm_add_epi64(_anSums,_mm_sad_epu8(_mm_loadu_si128((const __m128i*)(a+nOffset)),_mm_loadu_si128((const __m128i*)(b+nOffset))));
+            alignas(16) uint64_t anSums[2];
+            _mm_store_si128((__m128i*)anSums,_anSums);
+            nResult += size_t(anSums[0]+anSums[1]);
+        }
+#endif //LV_KERNELS_USE_SSE2
+        for(; nOffset<nBytes; ++nOffset)
+            nResult += absdiff_8(a[nOffset],b[nOffset]);
+        return nResult;
+    }
+
+    /// computes the L1 distances between a query and samples of a fixed (small) number of channels
+    template<size_t nChannels>
+    void L1dist_batch_small(const uchar* aQuery, const uchar* aSamples, size_t nSamples, size_t* anDists) {
+        for(size_t nSampleIdx=0; nSampleIdx<nSamples; ++nSampleIdx) {
+            size_t nResult = 0;
+            for(size_t c=0; c<nChannels; ++c)
+                nResult += absdiff_8(aQuery[c],aSamples[nSampleIdx*nChannels+c]);
+            anDists[nSampleIdx] = nResult;
+        }
+    }
+
+    /// computes the L1 distances between a query vector and N contiguous sample vectors
+    void L1dist_batch_impl(const uchar* aQuery, const uchar* aSamples, size_t nChannels, size_t nSamples, size_t* anDists) {
+        switch(nChannels) {
+            case 1: L1dist_batch_small<1>(aQuery,aSamples,nSamples,anDists); return;
+            case 2: L1dist_batch_small<2>(aQuery,aSamples,nSamples,anDists); return;
+            case 3: L1dist_batch_small<3>(aQuery,aSamples,nSamples,anDists); return;
+            case 4: L1dist_batch_small<4>(aQuery,aSamples,nSamples,anDists); return;
+            default:
+                for(size_t nSampleIdx=0; nSampleIdx<nSamples; ++nSampleIdx)
+                    anDists[nSampleIdx] = L1dist_bytes(aQuery,aSamples+nSampleIdx*nChannels,nChannels);
+        }
+    }
+
+} // namespace
+
+const lv::DistanceKernels lv::LV_DISTANCE_KERNELS_TABLE = {&hdist_impl,&hdist_batch_impl,&L1dist_batch_impl};
+
+#endif //def(LV_DISTANCE_KERNELS_TABLE)
@@ -0,0 +1,236 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "litiv/utils/parallel.hpp"
+
+namespace {
+
+    /// maximum number of threads 'parallel_for' may use from the calling thread (0 = unbounded, 1 = inside a parallel region)
+    thread_local size_t s_nThreadBudget = 0;
+
+    /// budget shared with another thread that may update it while the calling thread runs (null = none), combined with the fixed budget above
+    thread_local const std::atomic_size_t* s_pSharedThreadBudget = nullptr;
+
+    /// set of jobs shared by the caller of 'parallel_for' and the pool workers helping it
+    struct ParallelForJobSet {
+        ParallelForJobSet(size_t nJobs, const std::function<void(size_t)>& lJob) :
+                m_nJobs(nJobs),m_lJob(lJob),m_nNextJobIdx(0),m_nDoneJobCount(0),m_bAborted(false) {}
+        /// runs jobs until none are left to fetch (the job functor is never touched once all jobs are done, as the caller may have returned)
+        void run() {
+            for(size_t nJobIdx=m_nNextJobIdx++; nJobIdx<m_nJobs; nJobIdx=m_nNextJobIdx++) {
+                if(!m_bAborted) {
+                    try {
+                        m_lJob(nJobIdx);
+                    }
+                    catch(...) {
+                        std::mutex_lock_guard sync_lock(m_oSyncMutex);
+                        if(!m_pJobException)
+                            m_pJobException = std::current_exception();
+                        m_bAborted = true; // makes other workers skip remaining jobs asap
+                    }
+                }
+                if(++m_nDoneJobCount==m_nJobs) {
+                    std::mutex_lock_guard sync_lock(m_oSyncMutex);
+                    m_oDoneCondVar.notify_all();
+                }
+            }
+        }
+        /// blocks until all jobs are done (fetched jobs are always completed or skipped), and rethrows the first job exception, if any
+        void wait() {
+            std::mutex_unique_lock sync_lock(m_oSyncMutex);
+            m_oDoneCondVar.wait(sync_lock,[&]{return m_nDoneJobCount==m_nJobs;});
+            if(m_pJobException)
+                std::rethrow_exception(m_pJobException);
+        }
+    private:
+        const size_t m_nJobs;
+        const std::function<void(size_t)>& m_lJob;
+        std::atomic_size_t m_nNextJobIdx;
+        std::atomic_size_t m_nDoneJobCount;
+        std::atomic_bool m_bAborted;
+        std::exception_ptr m_pJobException;
+        std::mutex m_oSyncMutex;
+        std::condition_variable m_oDoneCondVar;
+    };
+
+    /// persistent worker pool shared by all 'parallel_for' calls (workers are flagged as being in a parallel region)
+    struct ParallelForPool {
+        ParallelForPool(size_t nWorkers) : m_bIsActive(true) {
+            for(size_t nWorkerIdx=0; nWorkerIdx<nWorkers; ++nWorkerIdx)
+                m_vhWorkers.emplace_back(&ParallelForPool::entry,this);
+        }
+        ~ParallelForPool() {
+            {
+                std::mutex_lock_guard sync_lock(m_oSyncMutex);
+                m_bIsActive = false;
+            }
+            m_oSyncVar.notify_all();
+            for(std::thread& oWorker : m_vhWorkers)
+                oWorker.join();
+        }
+        /// returns the number of persistent workers in the pool
+        size_t getWorkerCount() const {
+            return m_vhWorkers.size();
+        }
+        /// asks 'nHelpers' idle workers to help with the given job set (stale requests are dropped by workers as soon as they get them)
+        void queue(const std::shared_ptr<ParallelForJobSet>& pJobSet, size_t nHelpers) {
+            {
+                std::mutex_lock_guard sync_lock(m_oSyncMutex);
+                for(size_t nHelperIdx=0; nHelperIdx<nHelpers; ++nHelperIdx)
+                    m_qpJobSets.push(pJobSet);
+            }
+            if(nHelpers==1)
+                m_oSyncVar.notify_one();
+            else
+                m_oSyncVar.notify_all();
+        }
+    private:
+        void entry() {
+            s_nThreadBudget = 1;
+            std::mutex_unique_lock sync_lock(m_oSyncMutex);
+            while(true) {
+                m_oSyncVar.wait(sync_lock,[&]{return !m_bIsActive || !m_qpJobSets.empty();});
+                if(m_qpJobSets.empty())
+                    return;
+                std::shared_ptr<ParallelForJobSet> pJobSet = std::move(m_qpJobSets.front());
+                m_qpJobSets.pop();
+                std::unlock_guard<std::mutex_unique_lock> oUnlock(sync_lock);
+                pJobSet->run();
+            }
+        }
+        std::queue<std::shared_ptr<ParallelForJobSet>> m_qpJobSets;
+        std::vector<std::thread> m_vhWorkers;
+        std::mutex m_oSyncMutex;
+        std::condition_variable m_oSyncVar;
+        bool m_bIsActive;
+    };
+
+    ParallelForPool& getParallelForPool() {
+        static ParallelForPool s_oPool(size_t(std::max(std::thread::hardware_concurrency(),1u)-1));
+        return s_oPool;
+    }
+
+#if defined(_MSC_VER)
+
+    bool checkCPUID(int nLeaf, int nSubLeaf, int nRegIdx, int nBit) {
+        int anRegs[4];
+        __cpuid(anRegs,0);
+        if(anRegs[0]<nLeaf)
+            return false;
+        __cpuidex(anRegs,nLeaf,nSubLeaf);
+        return (anRegs[nRegIdx]&(1<<nBit))!=0;
+    }
+
+    lv::ISALevelList detectISALevel() {
+        // cpuid register indices: eax=0, ebx=1, ecx=2, edx=3
+        const bool bOSXSAVE = checkCPUID(1,0,2,27);
+        const unsigned long long nXCR0 = bOSXSAVE?_xgetbv(0):0;
+        const bool bOSAVX = (nXCR0&0x06)==0x06; // xmm+ymm states saved by os
+        const bool bOSAVX512 = (nXCR0&0xE6)==0xE6; // xmm+ymm+opmask+zmm states saved by os
+        if(!(checkCPUID(1,0,2,9) && checkCPUID(1,0,2,19) && checkCPUID(1,0,2,23)))
+            return lv::ISALevel_Generic;
+        if(!(bOSAVX && checkCPUID(7,0,1,5)))
+            return lv::ISALevel_SSE4;
+        if(!(bOSAVX512 && checkCPUID(7,0,1,16) && checkCPUID(7,0,1,30) && checkCPUID(7,0,2,14)))
+            return lv::ISALevel_AVX2;
+        return lv::ISALevel_AVX512;
+    }
+
+#else //(!defined(_MSC_VER))
+
+    lv::ISALevelList detectISALevel() {
+        // note: gcc/clang builtins also check for os support of extended register states
+        __builtin_cpu_init();
+        if(!(__builtin_cpu_supports("ssse3") && __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("popcnt")))
+            return lv::ISALevel_Generic;
+        if(!__builtin_cpu_supports("avx2"))
+            return lv::ISALevel_SSE4;
+        if(!(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vpopcntdq")))
+            return lv::ISALevel_AVX2;
+        return lv::ISALevel_AVX512;
+    }
+
+#endif //(!defined(_MSC_VER))
+
+} // namespace
+
+bool lv::isInParallelRegion() {
+    return getThreadBudget()==1;
+}
+
+size_t lv::getThreadBudget() {
+    if(!s_pSharedThreadBudget)
+        return s_nThreadBudget;
+    const size_t nSharedThreadBudget = std::max(s_pSharedThreadBudget->load(),size_t(1));
+    return (s_nThreadBudget==0 || nSharedThreadBudget<s_nThreadBudget)?nSharedThreadBudget:s_nThreadBudget;
+}
+
+lv::ThreadBudgetGuard::ThreadBudgetGuard(size_t nMaxThreads) :
+        m_nPrevThreadBudget(s_nThreadBudget) {
+    // budgets can only shrink when nested, so a guard never lets a thread use more than what its caller was given
+    const size_t nThreadBudget = std::max(nMaxThreads,size_t(1));
+    if(s_nThreadBudget==0 || nThreadBudget<s_nThreadBudget)
+        s_nThreadBudget = nThreadBudget;
+}
+
+lv::ThreadBudgetGuard::~ThreadBudgetGuard() {
+    s_nThreadBudget = m_nPrevThreadBudget;
+}
+
+lv::SharedThreadBudgetGuard::SharedThreadBudgetGuard(const std::atomic_size_t& nMaxThreads) :
+        m_pPrevSharedThreadBudget(s_pSharedThreadBudget) {
+    // only one shared budget is tracked per thread; fixed budgets set by 'ThreadBudgetGuard' still bound it from above
+    s_pSharedThreadBudget = &nMaxThreads;
+}
+
+lv::SharedThreadBudgetGuard::~SharedThreadBudgetGuard() {
+    s_pSharedThreadBudget = m_pPrevSharedThreadBudget;
+}
+
+void lv::parallel_for_pooled(size_t nJobs, size_t nThreads, const std::function<void(size_t)>& lJob) {
+    ParallelForPool& oPool = getParallelForPool();
+    auto pJobSet = std::make_shared<ParallelForJobSet>(nJobs,lJob);
+    oPool.queue(pJobSet,std::min(nThreads,oPool.getWorkerCount()+1)-1);
+    {
+        ParallelRegionGuard oGuard;
+        pJobSet->run();
+    }
+    pJobSet->wait();
+}
+
+lv::ISALevelList lv::getISALevel() {
+    static const ISALevelList s_eLevel = []() {
+        ISALevelList eLevel = detectISALevel();
+        const char* acMaxLevel = std::getenv("LITIV_MAX_ISA_LEVEL");
+        if(acMaxLevel && *acMaxLevel) {
+            const int nMaxLevel = std::atoi(acMaxLevel);
+            lvAssert__(nMaxLevel>=0 && nMaxLevel<(int)ISALevelCount,"bad 'LITIV_MAX_ISA_LEVEL' value (should be in [0,%d])",(int)ISALevelCount-1);
+            eLevel = std::min(eLevel,(ISALevelList)nMaxLevel);
+        }
+        return eLevel;
+    }();
+    return s_eLevel;
+}
+
+const char* lv::getISALevelName(ISALevelList eLevel) {
+    switch(eLevel) {
+        case ISALevel_Generic: return "generic";
+        case ISALevel_SSE4: return "sse4";
+        case ISALevel_AVX2: return "avx2";
+        case ISALevel_AVX512: return "avx512";
+        default: lvError("unknown instruction set level");
+    }
+}
@@ -176,6 +176,27 @@ bool lv::CreateDirIfNotExist(const std::string& sDirPath) {
 #endif //(!defined(_MSC_VER))
 }
 
+bool lv::GetPathStats(const std::string& sPath, uint64_t& nSizeBytes, int64_t& nLastModifTime) {
+#if defined(_MSC_VER)
+    struct _stat64 st;
+    if(_stat64(sPath.c_str(),&st)!=0)
+        return false;
+    nSizeBytes = (uint64_t)st.st_size;
+    nLastModifTime = (int64_t)st.st_mtime;
+#else //(!defined(_MSC_VER))
+    struct stat st;
+    if(stat(sPath.c_str(),&st)!=0)
+        return false;
+    nSizeBytes = (uint64_t)st.st_size;
+#if defined(__APPLE__)
+    nLastModifTime = (int64_t)st.st_mtimespec.tv_sec*1000000000+(int64_t)st.st_mtimespec.tv_nsec;
+#else //(!defined(__APPLE__))
+    nLastModifTime = (int64_t)st.st_mtim.tv_sec*1000000000+(int64_t)st.st_mtim.tv_nsec;
+#endif //(!defined(__APPLE__))
+#endif //(!defined(_MSC_VER))
+    return true;
+}
+
 std::fstream lv::CreateBinFileWithPrealloc(const std::string & sFilePath, size_t nPreallocBytes, bool bZeroInit) {
     std::fstream ssFile(sFilePath,std::ios::out|std::ios::in|std::ios::ate|std::ios::binary);
     if(!ssFile.is_open())
@@ -225,3 +246,51 @@ size_t lv::GetCurrentPhysMemBytesUsed() {
     return size_t(nMemUsed*sysconf(_SC_PAGESIZE));
 #endif //ndef(_MSC_VER)
 }
+
+lv::MemoryMappedFile::MemoryMappedFile(const std::string& sFilePath) :
+        m_pData(nullptr),m_nSize(0) {
+#if defined(_MSC_VER)
+    m_hFile = CreateFileA(sFilePath.c_str(),GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL|FILE_FLAG_SEQUENTIAL_SCAN,nullptr);
+    lvAssert__(m_hFile!=INVALID_HANDLE_VALUE,"could not open file at '%s'",sFilePath.c_str());
+    LARGE_INTEGER nFileSize;
+    if(!GetFileSizeEx(m_hFile,&nFileSize) || nFileSize.QuadPart<=0) {
+        CloseHandle(m_hFile);
+        lvError_("could not map empty or unreadable file at '%s'",sFilePath.c_str());
+    }
+    m_nSize = (size_t)nFileSize.QuadPart;
+    m_hMapping = CreateFileMappingA(m_hFile,nullptr,PAGE_WRITECOPY,0,0,nullptr);
+    if(m_hMapping)
+        m_pData = MapViewOfFile(m_hMapping,FILE_MAP_COPY,0,0,0);
+    if(!m_pData) {
+        if(m_hMapping)
+            CloseHandle(m_hMapping);
+        CloseHandle(m_hFile);
+        lvError_("could not map file at '%s'",sFilePath.c_str());
+    }
+#else //(!defined(_MSC_VER))
+    m_nFileDesc = open(sFilePath.c_str(),O_RDONLY);
+    lvAssert__(m_nFileDesc!=-1,"could not open file at '%s'",sFilePath.c_str());
+    struct stat st;
+    if(fstat(m_nFileDesc,&st)==-1 || st.st_size<=0) {
+        close(m_nFileDesc);
+        lvError_("could not map empty or unreadable file at '%s'",sFilePath.c_str());
+    }
+    m_nSize = (size_t)st.st_size;
+    m_pData = mmap(nullptr,m_nSize,PROT_READ|PROT_WRITE,MAP_PRIVATE,m_nFileDesc,0);
+    if(m_pData==MAP_FAILED) {
+        close(m_nFileDesc);
+        lvError_("could not map file at '%s'",sFilePath.c_str());
+    }
+#endif //(!defined(_MSC_VER))
+}
+
+lv::MemoryMappedFile::~MemoryMappedFile() {
+#if defined(_MSC_VER)
+    UnmapViewOfFile(m_pData);
+    CloseHandle(m_hMapping);
+    CloseHandle(m_hFile);
+#else //(!defined(_MSC_VER))
+    munmap(m_pData,m_nSize);
+    close(m_nFileDesc);
+#endif //(!defined(_MSC_VER))
+}
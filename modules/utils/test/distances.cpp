@@ -0,0 +1,101 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// checks every runtime-dispatched distance kernel table the current CPU supports against scalar reference implementations
+
+#include "litiv_test.hpp"
+#include "litiv/utils/distances.hpp"
+#include "distances_kernels.hpp"
+#include <random>
+#include <array>
+#include <climits>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+    /// scalar reference for the hamming distance between two byte arrays
+    size_t hdist_ref(const uchar* a, const uchar* b, size_t nBytes) {
+        size_t nResult = 0;
+        for(size_t nByteIdx=0; nByteIdx<nBytes; ++nByteIdx)
+            for(uchar nXOR=uchar(a[nByteIdx]^b[nByteIdx]); nXOR; nXOR&=uchar(nXOR-1))
+                ++nResult;
+        return nResult;
+    }
+
+    /// scalar reference for the L1 distance between two byte vectors
+    size_t L1dist_ref(const uchar* a, const uchar* b, size_t nChannels) {
+        size_t nResult = 0;
+        for(size_t nChIdx=0; nChIdx<nChannels; ++nChIdx)
+            nResult += (size_t)std::abs((int)a[nChIdx]-(int)b[nChIdx]);
+        return nResult;
+    }
+
+    /// checks one kernel table on random data for a given descriptor size and sample count
+    void testKernels(const lv::DistanceKernels& oKernels, const char* sISAName, std::mt19937& oRandGen, size_t nDescBytes, size_t nSamples) {
+        std::uniform_int_distribution<int> oByteDistrib(0,UCHAR_MAX);
+        std::vector<uchar> vQuery(nDescBytes), vSamples(nDescBytes*nSamples);
+        for(uchar& nVal : vQuery)
+            nVal = (uchar)oByteDistrib(oRandGen);
+        for(uchar& nVal : vSamples)
+            nVal = (uchar)oByteDistrib(oRandGen);
+        if(nSamples>0) // worst case for lane-local counters: all bits differ
+            for(size_t nByteIdx=0; nByteIdx<nDescBytes; ++nByteIdx)
+                vSamples[nByteIdx] = uchar(~vQuery[nByteIdx]);
+        std::vector<size_t> vDists(nSamples,SIZE_MAX);
+        oKernels.hdist_batch(vQuery.data(),vSamples.data(),nDescBytes,nSamples,vDists.data());
+        for(size_t nSampleIdx=0; nSampleIdx<nSamples; ++nSampleIdx) {
+            const uchar* aSample = vSamples.data()+nSampleIdx*nDescBytes;
+            const size_t nRefDist = hdist_ref(vQuery.data(),aSample,nDescBytes);
+            lvTestCheck_(vDists[nSampleIdx]==nRefDist,"%s hdist_batch, %d bytes, sample %d",sISAName,(int)nDescBytes,(int)nSampleIdx);
+            lvTestCheck_(oKernels.hdist(vQuery.data(),aSample,nDescBytes)==nRefDist,"%s hdist, %d bytes, sample %d",sISAName,(int)nDescBytes,(int)nSampleIdx);
+        }
+        std::fill(vDists.begin(),vDists.end(),SIZE_MAX);
+        oKernels.L1dist_batch(vQuery.data(),vSamples.data(),nDescBytes,nSamples,vDists.data());
+        for(size_t nSampleIdx=0; nSampleIdx<nSamples; ++nSampleIdx)
+            lvTestCheck_(vDists[nSampleIdx]==L1dist_ref(vQuery.data(),vSamples.data()+nSampleIdx*nDescBytes,nDescBytes),"%s L1dist_batch, %d channels, sample %d",sISAName,(int)nDescBytes,(int)nSampleIdx);
+    }
+
+} // namespace
+
+int main(int, char**) {
+    return lv::test::run("distances",[]() {
+        const std::array<const lv::DistanceKernels*,lv::ISALevelCount> apKernels = {{
+            &lv::g_oDistanceKernels_generic,
+            &lv::g_oDistanceKernels_sse4,
+            &lv::g_oDistanceKernels_avx2,
+            &lv::g_oDistanceKernels_avx512,
+        }};
+        // descriptor sizes cover the specialized 1/2/3/4-byte paths, odd sizes, and multiple full vectors with tails
+        const size_t anDescBytes[] = {0,1,2,3,4,5,6,7,8,13,16,31,32,33,64,65,100,1000,10000};
+        const size_t anSampleCounts[] = {0,1,3,16,17,50};
+        std::mt19937 oRandGen(42);
+        for(int nLevel=(int)lv::ISALevel_Generic; nLevel<=(int)lv::getISALevel(); ++nLevel) {
+            const char* sISAName = lv::getISALevelName((lv::ISALevelList)nLevel);
+            std::printf("testing '%s' distance kernels...\n",sISAName);
+            for(size_t nDescBytes : anDescBytes)
+                for(size_t nSamples : anSampleCounts)
+                    testKernels(*apKernels[nLevel],sISAName,oRandGen,nDescBytes,nSamples);
+        }
+        // the public entrypoints should route to the selected table (and agree with the references)
+        const std::vector<uchar> vA = {0x00,0xFF,0x0F,0xAA,0x55}, vB = {0xFF,0xFF,0xF0,0x55,0x55};
+        lvTestCheck(lv::hdist(vA.data(),vB.data(),vA.size())==hdist_ref(vA.data(),vB.data(),vA.size()));
+        size_t nL1Dist = 0;
+        lv::L1dist_batch(vA.data(),vB.data(),vA.size(),1,&nL1Dist);
+        lvTestCheck(nL1Dist==L1dist_ref(vA.data(),vB.data(),vA.size()));
+    });
+}
@@ -0,0 +1,62 @@
+// This file is part of the LITIV framework; visit the original repository at
+// https://github.com/plstcharles/litiv for more information.
+//
+// Copyright 2015 Pierre-Luc St-Charles; pierre-luc.st-charles<at>polymtl.ca
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#pragma once
+
+// note: this header only provides the bare minimum for the plain CTest executables found in each module's 'test'
+// directory; each test returns a nonzero exit code if any of its checks failed (or if an exception escaped)
+
+#include <cstdio>
+#include <cstddef>
+#include <exception>
+
+namespace lv {
+
+    namespace test {
+
+        /// returns the number of checks that failed so far in the current test executable
+        inline size_t& getFailureCount() {
+            static size_t s_nFailureCount = 0;
+            return s_nFailureCount;
+        }
+
+        /// runs the given test body, counting escaped exceptions as failures, and returns the exit code of the test executable
+        template<typename TFunc>
+        inline int run(const char* sTestName, TFunc&& lTestBody) {
+            try {
+                lTestBody();
+            }
+            catch(const std::exception& e) {
+                std::fprintf(stderr,"[%s] caught exception: %s\n",sTestName,e.what());
+                ++getFailureCount();
+            }
+            if(getFailureCount()>0) {
+                std::fprintf(stderr,"[%s] FAILED (%d check(s))\n",sTestName,(int)getFailureCount());
+                return 1;
+            }
+            std::printf("[%s] passed\n",sTestName);
+            return 0;
+        }
+
+    } // namespace test
+
+} // namespace lv
+
+/// checks the given expression, reporting (but not aborting on) failures
+#define lvTestCheck(expr) {if(!!(expr)); else {++lv::test::getFailureCount(); std::fprintf(stderr,"[lvTestCheck] (" #expr ") failed at %s:%d\n",__FILE__,__LINE__);}}
+/// checks the given expression, reporting (but not aborting on) failures with an extra printf-formatted message
+#define lvTestCheck_(expr,msg,...) {if(!!(expr)); else {++lv::test::getFailureCount(); std::fprintf(stderr,"[lvTestCheck: " msg "] (" #expr ") failed at %s:%d\n",__VA_ARGS__,__FILE__,__LINE__);}}
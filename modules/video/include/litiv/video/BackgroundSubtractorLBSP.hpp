@@ -26,6 +26,10 @@
 #define BGSLBSP_DEFAULT_LBSP_OFFSET_SIMILARITY_THRESHOLD (0)
 /// defines the default value for BackgroundSubtractorLBSP::m_nDefaultMedianBlurKernelSize
 #define BGSLBSP_DEFAULT_MEDIAN_BLUR_KERNEL_SIZE (9)
+#ifndef BGSLBSP_NONPARALLEL_PATTERN
+/// defines the LBSP sampling pattern used by non-parallel impls (GLSL impls always use the 16-bit double-cross pattern of their shaders)
+#define BGSLBSP_NONPARALLEL_PATTERN LBSPPattern_16bitsDbCross
+#endif //ndef(BGSLBSP_NONPARALLEL_PATTERN)
 
 /*!
     Local Binary Similarity Pattern (LBSP) algorithm interface for FG/BG video segmentation via change detection.
@@ -38,6 +42,11 @@
 template<lv::ParallelAlgoType eImpl>
 struct IBackgroundSubtractorLBSP_ : public IBackgroundSubtractor_<eImpl> {
 
+    /// LBSP descriptor utilities specialized for the sampling pattern used by this impl (see BGSLBSP_NONPARALLEL_PATTERN)
+    typedef LBSP_<(eImpl==lv::NonParallel)?BGSLBSP_NONPARALLEL_PATTERN:LBSPPattern_16bitsDbCross> LBSPDesc;
+    /// integer type used to store descriptors in this impl
+    typedef typename LBSPDesc::desc_t desc_t;
+
     /// returns a copy of the latest reconstructed background descriptors image
     virtual void getBackgroundDescriptorsImage(cv::OutputArray oBGDescImg) const = 0;
 
@@ -52,7 +61,7 @@ protected:
             m_fRelLBSPThreshold(fRelLBSPThreshold),
             m_nDefaultMedianBlurKernelSize(nDefaultMedianBlurKernelSize) {
         lvAssert_(m_fRelLBSPThreshold>=0,"relative threshold for LBSP features must be non-negative");
-        IIBackgroundSubtractor::m_nROIBorderSize = LBSP::PATCH_SIZE/2;
+        IIBackgroundSubtractor::m_nROIBorderSize = LBSPDesc::PATCH_SIZE/2;
     }
 #if HAVE_GLSL
     /// glsl impl constructor (defined here as MSVC is very prude with template-class-template-cstor-definitions)
@@ -69,7 +78,7 @@ protected:
             m_fRelLBSPThreshold(fRelLBSPThreshold),
             m_nDefaultMedianBlurKernelSize(nDefaultMedianBlurKernelSize) {
         lvAssert_(m_fRelLBSPThreshold>=0,"relative threshold for LBSP features must be non-negative");
-        IIBackgroundSubtractor::m_nROIBorderSize = LBSP::PATCH_SIZE/2;
+        IIBackgroundSubtractor::m_nROIBorderSize = LBSPDesc::PATCH_SIZE/2;
     }
     /// returns the GLSL compute shader source code for LBSP lookup/description functions
     template<lv::ParallelAlgoType eImplTemp = eImpl> // dont pass arguments here!
@@ -88,6 +97,8 @@ protected:
     virtual ~IBackgroundSubtractorLBSP_() {}
     /// common (re)initiaization method for all impl types (should be called in impl-specific initialize func)
     virtual void initialize_common(const cv::Mat& oInitImg, const cv::Mat& oROI) override;
+    /// converts an averaged (CV_64F) descriptors image to LBSPDesc::DESC_DEPTH; 32-bit descriptors keep their unsigned bit pattern instead of saturating at INT_MAX
+    static void convertAvgDescImage(const cv::Mat& oAvgDescImg, cv::OutputArray oDescImg);
     /// LBSP internal threshold offset value, used to reduce texture noise in dark regions
     const size_t m_nLBSPThresholdOffset;
     /// LBSP relative internal threshold (kept here since we don't keep an LBSP object)
@@ -68,7 +68,7 @@ protected:
     template<size_t nChannels>
     struct ColorLBSPFeature {
         std::array<uchar,nChannels> anColor;
-        std::array<ushort,nChannels> anDesc;
+        std::array<desc_t,nChannels> anDesc;
     };
     struct LocalWordBase {
         size_t nFirstOcc;
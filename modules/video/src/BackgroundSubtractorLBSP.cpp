@@ -21,24 +21,24 @@ template<lv::ParallelAlgoType eImpl>
 void IBackgroundSubtractorLBSP_<eImpl>::initialize_common(const cv::Mat& oInitImg, const cv::Mat& oROI) {
     lvDbgExceptionWatch;
     IIBackgroundSubtractor::initialize_common(oInitImg,oROI);
-    m_oLastDescFrame.create(this->m_oImgSize,CV_16UC((int)this->m_nImgChannels));
-    m_oLastDescFrame = cv::Scalar_<ushort>::all(0);
-    const int nLBSPBorderSize = (int)LBSP::PATCH_SIZE/2;
+    m_oLastDescFrame.create(this->m_oImgSize,CV_MAKETYPE(LBSPDesc::DESC_DEPTH,(int)this->m_nImgChannels));
+    m_oLastDescFrame = cv::Scalar_<desc_t>::all(0);
+    const int nLBSPBorderSize = (int)LBSPDesc::PATCH_SIZE/2;
     if(this->m_nImgChannels==1) {
-        lvAssert(m_oLastDescFrame.step.p[0]==this->m_oLastColorFrame.step.p[0]*2 && m_oLastDescFrame.step.p[1]==this->m_oLastColorFrame.step.p[1]*2);
+        lvAssert(m_oLastDescFrame.step.p[0]==this->m_oLastColorFrame.step.p[0]*LBSPDesc::DESC_SIZE && m_oLastDescFrame.step.p[1]==this->m_oLastColorFrame.step.p[1]*LBSPDesc::DESC_SIZE);
         for(size_t t=0; t<=UCHAR_MAX; ++t)
             m_anLBSPThreshold_8bitLUT[t] = cv::saturate_cast<uchar>((t*m_fRelLBSPThreshold+m_nLBSPThresholdOffset)/3);
         for(size_t nPxIter=0; nPxIter<this->m_nTotPxCount; ++nPxIter) {
             const int nImgCoord_X = this->m_voPxInfoLUT[nPxIter].nImgCoord_X;
             const int nImgCoord_Y = this->m_voPxInfoLUT[nPxIter].nImgCoord_Y;
             if(this->m_oROI.data[nPxIter] && nImgCoord_X>nLBSPBorderSize && nImgCoord_Y>nLBSPBorderSize && nImgCoord_X<oInitImg.cols-nLBSPBorderSize && nImgCoord_Y<oInitImg.rows-nLBSPBorderSize) {
-                const size_t nDescIter = nPxIter*2;
-                LBSP::computeDescriptor<1>(oInitImg,oInitImg.data[nPxIter],nImgCoord_X,nImgCoord_Y,0,m_anLBSPThreshold_8bitLUT[oInitImg.data[nPxIter]],*((ushort*)(m_oLastDescFrame.data+nDescIter)));
+                const size_t nDescIter = nPxIter*LBSPDesc::DESC_SIZE;
+                LBSPDesc::template computeDescriptor<1>(oInitImg,oInitImg.data[nPxIter],nImgCoord_X,nImgCoord_Y,0,m_anLBSPThreshold_8bitLUT[oInitImg.data[nPxIter]],*((desc_t*)(m_oLastDescFrame.data+nDescIter)));
             }
         }
     }
     else { //(m_nImgChannels==3 || m_nImgChannels==4)
-        lvAssert(m_oLastDescFrame.step.p[0]==this->m_oLastColorFrame.step.p[0]*2 && m_oLastDescFrame.step.p[1]==this->m_oLastColorFrame.step.p[1]*2);
+        lvAssert(m_oLastDescFrame.step.p[0]==this->m_oLastColorFrame.step.p[0]*LBSPDesc::DESC_SIZE && m_oLastDescFrame.step.p[1]==this->m_oLastColorFrame.step.p[1]*LBSPDesc::DESC_SIZE);
         for(size_t t=0; t<=UCHAR_MAX; ++t)
             m_anLBSPThreshold_8bitLUT[t] = cv::saturate_cast<uchar>(t*m_fRelLBSPThreshold+m_nLBSPThresholdOffset);
         for(size_t nPxIter=0; nPxIter<this->m_nTotPxCount; ++nPxIter) {
@@ -46,24 +46,43 @@ void IBackgroundSubtractorLBSP_<eImpl>::initialize_common(const cv::Mat& oInitIm
             const int nImgCoord_Y = this->m_voPxInfoLUT[nPxIter].nImgCoord_Y;
             if(this->m_oROI.data[nPxIter] && nImgCoord_X>nLBSPBorderSize && nImgCoord_Y>nLBSPBorderSize && nImgCoord_X<oInitImg.cols-nLBSPBorderSize && nImgCoord_Y<oInitImg.rows-nLBSPBorderSize) {
                 const size_t nPxRGBIter = nPxIter*this->m_nImgChannels;
-                const size_t nDescRGBIter = nPxRGBIter*2;
+                const size_t nDescRGBIter = nPxRGBIter*LBSPDesc::DESC_SIZE;
                 if(this->m_nImgChannels==3) {
-                    alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
-                    LBSP::computeDescriptor_lookup(oInitImg,nImgCoord_X,nImgCoord_Y,aanLBSPLookupVals);
+                    alignas(32) std::array<std::array<uchar,LBSPDesc::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
+                    LBSPDesc::computeDescriptor_lookup(oInitImg,nImgCoord_X,nImgCoord_Y,aanLBSPLookupVals);
                     for(size_t c=0; c<3; ++c)
-                        ((ushort*)(m_oLastDescFrame.data+nDescRGBIter))[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],oInitImg.data[nPxRGBIter+c],m_anLBSPThreshold_8bitLUT[oInitImg.data[nPxRGBIter+c]]);
+                        ((desc_t*)(m_oLastDescFrame.data+nDescRGBIter))[c] = LBSPDesc::computeDescriptor_threshold(aanLBSPLookupVals[c],oInitImg.data[nPxRGBIter+c],m_anLBSPThreshold_8bitLUT[oInitImg.data[nPxRGBIter+c]]);
                 }
                 else { //m_nImgChannels==4
-                    alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,4> aanLBSPLookupVals;
-                    LBSP::computeDescriptor_lookup(oInitImg,nImgCoord_X,nImgCoord_Y,aanLBSPLookupVals);
+                    alignas(32) std::array<std::array<uchar,LBSPDesc::DESC_SIZE_BITS>,4> aanLBSPLookupVals;
+                    LBSPDesc::computeDescriptor_lookup(oInitImg,nImgCoord_X,nImgCoord_Y,aanLBSPLookupVals);
                     for(size_t c=0; c<4; ++c)
-                        ((ushort*)(m_oLastDescFrame.data+nDescRGBIter))[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],oInitImg.data[nPxRGBIter+c],m_anLBSPThreshold_8bitLUT[oInitImg.data[nPxRGBIter+c]]);
+                        ((desc_t*)(m_oLastDescFrame.data+nDescRGBIter))[c] = LBSPDesc::computeDescriptor_threshold(aanLBSPLookupVals[c],oInitImg.data[nPxRGBIter+c],m_anLBSPThreshold_8bitLUT[oInitImg.data[nPxRGBIter+c]]);
                 }
             }
         }
     }
 }
 
+template<lv::ParallelAlgoType eImpl>
+void IBackgroundSubtractorLBSP_<eImpl>::convertAvgDescImage(const cv::Mat& oAvgDescImg, cv::OutputArray oDescImg) {
+    lvAssert_(!oAvgDescImg.empty() && oAvgDescImg.depth()==CV_64F,"averaged descriptors image must be non-empty, and of depth 64F");
+    if(LBSPDesc::DESC_SIZE<4) {
+        oAvgDescImg.convertTo(oDescImg,LBSPDesc::DESC_DEPTH);
+        return;
+    }
+    // CV_32S cannot hold all unsigned 32-bit descriptors, so the averaged values are rounded and stored bit-for-bit instead
+    oDescImg.create(oAvgDescImg.size(),CV_MAKETYPE(LBSPDesc::DESC_DEPTH,oAvgDescImg.channels()));
+    cv::Mat oOutput = oDescImg.getMat();
+    const int nCols = oAvgDescImg.cols*oAvgDescImg.channels();
+    for(int nRowIdx=0; nRowIdx<oAvgDescImg.rows; ++nRowIdx) {
+        const double* const adAvgDescRow = oAvgDescImg.ptr<double>(nRowIdx);
+        desc_t* const anDescRow = oOutput.ptr<desc_t>(nRowIdx);
+        for(int nColIdx=0; nColIdx<nCols; ++nColIdx)
+            anDescRow[nColIdx] = (desc_t)std::min(std::max(std::round(adAvgDescRow[nColIdx]),0.0),(double)std::numeric_limits<desc_t>::max());
+    }
+}
+
 #if HAVE_GLSL
 
 template<>
@@ -80,7 +80,7 @@
 #endif //USE_INTERNAL_HRCS
 
 static const size_t s_nColorMaxDataRange_1ch = UCHAR_MAX;
-static const size_t s_nDescMaxDataRange_1ch = LBSP::DESC_SIZE_BITS;
+static const size_t s_nDescMaxDataRange_1ch = IBackgroundSubtractorLBSP::LBSPDesc::DESC_SIZE_BITS;
 static const size_t s_nColorMaxDataRange_3ch = s_nColorMaxDataRange_1ch*3;
 static const size_t s_nDescMaxDataRange_3ch = s_nDescMaxDataRange_1ch*3;
 
@@ -132,12 +132,12 @@ void BackgroundSubtractorPAWCS::refreshModel(size_t nBaseOccCount, float fOccDec
                 for(size_t nLocalSamplingIter=0; nLocalSamplingIter<nTotLocalSamplingIterCount; ++nLocalSamplingIter) {
                     // == refresh: local resampling
                     int nSampleImgCoord_Y, nSampleImgCoord_X;
-                    cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                    cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,LBSPDesc::PATCH_SIZE/2,m_oImgSize);
                     const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
                     if(bForceFGUpdate || !m_oLastFGMask_dilated.data[nSamplePxIdx]) {
                         const uchar nSampleColor = m_oLastColorFrame.data[nSamplePxIdx];
-                        const size_t nSampleDescIdx = nSamplePxIdx*2;
-                        const ushort nSampleIntraDesc = *((ushort*)(m_oLastDescFrame.data+nSampleDescIdx));
+                        const size_t nSampleDescIdx = nSamplePxIdx*LBSPDesc::DESC_SIZE;
+                        const desc_t nSampleIntraDesc = *((desc_t*)(m_oLastDescFrame.data+nSampleDescIdx));
                         bool bFoundUninitd = false;
                         size_t nLocalWordIdx;
                         for(nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
@@ -280,13 +280,13 @@ void BackgroundSubtractorPAWCS::refreshModel(size_t nBaseOccCount, float fOccDec
                 for(size_t nLocalSamplingIter=0; nLocalSamplingIter<nTotLocalSamplingIterCount; ++nLocalSamplingIter) {
                     // == refresh: local resampling
                     int nSampleImgCoord_Y, nSampleImgCoord_X;
-                    cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                    cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X,m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y,LBSPDesc::PATCH_SIZE/2,m_oImgSize);
                     const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
                     if(bForceFGUpdate || !m_oLastFGMask_dilated.data[nSamplePxIdx]) {
                         const size_t nSamplePxRGBIdx = nSamplePxIdx*3;
-                        const size_t nSampleDescRGBIdx = nSamplePxRGBIdx*2;
+                        const size_t nSampleDescRGBIdx = nSamplePxRGBIdx*LBSPDesc::DESC_SIZE;
                         const uchar* const anSampleColor = m_oLastColorFrame.data+nSamplePxRGBIdx;
-                        const ushort* const anSampleIntraDesc = ((ushort*)(m_oLastDescFrame.data+nSampleDescRGBIdx));
+                        const desc_t* const anSampleIntraDesc = ((desc_t*)(m_oLastDescFrame.data+nSampleDescRGBIdx));
                         bool bFoundUninitd = false;
                         size_t nLocalWordIdx;
                         for(nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
@@ -576,7 +576,7 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
 #if DISPLAY_PAWCS_DEBUG_INFO
     std::vector<std::string> vsWordModList(m_nTotRelevantPxCount*m_nCurrLocalWords);
     std::array<uchar,3> anDBGColor = {0,0,0};
-    std::array<ushort,3> anDBGIntraDesc = {0,0,0};
+    std::array<desc_t,3> anDBGIntraDesc = {0,0,0};
     bool bDBGMaskResult = false;
     bool bDBGMaskModifiedByGDict = false;
     GlobalWordBase* pDBGGlobalWordModifier = nullptr;
@@ -617,13 +617,13 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
             std::chrono::high_resolution_clock::time_point pre_prep = std::chrono::high_resolution_clock::now();
 #endif //USE_INTERNAL_HRCS
             const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const size_t nDescIter = nPxIter*2;
+            const size_t nDescIter = nPxIter*LBSPDesc::DESC_SIZE;
             const size_t nFloatIter = nPxIter*4;
             const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
             const size_t nGlobalWordMapLookupIdx = m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx;
             const uchar nCurrColor = oInputImg.data[nPxIter];
             uchar& nLastColor = m_oLastColorFrame.data[nPxIter];
-            ushort& nLastIntraDesc = *((ushort*)(m_oLastDescFrame.data+nDescIter));
+            desc_t& nLastIntraDesc = *((desc_t*)(m_oLastDescFrame.data+nDescIter));
             size_t nMinColorDist = s_nColorMaxDataRange_1ch;
             size_t nMinDescDist = s_nDescMaxDataRange_1ch;
             float& fCurrMeanRawSegmRes_LT = *(float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter);
@@ -648,9 +648,9 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
 #endif //DISPLAY_PAWCS_DEBUG_INFO
             const int nCurrImgCoord_X = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X;
             const int nCurrImgCoord_Y = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y;
-            alignas(16) std::array<uchar,LBSP::DESC_SIZE_BITS> anLBSPLookupVals;
-            LBSP::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
-            const ushort nCurrIntraDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
+            alignas(32) std::array<uchar,LBSPDesc::DESC_SIZE_BITS> anLBSPLookupVals;
+            LBSPDesc::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
+            const desc_t nCurrIntraDesc = LBSPDesc::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
             const uchar nCurrIntraDescBITS = (uchar)lv::popcount(nCurrIntraDesc);
             const bool bCurrRegionIsFlat = nCurrIntraDescBITS<FLAT_REGION_BIT_COUNT;
             if(bCurrRegionIsFlat)
@@ -676,7 +676,7 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
                 {
                     const size_t nColorDist = lv::L1dist(nCurrColor,oCurrLocalWord.oFeature.anColor[0]);
                     const size_t nIntraDescDist = lv::hdist(nCurrIntraDesc,oCurrLocalWord.oFeature.anDesc[0]);
-                    const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,oCurrLocalWord.oFeature.anColor[0],m_anLBSPThreshold_8bitLUT[oCurrLocalWord.oFeature.anColor[0]]);
+                    const desc_t nCurrInterDesc = LBSPDesc::computeDescriptor_threshold(anLBSPLookupVals,oCurrLocalWord.oFeature.anColor[0],m_anLBSPThreshold_8bitLUT[oCurrLocalWord.oFeature.anColor[0]]);
                     const size_t nInterDescDist = lv::hdist(nCurrInterDesc,oCurrLocalWord.oFeature.anDesc[0]);
                     const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
                     if( (!bCurrRegionIsUnstable || bCurrRegionIsFlat || bCurrRegionIsROIBorder)
@@ -827,9 +827,9 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
             //if((!nCurrRegionSegmVal && (rand()%(nCurrRegionIllumUpdtVal?(nCurrLocalWordUpdateRate/2+1):nCurrLocalWordUpdateRate))==0) || bCurrRegionIsROIBorder) {
                 int nSampleImgCoord_Y, nSampleImgCoord_X;
                 if(bCurrRegionIsFlat || bCurrRegionIsROIBorder || m_bUsingMovingCamera)
-                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSPDesc::PATCH_SIZE/2,m_oImgSize);
                 else
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSPDesc::PATCH_SIZE/2,m_oImgSize);
                 const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
                 if(m_oROI.data[nSamplePxIdx]) {
                     const size_t nNeighborLocalDictIdx = m_voPxInfoLUT_PAWCS[nSamplePxIdx].nModelIdx*m_nCurrLocalWords;
@@ -852,8 +852,8 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
 #endif //DISPLAY_PAWCS_DEBUG_INFO
                         }
                         else if(!oCurrFGMask.data[nSamplePxIdx] && bCurrRegionIsFlat && (bBootstrapping || (rand()%nCurrLocalWordUpdateRate)==0)) {
-                            const size_t nSampleDescIdx = nSamplePxIdx*2;
-                            ushort& nNeighborLastIntraDesc = *((ushort*)(m_oLastDescFrame.data+nSampleDescIdx));
+                            const size_t nSampleDescIdx = nSamplePxIdx*LBSPDesc::DESC_SIZE;
+                            desc_t& nNeighborLastIntraDesc = *((desc_t*)(m_oLastDescFrame.data+nSampleDescIdx));
                             const size_t nNeighborLastIntraDescDist = lv::hdist(nCurrIntraDesc,nNeighborLastIntraDesc);
                             if(nNeighborColorDist<=nCurrColorDistThreshold && nNeighborLastIntraDescDist<=nCurrDescDistThreshold/2) {
                                 const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
@@ -945,13 +945,13 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
 #endif //USE_INTERNAL_HRCS
             const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
             const size_t nPxRGBIter = nPxIter*3;
-            const size_t nDescRGBIter = nPxRGBIter*2;
+            const size_t nDescRGBIter = nPxRGBIter*LBSPDesc::DESC_SIZE;
             const size_t nFloatIter = nPxIter*4;
             const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
             const size_t nGlobalWordMapLookupIdx = m_voPxInfoLUT_PAWCS[nPxIter].nGlobalWordMapLookupIdx;
             const uchar* const anCurrColor = oInputImg.data+nPxRGBIter;
             uchar* anLastColor = m_oLastColorFrame.data+nPxRGBIter;
-            ushort* anLastIntraDesc = ((ushort*)(m_oLastDescFrame.data+nDescRGBIter));
+            desc_t* anLastIntraDesc = ((desc_t*)(m_oLastDescFrame.data+nDescRGBIter));
             size_t nMinTotColorDist = s_nColorMaxDataRange_3ch;
             size_t nMinTotDescDist = s_nDescMaxDataRange_3ch;
             float& fCurrMeanRawSegmRes_LT = *(float*)(m_oMeanRawSegmResFrame_LT.data+nFloatIter);
@@ -976,11 +976,11 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
 #endif //DISPLAY_PAWCS_DEBUG_INFO
             const int nCurrImgCoord_X = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_X;
             const int nCurrImgCoord_Y = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y;
-            alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
-            LBSP::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
-            std::array<ushort,3> anCurrIntraDesc;
+            alignas(32) std::array<std::array<uchar,LBSPDesc::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
+            LBSPDesc::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
+            std::array<desc_t,3> anCurrIntraDesc;
             for(size_t c=0; c<3; ++c)
-                anCurrIntraDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
+                anCurrIntraDesc[c] = LBSPDesc::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
             const uchar nCurrIntraDescBITS = (uchar)lv::popcount(anCurrIntraDesc);
             const bool bCurrRegionIsFlat = nCurrIntraDescBITS<FLAT_REGION_BIT_COUNT*2;
             if(bCurrRegionIsFlat)
@@ -1008,9 +1008,9 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
                     const size_t nColorDistortion = lv::cdist(anCurrColor,oCurrLocalWord.oFeature.anColor);
                     const size_t nTotColorMixDist = lv::cmixdist(nTotColorL1Dist,nColorDistortion);
                     const size_t nTotIntraDescDist = lv::hdist(anCurrIntraDesc,oCurrLocalWord.oFeature.anDesc);
-                    std::array<ushort,3> anCurrInterDesc;
+                    std::array<desc_t,3> anCurrInterDesc;
                     for(size_t c=0; c<3; ++c)
-                        anCurrInterDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],oCurrLocalWord.oFeature.anColor[c],m_anLBSPThreshold_8bitLUT[oCurrLocalWord.oFeature.anColor[c]]);
+                        anCurrInterDesc[c] = LBSPDesc::computeDescriptor_threshold(aanLBSPLookupVals[c],oCurrLocalWord.oFeature.anColor[c],m_anLBSPThreshold_8bitLUT[oCurrLocalWord.oFeature.anColor[c]]);
                     const size_t nTotInterDescDist = lv::hdist(anCurrInterDesc,oCurrLocalWord.oFeature.anDesc);
                     const size_t nTotDescDist = (nTotIntraDescDist+nTotInterDescDist)/2;
                     if( (!bCurrRegionIsUnstable || bCurrRegionIsFlat || bCurrRegionIsROIBorder)
@@ -1167,9 +1167,9 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
             //if((!nCurrRegionSegmVal && (rand()%(nCurrRegionIllumUpdtVal?(nCurrLocalWordUpdateRate/2+1):nCurrLocalWordUpdateRate))==0) || bCurrRegionIsROIBorder) {
                 int nSampleImgCoord_Y, nSampleImgCoord_X;
                 if(bCurrRegionIsFlat || bCurrRegionIsROIBorder || m_bUsingMovingCamera)
-                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSPDesc::PATCH_SIZE/2,m_oImgSize);
                 else
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSPDesc::PATCH_SIZE/2,m_oImgSize);
                 const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
                 if(m_oROI.data[nSamplePxIdx]) {
                     const size_t nNeighborLocalDictIdx = m_voPxInfoLUT_PAWCS[nSamplePxIdx].nModelIdx*m_nCurrLocalWords;
@@ -1195,8 +1195,8 @@ void BackgroundSubtractorPAWCS::apply(cv::InputArray _image, cv::OutputArray _fg
                         }
                         else if(!oCurrFGMask.data[nSamplePxIdx] && bCurrRegionIsFlat && (bBootstrapping || (rand()%nCurrLocalWordUpdateRate)==0)) {
                             const size_t nSamplePxRGBIdx = nSamplePxIdx*3;
-                            const size_t nSampleDescRGBIdx = nSamplePxRGBIdx*2;
-                            ushort* anNeighborLastIntraDesc = ((ushort*)(m_oLastDescFrame.data+nSampleDescRGBIdx));
+                            const size_t nSampleDescRGBIdx = nSamplePxRGBIdx*LBSPDesc::DESC_SIZE;
+                            desc_t* anNeighborLastIntraDesc = ((desc_t*)(m_oLastDescFrame.data+nSampleDescRGBIdx));
                             const size_t nNeighborTotLastIntraDescDist = lv::hdist(anCurrIntraDesc,anNeighborLastIntraDesc);
                             if(nNeighborTotColorMixDist<=nCurrTotColorDistThreshold && nNeighborTotLastIntraDescDist<=nCurrTotDescDistThreshold/2) {
                                 const float fNeighborLocalWordWeight = GetLocalWordWeight(oNeighborLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
@@ -1559,9 +1559,8 @@ void BackgroundSubtractorPAWCS::getBackgroundImage(cv::OutputArray backgroundIma
 }
 
 void BackgroundSubtractorPAWCS::getBackgroundDescriptorsImage(cv::OutputArray backgroundDescImage) const { // @@@ add option to reconstruct from gwords?
-    static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
     lvAssert_(m_bInitialized,"algo must be initialized first");
-    cv::Mat oAvgBGDescImg = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
+    cv::Mat oAvgBGDescImg = cv::Mat::zeros(m_oImgSize,CV_64FC((int)m_nImgChannels));
     for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
         const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
         const size_t nLocalDictIdx = nModelIter*m_nCurrLocalWords;
@@ -1569,29 +1568,29 @@ void BackgroundSubtractorPAWCS::getBackgroundDescriptorsImage(cv::OutputArray ba
         const int nCurrImgCoord_Y = m_voPxInfoLUT_PAWCS[nPxIter].nImgCoord_Y;
         if(m_nImgChannels==1) {
             float fTotWeight = 0.0f;
-            float fTotDesc = 0.0f;
+            double dTotDesc = 0.0;
             for(size_t nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
                 const LocalWord_1ch& oCurrLocalWord = (LocalWord_1ch&)*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
                 float fCurrWeight = GetLocalWordWeight(oCurrLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
-                fTotDesc += (float)oCurrLocalWord.oFeature.anDesc[0]*fCurrWeight;
+                dTotDesc += (double)oCurrLocalWord.oFeature.anDesc[0]*fCurrWeight;
                 fTotWeight += fCurrWeight;
             }
-            oAvgBGDescImg.at<float>(nCurrImgCoord_Y,nCurrImgCoord_X) = fTotDesc/fTotWeight;
+            oAvgBGDescImg.at<double>(nCurrImgCoord_Y,nCurrImgCoord_X) = dTotDesc/fTotWeight;
         }
         else { //m_nImgChannels==3
             float fTotWeight = 0.0f;
-            std::array<float,3> fTotDesc = {0.0f,0.0f,0.0f};
+            std::array<double,3> adTotDesc = {0.0,0.0,0.0};
             for(size_t nLocalWordIdx=0; nLocalWordIdx<m_nCurrLocalWords; ++nLocalWordIdx) {
                 const LocalWord_3ch& oCurrLocalWord = (LocalWord_3ch&)*m_vpLocalWordDict[nLocalDictIdx+nLocalWordIdx];
                 float fCurrWeight = GetLocalWordWeight(oCurrLocalWord,m_nFrameIdx,m_nLocalWordWeightOffset);
                 for(size_t c=0; c<3; ++c)
-                    fTotDesc[c] += (float)oCurrLocalWord.oFeature.anDesc[c]*fCurrWeight;
+                    adTotDesc[c] += (double)oCurrLocalWord.oFeature.anDesc[c]*fCurrWeight;
                 fTotWeight += fCurrWeight;
             }
-            oAvgBGDescImg.at<cv::Vec3f>(nCurrImgCoord_Y,nCurrImgCoord_X) = cv::Vec3f(fTotDesc[0]/fTotWeight,fTotDesc[1]/fTotWeight,fTotDesc[2]/fTotWeight);
+            oAvgBGDescImg.at<cv::Vec3d>(nCurrImgCoord_Y,nCurrImgCoord_X) = cv::Vec3d(adTotDesc[0]/fTotWeight,adTotDesc[1]/fTotWeight,adTotDesc[2]/fTotWeight);
         }
     }
-    oAvgBGDescImg.convertTo(backgroundDescImage,CV_16U);
+    convertAvgDescImage(oAvgBGDescImg,backgroundDescImage);
 }
 
 float BackgroundSubtractorPAWCS::GetLocalWordWeight(const LocalWordBase& w, size_t nCurrFrame, size_t nOffset) {
@@ -55,7 +55,7 @@
 #define UNSTAB_DESC_DIST_OFFSET (m_nDescDistThresholdOffset)
 
 static const size_t s_nColorMaxDataRange_1ch = UCHAR_MAX;
-static const size_t s_nDescMaxDataRange_1ch = LBSP::DESC_SIZE_BITS;
+static const size_t s_nDescMaxDataRange_1ch = IBackgroundSubtractorLBSP::LBSPDesc::DESC_SIZE_BITS;
 static const size_t s_nColorMaxDataRange_3ch = s_nColorMaxDataRange_1ch*3;
 static const size_t s_nDescMaxDataRange_3ch = s_nDescMaxDataRange_1ch*3;
 
@@ -90,13 +90,13 @@ void BackgroundSubtractorSuBSENSE::refreshModel(float fSamplesRefreshFrac, bool
         if(bForceFGUpdate || !m_oLastFGMask.data[nPxIter]) {
             for(size_t nCurrModelSampleIdx=nRefreshSampleStartPos; nCurrModelSampleIdx<nRefreshSampleStartPos+nModelSamplesToRefresh; ++nCurrModelSampleIdx) {
                 int nSampleImgCoord_Y, nSampleImgCoord_X;
-                cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT[nPxIter].nImgCoord_X,m_voPxInfoLUT[nPxIter].nImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                cv::getRandSamplePosition_7x7_std2(nSampleImgCoord_X,nSampleImgCoord_Y,m_voPxInfoLUT[nPxIter].nImgCoord_X,m_voPxInfoLUT[nPxIter].nImgCoord_Y,LBSPDesc::PATCH_SIZE/2,m_oImgSize);
                 const size_t nSamplePxIdx = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
                 if(bForceFGUpdate || !m_oLastFGMask.data[nSamplePxIdx]) {
                     const size_t nCurrRealModelSampleIdx = nCurrModelSampleIdx%m_nBGSamples;
                     for(size_t c=0; c<nChannels; ++c) {
                         m_voBGColorSamples[nCurrRealModelSampleIdx].data[nPxIter*nChannels+c] = m_oLastColorFrame.data[nSamplePxIdx*nChannels+c];
-                        *((ushort*)(m_voBGDescSamples[nCurrRealModelSampleIdx].data+(nPxIter*nChannels+c)*2)) = *((ushort*)(m_oLastDescFrame.data+(nSamplePxIdx*nChannels+c)*2));
+                        *((desc_t*)(m_voBGDescSamples[nCurrRealModelSampleIdx].data+(nPxIter*nChannels+c)*LBSPDesc::DESC_SIZE)) = *((desc_t*)(m_oLastDescFrame.data+(nSamplePxIdx*nChannels+c)*LBSPDesc::DESC_SIZE));
                     }
                 }
             }
@@ -177,8 +177,8 @@ void BackgroundSubtractorSuBSENSE::initialize(const cv::Mat& oInitImg, const cv:
     for(size_t s=0; s<m_nBGSamples; ++s) {
         m_voBGColorSamples[s].create(m_oImgSize,CV_8UC((int)m_nImgChannels));
         m_voBGColorSamples[s] = cv::Scalar_<uchar>::all(0);
-        m_voBGDescSamples[s].create(m_oImgSize,CV_16UC((int)m_nImgChannels));
-        m_voBGDescSamples[s] = cv::Scalar_<ushort>::all(0);
+        m_voBGDescSamples[s].create(m_oImgSize,CV_MAKETYPE(LBSPDesc::DESC_DEPTH,(int)m_nImgChannels));
+        m_voBGDescSamples[s] = cv::Scalar_<desc_t>::all(0);
     }
     m_bInitialized = true;
     refreshModel(1.0f);
@@ -200,7 +200,7 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
     if(m_nImgChannels==1) {
         for(size_t nModelIter=0; nModelIter<m_nTotRelevantPxCount; ++nModelIter) {
             const size_t nPxIter = m_vnPxIdxLUT[nModelIter];
-            const size_t nDescIter = nPxIter*2;
+            const size_t nDescIter = nPxIter*LBSPDesc::DESC_SIZE;
             const size_t nFloatIter = nPxIter*4;
             const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
             const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
@@ -217,13 +217,13 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
             float* pfCurrMeanRawSegmRes_ST = ((float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter));
             float* pfCurrMeanFinalSegmRes_LT = ((float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter));
             float* pfCurrMeanFinalSegmRes_ST = ((float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter));
-            ushort& nLastIntraDesc = *((ushort*)(m_oLastDescFrame.data+nDescIter));
+            desc_t& nLastIntraDesc = *((desc_t*)(m_oLastDescFrame.data+nDescIter));
             uchar& nLastColor = m_oLastColorFrame.data[nPxIter];
             const size_t nCurrColorDistThreshold = (size_t)(((*pfCurrDistThresholdFactor)*m_nMinColorDistThreshold)-((!m_oUnstableRegionMask.data[nPxIter])*STAB_COLOR_DIST_OFFSET))/2;
             const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(*pfCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(m_oUnstableRegionMask.data[nPxIter]*UNSTAB_DESC_DIST_OFFSET);
-            alignas(16) std::array<uchar,LBSP::DESC_SIZE_BITS> anLBSPLookupVals;
-            LBSP::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
-            const ushort nCurrIntraDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
+            alignas(32) std::array<uchar,LBSPDesc::DESC_SIZE_BITS> anLBSPLookupVals;
+            LBSPDesc::computeDescriptor_lookup<1>(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,0,anLBSPLookupVals);
+            const desc_t nCurrIntraDesc = LBSPDesc::computeDescriptor_threshold(anLBSPLookupVals,nCurrColor,m_anLBSPThreshold_8bitLUT[nCurrColor]);
             m_oUnstableRegionMask.data[nPxIter] = ((*pfCurrDistThresholdFactor)>UNSTABLE_REG_RDIST_MIN || (*pfCurrMeanRawSegmRes_LT-*pfCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (*pfCurrMeanRawSegmRes_ST-*pfCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN)?1:0;
             size_t nGoodSamplesCount=0, nSampleIdx=0;
             while(nGoodSamplesCount<m_nRequiredBGSamples && nSampleIdx<m_nBGSamples) {
@@ -232,9 +232,9 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
                     const size_t nColorDist = lv::L1dist(nCurrColor,nBGColor);
                     if(nColorDist>nCurrColorDistThreshold)
                         goto failedcheck1ch;
-                    const ushort& nBGIntraDesc = *((ushort*)(m_voBGDescSamples[nSampleIdx].data+nDescIter));
+                    const desc_t& nBGIntraDesc = *((desc_t*)(m_voBGDescSamples[nSampleIdx].data+nDescIter));
                     const size_t nIntraDescDist = lv::hdist(nCurrIntraDesc,nBGIntraDesc);
-                    const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(anLBSPLookupVals,nBGColor,m_anLBSPThreshold_8bitLUT[nBGColor]);
+                    const desc_t nCurrInterDesc = LBSPDesc::computeDescriptor_threshold(anLBSPLookupVals,nBGColor,m_anLBSPThreshold_8bitLUT[nBGColor]);
                     const size_t nInterDescDist = lv::hdist(nCurrInterDesc,nBGIntraDesc);
                     const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
                     if(nDescDist>nCurrDescDistThreshold)
@@ -263,7 +263,7 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
                 oCurrFGMask.data[nPxIter] = UCHAR_MAX;
                 if(m_nModelResetCooldown && (rand()%(size_t)FEEDBACK_T_LOWER)==0) {
                     const size_t s_rand = rand()%m_nBGSamples;
-                    *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIter)) = nCurrIntraDesc;
+                    *((desc_t*)(m_voBGDescSamples[s_rand].data+nDescIter)) = nCurrIntraDesc;
                     m_voBGColorSamples[s_rand].data[nPxIter] = nCurrColor;
                 }
             }
@@ -277,15 +277,15 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
                 const size_t nLearningRate = std::isinf(learningRateOverride)?SIZE_MAX:(learningRateOverride>0?(size_t)ceil(learningRateOverride):(size_t)ceil(*pfCurrLearningRate));
                 if((rand()%nLearningRate)==0) {
                     const size_t s_rand = rand()%m_nBGSamples;
-                    *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIter)) = nCurrIntraDesc;
+                    *((desc_t*)(m_voBGDescSamples[s_rand].data+nDescIter)) = nCurrIntraDesc;
                     m_voBGColorSamples[s_rand].data[nPxIter] = nCurrColor;
                 }
                 int nSampleImgCoord_Y, nSampleImgCoord_X;
                 const bool bCurrUsing3x3Spread = m_bUse3x3Spread && !m_oUnstableRegionMask.data[nPxIter];
                 if(bCurrUsing3x3Spread)
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSPDesc::PATCH_SIZE/2,m_oImgSize);
                 else
-                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSPDesc::PATCH_SIZE/2,m_oImgSize);
                 const size_t n_rand = rand();
                 const size_t idx_rand_uchar = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
                 const size_t idx_rand_flt32 = idx_rand_uchar*4;
@@ -293,9 +293,9 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
                 const float fRandMeanRawSegmRes = *((float*)(m_oMeanRawSegmResFrame_ST.data+idx_rand_flt32));
                 if((n_rand%(bCurrUsing3x3Spread?nLearningRate:(nLearningRate/2+1)))==0
                     || (fRandMeanRawSegmRes>GHOSTDET_S_MIN && fRandMeanLastDist<GHOSTDET_D_MAX && (n_rand%((size_t)m_fCurrLearningRateLowerCap))==0)) {
-                    const size_t idx_rand_ushrt = idx_rand_uchar*2;
+                    const size_t idx_rand_desc = idx_rand_uchar*LBSPDesc::DESC_SIZE;
                     const size_t s_rand = rand()%m_nBGSamples;
-                    *((ushort*)(m_voBGDescSamples[s_rand].data+idx_rand_ushrt)) = nCurrIntraDesc;
+                    *((desc_t*)(m_voBGDescSamples[s_rand].data+idx_rand_desc)) = nCurrIntraDesc;
                     m_voBGColorSamples[s_rand].data[idx_rand_uchar] = nCurrColor;
                 }
             }
@@ -335,7 +335,7 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
             const int nCurrImgCoord_X = m_voPxInfoLUT[nPxIter].nImgCoord_X;
             const int nCurrImgCoord_Y = m_voPxInfoLUT[nPxIter].nImgCoord_Y;
             const size_t nPxIterRGB = nPxIter*3;
-            const size_t nDescIterRGB = nPxIterRGB*2;
+            const size_t nDescIterRGB = nPxIterRGB*LBSPDesc::DESC_SIZE;
             const size_t nFloatIter = nPxIter*4;
             const uchar* const anCurrColor = oInputImg.data+nPxIterRGB;
             size_t nMinTotDescDist=s_nDescMaxDataRange_3ch;
@@ -350,22 +350,22 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
             float* pfCurrMeanRawSegmRes_ST = ((float*)(m_oMeanRawSegmResFrame_ST.data+nFloatIter));
             float* pfCurrMeanFinalSegmRes_LT = ((float*)(m_oMeanFinalSegmResFrame_LT.data+nFloatIter));
             float* pfCurrMeanFinalSegmRes_ST = ((float*)(m_oMeanFinalSegmResFrame_ST.data+nFloatIter));
-            ushort* anLastIntraDesc = ((ushort*)(m_oLastDescFrame.data+nDescIterRGB));
+            desc_t* anLastIntraDesc = ((desc_t*)(m_oLastDescFrame.data+nDescIterRGB));
             uchar* anLastColor = m_oLastColorFrame.data+nPxIterRGB;
             const size_t nCurrColorDistThreshold = (size_t)(((*pfCurrDistThresholdFactor)*m_nMinColorDistThreshold)-((!m_oUnstableRegionMask.data[nPxIter])*STAB_COLOR_DIST_OFFSET));
             const size_t nCurrDescDistThreshold = ((size_t)1<<((size_t)floor(*pfCurrDistThresholdFactor+0.5f)))+m_nDescDistThresholdOffset+(m_oUnstableRegionMask.data[nPxIter]*UNSTAB_DESC_DIST_OFFSET);
             const size_t nCurrTotColorDistThreshold = nCurrColorDistThreshold*3;
             const size_t nCurrTotDescDistThreshold = nCurrDescDistThreshold*3;
             const size_t nCurrSCColorDistThreshold = nCurrTotColorDistThreshold/2;
-            alignas(16) std::array<std::array<uchar,LBSP::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
-            LBSP::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
-            std::array<ushort,3> anCurrIntraDesc;
+            alignas(32) std::array<std::array<uchar,LBSPDesc::DESC_SIZE_BITS>,3> aanLBSPLookupVals;
+            LBSPDesc::computeDescriptor_lookup(oInputImg,nCurrImgCoord_X,nCurrImgCoord_Y,aanLBSPLookupVals);
+            std::array<desc_t,3> anCurrIntraDesc;
             for(size_t c=0; c<3; ++c)
-                anCurrIntraDesc[c] = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
+                anCurrIntraDesc[c] = LBSPDesc::computeDescriptor_threshold(aanLBSPLookupVals[c],anCurrColor[c],m_anLBSPThreshold_8bitLUT[anCurrColor[c]]);
             m_oUnstableRegionMask.data[nPxIter] = ((*pfCurrDistThresholdFactor)>UNSTABLE_REG_RDIST_MIN || (*pfCurrMeanRawSegmRes_LT-*pfCurrMeanFinalSegmRes_LT)>UNSTABLE_REG_RATIO_MIN || (*pfCurrMeanRawSegmRes_ST-*pfCurrMeanFinalSegmRes_ST)>UNSTABLE_REG_RATIO_MIN)?1:0;
             size_t nGoodSamplesCount=0, nSampleIdx=0;
             while(nGoodSamplesCount<m_nRequiredBGSamples && nSampleIdx<m_nBGSamples) {
-                const ushort* const anBGIntraDesc = (ushort*)(m_voBGDescSamples[nSampleIdx].data+nDescIterRGB);
+                const desc_t* const anBGIntraDesc = (desc_t*)(m_voBGDescSamples[nSampleIdx].data+nDescIterRGB);
                 const uchar* const anBGColor = m_voBGColorSamples[nSampleIdx].data+nPxIterRGB;
                 size_t nTotDescDist = 0;
                 size_t nTotSumDist = 0;
@@ -374,7 +374,7 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
                     if(nColorDist>nCurrSCColorDistThreshold)
                         goto failedcheck3ch;
                     const size_t nIntraDescDist = lv::hdist(anCurrIntraDesc[c],anBGIntraDesc[c]);
-                    const ushort nCurrInterDesc = LBSP::computeDescriptor_threshold(aanLBSPLookupVals[c],anBGColor[c],m_anLBSPThreshold_8bitLUT[anBGColor[c]]);
+                    const desc_t nCurrInterDesc = LBSPDesc::computeDescriptor_threshold(aanLBSPLookupVals[c],anBGColor[c],m_anLBSPThreshold_8bitLUT[anBGColor[c]]);
                     const size_t nInterDescDist = lv::hdist(nCurrInterDesc,anBGIntraDesc[c]);
                     const size_t nDescDist = (nIntraDescDist+nInterDescDist)/2;
                     const size_t nSumDist = std::min((nDescDist/2)*(s_nColorMaxDataRange_1ch/s_nDescMaxDataRange_1ch)+nColorDist,s_nColorMaxDataRange_1ch);
@@ -406,7 +406,7 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
                 if(m_nModelResetCooldown && (rand()%(size_t)FEEDBACK_T_LOWER)==0) {
                     const size_t s_rand = rand()%m_nBGSamples;
                     for(size_t c=0; c<3; ++c) {
-                        *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIterRGB+2*c)) = anCurrIntraDesc[c];
+                        *((desc_t*)(m_voBGDescSamples[s_rand].data+nDescIterRGB)+c) = anCurrIntraDesc[c];
                         *(m_voBGColorSamples[s_rand].data+nPxIterRGB+c) = anCurrColor[c];
                     }
                 }
@@ -422,16 +422,16 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
                 if((rand()%nLearningRate)==0) {
                     const size_t s_rand = rand()%m_nBGSamples;
                     for(size_t c=0; c<3; ++c) {
-                        *((ushort*)(m_voBGDescSamples[s_rand].data+nDescIterRGB+2*c)) = anCurrIntraDesc[c];
+                        *((desc_t*)(m_voBGDescSamples[s_rand].data+nDescIterRGB)+c) = anCurrIntraDesc[c];
                         *(m_voBGColorSamples[s_rand].data+nPxIterRGB+c) = anCurrColor[c];
                     }
                 }
                 int nSampleImgCoord_Y, nSampleImgCoord_X;
                 const bool bCurrUsing3x3Spread = m_bUse3x3Spread && !m_oUnstableRegionMask.data[nPxIter];
                 if(bCurrUsing3x3Spread)
-                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                    cv::getRandNeighborPosition_3x3(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSPDesc::PATCH_SIZE/2,m_oImgSize);
                 else
-                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSP::PATCH_SIZE/2,m_oImgSize);
+                    cv::getRandNeighborPosition_5x5(nSampleImgCoord_X,nSampleImgCoord_Y,nCurrImgCoord_X,nCurrImgCoord_Y,LBSPDesc::PATCH_SIZE/2,m_oImgSize);
                 const size_t n_rand = rand();
                 const size_t idx_rand_uchar = m_oImgSize.width*nSampleImgCoord_Y + nSampleImgCoord_X;
                 const size_t idx_rand_flt32 = idx_rand_uchar*4;
@@ -440,10 +440,10 @@ void BackgroundSubtractorSuBSENSE::apply(cv::InputArray _image, cv::OutputArray
                 if((n_rand%(bCurrUsing3x3Spread?nLearningRate:(nLearningRate/2+1)))==0
                     || (fRandMeanRawSegmRes>GHOSTDET_S_MIN && fRandMeanLastDist<GHOSTDET_D_MAX && (n_rand%((size_t)m_fCurrLearningRateLowerCap))==0)) {
                     const size_t idx_rand_uchar_rgb = idx_rand_uchar*3;
-                    const size_t idx_rand_ushrt_rgb = idx_rand_uchar_rgb*2;
+                    const size_t idx_rand_desc_rgb = idx_rand_uchar_rgb*LBSPDesc::DESC_SIZE;
                     const size_t s_rand = rand()%m_nBGSamples;
                     for(size_t c=0; c<3; ++c) {
-                        *((ushort*)(m_voBGDescSamples[s_rand].data+idx_rand_ushrt_rgb+2*c)) = anCurrIntraDesc[c];
+                        *((desc_t*)(m_voBGDescSamples[s_rand].data+idx_rand_desc_rgb)+c) = anCurrIntraDesc[c];
                         *(m_voBGColorSamples[s_rand].data+idx_rand_uchar_rgb+c) = anCurrColor[c];
                     }
                 }
@@ -630,20 +630,19 @@ void BackgroundSubtractorSuBSENSE::getBackgroundImage(cv::OutputArray background
 }
 
 void BackgroundSubtractorSuBSENSE::getBackgroundDescriptorsImage(cv::OutputArray backgroundDescImage) const {
-    static_assert(LBSP::DESC_SIZE==2,"bad assumptions in impl below");
     lvAssert_(m_bInitialized,"algo must be initialized first");
-    cv::Mat oAvgBGDesc = cv::Mat::zeros(m_oImgSize,CV_32FC((int)m_nImgChannels));
+    cv::Mat oAvgBGDesc = cv::Mat::zeros(m_oImgSize,CV_64FC((int)m_nImgChannels));
     for(size_t n=0; n<m_voBGDescSamples.size(); ++n) {
         for(int y=0; y<m_oImgSize.height; ++y) {
             for(int x=0; x<m_oImgSize.width; ++x) {
                 const size_t idx_ndesc = m_voBGDescSamples[n].step.p[0]*y + m_voBGDescSamples[n].step.p[1]*x;
-                const size_t nFloatIter = idx_ndesc*2;
-                float* oAvgBgDescPtr = (float*)(oAvgBGDesc.data+nFloatIter);
-                const ushort* const oBGDescPtr = (ushort*)(m_voBGDescSamples[n].data+idx_ndesc);
+                const size_t nFloatIter = oAvgBGDesc.step.p[0]*y + oAvgBGDesc.step.p[1]*x;
+                double* oAvgBgDescPtr = (double*)(oAvgBGDesc.data+nFloatIter);
+                const desc_t* const oBGDescPtr = (desc_t*)(m_voBGDescSamples[n].data+idx_ndesc);
                 for(size_t c=0; c<m_nImgChannels; ++c)
-                    oAvgBgDescPtr[c] += ((float)oBGDescPtr[c])/m_voBGDescSamples.size();
+                    oAvgBgDescPtr[c] += ((double)oBGDescPtr[c])/m_voBGDescSamples.size();
             }
         }
     }
-    oAvgBGDesc.convertTo(backgroundDescImage,CV_16U);
+    convertAvgDescImage(oAvgBGDesc,backgroundDescImage);
 }